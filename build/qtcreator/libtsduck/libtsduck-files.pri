@@ -165,6 +165,7 @@ HEADERS += \
     ../../../src/libtsduck/tsISO639LanguageDescriptor.h \
     ../../../src/libtsduck/tsISPAccessModeDescriptor.h \
     ../../../src/libtsduck/tsjson.h \
+    ../../../src/libtsduck/tsLatencyHistogram.h \
     ../../../src/libtsduck/tsLinkageDescriptor.h \
     ../../../src/libtsduck/tsLNB.h \
     ../../../src/libtsduck/tsLocalTimeOffsetDescriptor.h \
@@ -205,6 +206,7 @@ HEADERS += \
     ../../../src/libtsduck/tsOneShotPacketizer.h \
     ../../../src/libtsduck/tsOutputPager.h \
     ../../../src/libtsduck/tsOutputRedirector.h \
+    ../../../src/libtsduck/tsPacingTimer.h \
     ../../../src/libtsduck/tsPacketizer.h \
     ../../../src/libtsduck/tsParentalRatingDescriptor.h \
     ../../../src/libtsduck/tsPartialTransportStreamDescriptor.h \
@@ -215,6 +217,8 @@ HEADERS += \
     ../../../src/libtsduck/tsPESDemux.h \
     ../../../src/libtsduck/tsPESHandlerInterface.h \
     ../../../src/libtsduck/tsPESPacket.h \
+    ../../../src/libtsduck/tsPIDMap.h \
+    ../../../src/libtsduck/tsPIDMapTemplate.h \
     ../../../src/libtsduck/tsPIDOperator.h \
     ../../../src/libtsduck/tsPlatform.h \
     ../../../src/libtsduck/tsPlugin.h \
@@ -409,12 +413,21 @@ HEADERS += \
     ../../../src/libtsduck/tsxmlElement.h \
     ../../../src/libtsduck/tsxmlElementTemplate.h \
     ../../../src/libtsduck/tsxmlNode.h \
+    ../../../src/libtsduck/tsxmlReader.h \
     ../../../src/libtsduck/tsxmlText.h \
     ../../../src/libtsduck/tsxmlUnknown.h \
+    ../../../src/libtsduck/tsxmlWriter.h \
+    ../../../src/libtsduck/private/tsAESNI.h \
+    ../../../src/libtsduck/private/tsCRC32PCLMUL.h \
     ../../../src/libtsduck/private/tsDektec.h \
     ../../../src/libtsduck/private/tsDektecDevice.h \
     ../../../src/libtsduck/private/tsDektecVPD.h \
+    ../../../src/libtsduck/private/tsDVBCSA2Slice.h \
+    ../../../src/libtsduck/private/tsDVBCSA2SliceTemplate.h \
     ../../../src/libtsduck/private/tsRefType.h \
+    ../../../src/libtsduck/private/tsSHAAVX2.h \
+    ../../../src/libtsduck/private/tsSHAMultiBuffer.h \
+    ../../../src/libtsduck/private/tsSHANI.h \
 
 SOURCES += \
     ../../../src/libtsduck/tsAACDescriptor.cpp \
@@ -528,6 +541,7 @@ SOURCES += \
     ../../../src/libtsduck/tsGrid.cpp \
     ../../../src/libtsduck/tsGuard.cpp \
     ../../../src/libtsduck/tsGuardCondition.cpp \
+    ../../../src/libtsduck/tsHash.cpp \
     ../../../src/libtsduck/tsHDSimulcastLogicalChannelDescriptor.cpp \
     ../../../src/libtsduck/tsHEVCTimingAndHRDDescriptor.cpp \
     ../../../src/libtsduck/tsHEVCVideoDescriptor.cpp \
@@ -549,6 +563,7 @@ SOURCES += \
     ../../../src/libtsduck/tsISO639LanguageDescriptor.cpp \
     ../../../src/libtsduck/tsISPAccessModeDescriptor.cpp \
     ../../../src/libtsduck/tsjson.cpp \
+    ../../../src/libtsduck/tsLatencyHistogram.cpp \
     ../../../src/libtsduck/tsLinkageDescriptor.cpp \
     ../../../src/libtsduck/tsLNB.cpp \
     ../../../src/libtsduck/tsLocalTimeOffsetDescriptor.cpp \
@@ -581,6 +596,7 @@ SOURCES += \
     ../../../src/libtsduck/tsOneShotPacketizer.cpp \
     ../../../src/libtsduck/tsOutputPager.cpp \
     ../../../src/libtsduck/tsOutputRedirector.cpp \
+    ../../../src/libtsduck/tsPacingTimer.cpp \
     ../../../src/libtsduck/tsPacketizer.cpp \
     ../../../src/libtsduck/tsParentalRatingDescriptor.cpp \
     ../../../src/libtsduck/tsPartialTransportStreamDescriptor.cpp \
@@ -745,10 +761,18 @@ SOURCES += \
     ../../../src/libtsduck/tsxmlDocument.cpp \
     ../../../src/libtsduck/tsxmlElement.cpp \
     ../../../src/libtsduck/tsxmlNode.cpp \
+    ../../../src/libtsduck/tsxmlReader.cpp \
     ../../../src/libtsduck/tsxmlText.cpp \
     ../../../src/libtsduck/tsxmlUnknown.cpp \
+    ../../../src/libtsduck/tsxmlWriter.cpp \
+    ../../../src/libtsduck/private/tsAESNI.cpp \
+    ../../../src/libtsduck/private/tsCRC32PCLMUL.cpp \
     ../../../src/libtsduck/private/tsDektecDevice.cpp \
     ../../../src/libtsduck/private/tsDektecVPD.cpp \
+    ../../../src/libtsduck/private/tsDVBCSA2AVX2.cpp \
+    ../../../src/libtsduck/private/tsSHAAVX2.cpp \
+    ../../../src/libtsduck/private/tsSHAMultiBuffer.cpp \
+    ../../../src/libtsduck/private/tsSHANI.cpp \
 
 linux {
     HEADERS += \
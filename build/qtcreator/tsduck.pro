@@ -103,8 +103,10 @@ SUBDIRS += \
     tsdump \
     tsecmg \
     tsemmg \
+    tsfilebench \
     tsfixcc \
     tsftrunc \
+    tsnamescomp \
     tslsdvb \
     tsp \
     tspacketize \
@@ -0,0 +1,3 @@
+CONFIG += tstool
+TARGET = tsfilebench
+include(../tsduck.pri)
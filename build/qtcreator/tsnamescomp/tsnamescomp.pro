@@ -0,0 +1,3 @@
+CONFIG += tstool
+TARGET = tsnamescomp
+include(../tsduck.pri)
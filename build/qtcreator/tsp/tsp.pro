@@ -8,7 +8,8 @@ SOURCES += \
     ../../../src/tstools/tspOptions.cpp \
     ../../../src/tstools/tspOutputExecutor.cpp \
     ../../../src/tstools/tspPluginExecutor.cpp \
-    ../../../src/tstools/tspProcessorExecutor.cpp
+    ../../../src/tstools/tspProcessorExecutor.cpp \
+    ../../../src/tstools/tspTelemetryMonitor.cpp
 
 HEADERS += \
     ../../../src/tstools/tspInputExecutor.h \
@@ -16,4 +17,5 @@ HEADERS += \
     ../../../src/tstools/tspOptions.h \
     ../../../src/tstools/tspOutputExecutor.h \
     ../../../src/tstools/tspPluginExecutor.h \
-    ../../../src/tstools/tspProcessorExecutor.h
+    ../../../src/tstools/tspProcessorExecutor.h \
+    ../../../src/tstools/tspTelemetryMonitor.h
@@ -32,6 +32,7 @@ SOURCES += \
     ../../../src/utest/utestGuard.cpp \
     ../../../src/utest/utestInterrupt.cpp \
     ../../../src/utest/utestJSON.cpp \
+    ../../../src/utest/utestLatencyHistogram.cpp \
     ../../../src/utest/utestMessageQueue.cpp \
     ../../../src/utest/utestMPEPacket.cpp \
     ../../../src/utest/utestMonotonic.cpp \
@@ -39,6 +40,7 @@ SOURCES += \
     ../../../src/utest/utestNames.cpp \
     ../../../src/utest/utestNetworking.cpp \
     ../../../src/utest/utestPacketizer.cpp \
+    ../../../src/utest/utestPESDemux.cpp \
     ../../../src/utest/utestPlatform.cpp \
     ../../../src/utest/utestPlugin.cpp \
     ../../../src/utest/utestReport.cpp \
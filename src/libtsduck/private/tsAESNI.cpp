@@ -0,0 +1,141 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  AES-NI implementation of AES encryption and decryption.
+//  This module is compiled with AES and SSE2 code generation on x86
+//  platforms. It is used only when the CPU supports them at run time.
+//
+//  The latency of AESENC / AESDEC is several cycles while their throughput
+//  is one per cycle or better. Independent blocks (ECB, CBC decryption) are
+//  processed by groups of 8 blocks to keep the AES unit busy.
+//
+//----------------------------------------------------------------------------
+
+#include "tsAESNI.h"
+TSDUCK_SOURCE;
+
+#if defined(TS_GCC) && defined(__AES__) && defined(__SSE2__)
+#include <immintrin.h>
+
+namespace {
+    // Maximum number of round keys (AES-256).
+    const int MAX_KEYS = 15;
+
+    // Number of blocks in flight.
+    const size_t PARALLEL_BLOCKS = 8;
+
+    #define LOAD(p)     _mm_loadu_si128(reinterpret_cast<const __m128i*>(p))
+    #define STORE(p, x) _mm_storeu_si128(reinterpret_cast<__m128i*>(p), (x))
+
+    // Generic multi-block processing, ROUND and LAST are the AES-NI instructions.
+    template <__m128i (*ROUND)(__m128i, __m128i), __m128i (*LAST)(__m128i, __m128i)>
+    inline void ProcessBlocks(const uint8_t* keys, int rounds, const uint8_t* in, uint8_t* out, size_t count)
+    {
+        __m128i k[MAX_KEYS];
+        for (int r = 0; r <= rounds; ++r) {
+            k[r] = LOAD(keys + 16 * r);
+        }
+
+        // Groups of blocks in flight.
+        while (count >= PARALLEL_BLOCKS) {
+            __m128i b[PARALLEL_BLOCKS];
+            for (size_t i = 0; i < PARALLEL_BLOCKS; ++i) {
+                b[i] = _mm_xor_si128(LOAD(in + 16 * i), k[0]);
+            }
+            for (int r = 1; r < rounds; ++r) {
+                for (size_t i = 0; i < PARALLEL_BLOCKS; ++i) {
+                    b[i] = ROUND(b[i], k[r]);
+                }
+            }
+            for (size_t i = 0; i < PARALLEL_BLOCKS; ++i) {
+                STORE(out + 16 * i, LAST(b[i], k[rounds]));
+            }
+            in += 16 * PARALLEL_BLOCKS;
+            out += 16 * PARALLEL_BLOCKS;
+            count -= PARALLEL_BLOCKS;
+        }
+
+        // Remaining blocks, one at a time.
+        for (; count > 0; --count, in += 16, out += 16) {
+            __m128i b = _mm_xor_si128(LOAD(in), k[0]);
+            for (int r = 1; r < rounds; ++r) {
+                b = ROUND(b, k[r]);
+            }
+            STORE(out, LAST(b, k[rounds]));
+        }
+    }
+
+    #undef LOAD
+    #undef STORE
+
+    // The intrinsics may be macros or builtins, wrap them into functions.
+    inline __m128i Enc(__m128i x, __m128i k) { return _mm_aesenc_si128(x, k); }
+    inline __m128i EncLast(__m128i x, __m128i k) { return _mm_aesenclast_si128(x, k); }
+    inline __m128i Dec(__m128i x, __m128i k) { return _mm_aesdec_si128(x, k); }
+    inline __m128i DecLast(__m128i x, __m128i k) { return _mm_aesdeclast_si128(x, k); }
+
+    void EncryptNI(const uint8_t* keys, int rounds, const uint8_t* in, uint8_t* out, size_t count)
+    {
+        ProcessBlocks<Enc, EncLast>(keys, rounds, in, out, count);
+    }
+
+    void DecryptNI(const uint8_t* keys, int rounds, const uint8_t* in, uint8_t* out, size_t count)
+    {
+        ProcessBlocks<Dec, DecLast>(keys, rounds, in, out, count);
+    }
+
+    bool SupportedNI()
+    {
+        return __builtin_cpu_supports("aes") && __builtin_cpu_supports("sse2");
+    }
+}
+
+ts::AESBlocksFunction ts::AESEncryptNI()
+{
+    return SupportedNI() ? EncryptNI : 0;
+}
+
+ts::AESBlocksFunction ts::AESDecryptNI()
+{
+    return SupportedNI() ? DecryptNI : 0;
+}
+
+#else
+
+ts::AESBlocksFunction ts::AESEncryptNI()
+{
+    return 0;
+}
+
+ts::AESBlocksFunction ts::AESDecryptNI()
+{
+    return 0;
+}
+
+#endif
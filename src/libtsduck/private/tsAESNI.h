@@ -0,0 +1,67 @@
+//-----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  AES-NI implementation of AES, used by ts::AES.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsPlatform.h"
+
+namespace ts {
+    //!
+    //! Profile of an AES multi-block processing function.
+    //!
+    //! Several independent blocks are processed in flight to hide the latency of
+    //! the AES round instructions.
+    //!
+    //! @param [in] keys Round keys, @a rounds + 1 blocks of 16 bytes, in the byte order
+    //! of the data. For decryption, these are the keys of the equivalent inverse cipher.
+    //! @param [in] rounds Number of AES rounds (10, 12 or 14).
+    //! @param [in] in Address of input blocks.
+    //! @param [out] out Address of output blocks. Can be the same as @a in.
+    //! @param [in] count Number of 16-byte blocks to process.
+    //!
+    typedef void (*AESBlocksFunction)(const uint8_t* keys, int rounds, const uint8_t* in, uint8_t* out, size_t count);
+
+    //!
+    //! Get the AES-NI implementation of the AES encryption.
+    //! It is compiled in a separate module with specific compilation options.
+    //! @return The AES-NI implementation or zero if not supported by the compiler or the CPU.
+    //!
+    AESBlocksFunction AESEncryptNI();
+
+    //!
+    //! Get the AES-NI implementation of the AES decryption.
+    //! It is compiled in a separate module with specific compilation options.
+    //! @return The AES-NI implementation or zero if not supported by the compiler or the CPU.
+    //!
+    AESBlocksFunction AESDecryptNI();
+}
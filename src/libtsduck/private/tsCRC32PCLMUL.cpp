@@ -0,0 +1,115 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  PCLMULQDQ implementation of the MPEG CRC32 folding.
+//  This module is compiled with PCLMUL and SSSE3 code generation on x86
+//  platforms. It is used only when the CPU supports them at run time.
+//
+//  Reference: Intel, "Fast CRC Computation for Generic Polynomials Using
+//  PCLMULQDQ Instruction", 2009. MPEG CRC32 is not bit-reflected: the data
+//  are byte-swapped in 128-bit registers and folded most significant first.
+//
+//----------------------------------------------------------------------------
+
+#include "tsCRC32PCLMUL.h"
+TSDUCK_SOURCE;
+
+#if defined(TS_GCC) && defined(__PCLMUL__) && defined(__SSSE3__)
+#include <immintrin.h>
+
+namespace {
+    // Folding constants x^n mod P, high 64 bits for the high half of a register, low 64 bits for the low half.
+    // Fold by 128 bits: x^(128+64) and x^128. Fold by 512 bits: x^(512+64) and x^512.
+    #define FOLD_CONSTANTS(hi, lo) _mm_set_epi64x(TS_UCONST64(hi), TS_UCONST64(lo))
+
+    // Fold a 128-bit register over a given distance and add the next data block.
+    inline __m128i Fold(__m128i x, __m128i k, __m128i next)
+    {
+        return _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x00), _mm_clmulepi64_si128(x, k, 0x11)), next);
+    }
+
+    void FoldPCLMUL(uint32_t fcs, const uint8_t* data, size_t size, uint8_t* residue)
+    {
+        // Byte order reversal in a 128-bit register, the first byte becomes the most significant one.
+        const __m128i swap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        const __m128i k128 = FOLD_CONSTANTS(0x00000000C5B9CD4C, 0x00000000E8A45605);
+        const __m128i k512 = FOLD_CONSTANTS(0x000000008833794C, 0x00000000E6228B11);
+
+        #define LOAD(i) _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data) + (i)), swap)
+
+        // The initial CRC value is added to the first 32 bits of the data.
+        __m128i x0 = _mm_xor_si128(LOAD(0), _mm_set_epi32(int(fcs), 0, 0, 0));
+        __m128i x1 = LOAD(1);
+        __m128i x2 = LOAD(2);
+        __m128i x3 = LOAD(3);
+        data += 64;
+        size -= 64;
+
+        // Fold 4 registers in parallel, 64 bytes at a time.
+        while (size >= 64) {
+            x0 = Fold(x0, k512, LOAD(0));
+            x1 = Fold(x1, k512, LOAD(1));
+            x2 = Fold(x2, k512, LOAD(2));
+            x3 = Fold(x3, k512, LOAD(3));
+            data += 64;
+            size -= 64;
+        }
+
+        // Fold the 4 registers into one.
+        x1 = Fold(x0, k128, x1);
+        x2 = Fold(x1, k128, x2);
+        x3 = Fold(x2, k128, x3);
+
+        // Fold the remaining 16-byte blocks.
+        while (size >= 16) {
+            x3 = Fold(x3, k128, LOAD(0));
+            data += 16;
+            size -= 16;
+        }
+
+        #undef LOAD
+
+        // Store the residue in original byte order.
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(residue), _mm_shuffle_epi8(x3, swap));
+    }
+}
+
+ts::CRC32FoldFunction ts::CRC32FoldPCLMUL()
+{
+    return __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("ssse3") ? FoldPCLMUL : 0;
+}
+
+#else
+
+ts::CRC32FoldFunction ts::CRC32FoldPCLMUL()
+{
+    return 0;
+}
+
+#endif
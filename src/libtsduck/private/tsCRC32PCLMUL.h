@@ -0,0 +1,59 @@
+//-----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Carry-less multiplication (PCLMULQDQ) folding of MPEG CRC32, used by ts::CRC32.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsPlatform.h"
+
+namespace ts {
+    //!
+    //! Profile of a CRC32 folding function.
+    //!
+    //! The data area is reduced to a 16-byte residue which has the same CRC32 as the
+    //! complete data area. The CRC32 computation shall be completed by computing the
+    //! CRC32 of the residue, starting from a zero initial value.
+    //!
+    //! @param [in] fcs Initial CRC32 value.
+    //! @param [in] data Address of area to analyze.
+    //! @param [in] size Size in bytes of area to analyze. Must be a multiple of 16, at least 64.
+    //! @param [out] residue Address of a 16-byte area receiving the residue.
+    //!
+    typedef void (*CRC32FoldFunction)(uint32_t fcs, const uint8_t* data, size_t size, uint8_t* residue);
+
+    //!
+    //! Get the PCLMULQDQ implementation of the CRC32 folding.
+    //! It is compiled in a separate module with specific compilation options.
+    //! @return The PCLMULQDQ implementation or zero if not supported by the compiler or the CPU.
+    //!
+    CRC32FoldFunction CRC32FoldPCLMUL();
+}
@@ -0,0 +1,63 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  AVX2 implementation of the bitsliced DVB-CSA2 stream cipher.
+//  This module is compiled with AVX2 code generation on x86 platforms.
+//  It is used only when the CPU supports AVX2 at run time.
+//
+//----------------------------------------------------------------------------
+
+#include "tsDVBCSA2Slice.h"
+TSDUCK_SOURCE;
+
+#if defined(TS_GCC) && defined(__AVX2__)
+
+namespace {
+    // 256-bit vector type, 256 data blocks in parallel.
+    typedef uint64_t Vector256 __attribute__((vector_size(32)));
+
+    void CipherAVX2(const uint8_t* key, uint8_t* const* data, const size_t* size, size_t count)
+    {
+        ts::DVBCSA2Slice<Vector256>::Cipher(key, data, size, count);
+    }
+}
+
+ts::DVBCSA2SliceFunction ts::DVBCSA2SliceAVX2()
+{
+    return __builtin_cpu_supports("avx2") ? CipherAVX2 : 0;
+}
+
+#else
+
+ts::DVBCSA2SliceFunction ts::DVBCSA2SliceAVX2()
+{
+    return 0;
+}
+
+#endif
@@ -0,0 +1,134 @@
+//-----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Bitsliced DVB-CSA2 stream cipher, used by the batch operations of ts::DVBCSA2.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsPlatform.h"
+
+namespace ts {
+    //!
+    //! Bitsliced DVB-CSA2 stream cipher.
+    //!
+    //! This is a private implementation class of the batch operations of ts::DVBCSA2.
+    //! Each bit of the stream cipher state is stored in one @a WORD. Each bit position
+    //! in a @a WORD belongs to a distinct data block. All data blocks are processed in
+    //! parallel using bitwise logical operations only.
+    //!
+    //! @tparam WORD Either uint64_t or a compiler-specific vector of uint64_t (SSE2, AVX2,
+    //! etc.) The operators ~, &, | and ^ must be defined on @a WORD.
+    //!
+    template <typename WORD>
+    class DVBCSA2Slice
+    {
+    public:
+        //!
+        //! Number of data blocks which are processed in parallel.
+        //!
+        static const size_t LANES = 8 * sizeof(WORD);
+
+        //!
+        //! Apply the stream cipher on a set of data blocks.
+        //! In each data block, the first 8 bytes initialize the stream cipher and
+        //! the rest of the data block is xor'ed with the generated key stream.
+        //! @param [in] key Control word, after entropy reduction if necessary. Its size must be 8 bytes.
+        //! @param [in,out] data Array of @a count addresses of data blocks.
+        //! @param [in] size Array of @a count data block sizes. All sizes must be 8 or more.
+        //! @param [in] count Number of data blocks, up to LANES.
+        //!
+        static void Cipher(const uint8_t* key, uint8_t* const* data, const size_t* size, size_t count);
+
+    private:
+        // Number of uint64_t in a WORD.
+        static const size_t CHUNKS = sizeof(WORD) / sizeof(uint64_t);
+
+        // The shift registers A and B are moved in a larger window to avoid moving
+        // all nibbles at each clock. They are relocated every WINDOW clocks.
+        static const size_t WINDOW = 32;
+
+        // Stream cipher state. Each nibble is an array of 4 bits, LSB first.
+        WORD   _a[WINDOW + 10][4];  // A[1..10] is _a[_pos.._pos+9].
+        WORD   _b[WINDOW + 10][4];  // B[1..10] is _b[_pos.._pos+9].
+        size_t _pos;
+        WORD   _x[4];
+        WORD   _y[4];
+        WORD   _z[4];
+        WORD   _d[4];
+        WORD   _e[4];
+        WORD   _f[4];
+        WORD   _p;
+        WORD   _q;
+        WORD   _r;
+
+        // Initialize the stream cipher with the same key in all lanes.
+        void init(const uint8_t* key);
+
+        // Perform one clock. The inputs are used during initialization only (null otherwise).
+        // Return the two output bits.
+        void clock(const WORD* in_a, const WORD* in_b, WORD& out1, WORD& out0);
+
+        // Process 8 bytes. In initialization mode, in[64] contains the sliced input bytes.
+        // In generation mode, in is null and out[64] receives the sliced key stream bytes.
+        // Bit b of byte i is at index 8*i+b.
+        void run(const WORD* in, WORD* out);
+
+        // Access a 64-bit chunk in a WORD.
+        static uint64_t& Chunk(WORD& w, size_t index) { return reinterpret_cast<uint64_t*>(&w)[index]; }
+
+        // Transpose a 64x64 bit matrix: bit l of m[c] is swapped with bit c of m[l].
+        static void Transpose(uint64_t m[64]);
+
+        // The seven s-boxes, as boolean functions of their 5 input bits (x4 is the MSB).
+        static void SBox1(WORD& o1, WORD& o0, const WORD& x4, const WORD& x3, const WORD& x2, const WORD& x1, const WORD& x0);
+        static void SBox2(WORD& o1, WORD& o0, const WORD& x4, const WORD& x3, const WORD& x2, const WORD& x1, const WORD& x0);
+        static void SBox3(WORD& o1, WORD& o0, const WORD& x4, const WORD& x3, const WORD& x2, const WORD& x1, const WORD& x0);
+        static void SBox4(WORD& o1, WORD& o0, const WORD& x4, const WORD& x3, const WORD& x2, const WORD& x1, const WORD& x0);
+        static void SBox5(WORD& o1, WORD& o0, const WORD& x4, const WORD& x3, const WORD& x2, const WORD& x1, const WORD& x0);
+        static void SBox6(WORD& o1, WORD& o0, const WORD& x4, const WORD& x3, const WORD& x2, const WORD& x1, const WORD& x0);
+        static void SBox7(WORD& o1, WORD& o0, const WORD& x4, const WORD& x3, const WORD& x2, const WORD& x1, const WORD& x0);
+    };
+
+    //!
+    //! Profile of a bitsliced stream cipher function.
+    //! @see DVBCSA2Slice::Cipher()
+    //!
+    typedef void (*DVBCSA2SliceFunction)(const uint8_t* key, uint8_t* const* data, const size_t* size, size_t count);
+
+    //!
+    //! Get the AVX2 implementation of the bitsliced stream cipher.
+    //! It is compiled in a separate module with specific compilation options.
+    //! @return The AVX2 implementation or zero if not supported by the compiler or the CPU.
+    //!
+    DVBCSA2SliceFunction DVBCSA2SliceAVX2();
+}
+
+#include "tsDVBCSA2SliceTemplate.h"
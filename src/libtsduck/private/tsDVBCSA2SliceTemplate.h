@@ -0,0 +1,377 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Bitsliced DVB-CSA2 stream cipher.
+//  The s-boxes are expressed as boolean functions using their algebraic
+//  normal form, computed from the s-box tables in tsDVBCSA2.cpp.
+//
+//----------------------------------------------------------------------------
+
+#pragma once
+
+
+//----------------------------------------------------------------------------
+// Apply the stream cipher on a set of data blocks.
+//----------------------------------------------------------------------------
+
+template <typename WORD>
+void ts::DVBCSA2Slice<WORD>::Cipher(const uint8_t* key, uint8_t* const* data, const size_t* size, size_t count)
+{
+    assert(count <= LANES);
+
+    DVBCSA2Slice<WORD> ctx;
+    WORD bits[64];
+    uint64_t m[64];
+    size_t max_size = 0;
+
+    // Slice the first 8 bytes of all data blocks.
+    for (size_t c = 0; c < CHUNKS; ++c) {
+        for (size_t l = 0; l < 64; ++l) {
+            const size_t i = 64 * c + l;
+            m[l] = i < count ? GetUInt64LE(data[i]) : 0;
+        }
+        Transpose(m);
+        for (size_t k = 0; k < 64; ++k) {
+            Chunk(bits[k], c) = m[k];
+        }
+    }
+    for (size_t i = 0; i < count; ++i) {
+        assert(size[i] >= 8);
+        max_size = std::max(max_size, size[i]);
+    }
+
+    // Stream cipher initialization using the first 8 bytes.
+    ctx.init(key);
+    ctx.run(bits, 0);
+
+    // Generate the key stream, 8 bytes at a time, and apply it on all data blocks.
+    for (size_t offset = 8; offset < max_size; offset += 8) {
+        ctx.run(0, bits);
+        for (size_t c = 0; c < CHUNKS; ++c) {
+            for (size_t k = 0; k < 64; ++k) {
+                m[k] = Chunk(bits[k], c);
+            }
+            Transpose(m);
+            for (size_t l = 0; l < 64 && 64 * c + l < count; ++l) {
+                const size_t i = 64 * c + l;
+                if (offset < size[i]) {
+                    uint8_t* const p = data[i] + offset;
+                    if (size[i] - offset >= 8) {
+                        PutUInt64LE(p, GetUInt64LE(p) ^ m[l]);
+                    }
+                    else {
+                        // Residue
+                        for (size_t b = 0; b < size[i] - offset; ++b) {
+                            p[b] ^= uint8_t(m[l] >> (8 * b));
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Initialize the stream cipher with the same key in all lanes.
+//----------------------------------------------------------------------------
+
+template <typename WORD>
+void ts::DVBCSA2Slice<WORD>::init(const uint8_t* key)
+{
+    const WORD zero = WORD();
+    const WORD ones = ~zero;
+
+    // Load first 32 bits of key into A[1]..A[8], last 32 bits of key into B[1]..B[8].
+    // All other registers are zero.
+    _pos = WINDOW;
+    for (size_t n = 0; n < 10; ++n) {
+        for (size_t i = 0; i < 4; ++i) {
+            const int shift = n % 2 == 0 ? 4 + i : i;
+            _a[_pos + n][i] = n < 8 && ((key[n / 2] >> shift) & 1) != 0 ? ones : zero;
+            _b[_pos + n][i] = n < 8 && ((key[4 + n / 2] >> shift) & 1) != 0 ? ones : zero;
+        }
+    }
+    for (size_t i = 0; i < 4; ++i) {
+        _x[i] = _y[i] = _z[i] = _d[i] = _e[i] = _f[i] = zero;
+    }
+    _p = _q = _r = zero;
+}
+
+
+//----------------------------------------------------------------------------
+// Process 8 bytes (32 clocks).
+//----------------------------------------------------------------------------
+
+template <typename WORD>
+void ts::DVBCSA2Slice<WORD>::run(const WORD* in, WORD* out)
+{
+    WORD out1, out0;
+    for (size_t i = 0; i < 8; ++i) {
+        for (size_t j = 0; j < 4; ++j) {
+            if (in != 0) {
+                // Initialization: A and B receive alternatively the most and least significant nibbles.
+                const WORD* const msn = in + 8 * i + 4;
+                const WORD* const lsn = in + 8 * i;
+                clock(j % 2 == 0 ? msn : lsn, j % 2 == 0 ? lsn : msn, out1, out0);
+            }
+            else {
+                // Generation: 2 output bits per clock, most significant bits first.
+                clock(0, 0, out1, out0);
+                out[8 * i + 7 - 2 * j] = out1;
+                out[8 * i + 6 - 2 * j] = out0;
+            }
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Perform one clock of the stream cipher.
+//----------------------------------------------------------------------------
+
+template <typename WORD>
+inline void ts::DVBCSA2Slice<WORD>::clock(const WORD* in_a, const WORD* in_b, WORD& out1, WORD& out0)
+{
+    // Relocate shift registers at the end of the window when necessary.
+    if (_pos == 0) {
+        for (size_t n = 0; n < 10; ++n) {
+            for (size_t i = 0; i < 4; ++i) {
+                _a[WINDOW + n][i] = _a[n][i];
+                _b[WINDOW + n][i] = _b[n][i];
+            }
+        }
+        _pos = WINDOW;
+    }
+
+    // A[1]..A[10] and B[1]..B[10].
+    const WORD (* const A)[4] = _a + _pos - 1;
+    const WORD (* const B)[4] = _b + _pos - 1;
+
+    // From A[1]..A[10], 35 bits are selected as inputs to 7 s-boxes.
+    // 5 bits input per s-box, 2 bits output per s-box.
+    WORD s1_1, s1_0, s2_1, s2_0, s3_1, s3_0, s4_1, s4_0, s5_1, s5_0, s6_1, s6_0, s7_1, s7_0;
+    SBox1(s1_1, s1_0, A[4][0], A[1][2], A[6][1], A[7][3], A[9][0]);
+    SBox2(s2_1, s2_0, A[2][1], A[3][2], A[6][3], A[7][0], A[9][1]);
+    SBox3(s3_1, s3_0, A[1][3], A[2][0], A[5][1], A[5][3], A[6][2]);
+    SBox4(s4_1, s4_0, A[3][3], A[1][1], A[2][3], A[4][2], A[8][0]);
+    SBox5(s5_1, s5_0, A[5][2], A[4][3], A[6][0], A[8][1], A[9][2]);
+    SBox6(s6_1, s6_0, A[3][1], A[4][1], A[5][0], A[7][2], A[9][3]);
+    SBox7(s7_1, s7_0, A[2][2], A[3][0], A[7][1], A[8][2], A[8][3]);
+
+    // Use 4x4 xor to produce extra nibble for T3.
+    WORD extra_b[4];
+    extra_b[3] = B[3][0] ^ B[6][1] ^ B[7][2] ^ B[9][3];
+    extra_b[2] = B[6][0] ^ B[8][1] ^ B[3][3] ^ B[4][2];
+    extra_b[1] = B[5][3] ^ B[8][2] ^ B[4][0] ^ B[5][1];
+    extra_b[0] = B[9][2] ^ B[6][3] ^ B[3][1] ^ B[8][0];
+
+    // T1 and T2 = xor all inputs.
+    // The input nibbles and D are only used during initialisation, not generation.
+    WORD next_a1[4];
+    WORD next_b1[4];
+    for (size_t i = 0; i < 4; ++i) {
+        next_a1[i] = A[10][i] ^ _x[i];
+        next_b1[i] = B[7][i] ^ B[10][i] ^ _y[i];
+        if (in_a != 0) {
+            next_a1[i] = next_a1[i] ^ _d[i] ^ in_a[i];
+            next_b1[i] = next_b1[i] ^ in_b[i];
+        }
+    }
+
+    // If p=1, rotate next B1 left.
+    const WORD b1_3 = next_b1[3];
+    next_b1[3] = next_b1[3] ^ (_p & (next_b1[3] ^ next_b1[2]));
+    next_b1[2] = next_b1[2] ^ (_p & (next_b1[2] ^ next_b1[1]));
+    next_b1[1] = next_b1[1] ^ (_p & (next_b1[1] ^ next_b1[0]));
+    next_b1[0] = next_b1[0] ^ (_p & (next_b1[0] ^ b1_3));
+
+    // T3 = xor all inputs: D = E ^ Z ^ extra_B.
+    // T4 = sum, carry of Z + E + r if q=1, E otherwise. New E is previous F.
+    WORD carry = _r;
+    for (size_t i = 0; i < 4; ++i) {
+        const WORD e = _e[i];
+        const WORD ze = _z[i] ^ e;
+        const WORD sum = ze ^ carry;
+        carry = (_z[i] & e) | (carry & ze);
+        _d[i] = ze ^ extra_b[i];
+        _e[i] = _f[i];
+        _f[i] = e ^ (_q & (sum ^ e));
+    }
+    _r = _r ^ (_q & (carry ^ _r));
+
+    // Shift registers.
+    _pos--;
+    for (size_t i = 0; i < 4; ++i) {
+        _a[_pos][i] = next_a1[i];
+        _b[_pos][i] = next_b1[i];
+    }
+
+    _x[3] = s4_0; _x[2] = s3_0; _x[1] = s2_1; _x[0] = s1_1;
+    _y[3] = s6_0; _y[2] = s5_0; _y[1] = s4_1; _y[0] = s3_1;
+    _z[3] = s2_0; _z[2] = s1_0; _z[1] = s6_1; _z[0] = s5_1;
+    _p = s7_1;
+    _q = s7_0;
+
+    // 2 output bits are a function of the 4 bits of D, xor 2 by 2.
+    out1 = _d[3] ^ _d[2];
+    out0 = _d[1] ^ _d[0];
+}
+
+
+//----------------------------------------------------------------------------
+// Transpose a 64x64 bit matrix.
+//----------------------------------------------------------------------------
+
+template <typename WORD>
+void ts::DVBCSA2Slice<WORD>::Transpose(uint64_t m[64])
+{
+    uint64_t mask = TS_UCONST64(0x00000000FFFFFFFF);
+    for (size_t j = 32; j != 0; j >>= 1, mask ^= mask << j) {
+        for (size_t k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+            const uint64_t t = ((m[k] >> j) ^ m[k | j]) & mask;
+            m[k] ^= t << j;
+            m[k | j] ^= t;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// The seven s-boxes of the stream cipher.
+//----------------------------------------------------------------------------
+
+template <typename WORD>
+inline void ts::DVBCSA2Slice<WORD>::SBox1(WORD& o1, WORD& o0, const WORD& x4, const WORD& x3, const WORD& x2, const WORD& x1, const WORD& x0)
+{
+    const WORD x01 = x0 & x1;
+    const WORD x02 = x0 & x2;
+    const WORD x12 = x1 & x2;
+    const WORD x03 = x0 & x3;
+    const WORD x13 = x1 & x3;
+    const WORD x23 = x2 & x3;
+    const WORD x013 = x01 & x3;
+    const WORD x023 = x02 & x3;
+    const WORD x123 = x12 & x3;
+    o0 = x1 ^ x02 ^ x3 ^ x03 ^ x013 ^ (x4 & (x0 ^ x3 ^ x13 ^ x23 ^ x023));
+    o1 = ~(x0 ^ x1 ^ x01 ^ x02 ^ x12 ^ x03 ^ x13 ^ x23 ^ x023 ^ x123) ^ (x4 & ~(x01 ^ x2 ^ x12 ^ x3 ^ x13 ^ x013 ^ x23 ^ x123));
+}
+
+template <typename WORD>
+inline void ts::DVBCSA2Slice<WORD>::SBox2(WORD& o1, WORD& o0, const WORD& x4, const WORD& x3, const WORD& x2, const WORD& x1, const WORD& x0)
+{
+    const WORD x01 = x0 & x1;
+    const WORD x02 = x0 & x2;
+    const WORD x12 = x1 & x2;
+    const WORD x03 = x0 & x3;
+    const WORD x13 = x1 & x3;
+    const WORD x23 = x2 & x3;
+    const WORD x012 = x01 & x2;
+    const WORD x013 = x01 & x3;
+    const WORD x023 = x02 & x3;
+    o0 = ~(x1 ^ x2 ^ x02 ^ x013 ^ x023) ^ (x4 & (x01 ^ x2 ^ x3 ^ x013 ^ x023));
+    o1 = ~(x0 ^ x1 ^ x02 ^ x12 ^ x012 ^ x3) ^ (x4 & (x12 ^ x03 ^ x13 ^ x013 ^ x23));
+}
+
+template <typename WORD>
+inline void ts::DVBCSA2Slice<WORD>::SBox3(WORD& o1, WORD& o0, const WORD& x4, const WORD& x3, const WORD& x2, const WORD& x1, const WORD& x0)
+{
+    const WORD x01 = x0 & x1;
+    const WORD x02 = x0 & x2;
+    const WORD x12 = x1 & x2;
+    const WORD x03 = x0 & x3;
+    const WORD x13 = x1 & x3;
+    const WORD x23 = x2 & x3;
+    const WORD x012 = x01 & x2;
+    const WORD x013 = x01 & x3;
+    const WORD x123 = x12 & x3;
+    o0 = x1 ^ x01 ^ x02 ^ x3 ^ x4;
+    o1 = ~(x0 ^ x1 ^ x02 ^ x12 ^ x012 ^ x3 ^ x03 ^ x13 ^ x013 ^ x23 ^ x123) ^ (x4 & ~(x1 ^ x01 ^ x2 ^ x02 ^ x12 ^ x012 ^ x03 ^ x23 ^ x123));
+}
+
+template <typename WORD>
+inline void ts::DVBCSA2Slice<WORD>::SBox4(WORD& o1, WORD& o0, const WORD& x4, const WORD& x3, const WORD& x2, const WORD& x1, const WORD& x0)
+{
+    const WORD x01 = x0 & x1;
+    const WORD x12 = x1 & x2;
+    const WORD x03 = x0 & x3;
+    const WORD x23 = x2 & x3;
+    const WORD x012 = x01 & x2;
+    const WORD x013 = x01 & x3;
+    const WORD x123 = x12 & x3;
+    o0 = ~(x1 ^ x01 ^ x2 ^ x03 ^ x013 ^ x23) ^ (x4 & (x0 ^ x1 ^ x012 ^ x3 ^ x03 ^ x013 ^ x23 ^ x123));
+    o1 = ~(x0 ^ x01 ^ x2 ^ x012 ^ x3 ^ x123) ^ (x4 & ~(x0 ^ x1 ^ x012 ^ x3 ^ x03 ^ x013 ^ x23 ^ x123));
+}
+
+template <typename WORD>
+inline void ts::DVBCSA2Slice<WORD>::SBox5(WORD& o1, WORD& o0, const WORD& x4, const WORD& x3, const WORD& x2, const WORD& x1, const WORD& x0)
+{
+    const WORD x01 = x0 & x1;
+    const WORD x02 = x0 & x2;
+    const WORD x12 = x1 & x2;
+    const WORD x03 = x0 & x3;
+    const WORD x13 = x1 & x3;
+    const WORD x012 = x01 & x2;
+    const WORD x013 = x01 & x3;
+    const WORD x023 = x02 & x3;
+    const WORD x123 = x12 & x3;
+    o0 = x01 ^ x2 ^ x02 ^ x012 ^ x03 ^ x13 ^ x023 ^ (x4 & (x0 ^ x2 ^ x02 ^ x12 ^ x012 ^ x3 ^ x03 ^ x13 ^ x013));
+    o1 = ~(x0 ^ x1 ^ x01 ^ x02 ^ x12 ^ x012 ^ x3 ^ x03 ^ x013 ^ x023 ^ x123) ^ (x4 & (x0 ^ x1 ^ x2 ^ x12 ^ x012 ^ x03 ^ x13 ^ x023 ^ x123));
+}
+
+template <typename WORD>
+inline void ts::DVBCSA2Slice<WORD>::SBox6(WORD& o1, WORD& o0, const WORD& x4, const WORD& x3, const WORD& x2, const WORD& x1, const WORD& x0)
+{
+    const WORD x01 = x0 & x1;
+    const WORD x02 = x0 & x2;
+    const WORD x12 = x1 & x2;
+    const WORD x03 = x0 & x3;
+    const WORD x13 = x1 & x3;
+    const WORD x23 = x2 & x3;
+    const WORD x012 = x01 & x2;
+    const WORD x013 = x01 & x3;
+    const WORD x023 = x02 & x3;
+    const WORD x123 = x12 & x3;
+    o0 = x0 ^ x2 ^ x12 ^ x012 ^ x13 ^ x23 ^ x123 ^ (x4 & (x01 ^ x12 ^ x012 ^ x013 ^ x123));
+    o1 = x1 ^ x02 ^ x013 ^ x23 ^ x023 ^ (x4 & ~(x01 ^ x03));
+}
+
+template <typename WORD>
+inline void ts::DVBCSA2Slice<WORD>::SBox7(WORD& o1, WORD& o0, const WORD& x4, const WORD& x3, const WORD& x2, const WORD& x1, const WORD& x0)
+{
+    const WORD x01 = x0 & x1;
+    const WORD x12 = x1 & x2;
+    const WORD x13 = x1 & x3;
+    const WORD x23 = x2 & x3;
+    const WORD x012 = x01 & x2;
+    const WORD x013 = x01 & x3;
+    const WORD x123 = x12 & x3;
+    o0 = x0 ^ x01 ^ x2 ^ x12 ^ x012 ^ x3 ^ x23 ^ (x4 & ~(x13 ^ x013));
+    o1 = x0 ^ x1 ^ x01 ^ x2 ^ x3 ^ x013 ^ (x4 & (x0 ^ x01 ^ x2 ^ x12 ^ x012 ^ x013 ^ x123));
+}
@@ -0,0 +1,230 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  AVX2 multi-buffer implementations of the SHA-1 and SHA-256 compression.
+//  This module is compiled with AVX2 code generation on x86 platforms.
+//  It is used only when the CPU supports AVX2 at run time.
+//
+//  Each 32-bit element of a 256-bit register belongs to a different message.
+//  The 8 messages are compressed with exactly the same operations as the
+//  scalar reference implementations.
+//
+//----------------------------------------------------------------------------
+
+#include "tsSHAAVX2.h"
+TSDUCK_SOURCE;
+
+#if defined(TS_GCC) && defined(__AVX2__)
+#include <immintrin.h>
+
+namespace {
+
+    typedef __m256i V;
+
+    inline V Add(V a, V b) { return _mm256_add_epi32(a, b); }
+    inline V Xor(V a, V b) { return _mm256_xor_si256(a, b); }
+    inline V And(V a, V b) { return _mm256_and_si256(a, b); }
+    inline V Or(V a, V b) { return _mm256_or_si256(a, b); }
+    inline V Const(uint32_t x) { return _mm256_set1_epi32(int(x)); }
+    inline V Shr(V x, int n) { return _mm256_srli_epi32(x, n); }
+    inline V Rol(V x, int n) { return _mm256_or_si256(_mm256_slli_epi32(x, n), _mm256_srli_epi32(x, 32 - n)); }
+    inline V Ror(V x, int n) { return _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - n)); }
+
+    // Load the 16 big-endian message words of the 8 blocks: w[i] contains word i of each block.
+    void LoadMessage(V* w, const uint8_t* const* blocks)
+    {
+        const V swap = _mm256_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+                                       12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+        for (size_t half = 0; half < 2; ++half) {
+            V r[8];
+            for (size_t l = 0; l < 8; ++l) {
+                r[l] = _mm256_loadu_si256(reinterpret_cast<const V*>(blocks[l] + 32 * half));
+            }
+            // Transpose the 8x8 matrix of 32-bit words.
+            const V t0 = _mm256_unpacklo_epi32(r[0], r[1]);
+            const V t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+            const V t2 = _mm256_unpacklo_epi32(r[2], r[3]);
+            const V t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+            const V t4 = _mm256_unpacklo_epi32(r[4], r[5]);
+            const V t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+            const V t6 = _mm256_unpacklo_epi32(r[6], r[7]);
+            const V t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+            const V u0 = _mm256_unpacklo_epi64(t0, t2);
+            const V u1 = _mm256_unpackhi_epi64(t0, t2);
+            const V u2 = _mm256_unpacklo_epi64(t1, t3);
+            const V u3 = _mm256_unpackhi_epi64(t1, t3);
+            const V u4 = _mm256_unpacklo_epi64(t4, t6);
+            const V u5 = _mm256_unpackhi_epi64(t4, t6);
+            const V u6 = _mm256_unpacklo_epi64(t5, t7);
+            const V u7 = _mm256_unpackhi_epi64(t5, t7);
+            V* const out = w + 8 * half;
+            out[0] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u0, u4, 0x20), swap);
+            out[1] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u1, u5, 0x20), swap);
+            out[2] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u2, u6, 0x20), swap);
+            out[3] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u3, u7, 0x20), swap);
+            out[4] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u0, u4, 0x31), swap);
+            out[5] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u1, u5, 0x31), swap);
+            out[6] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u2, u6, 0x31), swap);
+            out[7] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u3, u7, 0x31), swap);
+        }
+    }
+
+    #define LOADV(p)     _mm256_loadu_si256(reinterpret_cast<const V*>(p))
+    #define STOREV(p, x) _mm256_storeu_si256(reinterpret_cast<V*>(p), (x))
+
+    //------------------------------------------------------------------------
+    // SHA-256
+    //------------------------------------------------------------------------
+
+    const uint32_t K256[64] = {
+        0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+        0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+        0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+        0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+        0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+        0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+        0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+        0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2,
+    };
+
+    void SHA256Multi(uint32_t* state, const uint8_t* const* blocks)
+    {
+        V w[16];
+        LoadMessage(w, blocks);
+
+        V s[8];
+        for (size_t i = 0; i < 8; ++i) {
+            s[i] = LOADV(state + 8 * i);
+        }
+        V a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+
+        for (size_t i = 0; i < 64; ++i) {
+            if (i >= 16) {
+                // W[i] = Gamma1(W[i-2]) + W[i-7] + Gamma0(W[i-15]) + W[i-16], in a circular buffer.
+                const V w2 = w[(i - 2) & 15];
+                const V w15 = w[(i - 15) & 15];
+                const V gamma1 = Xor(Xor(Ror(w2, 17), Ror(w2, 19)), Shr(w2, 10));
+                const V gamma0 = Xor(Xor(Ror(w15, 7), Ror(w15, 18)), Shr(w15, 3));
+                w[i & 15] = Add(Add(gamma1, w[(i - 7) & 15]), Add(gamma0, w[i & 15]));
+            }
+            const V sigma1 = Xor(Xor(Ror(e, 6), Ror(e, 11)), Ror(e, 25));
+            const V ch = Xor(g, And(e, Xor(f, g)));
+            const V t0 = Add(Add(Add(h, sigma1), Add(ch, Const(K256[i]))), w[i & 15]);
+            const V sigma0 = Xor(Xor(Ror(a, 2), Ror(a, 13)), Ror(a, 22));
+            const V maj = Or(And(a, b), And(c, Or(a, b)));
+            const V t1 = Add(sigma0, maj);
+            h = g; g = f; f = e; e = Add(d, t0);
+            d = c; c = b; b = a; a = Add(t0, t1);
+        }
+
+        STOREV(state + 8 * 0, Add(s[0], a));
+        STOREV(state + 8 * 1, Add(s[1], b));
+        STOREV(state + 8 * 2, Add(s[2], c));
+        STOREV(state + 8 * 3, Add(s[3], d));
+        STOREV(state + 8 * 4, Add(s[4], e));
+        STOREV(state + 8 * 5, Add(s[5], f));
+        STOREV(state + 8 * 6, Add(s[6], g));
+        STOREV(state + 8 * 7, Add(s[7], h));
+    }
+
+    //------------------------------------------------------------------------
+    // SHA-1
+    //------------------------------------------------------------------------
+
+    void SHA1Multi(uint32_t* state, const uint8_t* const* blocks)
+    {
+        V w[16];
+        LoadMessage(w, blocks);
+
+        V s[5];
+        for (size_t i = 0; i < 5; ++i) {
+            s[i] = LOADV(state + 8 * i);
+        }
+        V a = s[0], b = s[1], c = s[2], d = s[3], e = s[4];
+
+        for (size_t i = 0; i < 80; ++i) {
+            if (i >= 16) {
+                // W[i] = ROL(W[i-3] ^ W[i-8] ^ W[i-14] ^ W[i-16], 1), in a circular buffer.
+                w[i & 15] = Rol(Xor(Xor(w[(i - 3) & 15], w[(i - 8) & 15]), Xor(w[(i - 14) & 15], w[i & 15])), 1);
+            }
+            V f, k;
+            if (i < 20) {
+                f = Xor(d, And(b, Xor(c, d)));
+                k = Const(0x5A827999);
+            }
+            else if (i < 40) {
+                f = Xor(Xor(b, c), d);
+                k = Const(0x6ED9EBA1);
+            }
+            else if (i < 60) {
+                f = Or(And(b, c), And(d, Or(b, c)));
+                k = Const(0x8F1BBCDC);
+            }
+            else {
+                f = Xor(Xor(b, c), d);
+                k = Const(0xCA62C1D6);
+            }
+            const V t = Add(Add(Rol(a, 5), f), Add(Add(e, k), w[i & 15]));
+            e = d; d = c; c = Rol(b, 30); b = a; a = t;
+        }
+
+        STOREV(state + 8 * 0, Add(s[0], a));
+        STOREV(state + 8 * 1, Add(s[1], b));
+        STOREV(state + 8 * 2, Add(s[2], c));
+        STOREV(state + 8 * 3, Add(s[3], d));
+        STOREV(state + 8 * 4, Add(s[4], e));
+    }
+
+    #undef LOADV
+    #undef STOREV
+}
+
+ts::SHAMultiCompressFunction ts::SHA1MultiAVX2()
+{
+    return __builtin_cpu_supports("avx2") ? SHA1Multi : 0;
+}
+
+ts::SHAMultiCompressFunction ts::SHA256MultiAVX2()
+{
+    return __builtin_cpu_supports("avx2") ? SHA256Multi : 0;
+}
+
+#else
+
+ts::SHAMultiCompressFunction ts::SHA1MultiAVX2()
+{
+    return 0;
+}
+
+ts::SHAMultiCompressFunction ts::SHA256MultiAVX2()
+{
+    return 0;
+}
+
+#endif
@@ -0,0 +1,66 @@
+//-----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  AVX2 multi-buffer implementations of SHA-1 and SHA-256.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsPlatform.h"
+
+namespace ts {
+    //!
+    //! Number of independent messages which are processed in parallel by a multi-buffer SHA function.
+    //!
+    const size_t SHA_LANES = 8;
+
+    //!
+    //! Profile of a multi-buffer SHA-1 or SHA-256 compression function.
+    //! One 64-byte block is compressed in each of the SHA_LANES independent hash states.
+    //! @param [in,out] state Hash states, interleaved: word @e w of lane @e l is state[w * SHA_LANES + l].
+    //! 5 words per lane for SHA-1, 8 words per lane for SHA-256.
+    //! @param [in] blocks Array of SHA_LANES addresses of 64-byte blocks.
+    //!
+    typedef void (*SHAMultiCompressFunction)(uint32_t* state, const uint8_t* const* blocks);
+
+    //!
+    //! Get the AVX2 multi-buffer implementation of the SHA-1 compression.
+    //! It is compiled in a separate module with specific compilation options.
+    //! @return The AVX2 implementation or zero if not supported by the compiler or the CPU.
+    //!
+    SHAMultiCompressFunction SHA1MultiAVX2();
+
+    //!
+    //! Get the AVX2 multi-buffer implementation of the SHA-256 compression.
+    //! It is compiled in a separate module with specific compilation options.
+    //! @return The AVX2 implementation or zero if not supported by the compiler or the CPU.
+    //!
+    SHAMultiCompressFunction SHA256MultiAVX2();
+}
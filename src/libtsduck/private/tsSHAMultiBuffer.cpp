@@ -0,0 +1,125 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsSHAMultiBuffer.h"
+#include "tsMemoryUtils.h"
+TSDUCK_SOURCE;
+
+namespace {
+    // SHA-1 and SHA-256 block size.
+    const size_t BLOCK_SIZE = 64;
+
+    // Description of the message which is processed in one lane.
+    struct Lane
+    {
+        bool           active;          // A message is currently processed.
+        size_t         index;           // Index of the message in the batch.
+        const uint8_t* data;            // Next complete block in the message.
+        size_t         full_blocks;     // Remaining complete blocks in the message.
+        size_t         tail_blocks;     // Remaining padding blocks in tail.
+        size_t         tail_index;      // Index of next padding block in tail.
+        uint8_t        tail[2 * BLOCK_SIZE];  // Last partial block and padding.
+    };
+}
+
+void ts::SHAMultiBufferHash(SHAMultiCompressFunction compress,
+                            const uint32_t* init,
+                            size_t words,
+                            const void* const* data,
+                            const size_t* sizes,
+                            size_t count,
+                            uint8_t* hashes)
+{
+    Lane lanes[SHA_LANES];
+    uint32_t state[8 * SHA_LANES];
+    const uint8_t* blocks[SHA_LANES];
+    uint8_t idle[BLOCK_SIZE];
+    size_t next = 0;
+    size_t active = 0;
+
+    Zero(idle, sizeof(idle));
+    Zero(state, sizeof(state));
+
+    // Start the next message in a lane, if any.
+    auto start = [&](size_t l) {
+        Lane& lane(lanes[l]);
+        lane.active = next < count;
+        if (lane.active) {
+            const size_t size = sizes[next];
+            const size_t residue = size % BLOCK_SIZE;
+            lane.index = next;
+            lane.data = reinterpret_cast<const uint8_t*>(data[next]);
+            lane.full_blocks = size / BLOCK_SIZE;
+            // Last partial block, '1' bit, zero padding and 64-bit size in bits.
+            lane.tail_blocks = residue < BLOCK_SIZE - 8 ? 1 : 2;
+            lane.tail_index = 0;
+            Zero(lane.tail, sizeof(lane.tail));
+            ::memcpy(lane.tail, lane.data + size - residue, residue);  // Flawfinder: ignore: memcpy()
+            lane.tail[residue] = 0x80;
+            PutUInt64(lane.tail + lane.tail_blocks * BLOCK_SIZE - 8, uint64_t(size) * 8);
+            for (size_t w = 0; w < words; ++w) {
+                state[w * SHA_LANES + l] = init[w];
+            }
+            ++next;
+            ++active;
+        }
+    };
+
+    for (size_t l = 0; l < SHA_LANES; ++l) {
+        start(l);
+    }
+
+    while (active > 0) {
+        // Compress one block in each lane.
+        for (size_t l = 0; l < SHA_LANES; ++l) {
+            const Lane& lane(lanes[l]);
+            blocks[l] = !lane.active ? idle : (lane.full_blocks > 0 ? lane.data : lane.tail + lane.tail_index * BLOCK_SIZE);
+        }
+        compress(state, blocks);
+
+        // Advance in each message. Output completed hashes and start next messages.
+        for (size_t l = 0; l < SHA_LANES; ++l) {
+            Lane& lane(lanes[l]);
+            if (lane.active) {
+                if (lane.full_blocks > 0) {
+                    lane.data += BLOCK_SIZE;
+                    lane.full_blocks--;
+                }
+                else if (++lane.tail_index >= lane.tail_blocks) {
+                    uint8_t* const out = hashes + lane.index * 4 * words;
+                    for (size_t w = 0; w < words; ++w) {
+                        PutUInt32(out + 4 * w, state[w * SHA_LANES + l]);
+                    }
+                    --active;
+                    start(l);
+                }
+            }
+        }
+    }
+}
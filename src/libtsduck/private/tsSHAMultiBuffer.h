@@ -0,0 +1,60 @@
+//-----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Multi-buffer hashing of independent messages with SHA-1 or SHA-256.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsSHAAVX2.h"
+
+namespace ts {
+    //!
+    //! Compute the SHA-1 or SHA-256 hashes of independent messages using a multi-buffer compression function.
+    //!
+    //! Each lane of the compression function processes one message. When a message is
+    //! complete (including the final padding), the next message is started in the same lane.
+    //!
+    //! @param [in] compress Multi-buffer compression function.
+    //! @param [in] init Initial hash state, @a words words.
+    //! @param [in] words Number of 32-bit words in the hash state, which is also the hash size in words.
+    //! @param [in] data Array of @a count message addresses.
+    //! @param [in] sizes Array of @a count message sizes in bytes.
+    //! @param [in] count Number of messages.
+    //! @param [out] hashes Address of @a count hash values, 4 * @a words bytes each.
+    //!
+    void SHAMultiBufferHash(SHAMultiCompressFunction compress,
+                            const uint32_t* init,
+                            size_t words,
+                            const void* const* data,
+                            const size_t* sizes,
+                            size_t count,
+                            uint8_t* hashes);
+}
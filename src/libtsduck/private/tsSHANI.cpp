@@ -0,0 +1,214 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  SHA-NI implementations of the SHA-1 and SHA-256 compression functions.
+//  This module is compiled with SHA, SSE4.1 and SSSE3 code generation on x86
+//  platforms. It is used only when the CPU supports them at run time.
+//
+//  Reference: Intel, "New Instructions Supporting the Secure Hash Algorithm
+//  on Intel Architecture Processors", 2013. The rounds are processed by groups
+//  of 4 rounds, completely unrolled. The four message registers rotate: group g
+//  uses M[g % 4].
+//
+//----------------------------------------------------------------------------
+
+#include "tsSHANI.h"
+TSDUCK_SOURCE;
+
+#if defined(TS_GCC) && defined(__SHA__) && defined(__SSE4_1__) && defined(__SSSE3__)
+#include <immintrin.h>
+#include <cpuid.h>
+
+namespace {
+
+    #define LOAD(p) _mm_loadu_si128(reinterpret_cast<const __m128i*>(p))
+
+    // SHA-256 constants.
+    const uint32_t K256[64] = {
+        0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+        0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+        0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+        0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+        0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+        0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+        0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+        0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2,
+    };
+
+    void SHA256NI(uint32_t* state, const uint8_t* data, size_t count)
+    {
+        // Byte swap of each 32-bit word.
+        const __m128i swap = _mm_set_epi64x(TS_CONST64(0x0C0D0E0F08090A0B), TS_CONST64(0x0405060700010203));
+
+        // The state is reorganized as ABEF and CDGH for the SHA256RNDS2 instruction.
+        __m128i tmp = _mm_shuffle_epi32(LOAD(state), 0xB1);        // CDAB
+        __m128i state1 = _mm_shuffle_epi32(LOAD(state + 4), 0x1B); // EFGH
+        __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);          // ABEF
+        state1 = _mm_blend_epi16(state1, tmp, 0xF0);               // CDGH
+
+        for (; count > 0; --count, data += 64) {
+            const __m128i save0 = state0;
+            const __m128i save1 = state1;
+            __m128i m[4];
+
+            for (int g = 0; g < 16; ++g) {
+                if (g < 4) {
+                    m[g] = _mm_shuffle_epi8(LOAD(data + 16 * g), swap);
+                }
+                __m128i msg = _mm_add_epi32(m[g & 3], LOAD(K256 + 4 * g));
+                state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+                if (g >= 3 && g <= 14) {
+                    // Complete the next message words.
+                    tmp = _mm_alignr_epi8(m[g & 3], m[(g - 1) & 3], 4);
+                    m[(g + 1) & 3] = _mm_sha256msg2_epu32(_mm_add_epi32(m[(g + 1) & 3], tmp), m[g & 3]);
+                }
+                msg = _mm_shuffle_epi32(msg, 0x0E);
+                state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+                if (g >= 1 && g <= 12) {
+                    // Start the message words of group g+3.
+                    m[(g - 1) & 3] = _mm_sha256msg1_epu32(m[(g - 1) & 3], m[g & 3]);
+                }
+            }
+
+            state0 = _mm_add_epi32(state0, save0);
+            state1 = _mm_add_epi32(state1, save1);
+        }
+
+        // Back to ABCD and EFGH.
+        tmp = _mm_shuffle_epi32(state0, 0x1B);              // FEBA
+        state1 = _mm_shuffle_epi32(state1, 0xB1);           // DCHG
+        state0 = _mm_blend_epi16(tmp, state1, 0xF0);        // DCBA
+        state1 = _mm_alignr_epi8(state1, tmp, 8);           // HGFE
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(state), state0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), state1);
+    }
+
+    // One group of 4 SHA-1 rounds. The group index is a template parameter so that
+    // all conditions are resolved at compile time and the round function selector
+    // of SHA1RNDS4 is an immediate value. The E values alternate between two registers.
+    template <int G>
+    inline void SHA1Group(__m128i& abcd, __m128i& ecur, __m128i& enext, __m128i* m)
+    {
+        ecur = G == 0 ? _mm_add_epi32(ecur, m[0]) : _mm_sha1nexte_epu32(ecur, m[G & 3]);
+        enext = abcd;
+        if (G >= 3 && G <= 18) {
+            m[(G + 1) & 3] = _mm_sha1msg2_epu32(m[(G + 1) & 3], m[G & 3]);
+        }
+        abcd = _mm_sha1rnds4_epu32(abcd, ecur, G / 5);
+        if (G >= 1 && G <= 16) {
+            m[(G - 1) & 3] = _mm_sha1msg1_epu32(m[(G - 1) & 3], m[G & 3]);
+        }
+        if (G >= 2 && G <= 17) {
+            m[(G - 2) & 3] = _mm_xor_si128(m[(G - 2) & 3], m[G & 3]);
+        }
+    }
+
+    void SHA1NI(uint32_t* state, const uint8_t* data, size_t count)
+    {
+        // Byte swap of the complete 128-bit register, the first word becomes the most significant one.
+        const __m128i swap = _mm_set_epi64x(TS_CONST64(0x0001020304050607), TS_CONST64(0x08090A0B0C0D0E0F));
+
+        __m128i abcd = _mm_shuffle_epi32(LOAD(state), 0x1B);
+        __m128i e0 = _mm_set_epi32(int(state[4]), 0, 0, 0);
+        __m128i e1;
+
+        for (; count > 0; --count, data += 64) {
+            const __m128i save_abcd = abcd;
+            const __m128i save_e = e0;
+            __m128i m[4];
+            for (int i = 0; i < 4; ++i) {
+                m[i] = _mm_shuffle_epi8(LOAD(data + 16 * i), swap);
+            }
+
+            SHA1Group<0>(abcd, e0, e1, m);
+            SHA1Group<1>(abcd, e1, e0, m);
+            SHA1Group<2>(abcd, e0, e1, m);
+            SHA1Group<3>(abcd, e1, e0, m);
+            SHA1Group<4>(abcd, e0, e1, m);
+            SHA1Group<5>(abcd, e1, e0, m);
+            SHA1Group<6>(abcd, e0, e1, m);
+            SHA1Group<7>(abcd, e1, e0, m);
+            SHA1Group<8>(abcd, e0, e1, m);
+            SHA1Group<9>(abcd, e1, e0, m);
+            SHA1Group<10>(abcd, e0, e1, m);
+            SHA1Group<11>(abcd, e1, e0, m);
+            SHA1Group<12>(abcd, e0, e1, m);
+            SHA1Group<13>(abcd, e1, e0, m);
+            SHA1Group<14>(abcd, e0, e1, m);
+            SHA1Group<15>(abcd, e1, e0, m);
+            SHA1Group<16>(abcd, e0, e1, m);
+            SHA1Group<17>(abcd, e1, e0, m);
+            SHA1Group<18>(abcd, e0, e1, m);
+            SHA1Group<19>(abcd, e1, e0, m);
+
+            // After the last group, e0 contains the initial ABCD of the last group.
+            e0 = _mm_sha1nexte_epu32(e0, save_e);
+            abcd = _mm_add_epi32(abcd, save_abcd);
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_shuffle_epi32(abcd, 0x1B));
+        state[4] = uint32_t(_mm_extract_epi32(e0, 3));
+    }
+
+    #undef LOAD
+
+    bool SupportedNI()
+    {
+        // Older GCC versions do not know the "sha" feature, check CPUID leaf 7, EBX bit 29.
+        unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+        if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+            return false;
+        }
+        return (ebx & (1 << 29)) != 0 && __builtin_cpu_supports("sse4.1") && __builtin_cpu_supports("ssse3");
+    }
+}
+
+ts::SHACompressFunction ts::SHA1CompressNI()
+{
+    return SupportedNI() ? SHA1NI : 0;
+}
+
+ts::SHACompressFunction ts::SHA256CompressNI()
+{
+    return SupportedNI() ? SHA256NI : 0;
+}
+
+#else
+
+ts::SHACompressFunction ts::SHA1CompressNI()
+{
+    return 0;
+}
+
+ts::SHACompressFunction ts::SHA256CompressNI()
+{
+    return 0;
+}
+
+#endif
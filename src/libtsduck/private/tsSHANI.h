@@ -0,0 +1,60 @@
+//-----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  SHA-NI implementations of SHA-1 and SHA-256, used by ts::SHA1 and ts::SHA256.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsPlatform.h"
+
+namespace ts {
+    //!
+    //! Profile of a SHA-1 or SHA-256 compression function on consecutive blocks.
+    //! @param [in,out] state Hash state, 5 words for SHA-1, 8 words for SHA-256.
+    //! @param [in] data Address of message blocks.
+    //! @param [in] count Number of 64-byte blocks to compress.
+    //!
+    typedef void (*SHACompressFunction)(uint32_t* state, const uint8_t* data, size_t count);
+
+    //!
+    //! Get the SHA-NI implementation of the SHA-1 compression.
+    //! It is compiled in a separate module with specific compilation options.
+    //! @return The SHA-NI implementation or zero if not supported by the compiler or the CPU.
+    //!
+    SHACompressFunction SHA1CompressNI();
+
+    //!
+    //! Get the SHA-NI implementation of the SHA-256 compression.
+    //! It is compiled in a separate module with specific compilation options.
+    //! @return The SHA-NI implementation or zero if not supported by the compiler or the CPU.
+    //!
+    SHACompressFunction SHA256CompressNI();
+}
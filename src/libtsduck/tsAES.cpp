@@ -14,6 +14,7 @@
 //----------------------------------------------------------------------------
 
 #include "tsAES.h"
+#include "tsAESNI.h"
 TSDUCK_SOURCE;
 
 #define BYTE(x,n) (((x) >> (8 * (n))) & 255)
@@ -1012,6 +1013,49 @@ namespace {
 }
 
 
+//----------------------------------------------------------------------------
+// Implementations of the AES computation.
+//----------------------------------------------------------------------------
+
+namespace {
+    // AES-NI functions, zero if not supported.
+    const ts::AESBlocksFunction encrypt_ni = ts::AESEncryptNI();
+    const ts::AESBlocksFunction decrypt_ni = ts::AESDecryptNI();
+
+    // Current implementation. Before static initialization of this module (from other
+    // static initializers), this variable is zero, meaning TABLES, which is always safe.
+    ts::AES::Implementation current_impl = encrypt_ni != 0 && decrypt_ni != 0 ? ts::AES::AESNI : ts::AES::TABLES;
+}
+
+bool ts::AES::IsSupported(Implementation impl)
+{
+    switch (impl) {
+        case TABLES:
+            return true;
+        case AESNI:
+            return encrypt_ni != 0 && decrypt_ni != 0;
+        default:
+            return false;
+    }
+}
+
+ts::AES::Implementation ts::AES::GetImplementation()
+{
+    return current_impl;
+}
+
+bool ts::AES::SetImplementation(Implementation impl)
+{
+    if (IsSupported(impl)) {
+        current_impl = impl;
+        return true;
+    }
+    else {
+        return false;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Schedule a new key. If rounds is zero, the default is used.
 // Return true on success, false on error.
@@ -1165,6 +1209,12 @@ bool ts::AES::setKey(const void* key_, size_t key_length, size_t rounds)
     *rk++ = *rrk++;
     *rk   = *rrk;
 
+    // Same keys in data byte order for AES-NI.
+    for (i = 0; i < 4 * (_Nr + 1); ++i) {
+        PutUInt32(_eKB + 4 * i, _eK[i]);
+        PutUInt32(_dKB + 4 * i, _dK[i]);
+    }
+
     return true;
 }
 
@@ -1182,6 +1232,14 @@ bool ts::AES::encrypt(const void* plain, size_t plain_length,
         return false;
     }
 
+    if (current_impl == AESNI) {
+        encrypt_ni(_eKB, _Nr, reinterpret_cast<const uint8_t*>(plain), reinterpret_cast<uint8_t*>(cipher), 1);
+        if (cipher_length != 0) {
+            *cipher_length = BLOCK_SIZE;
+        }
+        return true;
+    }
+
     const uint8_t* pt = reinterpret_cast<const uint8_t*> (plain);
     uint8_t* ct = reinterpret_cast<uint8_t*> (cipher);
 
@@ -1310,6 +1368,14 @@ bool ts::AES::decrypt(const void* cipher, size_t cipher_length,
         return false;
     }
 
+    if (current_impl == AESNI) {
+        decrypt_ni(_dKB, _Nr, reinterpret_cast<const uint8_t*>(cipher), reinterpret_cast<uint8_t*>(plain), 1);
+        if (plain_length != 0) {
+            *plain_length = BLOCK_SIZE;
+        }
+        return true;
+    }
+
     const uint8_t* ct = reinterpret_cast<const uint8_t*> (cipher);
     uint8_t* pt = reinterpret_cast<uint8_t*> (plain);
 
@@ -1426,6 +1492,34 @@ bool ts::AES::decrypt(const void* cipher, size_t cipher_length,
 }
 
 
+//----------------------------------------------------------------------------
+// Encryption / decryption of independent blocks.
+// With AES-NI, several blocks are processed in flight.
+//----------------------------------------------------------------------------
+
+bool ts::AES::encryptBlocks(const void* plain, void* cipher, size_t count)
+{
+    if (current_impl == AESNI) {
+        encrypt_ni(_eKB, _Nr, reinterpret_cast<const uint8_t*>(plain), reinterpret_cast<uint8_t*>(cipher), count);
+        return true;
+    }
+    else {
+        return BlockCipher::encryptBlocks(plain, cipher, count);
+    }
+}
+
+bool ts::AES::decryptBlocks(const void* cipher, void* plain, size_t count)
+{
+    if (current_impl == AESNI) {
+        decrypt_ni(_dKB, _Nr, reinterpret_cast<const uint8_t*>(cipher), reinterpret_cast<uint8_t*>(plain), count);
+        return true;
+    }
+    else {
+        return BlockCipher::decryptBlocks(cipher, plain, count);
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Constructor
 //----------------------------------------------------------------------------
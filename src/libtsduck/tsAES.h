@@ -68,10 +68,45 @@ namespace ts {
         virtual bool decrypt(const void* cipher, size_t cipher_length,
                              void* plain, size_t plain_maxsize,
                              size_t* plain_length = 0) override;
+        virtual bool encryptBlocks(const void* plain, void* cipher, size_t count) override;
+        virtual bool decryptBlocks(const void* cipher, void* plain, size_t count) override;
+
+        //!
+        //! Implementations of the AES computation.
+        //! The fastest implementation which is supported by the CPU is selected at startup.
+        //!
+        enum Implementation {
+            TABLES,   //!< Portable lookup tables, the reference implementation.
+            AESNI     //!< AES-NI instructions on x86 CPU's, several blocks in flight.
+        };
+
+        //!
+        //! Check if an implementation of AES is supported on this system.
+        //! @param [in] impl The implementation to check.
+        //! @return True if @a impl is supported.
+        //!
+        static bool IsSupported(Implementation impl);
+
+        //!
+        //! Get the current implementation of AES.
+        //! @return The current implementation.
+        //!
+        static Implementation GetImplementation();
+
+        //!
+        //! Select the implementation of AES.
+        //! This is a global setting which is typically used for tests and benchmarks.
+        //! It shall not be changed while AES computations are performed in other threads.
+        //! @param [in] impl The implementation to use.
+        //! @return True on success, false if @a impl is not supported (unchanged implementation).
+        //!
+        static bool SetImplementation(Implementation impl);
 
     private:
         int      _Nr;     //!< Number of rounds
         uint32_t _eK[60]; //!< Scheduled encryption keys
         uint32_t _dK[60]; //!< Scheduled decryption keys
+        uint8_t  _eKB[16 * (MAX_ROUNDS + 1)]; //!< Encryption keys in data byte order, for AES-NI.
+        uint8_t  _dKB[16 * (MAX_ROUNDS + 1)]; //!< Decryption keys in data byte order, for AES-NI.
     };
 }
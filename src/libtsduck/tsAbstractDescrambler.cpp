@@ -60,7 +60,8 @@ ts::AbstractDescrambler::AbstractDescrambler(TSP*           tsp_,
     _mutex(),
     _ecm_to_do(),
     _ecm_thread(this),
-    _stop_thread(false)
+    _stop_thread(false),
+    _batch_pkts()
 {
     option(u"",             0,  STRING, 0, 1);
     option(u"pid",         'p', PIDVAL, 0, UNLIMITED_COUNT);
@@ -146,6 +147,9 @@ bool ts::AbstractDescrambler::start()
     if (!_scrambling.loadArgs(*this)) {
         return false;
     }
+    if (_scrambling.batchEnabled()) {
+        tsp->verbose(u"DVB-CSA2 batch implementation: %s", {DVBCSA2::BatchEngineName()});
+    }
 
     // Descramble either a service or a list of PID's, not a mixture of them.
     if ((_use_service + _pids.any()) != 1) {
@@ -309,7 +313,7 @@ void ts::AbstractDescrambler::analyzeDescriptors(const DescriptorList& dlist, st
 void ts::AbstractDescrambler::handleSection(SectionDemux& demux, const Section& sect)
 {
     const PID ecm_pid = sect.sourcePID();
-    tsp->log(2, u"got ECM (TID 0x%X) on PID %d (0x%X)", {sect.tableId(), ecm_pid, ecm_pid});
+    TS_LOG(*tsp, 2, u"got ECM (TID 0x%X) on PID %d (0x%X)", {sect.tableId(), ecm_pid, ecm_pid});
 
     // Get ECM stream context
     ECMStreamMap::iterator ecm_it = _ecm_streams.find(ecm_pid);
@@ -329,7 +333,7 @@ void ts::AbstractDescrambler::handleSection(SectionDemux& demux, const Section&
 
     // Check if the ECM can be deciphered (ask subclass)
     if (!checkECM(sect)) {
-        tsp->log(2, u"ECM not handled by subclass");
+        TS_LOG(*tsp, 2, u"ECM not handled by subclass");
         return;
     }
     tsp->debug(u"new ECM (TID 0x%X) on PID %d (0x%X)", {sect.tableId(), ecm_pid, ecm_pid});
@@ -375,11 +379,11 @@ void ts::AbstractDescrambler::processECM(ECMStream& estream)
 
     // Here, we have an ECM to decipher.
     const size_t dumpSize = std::min<size_t>(8, ecm.payloadSize());
-    tsp->debug(u"packet %d, decipher ECM, %d bytes: %s%s", {
-               _packet_count - 1,
-               ecm.payloadSize(),
-               UString::Dump(ecm.payload(), dumpSize, UString::SINGLE_LINE),
-               dumpSize < ecm.payloadSize() ? u" ..." : u""});
+    TS_DEBUG(*tsp, u"packet %d, decipher ECM, %d bytes: %s%s", {
+             _packet_count - 1,
+             ecm.payloadSize(),
+             UString::Dump(ecm.payload(), dumpSize, UString::SINGLE_LINE),
+             dumpSize < ecm.payloadSize() ? u" ..." : u""});
 
     // Submit the ECM to the CAS (subclass)
     ByteBlock cw_even;
@@ -387,8 +391,8 @@ void ts::AbstractDescrambler::processECM(ECMStream& estream)
     bool ok = decipherECM(ecm, cw_even, cw_odd);
 
     if (ok) {
-        tsp->debug(u"even CW: %s", {UString::Dump(cw_even, UString::SINGLE_LINE)});
-        tsp->debug(u"odd CW:  %s", {UString::Dump(cw_odd, UString::SINGLE_LINE)});
+        TS_DEBUG(*tsp, u"even CW: %s", {UString::Dump(cw_even, UString::SINGLE_LINE)});
+        TS_DEBUG(*tsp, u"odd CW:  %s", {UString::Dump(cw_odd, UString::SINGLE_LINE)});
     }
 
     // In asynchronous mode, relock the mutex.
@@ -567,3 +571,48 @@ ts::ProcessorPlugin::Status ts::AbstractDescrambler::processPacket(TSPacket& pkt
     // Descramble the packet payload.
     return pecm->scrambling.decrypt(pkt) ? TSP_OK : TSP_END;
 }
+
+
+//----------------------------------------------------------------------------
+// Packet batch processing method
+//----------------------------------------------------------------------------
+
+size_t ts::AbstractDescrambler::processPacketBatch(TSPacket* pkt, Status* status, size_t count, bool& flush, bool& bitrate_changed)
+{
+    // With ECM's, each scrambled stream may use distinct control words, process packets one by one.
+    if (_need_ecm) {
+        return ProcessorPlugin::processPacketBatch(pkt, status, count, flush, bitrate_changed);
+    }
+
+    // With fixed control words, collect the packets to descramble and descramble them together.
+    _batch_pkts.clear();
+    size_t done = 0;
+    while (done < count) {
+        TSPacket& p(pkt[done]);
+        _packet_count++;
+        if (_pids.any()) {
+            if (_pids.test(p.getPID())) {
+                _batch_pkts.push_back(&p);
+            }
+        }
+        else {
+            // Filter sections to locate the service.
+            _service.feedPacket(p);
+            _demux.feedPacket(p);
+            if (_abort || _service.nonExistentService()) {
+                status[done++] = TSP_END;
+                break;
+            }
+            const uint8_t scv = p.getScrambling();
+            if (p.hasPayload() && (scv == SC_EVEN_KEY || scv == SC_ODD_KEY)) {
+                _batch_pkts.push_back(&p);
+            }
+        }
+        status[done++] = TSP_OK;
+    }
+
+    if (!_batch_pkts.empty() && !_scrambling.decrypt(&_batch_pkts[0], _batch_pkts.size())) {
+        status[done - 1] = TSP_END;
+    }
+    return done;
+}
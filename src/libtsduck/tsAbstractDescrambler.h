@@ -61,6 +61,7 @@ namespace ts {
         virtual bool stop() override;
         virtual BitRate getBitrate() override {return 0;}
         virtual Status processPacket(TSPacket&, bool&, bool&) override;
+        virtual size_t processPacketBatch(TSPacket*, Status*, size_t, bool&, bool&) override;
 
     protected:
         //!
@@ -264,6 +265,7 @@ namespace ts {
         // -- start of protected area --
         bool               _stop_thread;       // Terminate ECM processing thread
         // -- end of protected area --
+        std::vector<TSPacket*> _batch_pkts;    // Packets to descramble at end of batch.
 
         // Inaccessible operations.
         AbstractDescrambler() = delete;
@@ -54,3 +54,35 @@ bool ts::BlockCipher::decryptInPlace(void* data, size_t data_length, size_t* max
     const size_t plain_max_size = max_actual_length != 0 ? *max_actual_length : data_length;
     return decrypt(cipher.data(), cipher.size(), data, plain_max_size, max_actual_length);
 }
+
+
+//----------------------------------------------------------------------------
+// Encrypt / decrypt a sequence of independent blocks.
+// Default implementation, one block at a time.
+//----------------------------------------------------------------------------
+
+bool ts::BlockCipher::encryptBlocks(const void* plain, void* cipher, size_t count)
+{
+    const size_t bsize = blockSize();
+    const uint8_t* pt = reinterpret_cast<const uint8_t*>(plain);
+    uint8_t* ct = reinterpret_cast<uint8_t*>(cipher);
+    for (; count > 0; --count, pt += bsize, ct += bsize) {
+        if (!encrypt(pt, bsize, ct, bsize)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ts::BlockCipher::decryptBlocks(const void* cipher, void* plain, size_t count)
+{
+    const size_t bsize = blockSize();
+    const uint8_t* ct = reinterpret_cast<const uint8_t*>(cipher);
+    uint8_t* pt = reinterpret_cast<uint8_t*>(plain);
+    for (; count > 0; --count, ct += bsize, pt += bsize) {
+        if (!decrypt(ct, bsize, pt, bsize)) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -177,6 +177,40 @@ namespace ts {
         //!
         virtual bool decryptInPlace(void* data, size_t data_length, size_t* max_actual_length = 0);
 
+        //!
+        //! Encrypt a sequence of independent blocks of data.
+        //!
+        //! This is the multi-block interface which is used by cipher chainings.
+        //! Each block is encrypted independently, as in ECB mode. A block cipher
+        //! which is able to process several blocks in parallel (AES-NI for instance)
+        //! should override this method. The default implementation calls encrypt()
+        //! on each block.
+        //!
+        //! @param [in] plain Address of plain text, @a count blocks of blockSize() bytes.
+        //! @param [out] cipher Address of buffer for cipher text, @a count blocks of blockSize() bytes.
+        //! The @a plain and @a cipher areas may be identical but shall not partially overlap.
+        //! @param [in] count Number of blocks to encrypt.
+        //! @return True on success, false on error.
+        //!
+        virtual bool encryptBlocks(const void* plain, void* cipher, size_t count);
+
+        //!
+        //! Decrypt a sequence of independent blocks of data.
+        //!
+        //! This is the multi-block interface which is used by cipher chainings.
+        //! Each block is decrypted independently, as in ECB mode. A block cipher
+        //! which is able to process several blocks in parallel (AES-NI for instance)
+        //! should override this method. The default implementation calls decrypt()
+        //! on each block.
+        //!
+        //! @param [in] cipher Address of cipher text, @a count blocks of blockSize() bytes.
+        //! @param [out] plain Address of buffer for plain text, @a count blocks of blockSize() bytes.
+        //! The @a plain and @a cipher areas may be identical but shall not partially overlap.
+        //! @param [in] count Number of blocks to decrypt.
+        //! @return True on success, false on error.
+        //!
+        virtual bool decryptBlocks(const void* cipher, void* plain, size_t count);
+
         //!
         //! Virtual destructor.
         //!
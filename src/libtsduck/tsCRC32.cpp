@@ -32,6 +32,7 @@
 //----------------------------------------------------------------------------
 
 #include "tsCRC32.h"
+#include "tsCRC32PCLMUL.h"
 TSDUCK_SOURCE;
 
 
@@ -109,13 +110,135 @@ namespace {
     };
 }
 
+//----------------------------------------------------------------------------
+// Implementations of the CRC32 computation.
+//----------------------------------------------------------------------------
+
+namespace {
+    // Minimum data size to use PCLMULQDQ, the folding needs four 16-byte blocks.
+    const size_t PCLMULQDQ_MIN_SIZE = 64;
+
+    // Slicing-by-8 tables. The first one is fcstab_32. Entry n of table k is the CRC32
+    // of byte value n, followed by k zero bytes, starting from a zero initial value.
+    class SliceTables
+    {
+    public:
+        uint32_t tab[8][256];
+        SliceTables();
+    };
+
+    SliceTables::SliceTables()
+    {
+        for (size_t n = 0; n < 256; ++n) {
+            tab[0][n] = fcstab_32[n];
+        }
+        for (size_t k = 1; k < 8; ++k) {
+            for (size_t n = 0; n < 256; ++n) {
+                tab[k][n] = (tab[k-1][n] << 8) ^ fcstab_32[tab[k-1][n] >> 24];
+            }
+        }
+    }
+
+    const SliceTables slice_tables;
+
+    // PCLMULQDQ folding function, zero if not supported.
+    const ts::CRC32FoldFunction fold_pclmul = ts::CRC32FoldPCLMUL();
+
+    // Current implementation. Before static initialization of this module (from other
+    // static initializers), this variable is zero, meaning BYTEWISE, which is always safe.
+    ts::CRC32::Implementation current_impl = fold_pclmul != 0 ? ts::CRC32::PCLMULQDQ : ts::CRC32::SLICING_BY_8;
+
+    // Byte-at-a-time computation.
+    inline uint32_t AddBytewise(uint32_t fcs, const uint8_t* cp, size_t size)
+    {
+        while (size-- > 0) {
+            fcs = (fcs << 8) ^ fcstab_32[((fcs >> 24) ^ (*cp++)) & 0xFF];
+        }
+        return fcs;
+    }
+
+    // Slicing-by-8 computation.
+    uint32_t AddSliced(uint32_t fcs, const uint8_t* cp, size_t size)
+    {
+        const uint32_t (*tab)[256] = slice_tables.tab;
+        while (size >= 8) {
+            const uint32_t a = fcs ^ ts::GetUInt32BE(cp);
+            const uint32_t b = ts::GetUInt32BE(cp + 4);
+            fcs = tab[7][a >> 24] ^ tab[6][(a >> 16) & 0xFF] ^ tab[5][(a >> 8) & 0xFF] ^ tab[4][a & 0xFF] ^
+                  tab[3][b >> 24] ^ tab[2][(b >> 16) & 0xFF] ^ tab[1][(b >> 8) & 0xFF] ^ tab[0][b & 0xFF];
+            cp += 8;
+            size -= 8;
+        }
+        return AddBytewise(fcs, cp, size);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Select the implementation of the CRC32 computation.
+//----------------------------------------------------------------------------
+
+bool ts::CRC32::IsSupported(Implementation impl)
+{
+    switch (impl) {
+        case BYTEWISE:
+        case SLICING_BY_8:
+            return true;
+        case PCLMULQDQ:
+            return fold_pclmul != 0;
+        default:
+            return false;
+    }
+}
+
+ts::CRC32::Implementation ts::CRC32::GetImplementation()
+{
+    return current_impl;
+}
+
+bool ts::CRC32::SetImplementation(Implementation impl)
+{
+    if (IsSupported(impl)) {
+        current_impl = impl;
+        return true;
+    }
+    else {
+        return false;
+    }
+}
+
+
+//----------------------------------------------------------------------------
 // Continue the computation of a data area, following a previous CRC32
+//----------------------------------------------------------------------------
 
-void ts::CRC32::add (const void* data, size_t size)
+void ts::CRC32::add(const void* data, size_t size)
 {
-    const uint8_t* cp = static_cast <const uint8_t*> (data);
+    const uint8_t* cp = static_cast<const uint8_t*>(data);
 
-    while (size-- > 0) {
-        _fcs = (_fcs << 8) ^ fcstab_32 [((_fcs >> 24) ^ (*cp++)) & 0xFF];
+    switch (current_impl) {
+        case PCLMULQDQ: {
+            if (size >= PCLMULQDQ_MIN_SIZE) {
+                // Fold all complete 16-byte blocks into a 16-byte residue, then compute the
+                // CRC32 of the residue and the remaining bytes from a zero initial value.
+                const size_t fold_size = size & ~size_t(15);
+                uint8_t residue[16];
+                fold_pclmul(_fcs, cp, fold_size, residue);
+                _fcs = AddSliced(AddSliced(0, residue, sizeof(residue)), cp + fold_size, size - fold_size);
+                break;
+            }
+            // Small data area, use slicing-by-8.
+            _fcs = AddSliced(_fcs, cp, size);
+            break;
+        }
+        case SLICING_BY_8: {
+            _fcs = AddSliced(_fcs, cp, size);
+            break;
+        }
+        case BYTEWISE:
+        default: {
+            _fcs = AddBytewise(_fcs, cp, size);
+            break;
+        }
     }
 }
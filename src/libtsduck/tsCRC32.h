@@ -132,6 +132,38 @@ namespace ts {
             _fcs = 0xFFFFFFFF;
         }
 
+        //!
+        //! Implementations of the CRC32 computation.
+        //! The fastest implementation which is supported by the CPU is selected at startup.
+        //!
+        enum Implementation {
+            BYTEWISE,       //!< Byte-at-a-time lookup table, the reference implementation.
+            SLICING_BY_8,   //!< Slicing-by-8 lookup tables, 8 bytes at a time.
+            PCLMULQDQ       //!< Carry-less multiplication folding on x86 CPU's with PCLMULQDQ.
+        };
+
+        //!
+        //! Check if an implementation of the CRC32 computation is supported on this system.
+        //! @param [in] impl The implementation to check.
+        //! @return True if @a impl is supported.
+        //!
+        static bool IsSupported(Implementation impl);
+
+        //!
+        //! Get the current implementation of the CRC32 computation.
+        //! @return The current implementation.
+        //!
+        static Implementation GetImplementation();
+
+        //!
+        //! Select the implementation of the CRC32 computation.
+        //! This is a global setting which is typically used for tests and benchmarks.
+        //! It shall not be changed while CRC32 are computed in other threads.
+        //! @param [in] impl The implementation to use.
+        //! @return True on success, false if @a impl is not supported (unchanged implementation).
+        //!
+        static bool SetImplementation(Implementation impl);
+
         //!
         //! What to do with a CRC32.
         //! Used when building MPEG sections.
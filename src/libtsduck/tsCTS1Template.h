@@ -148,22 +148,16 @@ bool ts::CTS1<CIPHER>::decrypt (const void* cipher, size_t cipher_length,
     const uint8_t* ct = reinterpret_cast<const uint8_t*> (cipher);
     uint8_t* pt = reinterpret_cast<uint8_t*> (plain);
 
-    while (cipher_length > 2 * this->block_size) {
-        // work = decrypt (cipher-text)
-        if (!this->algo->decrypt(ct, this->block_size, this->work.data(), this->block_size)) {
-            return false;
-        }
-        // plain-text = previous-cipher XOR work
-        for (size_t i = 0; i < this->block_size; ++i) {
-            pt[i] = previous[i] ^ this->work[i];
-        }
-        // previous-cipher = cipher-text
-        previous = ct;
-        // advance one block
-        ct += this->block_size;
-        pt += this->block_size;
-        cipher_length -= this->block_size;
+    const size_t count = (cipher_length - this->block_size - 1) / this->block_size;
+    if (!this->decryptBlocksCBC(previous, ct, pt, count)) {
+        return false;
+    }
+    if (count > 0) {
+        previous = ct + (count - 1) * this->block_size;
     }
+    ct += count * this->block_size;
+    pt += count * this->block_size;
+    cipher_length -= count * this->block_size;
 
     // Process final two blocks.
     // The remaining size is exactly one complete block plus a partial one.
@@ -62,14 +62,13 @@ bool ts::CTS4<CIPHER>::encrypt(const void* plain, size_t plain_length,
 
     // Process in ECB mode, except the last 2 blocks
 
-    while (plain_length > 2 * this->block_size) {
-        if (!this->algo->encrypt(pt, this->block_size, ct, this->block_size)) {
-            return false;
-        }
-        ct += this->block_size;
-        pt += this->block_size;
-        plain_length -= this->block_size;
+    const size_t count = (plain_length - this->block_size - 1) / this->block_size;
+    if (!this->algo->encryptBlocks(pt, ct, count)) {
+        return false;
     }
+    ct += count * this->block_size;
+    pt += count * this->block_size;
+    plain_length -= count * this->block_size;
 
     // Process final two blocks.
 
@@ -122,14 +121,13 @@ bool ts::CTS4<CIPHER>::decrypt (const void* cipher, size_t cipher_length,
 
     // Process in ECB mode, except the last block
 
-    while (cipher_length > this->block_size) {
-        if (!this->algo->decrypt(ct, this->block_size, pt, this->block_size)) {
-            return false;
-        }
-        ct += this->block_size;
-        pt += this->block_size;
-        cipher_length -= this->block_size;
+    const size_t count = (cipher_length - 1) / this->block_size;
+    if (!this->algo->decryptBlocks(ct, pt, count)) {
+        return false;
     }
+    ct += count * this->block_size;
+    pt += count * this->block_size;
+    cipher_length -= count * this->block_size;
 
     // Process final block
 
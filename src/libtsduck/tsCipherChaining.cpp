@@ -46,6 +46,30 @@ ts::CipherChaining::CipherChaining (BlockCipher* cipher, size_t iv_min_blocks, s
 }
 
 
+//----------------------------------------------------------------------------
+// Decrypt a sequence of complete blocks in CBC mode.
+//----------------------------------------------------------------------------
+
+bool ts::CipherChaining::decryptBlocksCBC(const uint8_t* previous, const uint8_t* cipher, uint8_t* plain, size_t count)
+{
+    // plain-text = decrypt (cipher-text), all blocks at once.
+    if (algo == 0 || (count > 0 && !algo->decryptBlocks(cipher, plain, count))) {
+        return false;
+    }
+
+    // plain-text = previous-cipher XOR plain-text
+    for (size_t b = 0; b < count; ++b) {
+        for (size_t i = 0; i < block_size; ++i) {
+            plain[i] ^= previous[i];
+        }
+        previous = cipher;
+        cipher += block_size;
+        plain += block_size;
+    }
+    return true;
+}
+
+
 //----------------------------------------------------------------------------
 // Implementation of BlockCipher interface:
 //----------------------------------------------------------------------------
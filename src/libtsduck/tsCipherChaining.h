@@ -112,6 +112,18 @@ namespace ts {
                        size_t iv_max_blocks = 1,
                        size_t work_blocks = 1);
 
+        //!
+        //! Decrypt a sequence of complete blocks in CBC mode.
+        //! All blocks are first decrypted in one call to the multi-block interface of
+        //! the block cipher, then XOR'ed with the previous cipher block.
+        //! @param [in] previous Address of the cipher block (or IV) which precedes the first block.
+        //! @param [in] cipher Address of cipher text, @a count blocks.
+        //! @param [out] plain Address of plain text, @a count blocks. Must not overlap @a cipher.
+        //! @param [in] count Number of blocks to decrypt.
+        //! @return True on success, false on error.
+        //!
+        bool decryptBlocksCBC(const uint8_t* previous, const uint8_t* cipher, uint8_t* plain, size_t count);
+
     private:
         // Inaccesible operations
         CipherChaining(const CipherChaining&) = delete;
@@ -168,21 +168,10 @@ void ts::CyclingPacketizer::removeSections(SectionDescList& list, TID tid, uint1
 {
     SectionDescList::iterator it(list.begin());
     while (it != list.end()) {
-        const SectionDescPtr& sp(*it);
-        const Section& sect(*sp->section);
+        const Section& sect(*(*it)->section);
         if (sect.tableId() == tid && (!use_tid_ext || sect.tableIdExtension() == tid_ext)) {
             // Section match, remove it
-            assert(_section_count > 0);
-            _section_count--;
-            if (sp->last_cycle != _current_cycle) {
-                assert(_remain_in_cycle > 0);
-                _remain_in_cycle--;
-            }
-            if (scheduled) {
-                assert(_sched_packets >= sect.packetCount());
-                _sched_packets -= sect.packetCount();
-            }
-            it = list.erase(it);
+            it = removeSection(list, it, scheduled);
         }
         else {
             ++it;
@@ -191,6 +180,49 @@ void ts::CyclingPacketizer::removeSections(SectionDescList& list, TID tid, uint1
 }
 
 
+//----------------------------------------------------------------------------
+// Remove one section, identified by its smart pointer.
+//----------------------------------------------------------------------------
+
+bool ts::CyclingPacketizer::removeSection(const SectionPtr& section)
+{
+    for (SectionDescList::iterator it = _sched_sections.begin(); it != _sched_sections.end(); ++it) {
+        if ((*it)->section.pointer() == section.pointer()) {
+            removeSection(_sched_sections, it, true);
+            return true;
+        }
+    }
+    for (SectionDescList::iterator it = _other_sections.begin(); it != _other_sections.end(); ++it) {
+        if ((*it)->section.pointer() == section.pointer()) {
+            removeSection(_other_sections, it, false);
+            return true;
+        }
+    }
+    return false;
+}
+
+
+//----------------------------------------------------------------------------
+// Remove the section at the specified position in the specified list.
+//----------------------------------------------------------------------------
+
+ts::CyclingPacketizer::SectionDescList::iterator ts::CyclingPacketizer::removeSection(SectionDescList& list, SectionDescList::iterator it, bool scheduled)
+{
+    const SectionDescPtr& sp(*it);
+    assert(_section_count > 0);
+    _section_count--;
+    if (sp->last_cycle != _current_cycle) {
+        assert(_remain_in_cycle > 0);
+        _remain_in_cycle--;
+    }
+    if (scheduled) {
+        assert(_sched_packets >= sp->section->packetCount());
+        _sched_packets -= sp->section->packetCount();
+    }
+    return list.erase(it);
+}
+
+
 //----------------------------------------------------------------------------
 // Remove all sections in the packetized.
 //----------------------------------------------------------------------------
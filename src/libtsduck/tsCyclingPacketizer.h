@@ -182,6 +182,16 @@ namespace ts {
         //!
         void removeSections(TID tid, uint16_t tid_ext);
 
+        //!
+        //! Remove one section from the packetizer.
+        //! The section is identified by its smart pointer, not by its content.
+        //! Other sections keep their position in the cycle and their schedule.
+        //! If the section is currently being packetized, the rest of the section will be packetized.
+        //! @param [in] section A smart pointer to a section which was previously added.
+        //! @return True if the section was found and removed, false otherwise.
+        //!
+        bool removeSection(const SectionPtr& section);
+
         //!
         //! Remove all sections in the packetizer.
         //! If a section is currently being packetized, the rest of the section will be packetized.
@@ -257,6 +267,9 @@ namespace ts {
         // Remove all sections with the specified tid/tid_ext in the specified list.
         void removeSections(SectionDescList&, TID, uint16_t tid_ext, bool use_tid_ext, bool scheduled);
 
+        // Remove the section at the specified position in the specified list, return the next position.
+        SectionDescList::iterator removeSection(SectionDescList&, SectionDescList::iterator, bool scheduled);
+
         // Inherited from SectionProviderInterface
         virtual void provideSection(SectionCounter, SectionPtr&) override;
         virtual bool doStuffing() override;
@@ -10,6 +10,7 @@
 //----------------------------------------------------------------------------
 
 #include "tsDVBCSA2.h"
+#include "tsDVBCSA2Slice.h"
 TSDUCK_SOURCE;
 
 // Operations on 64-bit areas.
@@ -25,6 +26,12 @@ TSDUCK_SOURCE;
 
 #define MAX_NBLOCKS (184 / 8)
 
+// Maximum number of data blocks in one pass of the batch operations (AVX2 vectors).
+// Under a few data blocks, the bitsliced implementation is slower than the byte-oriented one.
+
+#define MAX_LANES 256
+#define MIN_LANES 4
+
 // Disable some aggressive warnings on MSVC.
 
 #if defined(TS_MSC)
@@ -569,6 +576,132 @@ void ts::DVBCSA2::BlockCipher::encipher (const uint8_t *bd, uint8_t *ib)
 }
 
 
+//----------------------------------------------------------------------------
+// Block cipher on several data blocks in parallel.
+// The registers R[1]..R[8] of all data blocks are stored byte-sliced and
+// the register names are rotated at each round instead of moving bytes.
+//----------------------------------------------------------------------------
+
+void ts::DVBCSA2::BlockCipher::decipherBatch(uint8_t* const* data, const size_t* nblocks, size_t count)
+{
+    assert(count <= MAX_LANES);
+
+    uint8_t reg[8][MAX_LANES];
+    uint8_t* lane[MAX_LANES];
+    size_t max_nblocks = 0;
+
+    for (size_t l = 0; l < count; ++l) {
+        max_nblocks = std::max(max_nblocks, nblocks[l]);
+    }
+
+    // Blocks of same index are processed together, in increasing order.
+    for (size_t blk = 0; blk < max_nblocks; ++blk) {
+
+        // Load block index blk of all data blocks which are long enough.
+        size_t n = 0;
+        for (size_t l = 0; l < count; ++l) {
+            if (blk < nblocks[l]) {
+                lane[n] = data[l] + 8 * blk;
+                for (size_t k = 0; k < 8; ++k) {
+                    reg[k][n] = lane[n][k];
+                }
+                n++;
+            }
+        }
+
+        // Loop over kk[56]..kk[1]. At each round, new R[k] is previous R[k-1].
+        for (size_t t = 0; t < 56; ++t) {
+            const uint8_t kk = uint8_t(_kk[56 - t]);
+            uint8_t* const R2 = reg[(1 - t) & 7];
+            uint8_t* const R3 = reg[(2 - t) & 7];
+            uint8_t* const R4 = reg[(3 - t) & 7];
+            uint8_t* const R6 = reg[(5 - t) & 7];
+            uint8_t* const R7 = reg[(6 - t) & 7];
+            uint8_t* const R8 = reg[(7 - t) & 7];
+            for (size_t l = 0; l < n; ++l) {
+                const uint8_t sbox_out = block_sbox[kk ^ R7[l]];
+                const uint8_t r8 = R8[l] ^ sbox_out;
+                R6[l] ^= block_perm[sbox_out];
+                R4[l] ^= r8;
+                R3[l] ^= r8;
+                R2[l] ^= r8;
+                R8[l] = r8;
+            }
+        }
+
+        // After 56 rounds, the register names are back in place.
+        // Plain block is xor'ed with next intermediate block (zero after last one).
+        n = 0;
+        for (size_t l = 0; l < count; ++l) {
+            if (blk < nblocks[l]) {
+                const bool last = blk + 1 == nblocks[l];
+                for (size_t k = 0; k < 8; ++k) {
+                    lane[n][k] = reg[k][n] ^ (last ? 0 : lane[n][8 + k]);
+                }
+                n++;
+            }
+        }
+    }
+}
+
+void ts::DVBCSA2::BlockCipher::encipherBatch(uint8_t* const* data, const size_t* nblocks, size_t count)
+{
+    assert(count <= MAX_LANES);
+
+    uint8_t reg[8][MAX_LANES];
+    uint8_t* lane[MAX_LANES];
+    size_t max_nblocks = 0;
+
+    for (size_t l = 0; l < count; ++l) {
+        max_nblocks = std::max(max_nblocks, nblocks[l]);
+    }
+
+    // Reverse CBC: process blocks from the end of each data block.
+    for (size_t step = 0; step < max_nblocks; ++step) {
+
+        // Load the block at index nblocks-1-step, xor'ed with next enciphered block.
+        size_t n = 0;
+        for (size_t l = 0; l < count; ++l) {
+            if (step < nblocks[l]) {
+                const bool last = step == 0;
+                lane[n] = data[l] + 8 * (nblocks[l] - 1 - step);
+                for (size_t k = 0; k < 8; ++k) {
+                    reg[k][n] = lane[n][k] ^ (last ? 0 : lane[n][8 + k]);
+                }
+                n++;
+            }
+        }
+
+        // Loop over kk[1]..kk[56]. At each round, new R[k] is previous R[k+1].
+        for (size_t t = 0; t < 56; ++t) {
+            const uint8_t kk = uint8_t(_kk[1 + t]);
+            uint8_t* const R1 = reg[(0 + t) & 7];
+            uint8_t* const R3 = reg[(2 + t) & 7];
+            uint8_t* const R4 = reg[(3 + t) & 7];
+            uint8_t* const R5 = reg[(4 + t) & 7];
+            uint8_t* const R7 = reg[(6 + t) & 7];
+            uint8_t* const R8 = reg[(7 + t) & 7];
+            for (size_t l = 0; l < n; ++l) {
+                const uint8_t sbox_out = block_sbox[kk ^ R8[l]];
+                const uint8_t r1 = R1[l];
+                R3[l] ^= r1;
+                R4[l] ^= r1;
+                R5[l] ^= r1;
+                R7[l] ^= block_perm[sbox_out];
+                R1[l] = r1 ^ sbox_out;
+            }
+        }
+
+        // Store enciphered blocks.
+        for (size_t l = 0; l < n; ++l) {
+            for (size_t k = 0; k < 8; ++k) {
+                lane[l][k] = reg[k][l];
+            }
+        }
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Set the control word for subsequent encrypt/decrypt operations
 //----------------------------------------------------------------------------
@@ -747,3 +880,157 @@ bool ts::DVBCSA2::decrypt(const void* cipher, size_t cipher_length, void* plain,
         return decryptInPlace(plain, cipher_length, plain_length);
     }
 }
+
+
+//----------------------------------------------------------------------------
+// Bitsliced stream cipher implementations, selected at run time.
+//----------------------------------------------------------------------------
+
+namespace {
+
+    // Description of a bitsliced implementation.
+    struct SliceEngine
+    {
+        size_t                   lanes;   // Number of data blocks in parallel.
+        ts::DVBCSA2SliceFunction cipher;  // Bitsliced stream cipher.
+        const ts::UChar*         name;    // Implementation name.
+    };
+
+    // 64-bit integers, 64 data blocks in parallel, all platforms.
+    void Cipher64(const uint8_t* key, uint8_t* const* data, const size_t* size, size_t count)
+    {
+        ts::DVBCSA2Slice<uint64_t>::Cipher(key, data, size, count);
+    }
+
+#if defined(TS_GCC) && (defined(__SSE2__) || defined(__ARM_NEON) || defined(__ARM_NEON__))
+#define TS_CSA2_VECTOR128 1
+
+    // 128-bit vectors (SSE2, Neon), 128 data blocks in parallel.
+    typedef uint64_t Vector128 __attribute__((vector_size(16)));
+
+    void Cipher128(const uint8_t* key, uint8_t* const* data, const size_t* size, size_t count)
+    {
+        ts::DVBCSA2Slice<Vector128>::Cipher(key, data, size, count);
+    }
+#endif
+
+    // Available implementations, by increasing number of lanes.
+    class SliceEngines
+    {
+    public:
+        std::vector<SliceEngine> list;
+
+        SliceEngines() :
+            list()
+        {
+            const SliceEngine e64 = {64, Cipher64, u"64-bit"};
+            list.push_back(e64);
+#if defined(TS_CSA2_VECTOR128)
+            const SliceEngine e128 = {128, Cipher128, u"128-bit vectors"};
+            list.push_back(e128);
+#endif
+            const ts::DVBCSA2SliceFunction avx2 = ts::DVBCSA2SliceAVX2();
+            if (avx2 != 0) {
+                const SliceEngine e256 = {256, avx2, u"AVX2"};
+                list.push_back(e256);
+            }
+            assert(list.back().lanes <= MAX_LANES);
+        }
+
+        // Thread-safe initialization of the local static instance.
+        static const SliceEngines& Instance()
+        {
+            static const SliceEngines instance;
+            return instance;
+        }
+    };
+}
+
+
+//----------------------------------------------------------------------------
+// Get the name of the bitsliced implementation.
+//----------------------------------------------------------------------------
+
+ts::UString ts::DVBCSA2::BatchEngineName()
+{
+    const SliceEngine& e(SliceEngines::Instance().list.back());
+    return UString::Format(u"%s, %d packets", {e.name, e.lanes});
+}
+
+
+//----------------------------------------------------------------------------
+// Encrypt or decrypt several data blocks.
+//----------------------------------------------------------------------------
+
+bool ts::DVBCSA2::encryptBatch(uint8_t* const* data, const size_t* size, size_t count)
+{
+    return processBatch(data, size, count, true);
+}
+
+bool ts::DVBCSA2::decryptBatch(uint8_t* const* data, const size_t* size, size_t count)
+{
+    return processBatch(data, size, count, false);
+}
+
+bool ts::DVBCSA2::processBatch(uint8_t* const* data, const size_t* size, size_t count, bool encrypt)
+{
+    // Filter invalid parameters before touching any data.
+    if (!_init || (count > 0 && (data == 0 || size == 0))) {
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (data[i] == 0 || size[i] / 8 > MAX_NBLOCKS) {
+            return false;
+        }
+    }
+
+    const std::vector<SliceEngine>& engines(SliceEngines::Instance().list);
+    const size_t max_lanes = engines.back().lanes;
+    uint8_t* blk_data[MAX_LANES];
+    size_t blk_size[MAX_LANES];
+    size_t blk_count[MAX_LANES];
+
+    for (size_t i = 0; i < count; ) {
+
+        // Collect data blocks for the next pass. Data blocks smaller than 8 bytes are left unscrambled.
+        size_t n = 0;
+        for (; i < count && n < max_lanes; ++i) {
+            if (size[i] >= 8) {
+                blk_data[n] = data[i];
+                blk_size[n] = size[i];
+                blk_count[n] = size[i] / 8;
+                n++;
+            }
+        }
+
+        if (n < MIN_LANES) {
+            // Not enough data blocks, use the byte-oriented implementation.
+            for (size_t l = 0; l < n; ++l) {
+                if (encrypt) {
+                    encryptInPlace(blk_data[l], blk_size[l]);
+                }
+                else {
+                    decryptInPlace(blk_data[l], blk_size[l]);
+                }
+            }
+        }
+        else {
+            // Use the smallest bitsliced implementation which processes all data blocks at once.
+            size_t e = 0;
+            while (engines[e].lanes < n) {
+                e++;
+            }
+            if (encrypt) {
+                // Block cipher in reverse CBC mode, then stream cipher starting with the first scrambled block.
+                _block.encipherBatch(blk_data, blk_count, n);
+                engines[e].cipher(_key, blk_data, blk_size, n);
+            }
+            else {
+                // Stream cipher starting with the first scrambled block, then block cipher.
+                engines[e].cipher(_key, blk_data, blk_size, n);
+                _block.decipherBatch(blk_data, blk_count, n);
+            }
+        }
+    }
+    return true;
+}
@@ -87,6 +87,36 @@ namespace ts {
         //!
         static bool IsReducedCW(const uint8_t *cw);
 
+        //!
+        //! Encrypt several data blocks in place, typically the payloads of TS packets, using the current key.
+        //! The data blocks are processed in parallel using a bitsliced implementation of the stream
+        //! cipher. The fastest implementation for the CPU (64-bit, SSE2, AVX2) is selected at run time.
+        //! The result is identical to individual calls to encryptInPlace() on each data block.
+        //! @param [in,out] data Array of @a count addresses of data blocks.
+        //! @param [in] size Array of @a count data block sizes.
+        //! @param [in] count Number of data blocks.
+        //! @return True on success, false on error.
+        //!
+        bool encryptBatch(uint8_t* const* data, const size_t* size, size_t count);
+
+        //!
+        //! Decrypt several data blocks in place, typically the payloads of TS packets, using the current key.
+        //! The data blocks are processed in parallel using a bitsliced implementation of the stream
+        //! cipher. The fastest implementation for the CPU (64-bit, SSE2, AVX2) is selected at run time.
+        //! The result is identical to individual calls to decryptInPlace() on each data block.
+        //! @param [in,out] data Array of @a count addresses of data blocks.
+        //! @param [in] size Array of @a count data block sizes.
+        //! @param [in] count Number of data blocks.
+        //! @return True on success, false on error.
+        //!
+        bool decryptBatch(uint8_t* const* data, const size_t* size, size_t count);
+
+        //!
+        //! Get the name of the bitsliced implementation which is used by the batch operations.
+        //! @return The name of the largest bitsliced implementation which is supported by the CPU.
+        //!
+        static UString BatchEngineName();
+
         // Implementation of CipherChaining interface. Cannot set IV with DVB CSA.
         virtual bool setIV(const void*, size_t) override { return false; }
         virtual size_t minIVSize() const override { return 0; }
@@ -119,6 +149,11 @@ namespace ts {
             void init(const uint8_t *cw);
             void encipher(const uint8_t *bd, uint8_t *ib);
             void decipher(const uint8_t *ib, uint8_t *bd);
+            // Process the same block index in several data blocks in parallel.
+            // In-place reverse CBC mode with zero IV: data[i] = E(data[i] ^ data[i+1]).
+            void encipherBatch(uint8_t* const* data, const size_t* nblocks, size_t count);
+            // In-place deciphering: data[i] = D(data[i]) ^ data[i+1].
+            void decipherBatch(uint8_t* const* data, const size_t* nblocks, size_t count);
         };
 
         // Stream cipher data
@@ -147,5 +182,8 @@ namespace ts {
         uint8_t      _key[KEY_SIZE];
         BlockCipher  _block;
         StreamCipher _stream;
+
+        // Encrypt or decrypt a batch of data blocks.
+        bool processBatch(uint8_t* const* data, const size_t* size, size_t count, bool encrypt);
     };
 }
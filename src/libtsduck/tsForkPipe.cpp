@@ -519,7 +519,7 @@ bool ts::ForkPipe::write (const void* addr, size_t size, Report& report)
             // Normal case, some data were written
             assert(outsize <= remain);
             data += outsize;
-            remain -= std::max(remain, outsize);
+            remain -= std::min(remain, outsize);
         }
         else {
             // Write error
@@ -542,7 +542,7 @@ bool ts::ForkPipe::write (const void* addr, size_t size, Report& report)
             // Normal case, some data were written
             assert(size_t(outsize) <= remain);
             data += outsize;
-            remain -= std::max(remain, size_t(outsize));
+            remain -= std::min(remain, size_t(outsize));
         }
         else if ((error_code = LastErrorCode()) != EINTR) {
             // Actual error (not an interrupt)
@@ -612,7 +612,7 @@ bool ts::ForkPipe::read(void* addr, size_t max_size, size_t unit_size, size_t& r
             insize = std::max(::DWORD(0), insize);  // just in case we got a negative value
             ret_size += insize;
             data += insize;
-            remain -= std::max(remain, insize);
+            remain -= std::min(remain, insize);
             // Exit when we read an integral number of "units" or the buffer is full.
             if (unit_size == 0 || remain == 0 || ret_size % unit_size == 0) {
                 return true;
@@ -655,7 +655,7 @@ bool ts::ForkPipe::read(void* addr, size_t max_size, size_t unit_size, size_t& r
             assert(size_t(insize) <= remain);
             ret_size += insize;
             data += insize;
-            remain -= std::max(remain, size_t(insize));
+            remain -= std::min(remain, size_t(insize));
             // Exit when we read an integral number of "units" or the buffer is full.
             if (unit_size == 0 || remain == 0 || ret_size % unit_size == 0) {
                 return true;
@@ -103,6 +103,23 @@ namespace ts {
             return init() && add(data, data_size) && getHash(hash, hash_maxsize, hash_retsize);
         }
 
+        //!
+        //! Compute the hashes of several independent messages in one operation.
+        //!
+        //! The default implementation hashes each message successively using init(),
+        //! add() and getHash(). A subclass may process several messages in parallel.
+        //! In all cases, any computation which was in progress in this object is lost.
+        //!
+        //! @param [in] data Array of @a count message addresses.
+        //! @param [in] sizes Array of @a count message sizes in bytes.
+        //! @param [in] count Number of messages to hash.
+        //! @param [out] hashes Address of returned hash buffer, receiving @a count
+        //! consecutive hash values of hashSize() bytes each.
+        //! @param [in] hashes_maxsize Size in bytes of the @a hashes buffer.
+        //! @return True on success, false on error.
+        //!
+        virtual bool hashBatch(const void* const* data, const size_t* sizes, size_t count, void* hashes, size_t hashes_maxsize);
+
         //!
         //! Virtual destructor.
         //!
@@ -0,0 +1,182 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsLatencyHistogram.h"
+TSDUCK_SOURCE;
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+const size_t ts::LatencyHistogram::SUB_BITS;
+const size_t ts::LatencyHistogram::SUB_COUNT;
+const size_t ts::LatencyHistogram::BUCKET_COUNT;
+#endif
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+ts::LatencyHistogram::LatencyHistogram() :
+    _count(0),
+    _min(0),
+    _max(0),
+    _sum(0),
+    _buckets()
+{
+    reset();
+}
+
+
+//----------------------------------------------------------------------------
+// Reset the content of the histogram.
+//----------------------------------------------------------------------------
+
+void ts::LatencyHistogram::reset()
+{
+    _count = 0;
+    _min = 0;
+    _max = 0;
+    _sum = 0;
+    ::memset(_buckets, 0, sizeof(_buckets));
+}
+
+
+//----------------------------------------------------------------------------
+// Bucket index of a value: values below SUB_COUNT are stored exactly, above,
+// the bucket is identified by the position of the most significant bit and
+// the SUB_BITS next bits.
+//----------------------------------------------------------------------------
+
+size_t ts::LatencyHistogram::BucketIndex(uint64_t value)
+{
+    if (value < SUB_COUNT) {
+        return size_t(value);
+    }
+
+    // Position of the most significant bit, at least SUB_BITS.
+    size_t msb = 0;
+#if defined(TS_GCC)
+    msb = 63 - size_t(__builtin_clzll(value));
+#else
+    for (uint64_t v = value >> 1; v != 0; v >>= 1) {
+        msb++;
+    }
+#endif
+
+    const size_t shift = msb - SUB_BITS;
+    return SUB_COUNT + shift * SUB_COUNT + size_t((value >> shift) & (SUB_COUNT - 1));
+}
+
+
+//----------------------------------------------------------------------------
+// Highest value in a bucket.
+//----------------------------------------------------------------------------
+
+uint64_t ts::LatencyHistogram::BucketHighValue(size_t index)
+{
+    if (index < SUB_COUNT) {
+        return uint64_t(index);
+    }
+    else if (index >= BUCKET_COUNT) {
+        return TS_UCONST64(0xFFFFFFFFFFFFFFFF);
+    }
+    else {
+        const size_t shift = (index - SUB_COUNT) / SUB_COUNT;
+        const uint64_t sub = SUB_COUNT + (index - SUB_COUNT) % SUB_COUNT;
+        // Compute ((sub + 1) << shift) - 1 without overflow on the last bucket.
+        return (sub << shift) + ((uint64_t(1) << shift) - 1);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Record values.
+//----------------------------------------------------------------------------
+
+void ts::LatencyHistogram::add(uint64_t value, uint64_t count)
+{
+    if (count > 0) {
+        if (_count == 0 || value < _min) {
+            _min = value;
+        }
+        if (value > _max) {
+            _max = value;
+        }
+        _count += count;
+        _sum += value * count;
+        _buckets[BucketIndex(value)] += count;
+    }
+}
+
+void ts::LatencyHistogram::add(const LatencyHistogram& other)
+{
+    if (other._count > 0) {
+        if (_count == 0 || other._min < _min) {
+            _min = other._min;
+        }
+        if (other._max > _max) {
+            _max = other._max;
+        }
+        _count += other._count;
+        _sum += other._sum;
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            _buckets[i] += other._buckets[i];
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Statistics.
+//----------------------------------------------------------------------------
+
+uint64_t ts::LatencyHistogram::mean() const
+{
+    return _count == 0 ? 0 : _sum / _count;
+}
+
+uint64_t ts::LatencyHistogram::percentile(double percent) const
+{
+    if (_count == 0) {
+        return 0;
+    }
+
+    // Number of values which must be lower than or equal to the result (at least one).
+    const double limit = std::max(0.0, std::min(100.0, percent));
+    uint64_t rank = uint64_t((limit * double(_count)) / 100.0 + 0.5);
+    rank = std::max<uint64_t>(1, std::min(rank, _count));
+
+    uint64_t total = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        total += _buckets[i];
+        if (total >= rank) {
+            return std::max(_min, std::min(_max, BucketHighValue(i)));
+        }
+    }
+    return _max;
+}
@@ -0,0 +1,148 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Histogram of latency values with a bounded relative error.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsPlatform.h"
+
+namespace ts {
+    //!
+    //! Histogram of latency values with a bounded relative error.
+    //! @ingroup system
+    //!
+    //! Values are unsigned 64-bit integers in any unit (typically microseconds).
+    //! The histogram uses log-linear buckets, in the style of "high dynamic range"
+    //! histograms: each power of two is divided into 2^SUB_BITS equal sub-buckets.
+    //! Values below 2^SUB_BITS are recorded exactly. Larger values are recorded
+    //! with a relative error lower than 1/2^SUB_BITS. The memory footprint is
+    //! fixed and recording a value is a constant-time operation without allocation.
+    //!
+    //! This class is not thread-safe. Concurrent accesses must be synchronized
+    //! by the application.
+    //!
+    class TSDUCKDLL LatencyHistogram
+    {
+    public:
+        //!
+        //! Number of bits of sub-buckets in each power of two.
+        //!
+        static const size_t SUB_BITS = 4;
+
+        //!
+        //! Number of sub-buckets in each power of two.
+        //!
+        static const size_t SUB_COUNT = size_t(1) << SUB_BITS;
+
+        //!
+        //! Total number of buckets.
+        //!
+        static const size_t BUCKET_COUNT = SUB_COUNT + (64 - SUB_BITS) * SUB_COUNT;
+
+        //!
+        //! Constructor.
+        //!
+        LatencyHistogram();
+
+        //!
+        //! Reset the content of the histogram.
+        //!
+        void reset();
+
+        //!
+        //! Record a value.
+        //! @param [in] value The value to record.
+        //! @param [in] count Number of occurences of @a value.
+        //!
+        void add(uint64_t value, uint64_t count = 1);
+
+        //!
+        //! Merge the content of another histogram into this one.
+        //! @param [in] other Another histogram.
+        //!
+        void add(const LatencyHistogram& other);
+
+        //!
+        //! Get the total number of recorded values.
+        //! @return The total number of recorded values.
+        //!
+        uint64_t count() const { return _count; }
+
+        //!
+        //! Get the minimum recorded value.
+        //! @return The exact minimum recorded value or zero if the histogram is empty.
+        //!
+        uint64_t minimum() const { return _count == 0 ? 0 : _min; }
+
+        //!
+        //! Get the maximum recorded value.
+        //! @return The exact maximum recorded value or zero if the histogram is empty.
+        //!
+        uint64_t maximum() const { return _max; }
+
+        //!
+        //! Get the mean value of all recorded values.
+        //! @return The mean value or zero if the histogram is empty.
+        //!
+        uint64_t mean() const;
+
+        //!
+        //! Get the value at a given percentile.
+        //! @param [in] percent Percentile, from 0.0 to 100.0 (e.g. 99.9).
+        //! @return The highest value which is equivalent to the value at @a percent,
+        //! within the precision of the histogram, capped by the maximum recorded value.
+        //! Zero if the histogram is empty.
+        //!
+        uint64_t percentile(double percent) const;
+
+        //!
+        //! Get the bucket index of a value.
+        //! @param [in] value A value.
+        //! @return The index of the bucket where @a value is recorded.
+        //!
+        static size_t BucketIndex(uint64_t value);
+
+        //!
+        //! Get the highest value in a bucket.
+        //! @param [in] index Index of a bucket.
+        //! @return The highest value which is recorded in the bucket @a index.
+        //!
+        static uint64_t BucketHighValue(size_t index);
+
+    private:
+        uint64_t _count;                  // Total number of values.
+        uint64_t _min;                    // Exact minimum value.
+        uint64_t _max;                    // Exact maximum value.
+        uint64_t _sum;                    // Sum of all values (for mean, may wrap on absurd values).
+        uint64_t _buckets[BUCKET_COUNT];  // Counts per bucket.
+    };
+}
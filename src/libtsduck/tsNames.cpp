@@ -30,8 +30,6 @@
 #include "tsNames.h"
 #include "tsMPEG.h"
 #include "tsSysUtils.h"
-#include "tsFatal.h"
-#include "tsCerrReport.h"
 TSDUCK_SOURCE;
 
 
@@ -314,32 +312,110 @@ ts::UString ts::names::AC3ComponentType(uint8_t type, Flags flags)
 
 
 //----------------------------------------------------------------------------
-// Constructor (load the configuration file).
+// Compiled configuration files.
+//----------------------------------------------------------------------------
+
+const ts::UChar* const ts::Names::COMPILED_SUFFIX = u".bin";
+
+namespace {
+    // Magic number of compiled files, "TSNM" when read in little endian.
+    const uint32_t IMAGE_MAGIC = 0x4D4E5354;
+
+    // Format version, includes the size of characters.
+    const uint32_t IMAGE_VERSION = 0x0100 | uint32_t(sizeof(ts::UChar));
+}
+
+
+//----------------------------------------------------------------------------
+// Constructors (load the configuration file).
 //----------------------------------------------------------------------------
 
 ts::Names::Names(const UString& fileName) :
-    _log(CERR),
+    Names(fileName, CERR, true)
+{
+}
+
+ts::Names::Names(const UString& fileName, Report& report, bool useCompiled) :
+    _log(report),
     _configFile(SearchConfigurationFile(fileName)),
     _configLines(0),
     _configErrors(0),
-    _sections()
-{
+    _compiled(false),
+    _imageData(),
+    _image(0),
+    _imageSize(0),
+    _mapAddress(0),
+    _mapSize(0)
+{
+    // Look for a compiled file. It is used only if it is more recent than the text file
+    // and was compiled from a text file of the same size. Otherwise, the text file has
+    // been modified by the user and it takes precedence.
+    const UString binFile(useCompiled ? SearchConfigurationFile(fileName + COMPILED_SUFFIX) : UString());
+    if (!binFile.empty() &&
+        (_configFile.empty() || GetFileModificationTimeUTC(binFile) >= GetFileModificationTimeUTC(_configFile)) &&
+        loadCompiled(binFile))
+    {
+        if (_configFile.empty() || header().sourceSize == uint64_t(GetFileSize(_configFile))) {
+            _compiled = true;
+            if (_configFile.empty()) {
+                _configFile = binFile;
+            }
+            return;
+        }
+        releaseImage();
+    }
+
     // Locate the configuration file.
     if (_configFile.empty()) {
         // Cannot load configuration, names will not be available.
-        _log.error(u"configuration file 'tsduck.names' not found");
+        _log.error(u"configuration file '%s' not found", {fileName});
         return;
     }
 
+    loadText();
+}
+
+
+//----------------------------------------------------------------------------
+// Destructor: free all resources.
+//----------------------------------------------------------------------------
+
+ts::Names::~Names()
+{
+    releaseImage();
+}
+
+void ts::Names::releaseImage()
+{
+#if defined(TS_UNIX)
+    if (_mapAddress != 0) {
+        ::munmap(_mapAddress, _mapSize);
+    }
+#endif
+    _mapAddress = 0;
+    _mapSize = 0;
+    _image = 0;
+    _imageSize = 0;
+    _imageData.clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Load a text configuration file, build the image.
+//----------------------------------------------------------------------------
+
+bool ts::Names::loadText()
+{
     // Open configuration file.
     const std::string fileUTF8(_configFile.toUTF8());
     std::ifstream strm(fileUTF8.c_str());
     if (!strm) {
         _log.error(u"error opening file " + _configFile);
-        return;
+        return false;
     }
 
     // Read configuration file line by line.
+    ConfigSectionMap sectionMap;
     ConfigSection* section = 0;
     UString line;
     while (line.getLine(strm)) {
@@ -357,16 +433,7 @@ ts::Names::Names(const UString& fileName) :
             line.convertToLower();
 
             // Get or create associated section.
-            ConfigSectionMap::iterator it = _sections.find(line);
-            if (it != _sections.end()) {
-                section = it->second;
-            }
-            else {
-                // Create new section.
-                section = new ConfigSection;
-                CheckNonNull(section);
-                _sections.insert(std::make_pair(line, section));
-            }
+            section = &sectionMap[line];
         }
         else if (!decodeDefinition(line, section)) {
             // Invalid line.
@@ -379,6 +446,60 @@ ts::Names::Names(const UString& fileName) :
         }
     }
     strm.close();
+
+    // Count entries and characters in names.
+    size_t entryCount = 0;
+    size_t charCount = 0;
+    for (ConfigSectionMap::const_iterator sec = sectionMap.begin(); sec != sectionMap.end(); ++sec) {
+        charCount += sec->first.length();
+        entryCount += sec->second.entries.size();
+        for (std::map<Value, std::pair<Value, UString>>::const_iterator it = sec->second.entries.begin(); it != sec->second.entries.end(); ++it) {
+            charCount += it->second.second.length();
+        }
+    }
+
+    // Build the image. The sections are sorted by lower-case name, the entries by first value.
+    _imageSize = sizeof(ImageHeader) + sectionMap.size() * sizeof(ImageSection) + entryCount * sizeof(ImageEntry) + charCount * sizeof(UChar);
+    _imageData.assign(_imageSize, 0);
+    _image = _imageData.data();
+
+    ImageHeader* hdr = reinterpret_cast<ImageHeader*>(_imageData.data());
+    hdr->magic = IMAGE_MAGIC;
+    hdr->version = IMAGE_VERSION;
+    hdr->sourceSize = uint64_t(std::max<int64_t>(0, GetFileSize(_configFile)));
+    hdr->sectionCount = uint32_t(sectionMap.size());
+    hdr->entryCount = uint32_t(entryCount);
+    hdr->charCount = uint32_t(charCount);
+
+    ImageSection* isec = const_cast<ImageSection*>(sections());
+    ImageEntry* ient = const_cast<ImageEntry*>(entries());
+    UChar* const ichars = const_cast<UChar*>(chars());
+    uint32_t entryIndex = 0;
+    uint32_t charIndex = 0;
+
+    for (ConfigSectionMap::const_iterator sec = sectionMap.begin(); sec != sectionMap.end(); ++sec, ++isec) {
+        isec->name = charIndex;
+        isec->nameLength = uint32_t(sec->first.length());
+        isec->bits = uint32_t(sec->second.bits);
+        isec->firstEntry = entryIndex;
+        isec->entryCount = uint32_t(sec->second.entries.size());
+        sec->first.copy(ichars + charIndex, sec->first.length());
+        charIndex += isec->nameLength;
+        for (std::map<Value, std::pair<Value, UString>>::const_iterator it = sec->second.entries.begin(); it != sec->second.entries.end(); ++it, ++ient) {
+            const UString& name(it->second.second);
+            ient->first = it->first;
+            ient->last = it->second.first;
+            ient->name = charIndex;
+            ient->nameLength = uint32_t(name.length());
+            name.copy(ichars + charIndex, name.length());
+            charIndex += ient->nameLength;
+        }
+        entryIndex += isec->entryCount;
+    }
+
+    assert(entryIndex == entryCount);
+    assert(charIndex == charCount);
+    return true;
 }
 
 
@@ -423,7 +544,7 @@ bool ts::Names::decodeDefinition(const UString& line, ConfigSection* section)
     // Add the definition.
     if (valid) {
         if (section->freeRange(first, last)) {
-            section->addEntry(first, last, value);
+            section->entries.insert(std::make_pair(first, std::make_pair(last, value)));
         }
         else {
             _log.error(u"%s: range 0x%X-0x%X overlaps with an existing range", {_configFile, first, last});
@@ -435,113 +556,238 @@ bool ts::Names::decodeDefinition(const UString& line, ConfigSection* section)
 
 
 //----------------------------------------------------------------------------
-// Destructor: free all resources.
+// Configuration section, while loading a text file.
 //----------------------------------------------------------------------------
 
-ts::Names::~Names()
+ts::Names::ConfigSection::ConfigSection() :
+    bits(0),
+    entries()
 {
-    // Deallocate all configuration sections.
-    for (ConfigSectionMap::iterator it = _sections.begin(); it != _sections.end(); ++it) {
-        delete it->second;
+}
+
+bool ts::Names::ConfigSection::freeRange(Value first, Value last) const
+{
+    // Get an iterator pointing to the first element that is "not less" than 'first'.
+    std::map<Value, std::pair<Value, UString>>::const_iterator it = entries.lower_bound(first);
+
+    if (it != entries.end() && it->first <= last) {
+        // This is an existing range which starts inside [first..last].
+        assert(it->first >= first);
+        return false;
+    }
+
+    if (it != entries.begin() && (--it)->second.first >= first) {
+        // The previous range ends inside [first..last].
+        assert(it->first < first);
+        return false;
     }
-    _sections.clear();
+
+    // No overlap found.
+    return true;
 }
 
 
 //----------------------------------------------------------------------------
-// Configuration entry.
+// Load a compiled configuration file.
 //----------------------------------------------------------------------------
 
-ts::Names::ConfigEntry::ConfigEntry(Value l, const UString& n) :
-    last(l),
-    name(n)
+bool ts::Names::loadCompiled(const UString& binFile)
 {
+#if defined(TS_UNIX)
+
+    // Map the compiled file in memory.
+    const int fd = ::open(binFile.toUTF8().c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct ::stat st;
+    if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+        void* addr = ::mmap(0, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            _mapAddress = addr;
+            _mapSize = size_t(st.st_size);
+        }
+    }
+    ::close(fd);
+    if (_mapAddress == 0) {
+        return false;
+    }
+    _image = reinterpret_cast<const uint8_t*>(_mapAddress);
+    _imageSize = _mapSize;
+
+#else
+
+    // Read the compiled file in memory.
+    std::ifstream strm(binFile.toUTF8().c_str(), std::ios::binary);
+    const int64_t size = GetFileSize(binFile);
+    if (!strm || size <= 0) {
+        return false;
+    }
+    _imageData.resize(size_t(size));
+    if (!strm.read(reinterpret_cast<char*>(_imageData.data()), std::streamsize(size))) {
+        _imageData.clear();
+        return false;
+    }
+    _image = _imageData.data();
+    _imageSize = _imageData.size();
+
+#endif
+
+    if (!checkImage(_image, _imageSize)) {
+        _log.debug(u"invalid compiled names file %s", {binFile});
+        releaseImage();
+        return false;
+    }
+    return true;
 }
 
 
 //----------------------------------------------------------------------------
-// Configuration section.
+// Check the validity of an image.
 //----------------------------------------------------------------------------
 
-ts::Names::ConfigSection::ConfigSection() :
-    bits(0),
-    entries()
+bool ts::Names::checkImage(const uint8_t* image, size_t size) const
 {
-}
+    if (image == 0 || size < sizeof(ImageHeader)) {
+        return false;
+    }
+    const ImageHeader* hdr = reinterpret_cast<const ImageHeader*>(image);
+    if (hdr->magic != IMAGE_MAGIC ||
+        hdr->version != IMAGE_VERSION ||
+        size != sizeof(ImageHeader) + hdr->sectionCount * sizeof(ImageSection) + hdr->entryCount * sizeof(ImageEntry) + hdr->charCount * sizeof(UChar))
+    {
+        return false;
+    }
 
-ts::Names::ConfigSection::~ConfigSection()
-{
-    // Deallocate all configuration entries.
-    for (ConfigEntryMap::iterator it = entries.begin(); it != entries.end(); ++it) {
-        delete it->second;
+    // Check that all indexes are in range, lookups do not check them.
+    const ImageSection* secs = reinterpret_cast<const ImageSection*>(image + sizeof(ImageHeader));
+    const ImageEntry* ents = reinterpret_cast<const ImageEntry*>(secs + hdr->sectionCount);
+    for (uint32_t i = 0; i < hdr->sectionCount; ++i) {
+        if (secs[i].firstEntry > hdr->entryCount ||
+            secs[i].entryCount > hdr->entryCount - secs[i].firstEntry ||
+            secs[i].name > hdr->charCount ||
+            secs[i].nameLength > hdr->charCount - secs[i].name)
+        {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < hdr->entryCount; ++i) {
+        if (ents[i].name > hdr->charCount || ents[i].nameLength > hdr->charCount - ents[i].name) {
+            return false;
+        }
     }
-    entries.clear();
+    return true;
 }
 
 
 //----------------------------------------------------------------------------
-// Check if a range is free, ie no value is defined in the range.
+// Compile a configuration file into a binary file.
 //----------------------------------------------------------------------------
 
-bool ts::Names::ConfigSection::freeRange(Value first, Value last) const
+bool ts::Names::Compile(const UString& textFile, const UString& binFile, Report& report)
 {
-    // Get an iterator pointing to the first element that is "not less" than 'first'.
-    ConfigEntryMap::const_iterator it = entries.lower_bound(first);
-
-    if (it != entries.end() && it->first <= last) {
-        // This is an existing range which starts inside [first..last].
-        assert(it->first >= first);
+    // Load the text file, without looking for a compiled file.
+    const Names names(textFile, report, false);
+    if (names._image == 0 || names._configErrors > 0) {
+        report.error(u"%s: names not compiled", {textFile});
         return false;
     }
 
-    if (it != entries.begin() && (--it)->second->last >= first) {
-        // The previous range ends inside [first..last].
-        assert(it->first < first);
+    // Write the image.
+    std::ofstream strm(binFile.toUTF8().c_str(), std::ios::binary | std::ios::trunc);
+    if (!strm || !strm.write(reinterpret_cast<const char*>(names._image), std::streamsize(names._imageSize))) {
+        report.error(u"error creating %s", {binFile});
         return false;
     }
-
-    // No overlap found.
-    return true;
+    strm.close();
+    report.verbose(u"%s: %d sections, %d entries", {binFile, names.header().sectionCount, names.header().entryCount});
+    return !strm.fail();
 }
 
 
 //----------------------------------------------------------------------------
-// Add a new configuration entry.
+// Find a section, case-insensitive.
 //----------------------------------------------------------------------------
 
-void ts::Names::ConfigSection::addEntry(Value first, Value last, const UString& name)
+const ts::Names::ImageSection* ts::Names::findSection(const UString& sectionName) const
 {
-    ConfigEntry* entry = new ConfigEntry(last, name);
-    CheckNonNull(entry);
-    entries.insert(std::make_pair(first, entry));
+    if (_image == 0) {
+        return 0;
+    }
+
+    // Ignore leading and trailing spaces in the section name, without allocating a new string.
+    size_t start = 0;
+    size_t end = sectionName.length();
+    while (start < end && IsSpace(sectionName[start])) {
+        ++start;
+    }
+    while (end > start && IsSpace(sectionName[end - 1])) {
+        --end;
+    }
+
+    // Binary search in the sorted lower-case section names.
+    const UChar* const names = chars();
+    const ImageSection* low = sections();
+    const ImageSection* high = low + header().sectionCount;
+    while (low < high) {
+        const ImageSection* mid = low + (high - low) / 2;
+        const UChar* name = names + mid->name;
+        const size_t len = std::min<size_t>(mid->nameLength, end - start);
+        int cmp = 0;
+        for (size_t i = 0; cmp == 0 && i < len; ++i) {
+            cmp = int(name[i]) - int(ToLower(sectionName[start + i]));
+        }
+        if (cmp == 0) {
+            cmp = int(mid->nameLength) - int(end - start);
+        }
+        if (cmp == 0) {
+            return mid;
+        }
+        else if (cmp < 0) {
+            low = mid + 1;
+        }
+        else {
+            high = mid;
+        }
+    }
+    return 0;
 }
 
 
 //----------------------------------------------------------------------------
-// Get a name from a value, empty if not found.
+// Find the entry containing a value in a section.
 //----------------------------------------------------------------------------
 
-ts::UString ts::Names::ConfigSection::getName(Value val) const
+const ts::Names::ImageEntry* ts::Names::findEntry(const ImageSection* section, Value value) const
 {
-    // Eliminate trivial cases which would cause issues with code below.
-    if (entries.empty()) {
-        return UString();
+    if (section == 0) {
+        return 0;
     }
 
-    // The key in the 'entries' map is the _first_ value of a range.
-    // Get an iterator pointing to the first element that is "not less" than 'val'.
-    ConfigEntryMap::const_iterator it = entries.lower_bound(val);
-
-    if (it == entries.end() || (it != entries.begin() && it->first != val)) {
-        // There is no entry with a value range starting at 'val'.
-        // Maybe 'val' is in the range of the previous entry.
-        --it;
+    // Find the first entry with a range starting after 'value'. The candidate is the previous one.
+    const ImageEntry* begin = entries() + section->firstEntry;
+    const ImageEntry* high = begin + section->entryCount;
+    const ImageEntry* low = begin;
+    while (low < high) {
+        const ImageEntry* mid = low + (high - low) / 2;
+        if (mid->first <= value) {
+            low = mid + 1;
+        }
+        else {
+            high = mid;
+        }
     }
+    return low != begin && value <= (low - 1)->last ? low - 1 : 0;
+}
 
-    assert(it != entries.end());
-    assert(it->second != 0);
 
-    return val >= it->first && val <= it->second->last ? it->second->name : UString();
+//----------------------------------------------------------------------------
+// Get the name of an entry, empty if there is no entry.
+//----------------------------------------------------------------------------
+
+ts::UString ts::Names::entryName(const ImageEntry* entry) const
+{
+    return entry == 0 ? UString() : UString(chars() + entry->name, entry->nameLength);
 }
 
 
@@ -619,9 +865,8 @@ ts::UString ts::Names::Formatted(Value value, const UString& name, names::Flags
 
 bool ts::Names::nameExists(const UString& sectionName, Value value) const
 {
-    // Get the section, normalize the section name.
-    ConfigSectionMap::const_iterator it = _sections.find(sectionName.toTrimmed().toLower());
-    return it != _sections.end() && !it->second->getName(value).empty();
+    const ImageEntry* entry = findEntry(findSection(sectionName), value);
+    return entry != 0 && entry->nameLength > 0;
 }
 
 
@@ -631,16 +876,14 @@ bool ts::Names::nameExists(const UString& sectionName, Value value) const
 
 ts::UString ts::Names::nameFromSection(const UString& sectionName, Value value, names::Flags flags, size_t bits, Value alternateValue) const
 {
-    // Get the section, normalize the section name.
-    ConfigSectionMap::const_iterator it = _sections.find(sectionName.toTrimmed().toLower());
-    const ConfigSection* section = it == _sections.end() ? 0 : it->second;
+    const ImageSection* section = findSection(sectionName);
 
     if (section == 0) {
         // Non-existent section, no name.
         return Formatted(value, UString(), flags, bits, alternateValue);
     }
     else {
-        return Formatted(value, section->getName(value), flags, bits != 0 ? bits : section->bits, alternateValue);
+        return Formatted(value, entryName(findEntry(section, value)), flags, bits != 0 ? bits : section->bits, alternateValue);
     }
 }
 
@@ -651,23 +894,21 @@ ts::UString ts::Names::nameFromSection(const UString& sectionName, Value value,
 
 ts::UString ts::Names::nameFromSectionWithFallback(const UString& sectionName, Value value1, Value value2, names::Flags flags, size_t bits, Value alternateValue) const
 {
-    // Get the section, normalize the section name.
-    ConfigSectionMap::const_iterator it = _sections.find(sectionName.toTrimmed().toLower());
-    const ConfigSection* section = it == _sections.end() ? 0 : it->second;
+    const ImageSection* section = findSection(sectionName);
 
     if (section == 0) {
         // Non-existent section, no name.
         return Formatted(value1, UString(), flags, bits, alternateValue);
     }
     else {
-        const UString name(section->getName(value1));
-        if (!name.empty()) {
+        const ImageEntry* entry = findEntry(section, value1);
+        if (entry != 0 && entry->nameLength > 0) {
             // value1 has a name
-            return Formatted(value1, name, flags, bits != 0 ? bits : section->bits, alternateValue);
+            return Formatted(value1, entryName(entry), flags, bits != 0 ? bits : section->bits, alternateValue);
         }
         else {
             // value1 has no name, use value2.
-            return Formatted(value2, section->getName(value2), flags, bits != 0 ? bits : section->bits, alternateValue);
+            return Formatted(value2, entryName(findEntry(section, value2)), flags, bits != 0 ? bits : section->bits, alternateValue);
         }
     }
 }
@@ -35,8 +35,9 @@
 
 #pragma once
 #include "tsUString.h"
+#include "tsByteBlock.h"
 #include "tsCASFamily.h"
-#include "tsReport.h"
+#include "tsCerrReport.h"
 #include "tsStaticInstance.h"
 
 namespace ts {
@@ -349,6 +350,13 @@ namespace ts {
     //! A repository of names for MPEG/DVB entities.
     //! All names are loaded from configuration files @em tsduck.*.names.
     //!
+    //! A configuration file can be precompiled into a binary file with the same name
+    //! and the suffix @c .bin (see Compile()). The compiled file contains sorted tables
+    //! of value ranges which are directly mapped in memory. The compiled file is used
+    //! instead of the text file when it is up to date: its source file had the same
+    //! size as the text file and the text file was not modified after the compiled file.
+    //! Otherwise, for instance when the user modified the text file, the text file is used.
+    //!
     class TSDUCKDLL Names
     {
     public:
@@ -358,6 +366,20 @@ namespace ts {
         //!
         Names(const UString& fileName);
 
+        //!
+        //! Suffix of the compiled configuration files.
+        //!
+        static const UChar* const COMPILED_SUFFIX;
+
+        //!
+        //! Compile a configuration file into a binary file which can be mapped in memory.
+        //! @param [in] textFile Name of the text configuration file.
+        //! @param [in] binFile Name of the binary file to create.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        static bool Compile(const UString& textFile, const UString& binFile, Report& report = CERR);
+
         //!
         //! Virtual destructor.
         //!
@@ -386,6 +408,15 @@ namespace ts {
             return _configErrors;
         }
 
+        //!
+        //! Check if the names were loaded from a compiled configuration file.
+        //! @return True if the names were loaded from a compiled configuration file.
+        //!
+        bool isCompiled() const
+        {
+            return _compiled;
+        }
+
         //!
         //! Check if a name exists in a specified section.
         //! @param [in] sectionName Name of section to search. Not case-sensitive.
@@ -429,47 +460,87 @@ namespace ts {
         static UString Formatted(Value value, const UString& name, names::Flags flags, size_t bits, Value alternateValue = 0);
 
     private:
-        // Description of a configuration entry.
-        // The first value of the range is the key in a map.
-        class ConfigEntry
+        // The names are stored in an "image", a contiguous memory area with sorted tables of
+        // value ranges, which is either mapped from a compiled file or built from a text file.
+        // Layout: header, sections (sorted by lower-case names), entries (sorted by first value
+        // in each section), characters of all names. All integer fields use the native byte
+        // order, the header identifies the byte order and the size of characters.
+        struct ImageHeader
         {
-        public:
-            Value   last;   // Last value in the range.
-            UString name;   // Associated name.
-
-            ConfigEntry(Value l = 0, const UString& n = UString());
+            uint32_t magic;          // Magic number, also identifies the byte order.
+            uint32_t version;        // Format version and size of characters.
+            uint64_t sourceSize;     // Size in bytes of the source text file.
+            uint32_t sectionCount;   // Number of sections.
+            uint32_t entryCount;     // Total number of entries.
+            uint32_t charCount;      // Total number of characters in names.
+            uint32_t reserved;       // Padding.
+        };
+        struct ImageSection
+        {
+            uint32_t name;           // Index of lower-case section name in characters.
+            uint32_t nameLength;     // Name length in characters.
+            uint32_t bits;           // Number of significant bits in values of the type.
+            uint32_t firstEntry;     // Index of first entry.
+            uint32_t entryCount;     // Number of entries.
+            uint32_t reserved;       // Padding.
+        };
+        struct ImageEntry
+        {
+            Value    first;          // First value in the range.
+            Value    last;           // Last value in the range.
+            uint32_t name;           // Index of associated name in characters.
+            uint32_t nameLength;     // Name length in characters.
         };
 
-        // Map of configuration entries, indexed by first value of the range.
-        typedef std::map<Value, ConfigEntry*> ConfigEntryMap;
-
-        // Description of a configuration section.
-        // The name of the section is the key in a map.
+        // Description of a configuration section, while loading a text file.
         class ConfigSection
         {
         public:
-            size_t          bits;     // Number of significant bits in values of the type.
-            ConfigEntryMap  entries;  // All entries, indexed by names.
+            size_t bits;                                          // Number of significant bits in values of the type.
+            std::map<Value, std::pair<Value, UString>> entries;  // Last value and name, indexed by first value.
 
             ConfigSection();
-            ~ConfigSection();
 
             // Check if a range is free, ie no value is defined in the range.
             bool freeRange(Value first, Value last) const;
+        };
 
-            // Add a new entry.
-            void addEntry(Value first, Value last, const UString& name);
+        // Map of configuration sections, indexed by lower-case name.
+        typedef std::map<UString, ConfigSection> ConfigSectionMap;
 
-            // Get a name from a value, empty if not found.
-            UString getName(Value val) const;
-        };
+        // Private constructor, optionally using compiled files.
+        Names(const UString& fileName, Report& report, bool useCompiled);
 
-        // Map of configuration sections, indexed by name.
-        typedef std::map<UString, ConfigSection*> ConfigSectionMap;
+        // Load a text configuration file, build the image. Return true on success, false on error.
+        bool loadText();
 
         // Decode a line as "first[-last] = name". Return true on success, false on error.
         bool decodeDefinition(const UString& line, ConfigSection* section);
 
+        // Load a compiled configuration file. Return true on success, false on error.
+        bool loadCompiled(const UString& binFile);
+
+        // Check the validity of the image, return true if valid.
+        bool checkImage(const uint8_t* image, size_t size) const;
+
+        // Release the image.
+        void releaseImage();
+
+        // Access to the tables of the image.
+        const ImageHeader& header() const { return *reinterpret_cast<const ImageHeader*>(_image); }
+        const ImageSection* sections() const { return reinterpret_cast<const ImageSection*>(_image + sizeof(ImageHeader)); }
+        const ImageEntry* entries() const { return reinterpret_cast<const ImageEntry*>(sections() + header().sectionCount); }
+        const UChar* chars() const { return reinterpret_cast<const UChar*>(entries() + header().entryCount); }
+
+        // Find a section, case-insensitive. Return zero if not found.
+        const ImageSection* findSection(const UString& sectionName) const;
+
+        // Find the entry containing a value in a section. Return zero if not found.
+        const ImageEntry* findEntry(const ImageSection* section, Value value) const;
+
+        // Get the name of an entry, empty if there is no entry.
+        UString entryName(const ImageEntry* entry) const;
+
         // Compute a number of hexa digits.
         static int HexaDigits(size_t bits);
 
@@ -477,11 +548,16 @@ namespace ts {
         static Value DisplayMask(size_t bits);
 
         // Names private fields.
-        Report&          _log;           // Error logger.
-        const UString    _configFile;    // Configuration file path.
-        size_t           _configLines;   // Number of lines in configuration file.
-        size_t           _configErrors;  // Number of errors in configuration file.
-        ConfigSectionMap _sections;      // Configuration sections.
+        Report&        _log;           // Error logger.
+        UString        _configFile;    // Configuration file path.
+        size_t         _configLines;   // Number of lines in configuration file.
+        size_t         _configErrors;  // Number of errors in configuration file.
+        bool           _compiled;      // Loaded from a compiled file.
+        ByteBlock      _imageData;     // Image built in memory or read from a compiled file.
+        const uint8_t* _image;         // Address of the image, zero if there is none.
+        size_t         _imageSize;     // Size in bytes of the image.
+        void*          _mapAddress;    // Address of the memory mapping of the compiled file, if any.
+        size_t         _mapSize;       // Size of the memory mapping of the compiled file.
 
         // Inaccessible operations.
         Names() = delete;
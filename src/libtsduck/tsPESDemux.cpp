@@ -49,6 +49,9 @@ namespace {
 
     // End of AVC NALunit delimiter
     const uint8_t Zero3[] = {0x00, 0x00, 0x00};
+
+    // Maximum number of unused reassembly buffers to keep in the pool.
+    const size_t MAX_FREE_BUFFERS = 16;
 }
 
 
@@ -59,7 +62,9 @@ namespace {
 ts::PESDemux::PESDemux(PESHandlerInterface* pes_handler, const PIDSet& pid_filter) :
     SuperClass(pid_filter),
     _pes_handler(pes_handler),
+    _header_only(false),
     _pids(),
+    _buffers(),
     _stream_types(),
     _section_demux(this)
 {
@@ -87,7 +92,9 @@ ts::PESDemux::PIDContext::PIDContext() :
     sync(false),
     first_pkt(0),
     last_pkt(0),
-    ts(new ByteBlock()),
+    header_only(false),
+    header_done(false),
+    ts(),
     audio(),
     video(),
     avc(),
@@ -212,7 +219,8 @@ void ts::PESDemux::processPacket(const TSPacket& pkt)
     }
 
     // If at a unit start and the context exists, process previous PES packet in context
-    if (pc_exists && pkt.getPUSI() && pci->second.sync) {
+    // (already done in header-only mode).
+    if (pc_exists && pkt.getPUSI() && pci->second.sync && !pci->second.header_only) {
         // Process packet, invoke all handlers  
         processPESPacket(pid, pci->second);
         // Recheck PID context in case it was reset by a handler
@@ -241,11 +249,22 @@ void ts::PESDemux::processPacket(const TSPacket& pkt)
         if (pl_size >= 3 && pl[0] == 0 && pl[1] == 0 && pl[2] == 1) {
             // We are at the beginning of a PES packet. Create context if non existent.
             PIDContext& pc(_pids[pid]);
+            // Get another buffer if the previous one is still referenced by a handler.
+            // The buffer is otherwise referenced by the context and the pool only.
+            if (pc.ts.isNull() || pc.ts.count() > 2) {
+                pc.ts = getBuffer();
+            }
             pc.continuity = pkt.getCC();
             pc.sync = true;
+            pc.header_only = _header_only;
+            pc.header_done = false;
             pc.ts->copy(pl, pl_size);
             pc.first_pkt = _packet_count;
             pc.last_pkt = _packet_count;
+            // In header-only mode, the header is usually complete in the first TS packet.
+            if (pc.header_only) {
+                processPESHeader(pid, pc);
+            }
         }
         else if (pc_exists) {
             // This PID does not contain PES packet, reset context
@@ -274,6 +293,12 @@ void ts::PESDemux::processPacket(const TSPacket& pkt)
     }
     pc.continuity = pkt.getCC();
 
+    // In header-only mode, the rest of the payload is not reassembled.
+    if (pc.header_done) {
+        pc.last_pkt = _packet_count;
+        return;
+    }
+
     // Append the TS payload in PID context.
     size_t capacity = pc.ts->capacity();
     if (pc.ts->size() + pl_size > capacity) {
@@ -296,6 +321,46 @@ void ts::PESDemux::processPacket(const TSPacket& pkt)
 
     // Last TS packet containing actual data for this PES packet
     pc.last_pkt = _packet_count;
+
+    // In header-only mode, check if the header is now complete.
+    if (pc.header_only) {
+        processPESHeader(pid, pc);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Get a free reassembly buffer from the pool.
+//----------------------------------------------------------------------------
+
+ts::ByteBlockPtr ts::PESDemux::getBuffer()
+{
+    // A buffer is free when it is referenced by the pool only.
+    // The free buffers keep their capacity from previous PES packets.
+    ByteBlockPtr buffer;
+    size_t free_count = 0;
+    for (auto it = _buffers.begin(); it != _buffers.end(); ) {
+        if (it->count() > 1) {
+            ++it;
+        }
+        else if (buffer.isNull()) {
+            buffer = *it++;
+        }
+        else if (++free_count > MAX_FREE_BUFFERS) {
+            // Too many unused buffers, release memory.
+            it = _buffers.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+
+    // Allocate a new buffer when no free one is available.
+    if (buffer.isNull()) {
+        buffer = new ByteBlock();
+        _buffers.push_back(buffer);
+    }
+    return buffer;
 }
 
 
@@ -336,7 +401,7 @@ void ts::PESDemux::handleTable(SectionDemux& demux, const BinaryTable& table)
 
 
 //-----------------------------------------------------------------------------
-// This hook is invoked when a complete PES packet is available.
+// These hooks are invoked when a complete PES packet or header is available.
 //-----------------------------------------------------------------------------
 
 void ts::PESDemux::handlePESPacket(const PESPacket& packet)
@@ -346,6 +411,52 @@ void ts::PESDemux::handlePESPacket(const PESPacket& packet)
     }
 }
 
+void ts::PESDemux::handlePESHeader(const PESPacket& packet)
+{
+    if (_pes_handler != 0) {
+        _pes_handler->handlePESHeader(*this, packet);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Process a complete PES header in header-only mode.
+//----------------------------------------------------------------------------
+
+void ts::PESDemux::processPESHeader(PID pid, PIDContext& pc)
+{
+    // Build a PES packet object around the TS buffer, invalid while the header is incomplete.
+    PESPacket pp(pc.ts, pid);
+    if (!pp.isValid()) {
+        return;
+    }
+
+    // Count valid PES packets. The rest of the payload is ignored.
+    pc.pes_count++;
+    pc.header_done = true;
+
+    // Location of the PES packet inside the demultiplexed stream, the last packet is not yet known.
+    pp.setFirstTSPacketIndex(pc.first_pkt);
+    pp.setLastTSPacketIndex(pc.last_pkt);
+
+    // Set stream type if known.
+    const StreamTypeMap::const_iterator it = _stream_types.find(pid);
+    if (it != _stream_types.end()) {
+        pp.setStreamType(it->second);
+    }
+
+    // The PID context may be reset by the handler, do not use it after the call.
+    beforeCallingHandler(pid);
+    try {
+        handlePESHeader(pp);
+    }
+    catch (...) {
+        afterCallingHandler(false);
+        throw;
+    }
+    afterCallingHandler(true);
+}
+
 
 //----------------------------------------------------------------------------
 // Process a complete PES packet
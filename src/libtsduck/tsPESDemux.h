@@ -47,6 +47,16 @@ namespace ts {
     //! This class extracts PES packets from TS packets.
     //! @ingroup mpeg
     //!
+    //! The PES packets are reassembled in buffers which are recycled from one PES packet
+    //! to another. The PESPacket objects which are passed to the handlers share the
+    //! reassembly buffer, they do not copy it. A handler which keeps a copy of a PESPacket
+    //! (using the SHARE mode) retains the buffer and the demux uses another one.
+    //!
+    //! In header-only mode, the PES payloads are never reassembled. The handlers are notified
+    //! of each PES header, using PESHandlerInterface::handlePESHeader(), as soon as it is
+    //! received, usually in the first TS packet of the PES packet. This mode is appropriate
+    //! for applications which only need the PES headers on high-bitrate PID's.
+    //!
     class TSDUCKDLL PESDemux: public TimeTrackerDemux, private TableHandlerInterface
     {
     public:
@@ -79,6 +89,29 @@ namespace ts {
             _pes_handler = h;
         }
 
+        //!
+        //! Set the header-only mode.
+        //! In header-only mode, the PES payloads are not reassembled. Only the handler method
+        //! PESHandlerInterface::handlePESHeader() is invoked. The other handler methods, which
+        //! need the complete PES packet, are not invoked. The audio and video attributes are
+        //! not analyzed. The new mode applies starting at the next PES packet in each PID.
+        //! @param [in] on When true, use the header-only mode. When false (the default), the
+        //! complete PES packets are reassembled.
+        //!
+        void setHeaderOnly(bool on)
+        {
+            _header_only = on;
+        }
+
+        //!
+        //! Check if the demux is in header-only mode.
+        //! @return True if the demux is in header-only mode.
+        //!
+        bool headerOnly() const
+        {
+            return _header_only;
+        }
+
         //!
         //! Get the current audio attributes on the specified PID.
         //! @param [in] pid The PID to check.
@@ -130,6 +163,13 @@ namespace ts {
         //!
         virtual void handlePESPacket(const PESPacket& packet);
 
+        //!
+        //! This hook is invoked in header-only mode when a complete PES header is available.
+        //! Can be overloaded by subclasses to add intermediate processing.
+        //! @param [in] packet A PES packet containing the complete header and the beginning of the payload.
+        //!
+        virtual void handlePESHeader(const PESPacket& packet);
+
         // Inherited methods
         virtual void immediateReset() override;
         virtual void immediateResetPID(PID pid) override;
@@ -143,7 +183,9 @@ namespace ts {
             bool            sync;        // We are synchronous in this PID
             PacketCounter   first_pkt;   // Index of first TS packet for current PES packet
             PacketCounter   last_pkt;    // Index of last TS packet for current PES packet
-            ByteBlockPtr    ts;          // TS payload buffer
+            bool            header_only; // Current PES packet is processed in header-only mode
+            bool            header_done; // Header already notified (header-only mode)
+            ByteBlockPtr    ts;          // TS payload buffer, from the buffer pool
             AudioAttributes audio;       // Current audio attributes
             VideoAttributes video;       // Current video attributes (MPEG-1, MPEG-2)
             AVCAttributes   avc;         // Current AVC attributes
@@ -159,7 +201,7 @@ namespace ts {
 
         // Map of PID contexts, indexed by PID.
         // One context is created per demuxed PES PID.
-        typedef std::map<PID,PIDContext> PIDContextMap;
+        typedef PIDMap<PIDContext> PIDContextMap;
 
         // Map of stream types (from PMT), indexed by PID.
         // All known PID's are referenced here, not only demuxed PES PID's.
@@ -171,12 +213,20 @@ namespace ts {
         // Process a complete PES packet
         void processPESPacket(PID, PIDContext&);
 
+        // Process a complete PES header in header-only mode.
+        void processPESHeader(PID, PIDContext&);
+
+        // Get a free reassembly buffer from the pool.
+        ByteBlockPtr getBuffer();
+
         // Implementation of TableHandlerInterface.
         virtual void handleTable(SectionDemux& demux, const BinaryTable& table) override;
 
         // Private members:
         PESHandlerInterface* _pes_handler;
+        bool                 _header_only;
         PIDContextMap        _pids;
+        std::vector<ByteBlockPtr> _buffers;  // Pool of reassembly buffers, free when not referenced elsewhere.
         StreamTypeMap        _stream_types;
         SectionDemux         _section_demux;
 
@@ -58,6 +58,17 @@ namespace ts {
         //!
         virtual void handlePESPacket(PESDemux& demux, const PESPacket& packet) {}
 
+        //!
+        //! This hook is invoked in header-only mode when a complete PES header is available.
+        //! The packet contains the complete PES header but only the beginning of the payload,
+        //! from the TS packets which were received so far (usually only the first one).
+        //! The index of the last TS packet of the PES packet is not yet known.
+        //! @param [in,out] demux A reference to the PES demux.
+        //! @param [in] packet The PES header and the beginning of the payload.
+        //! @see PESDemux::setHeaderOnly()
+        //!
+        virtual void handlePESHeader(PESDemux& demux, const PESPacket& packet) {}
+
         //!
         //! This hook is invoked when a video start code is encountered.
         //! @param [in,out] demux A reference to the PES demux.
@@ -0,0 +1,273 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Declare the ts::PIDMap template class.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsMPEG.h"
+
+namespace ts {
+    //!
+    //! A dense map of objects, indexed by PID value.
+    //! @ingroup mpeg
+    //!
+    //! This is a replacement for std::map<PID,T> in the packet processing paths of
+    //! demuxes and analyzers. All 8192 PID values are directly indexed, a lookup is
+    //! a single array access. The @a T instances are allocated only when a PID is
+    //! first used. The iteration is performed in increasing PID values, using a bitmap
+    //! of the allocated PID's.
+    //!
+    //! The interface is a subset of std::map<PID,T>. The value type is std::pair<const PID,T>.
+    //! The addresses of the elements are stable, as long as they are not erased. An iterator
+    //! remains valid after insertion or removal of other elements.
+    //!
+    //! @tparam T The type of objects to store for each PID.
+    //!
+    template <typename T>
+    class PIDMap
+    {
+    public:
+        typedef PID key_type;                        //!< Key type, always a PID.
+        typedef T mapped_type;                       //!< Type of stored objects.
+        typedef std::pair<const PID, T> value_type;  //!< Type of iterated elements.
+
+        //!
+        //! Generic iterator over a PIDMap.
+        //! @tparam MAP Either PIDMap or const PIDMap.
+        //! @tparam VALUE Either value_type or const value_type.
+        //!
+        template <class MAP, class VALUE>
+        class Iterator
+        {
+        public:
+            //!
+            //! Default constructor, an invalid iterator.
+            //!
+            Iterator() : _map(0), _pid(PID_MAX) {}
+
+            //!
+            //! Conversion constructor (typically from non-const to const iterator).
+            //! @param [in] other Another iterator.
+            //!
+            template <class MAP2, class VALUE2>
+            Iterator(const Iterator<MAP2,VALUE2>& other) : _map(other._map), _pid(other._pid) {}
+
+            //!
+            //! Dereference operator.
+            //! @return A reference to the current element.
+            //!
+            VALUE& operator*() const { return *_map->_slots[_pid]; }
+
+            //!
+            //! Access operator.
+            //! @return The address of the current element.
+            //!
+            VALUE* operator->() const { return _map->_slots[_pid]; }
+
+            //!
+            //! Pre-increment operator, move to next allocated PID.
+            //! @return A reference to this object.
+            //!
+            Iterator& operator++() { _pid = _map->nextPID(_pid + 1); return *this; }
+
+            //!
+            //! Post-increment operator, move to next allocated PID.
+            //! @return A copy of the previous iterator.
+            //!
+            Iterator operator++(int) { Iterator it(*this); ++*this; return it; }
+
+            //!
+            //! Equality operator.
+            //! @param [in] other Another iterator.
+            //! @return True if both iterators point to the same element.
+            //!
+            template <class MAP2, class VALUE2>
+            bool operator==(const Iterator<MAP2,VALUE2>& other) const { return _pid == other._pid; }
+
+            //!
+            //! Difference operator.
+            //! @param [in] other Another iterator.
+            //! @return True if both iterators point to different elements.
+            //!
+            template <class MAP2, class VALUE2>
+            bool operator!=(const Iterator<MAP2,VALUE2>& other) const { return _pid != other._pid; }
+
+        private:
+            template <class MAP2, class VALUE2> friend class Iterator;
+            friend class PIDMap;
+            MAP* _map;
+            PID  _pid;   // PID_MAX at end of map.
+            Iterator(MAP* map, PID pid) : _map(map), _pid(pid) {}
+        };
+
+        typedef Iterator<PIDMap, value_type> iterator;                    //!< Iterator type.
+        typedef Iterator<const PIDMap, const value_type> const_iterator;  //!< Constant iterator type.
+
+        //!
+        //! Default constructor, an empty map.
+        //!
+        PIDMap();
+
+        //!
+        //! Copy constructor.
+        //! @param [in] other Another map to copy.
+        //!
+        PIDMap(const PIDMap& other);
+
+        //!
+        //! Destructor.
+        //!
+        ~PIDMap() { clear(); }
+
+        //!
+        //! Assignment operator.
+        //! @param [in] other Another map to copy.
+        //! @return A reference to this object.
+        //!
+        PIDMap& operator=(const PIDMap& other);
+
+        //!
+        //! Get the number of allocated elements.
+        //! @return The number of allocated elements.
+        //!
+        size_t size() const { return _count; }
+
+        //!
+        //! Check if the map is empty.
+        //! @return True if the map is empty.
+        //!
+        bool empty() const { return _count == 0; }
+
+        //!
+        //! Access or create the element for a PID.
+        //! @param [in] pid A PID value, must be less than PID_MAX.
+        //! @return A reference to the element for @a pid. It is default-constructed if it did not exist.
+        //!
+        T& operator[](PID pid)
+        {
+            assert(pid < PID_MAX);
+            return _slots[pid] != 0 ? _slots[pid]->second : allocate(pid)->second;
+        }
+
+        //!
+        //! Get the element for a PID, if it exists.
+        //! @param [in] pid A PID value.
+        //! @return The address of the element for @a pid or zero if it does not exist.
+        //!
+        T* get(PID pid) { return pid < PID_MAX && _slots[pid] != 0 ? &_slots[pid]->second : 0; }
+
+        //!
+        //! Get the element for a PID, if it exists.
+        //! @param [in] pid A PID value.
+        //! @return The address of the element for @a pid or zero if it does not exist.
+        //!
+        const T* get(PID pid) const { return pid < PID_MAX && _slots[pid] != 0 ? &_slots[pid]->second : 0; }
+
+        //!
+        //! Find the element for a PID.
+        //! @param [in] pid A PID value.
+        //! @return An iterator to the element for @a pid or end() if it does not exist.
+        //!
+        iterator find(PID pid) { return iterator(this, pid < PID_MAX && _slots[pid] != 0 ? pid : PID_MAX); }
+
+        //!
+        //! Find the element for a PID.
+        //! @param [in] pid A PID value.
+        //! @return An iterator to the element for @a pid or end() if it does not exist.
+        //!
+        const_iterator find(PID pid) const { return const_iterator(this, pid < PID_MAX && _slots[pid] != 0 ? pid : PID_MAX); }
+
+        //!
+        //! Count the number of elements for a PID.
+        //! @param [in] pid A PID value.
+        //! @return 1 if the element for @a pid exists, 0 otherwise.
+        //!
+        size_t count(PID pid) const { return pid < PID_MAX && _slots[pid] != 0 ? 1 : 0; }
+
+        //!
+        //! Erase the element for a PID.
+        //! @param [in] pid A PID value.
+        //! @return The number of erased elements (0 or 1).
+        //!
+        size_t erase(PID pid);
+
+        //!
+        //! Erase the element at a given position.
+        //! @param [in] it An iterator to an existing element.
+        //!
+        void erase(const iterator& it) { erase(it._pid); }
+
+        //!
+        //! Erase all elements.
+        //!
+        void clear();
+
+        //!
+        //! Get an iterator to the element with the lowest PID value.
+        //! @return An iterator to the first element.
+        //!
+        iterator begin() { return iterator(this, nextPID(0)); }
+
+        //!
+        //! Get an iterator to the element with the lowest PID value.
+        //! @return A constant iterator to the first element.
+        //!
+        const_iterator begin() const { return const_iterator(this, nextPID(0)); }
+
+        //!
+        //! Get an iterator after the last element.
+        //! @return An iterator after the last element.
+        //!
+        iterator end() { return iterator(this, PID_MAX); }
+
+        //!
+        //! Get an iterator after the last element.
+        //! @return A constant iterator after the last element.
+        //!
+        const_iterator end() const { return const_iterator(this, PID_MAX); }
+
+    private:
+        static const size_t WORDS = PID_MAX / 64;
+
+        value_type* _slots[PID_MAX];  // Allocated elements, indexed by PID.
+        uint64_t    _bits[WORDS];     // Bitmap of allocated PID's.
+        size_t      _count;           // Number of allocated elements.
+
+        // Allocate a new element.
+        value_type* allocate(PID pid);
+
+        // Get the first allocated PID, starting at a given one, PID_MAX if there is none.
+        PID nextPID(size_t pid) const;
+    };
+}
+
+#include "tsPIDMapTemplate.h"
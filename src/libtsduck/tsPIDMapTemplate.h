@@ -0,0 +1,140 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#pragma once
+
+
+//----------------------------------------------------------------------------
+// Constructors and assignment.
+//----------------------------------------------------------------------------
+
+template <typename T>
+ts::PIDMap<T>::PIDMap() :
+    _slots(),
+    _bits(),
+    _count(0)
+{
+}
+
+template <typename T>
+ts::PIDMap<T>::PIDMap(const PIDMap& other) :
+    _slots(),
+    _bits(),
+    _count(0)
+{
+    *this = other;
+}
+
+template <typename T>
+ts::PIDMap<T>& ts::PIDMap<T>::operator=(const PIDMap& other)
+{
+    if (&other != this) {
+        clear();
+        for (const_iterator it = other.begin(); it != other.end(); ++it) {
+            allocate(it->first)->second = it->second;
+        }
+    }
+    return *this;
+}
+
+
+//----------------------------------------------------------------------------
+// Allocate a new element.
+//----------------------------------------------------------------------------
+
+template <typename T>
+typename ts::PIDMap<T>::value_type* ts::PIDMap<T>::allocate(PID pid)
+{
+    assert(_slots[pid] == 0);
+    _slots[pid] = new value_type(std::piecewise_construct, std::forward_as_tuple(pid), std::forward_as_tuple());
+    _bits[pid / 64] |= TS_UCONST64(1) << (pid % 64);
+    _count++;
+    return _slots[pid];
+}
+
+
+//----------------------------------------------------------------------------
+// Erase elements.
+//----------------------------------------------------------------------------
+
+template <typename T>
+size_t ts::PIDMap<T>::erase(PID pid)
+{
+    if (pid >= PID_MAX || _slots[pid] == 0) {
+        return 0;
+    }
+    else {
+        // Detach the element before deleting it, in case its destructor accesses the map.
+        value_type* const elem = _slots[pid];
+        _slots[pid] = 0;
+        _bits[pid / 64] &= ~(TS_UCONST64(1) << (pid % 64));
+        _count--;
+        delete elem;
+        return 1;
+    }
+}
+
+template <typename T>
+void ts::PIDMap<T>::clear()
+{
+    for (PID pid = nextPID(0); pid < PID_MAX; pid = nextPID(pid + 1)) {
+        erase(pid);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Get the first allocated PID, starting at a given one.
+//----------------------------------------------------------------------------
+
+template <typename T>
+ts::PID ts::PIDMap<T>::nextPID(size_t pid) const
+{
+    if (_count > 0) {
+        size_t index = pid / 64;
+        uint64_t word = index < WORDS ? _bits[index] & (~TS_UCONST64(0) << (pid % 64)) : 0;
+        while (index < WORDS) {
+            if (word != 0) {
+#if defined(TS_GCC)
+                return PID(64 * index + __builtin_ctzll(word));
+#else
+                size_t bit = 0;
+                while ((word & (TS_UCONST64(1) << bit)) == 0) {
+                    bit++;
+                }
+                return PID(64 * index + bit);
+#endif
+            }
+            if (++index < WORDS) {
+                word = _bits[index];
+            }
+        }
+    }
+    return PID_MAX;
+}
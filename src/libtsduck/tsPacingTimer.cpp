@@ -0,0 +1,100 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsPacingTimer.h"
+TSDUCK_SOURCE;
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+const ts::NanoSecond ts::PacingTimer::DEFAULT_MAX_SPIN;
+#endif
+
+namespace {
+    // Initial estimate of the wake-up latency of the system sleep.
+    const ts::NanoSecond INITIAL_LATENCY = 50000;
+
+    // Additional guard time before the due time when sleeping.
+    const ts::NanoSecond SLEEP_GUARD = 5000;
+
+    // The latency estimate decays by 1/2^LATENCY_DECAY of the difference when the wake-up is faster.
+    const int LATENCY_DECAY = 4;
+}
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+ts::PacingTimer::PacingTimer(NanoSecond max_spin) :
+    _max_spin(std::max<NanoSecond>(0, max_spin)),
+    _latency(INITIAL_LATENCY),
+    _slack_set(false)
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Wait until a given time of the monotonic clock.
+//----------------------------------------------------------------------------
+
+ts::NanoSecond ts::PacingTimer::waitUntil(const Monotonic& due, Monotonic& now)
+{
+#if defined(TS_LINUX)
+    // The default timer slack of a thread (50 microseconds) delays all wake-ups.
+    if (!_slack_set) {
+        ::prctl(PR_SET_TIMERSLACK, 1UL, 0UL, 0UL, 0UL);
+        _slack_set = true;
+    }
+#endif
+
+    now.getSystemTime();
+
+    // Sleep until a short time before the due time, if there is enough time for this.
+    const NanoSecond margin = _max_spin == 0 ? 0 : std::min(_latency + SLEEP_GUARD, _max_spin);
+    if (due - now > margin) {
+        Monotonic wake(due);
+        wake -= margin;
+        wake.wait();
+        now.getSystemTime();
+
+        // Calibrate the wake-up latency: follow increases, slowly decay.
+        const NanoSecond late = std::max<NanoSecond>(0, now - wake);
+        if (late > _latency) {
+            _latency = late;
+        }
+        else {
+            _latency -= (_latency - late) >> LATENCY_DECAY;
+        }
+    }
+
+    // Spin until the due time.
+    while (now < due) {
+        now.getSystemTime();
+    }
+    return now - due;
+}
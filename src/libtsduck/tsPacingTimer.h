@@ -0,0 +1,116 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  High-precision pacing timer, hybrid sleep and spin.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsMonotonic.h"
+
+namespace ts {
+    //!
+    //! High-precision pacing timer.
+    //! @ingroup system
+    //!
+    //! The system sleep functions wake up the calling thread with some latency,
+    //! typically several tens of microseconds, sometimes more. This is too coarse
+    //! to pace packets at high bitrates. A PacingTimer sleeps using the system
+    //! monotonic timer until a short time before the due time and then spins on
+    //! the monotonic clock until the due time.
+    //!
+    //! The duration of the final spin is adjusted from the observed wake-up
+    //! latency of the system: the timer keeps a calibrated estimate of the
+    //! latency which quickly follows increases and slowly decays. The duration
+    //! of the spin is bounded by a configurable maximum to limit the CPU usage.
+    //!
+    //! On Linux, the timer slack of the calling thread is reduced to its minimum
+    //! on the first wait. Since the timer slack is a thread attribute, a PacingTimer
+    //! should be used from one single thread.
+    //!
+    class TSDUCKDLL PacingTimer
+    {
+    public:
+        //!
+        //! Default maximum duration of the final spin in nanoseconds (200 microseconds).
+        //!
+        static const NanoSecond DEFAULT_MAX_SPIN = 200000;
+
+        //!
+        //! Constructor.
+        //! @param [in] max_spin Maximum duration of the final spin in nanoseconds.
+        //! With zero, there is no spin, the timer only relies on the system sleep.
+        //!
+        explicit PacingTimer(NanoSecond max_spin = DEFAULT_MAX_SPIN);
+
+        //!
+        //! Set the maximum duration of the final spin.
+        //! @param [in] max_spin Maximum duration of the final spin in nanoseconds.
+        //!
+        void setMaxSpin(NanoSecond max_spin) { _max_spin = std::max<NanoSecond>(0, max_spin); }
+
+        //!
+        //! Get the maximum duration of the final spin.
+        //! @return The maximum duration of the final spin in nanoseconds.
+        //!
+        NanoSecond maxSpin() const { return _max_spin; }
+
+        //!
+        //! Get the current estimate of the wake-up latency of the system sleep.
+        //! @return The estimated wake-up latency in nanoseconds.
+        //!
+        NanoSecond sleepLatency() const { return _latency; }
+
+        //!
+        //! Wait until a given time of the monotonic clock.
+        //! @param [in] due Due time.
+        //! @param [out] now Time of the monotonic clock when the method returns.
+        //! @return The lateness in nanoseconds, ie. the difference between @a now
+        //! and @a due, zero if the method returned on time.
+        //!
+        NanoSecond waitUntil(const Monotonic& due, Monotonic& now);
+
+        //!
+        //! Wait until a given time of the monotonic clock.
+        //! @param [in] due Due time.
+        //! @return The lateness in nanoseconds, zero if the method returned on time.
+        //!
+        NanoSecond waitUntil(const Monotonic& due)
+        {
+            Monotonic now;
+            return waitUntil(due, now);
+        }
+
+    private:
+        NanoSecond _max_spin;  // Maximum duration of the final spin.
+        NanoSecond _latency;   // Calibrated wake-up latency of the system sleep.
+        bool       _slack_set; // The timer slack of the thread was reduced.
+    };
+}
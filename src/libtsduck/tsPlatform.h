@@ -600,12 +600,35 @@
 #if defined(TS_LINUX)
 #include <limits.h>
 #include <sys/mman.h>
+#include <sys/syscall.h>
 #include <byteswap.h>
+#include <sys/prctl.h>
+#include <linux/mempolicy.h>
+#include <linux/net_tstamp.h>
 #include <linux/dvb/version.h>
 #include <linux/dvb/frontend.h>
 #include <linux/dvb/dmx.h>
 #endif
 
+#if defined(DOXYGEN) /* documentation only */
+    //!
+    //! Defined when io_uring is not available on the target platform.
+    //!
+    //! This symbol is automatically defined on non-Linux systems and when the
+    //! Linux kernel headers do not provide io_uring. It can also be defined by
+    //! the developer on the command line to compile without io_uring support.
+    //!
+    #define TS_NO_IO_URING
+#elif defined(TS_LINUX) && !defined(TS_NO_IO_URING) && defined(__has_include)
+    // <linux/io_uring.h> is not included here since it defines macros such
+    // as BLOCK_SIZE which conflict with TSDuck identifiers.
+    #if !__has_include(<linux/io_uring.h>) || !defined(__NR_io_uring_setup)
+        #define TS_NO_IO_URING 1
+    #endif
+#elif !defined(TS_NO_IO_URING)
+    #define TS_NO_IO_URING 1
+#endif
+
 #if defined(TS_MAC)
 #include <sys/mman.h>
 #include <libproc.h>
@@ -617,6 +640,7 @@
 #include <deque>
 #include <list>
 #include <map>
+#include <tuple>
 #include <set>
 #include <bitset>
 #include <algorithm>
@@ -629,6 +653,7 @@
 #include <sstream>
 #include <iostream>
 #include <exception>
+#include <atomic>
 
 #include <cassert>
 #include <cstdlib>
@@ -638,6 +663,7 @@
 #include <cstring>
 #include <cctype>
 #include <cstddef>     // size_t
+#include <cmath>
 #include <fcntl.h>
 
 
@@ -77,6 +77,23 @@ ts::ProcessorPlugin::ProcessorPlugin(TSP* tsp_,
 }
 
 
+//----------------------------------------------------------------------------
+// Default packet batch processing: process packets one by one.
+//----------------------------------------------------------------------------
+
+size_t ts::ProcessorPlugin::processPacketBatch(TSPacket* pkt, Status* status, size_t count, bool& flush, bool& bitrate_changed)
+{
+    size_t done = 0;
+    while (done < count && !flush) {
+        status[done] = processPacket(pkt[done], flush, bitrate_changed);
+        if (status[done++] == TSP_END) {
+            break;
+        }
+    }
+    return done;
+}
+
+
 //----------------------------------------------------------------------------
 // Report implementation.
 //----------------------------------------------------------------------------
@@ -86,7 +86,7 @@ namespace ts {
         //! @c int data named @c tspInterfaceVersion which contains the current
         //! interface version at the time the library is built.
         //!
-        static const int API_VERSION = 5;
+        static const int API_VERSION = 6;
 
         //!
         //! Get the current input bitrate in bits/seconds.
@@ -141,9 +141,9 @@ namespace ts {
         virtual bool thisJointTerminated() const = 0;
 
     protected:
-        bool          _use_realtime;  //!< The plugin should use realtime defaults.
-        BitRate       _tsp_bitrate;   //!< TSP input bitrate.
-        volatile bool _tsp_aborting;  //!< TSP is currently aborting.
+        bool              _use_realtime;  //!< The plugin should use realtime defaults.
+        BitRate           _tsp_bitrate;   //!< TSP input bitrate.
+        std::atomic<bool> _tsp_aborting;  //!< TSP is currently aborting, read by other plugin threads.
 
         //!
         //! Constructor for subclasses.
@@ -446,6 +446,69 @@ namespace ts {
         //!
         virtual Status processPacket(TSPacket& pkt, bool& flush, bool& bitrate_changed) = 0;
 
+        //!
+        //! Packet batch processing interface.
+        //!
+        //! The main application invokes processPacketBatch() to let the shared
+        //! library process a contiguous array of TS packets. None of these packets
+        //! were dropped by a previous packet processor.
+        //!
+        //! The default implementation invokes processPacket() on each packet. Plugins
+        //! with a cheap per-packet processing should override this method to avoid
+        //! the overhead of a virtual call and status handling per packet. The semantics
+        //! of each individual packet processing remains the same as processPacket().
+        //!
+        //! The processing of the batch stops after the first packet for which the
+        //! status is @link TSP_END @endlink or which sets @a flush to true. The remaining
+        //! packets will be passed again in a subsequent call.
+        //!
+        //! @param [in,out] pkt Address of the first TS packet to process.
+        //! @param [out] status Address of an array of @a count status values. On return,
+        //! the processing status of each processed packet.
+        //! @param [in] count Number of packets to process in @a pkt. Never zero.
+        //! @param [in,out] flush Initially set to false. If the method sets @a flush to true,
+        //! the last processed packet and all previously processed and buffered packets
+        //! should be passed to the next processor as soon as possible.
+        //! @param [in,out] bitrate_changed Initially set to false. If the method sets
+        //! @a bitrate_changed to true, tsp should call the getBitrate() callback as soon as possible.
+        //! @return The number of processed packets, from 1 to @a count.
+        //!
+        virtual size_t processPacketBatch(TSPacket* pkt, Status* status, size_t count, bool& flush, bool& bitrate_changed);
+
+        //!
+        //! Data parallelism capabilities of a packet processor.
+        //!
+        enum Parallelism {
+            PARALLEL_NONE   = 0,  //!< All packets must be processed in sequence by one single thread (default).
+            PARALLEL_PACKET = 1,  //!< Each packet can be processed independently of all others.
+            PARALLEL_PID    = 2   //!< Packets from distinct PID's can be processed independently, packets from the same PID in sequence.
+        };
+
+        //!
+        //! Get the data parallelism capabilities of the packet processor.
+        //!
+        //! When the plugin declares some data parallelism and tsp is instructed to
+        //! use more than one processing thread per plugin, processPacketBatch() is
+        //! concurrently invoked from several threads on disjoint sets of packets:
+        //! - @link PARALLEL_PACKET @endlink: Each thread processes a contiguous
+        //!   sub-range of the packet window of the plugin.
+        //! - @link PARALLEL_PID @endlink: The PID's are partitioned between the
+        //!   threads. All packets from a given PID are always processed by the same
+        //!   thread, in their order of appearance in the stream.
+        //!
+        //! A plugin shall declare some data parallelism only if its processPacketBatch()
+        //! is reentrant under these conditions, typically when the plugin keeps no
+        //! state between packets or only per-PID states. The processing status of
+        //! all packets is collected in stream order before passing packets to the
+        //! next plugin. Requests to flush are ignored in parallel processing.
+        //!
+        //! This method is invoked after start() and may depend on command line options.
+        //! The default implementation returns @link PARALLEL_NONE @endlink.
+        //!
+        //! @return The data parallelism of the plugin.
+        //!
+        virtual Parallelism getParallelism() {return PARALLEL_NONE;}
+
         //!
         //! Constructor.
         //!
@@ -31,6 +31,7 @@
 #include "tsApplicationSharedLibrary.h"
 #include "tsPluginSharedLibrary.h"
 #include "tsSysUtils.h"
+#include "tsjson.h"
 TSDUCK_SOURCE;
 
 TS_DEFINE_SINGLETON(ts::PluginRepository);
@@ -44,8 +45,50 @@ ts::PluginRepository::PluginRepository() :
     _sharedLibraryAllowed(true),
     _inputPlugins(),
     _processorPlugins(),
-    _outputPlugins()
+    _outputPlugins(),
+    _bundleChecked(false),
+    _cacheFile()
 {
+    // Default location of the plugin index, can be overridden (or disabled with an empty value).
+    const UString home(UserHomeDirectory());
+    const UString def(home.empty() ? UString() : home + PathSeparator + u".tsplugins.cache");
+    _cacheFile = EnvironmentExists(u"TSPLUGINS_CACHE") ? GetEnvironment(u"TSPLUGINS_CACHE") : def;
+}
+
+
+//----------------------------------------------------------------------------
+// Load the bundle of all plugins, once.
+//----------------------------------------------------------------------------
+
+void ts::PluginRepository::loadBundle(Report& report)
+{
+    if (!_sharedLibraryAllowed || _bundleChecked) {
+        return;
+    }
+    _bundleChecked = true;
+
+    // The static objects of the bundle register all its plugins when the library is loaded.
+    // Keep the previous state in case the bundle is incompatible.
+    const InputMap inputs(_inputPlugins);
+    const ProcessorMap processors(_processorPlugins);
+    const OutputMap outputs(_outputPlugins);
+
+    ApplicationSharedLibrary shlib(u"tsplugins", UString(), TS_PLUGINS_PATH, true, NULLREP);
+    if (!shlib.isLoaded()) {
+        // No bundle, this is not an error, plugins are individually loaded.
+        return;
+    }
+
+    const int* version = reinterpret_cast<const int*>(shlib.getSymbol("tspInterfaceVersion"));
+    if (version == 0 || *version != TSP::API_VERSION) {
+        report.error(u"incompatible API version in %s, bundled plugins ignored", {shlib.fileName()});
+        _inputPlugins = inputs;
+        _processorPlugins = processors;
+        _outputPlugins = outputs;
+    }
+    else {
+        report.debug(u"loaded plugin bundle %s", {shlib.fileName()});
+    }
 }
 
 
@@ -96,6 +139,9 @@ ts::PluginRepository::Register::Register(const char* name, NewOutputProfile allo
 
 ts::NewInputProfile ts::PluginRepository::getInput(const UString& name, Report& report)
 {
+    // Register all bundled plugins first.
+    loadBundle(report);
+
     // Search plugin in current cache.
     const InputMap::const_iterator it = _inputPlugins.find(name);
     if (it != _inputPlugins.end()) {
@@ -127,6 +173,9 @@ ts::NewInputProfile ts::PluginRepository::getInput(const UString& name, Report&
 
 ts::NewProcessorProfile ts::PluginRepository::getProcessor(const UString& name, Report& report)
 {
+    // Register all bundled plugins first.
+    loadBundle(report);
+
     // Search plugin in current cache.
     const ProcessorMap::const_iterator it = _processorPlugins.find(name);
     if (it != _processorPlugins.end()) {
@@ -158,6 +207,9 @@ ts::NewProcessorProfile ts::PluginRepository::getProcessor(const UString& name,
 
 ts::NewOutputProfile ts::PluginRepository::getOutput(const UString& name, Report& report)
 {
+    // Register all bundled plugins first.
+    loadBundle(report);
+
     // Search plugin in current cache.
     const OutputMap::const_iterator it = _outputPlugins.find(name);
     if (it != _outputPlugins.end()) {
@@ -199,6 +251,9 @@ void ts::PluginRepository::loadAllPlugins(Report& report)
         return;
     }
 
+    // Register all bundled plugins first.
+    loadBundle(report);
+
     // Get list of shared library files
     UStringVector files;
     ApplicationSharedLibrary::GetPluginList(files, u"tsplugin_", TS_PLUGINS_PATH);
@@ -216,6 +271,169 @@ void ts::PluginRepository::loadAllPlugins(Report& report)
 }
 
 
+//----------------------------------------------------------------------------
+// Load and save the plugin index file.
+//----------------------------------------------------------------------------
+
+bool ts::PluginRepository::loadCacheFile(CacheMap& cache, Report& report) const
+{
+    cache.clear();
+
+    UStringList lines;
+    json::ValuePtr root;
+    if (_cacheFile.empty() || !FileExists(_cacheFile) || !UString::Load(lines, _cacheFile) || !json::Parse(root, lines, report) || !root->isObject()) {
+        return false;
+    }
+
+    // An index from another API version is ignored.
+    if (root->value(u"version").toInteger(-1) != TSP::API_VERSION) {
+        return false;
+    }
+
+    const json::Value& files(root->value(u"files"));
+    for (size_t i = 0; i < files.size(); ++i) {
+        const json::Value& jf(files.at(i));
+        const UString path(jf.value(u"file").toString());
+        if (!path.empty()) {
+            CacheEntry& entry(cache[path]);
+            entry.size = jf.value(u"size").toInteger();
+            entry.mtime = jf.value(u"mtime").toInteger();
+            entry.name = jf.value(u"name").toString();
+            CacheCapability* const caps[] = {&entry.input, &entry.output, &entry.processor};
+            const UChar* const names[] = {u"input", u"output", u"processor"};
+            for (size_t c = 0; c < 3; ++c) {
+                const json::Value& jc(jf.value(names[c]));
+                caps[c]->present = jc.isObject();
+                caps[c]->stack = size_t(jc.value(u"stack").toInteger());
+                caps[c]->description = jc.value(u"description").toString();
+            }
+        }
+    }
+    return true;
+}
+
+bool ts::PluginRepository::saveCacheFile(const CacheMap& cache, Report& report) const
+{
+    if (_cacheFile.empty()) {
+        return true;
+    }
+
+    json::ValuePtr files(new json::Array);
+    for (CacheMap::const_iterator it = cache.begin(); it != cache.end(); ++it) {
+        const CacheEntry& entry(it->second);
+        json::ValuePtr jf(new json::Object);
+        jf->add(u"file", json::ValuePtr(new json::String(it->first)));
+        jf->add(u"size", json::ValuePtr(new json::Number(entry.size)));
+        jf->add(u"mtime", json::ValuePtr(new json::Number(entry.mtime)));
+        jf->add(u"name", json::ValuePtr(new json::String(entry.name)));
+        const CacheCapability* const caps[] = {&entry.input, &entry.output, &entry.processor};
+        const UChar* const names[] = {u"input", u"output", u"processor"};
+        for (size_t c = 0; c < 3; ++c) {
+            if (caps[c]->present) {
+                json::ValuePtr jc(new json::Object);
+                jc->add(u"stack", json::ValuePtr(new json::Number(int64_t(caps[c]->stack))));
+                jc->add(u"description", json::ValuePtr(new json::String(caps[c]->description)));
+                jf->add(names[c], jc);
+            }
+        }
+        files->set(jf);
+    }
+
+    json::Object root;
+    root.add(u"version", json::ValuePtr(new json::Number(TSP::API_VERSION)));
+    root.add(u"files", files);
+
+    // Write a temporary file and rename it, concurrent readers never see a partial index.
+    const UString tmp(UString::Format(u"%s.%d.tmp", {_cacheFile, CurrentProcessId()}));
+    UStringList lines;
+    lines.push_back(root.printed(2, report));
+    if (!UString::Save(lines, tmp)) {
+        report.debug(u"error creating plugin index %s", {tmp});
+        DeleteFile(tmp);
+        return false;
+    }
+    const ErrorCode err = RenameFile(tmp, _cacheFile);
+    if (err != SYS_SUCCESS) {
+        report.debug(u"error creating plugin index %s: %s", {_cacheFile, ErrorCodeMessage(err)});
+        DeleteFile(tmp);
+        return false;
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Update the plugin index from the plugin shared libraries.
+//----------------------------------------------------------------------------
+
+void ts::PluginRepository::updateCache(CacheMap& cache, Report& report)
+{
+    // Load the previous index. Rebuild it from scratch if it does not exist or is invalid.
+    bool modified = !loadCacheFile(cache, report);
+
+    // Get list of shared library files.
+    UStringVector files;
+    ApplicationSharedLibrary::GetPluginList(files, u"tsplugin_", TS_PLUGINS_PATH);
+
+    // Build a new index with all current files.
+    CacheMap current;
+    for (size_t i = 0; i < files.size(); ++i) {
+        const UString& path(files[i]);
+        const int64_t size = GetFileSize(path);
+        const int64_t mtime = GetFileModificationTimeUTC(path) - Time::Epoch;
+
+        // Reuse the previous entry if the file is unchanged.
+        const CacheMap::const_iterator prev = cache.find(path);
+        if (prev != cache.end() && prev->second.size == size && prev->second.mtime == mtime) {
+            current[path] = prev->second;
+            continue;
+        }
+
+        // New or modified file, load it to get its characteristics.
+        modified = true;
+        PluginSharedLibrary shlib(path, report);
+        if (shlib.isLoaded()) {
+            CacheEntry& entry(current[path]);
+            entry.size = size;
+            entry.mtime = mtime;
+            entry.name = shlib.moduleName();
+            if (shlib.new_input != 0) {
+                GetCapability(entry.input, shlib.new_input(0));
+            }
+            if (shlib.new_output != 0) {
+                GetCapability(entry.output, shlib.new_output(0));
+            }
+            if (shlib.new_processor != 0) {
+                GetCapability(entry.processor, shlib.new_processor(0));
+            }
+        }
+    }
+
+    // Removed files also modify the index.
+    modified = modified || current.size() != cache.size();
+    cache.swap(current);
+
+    if (modified) {
+        saveCacheFile(cache, report);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Instantiate a plugin to get its description and stack usage.
+//----------------------------------------------------------------------------
+
+void ts::PluginRepository::GetCapability(CacheCapability& cap, Plugin* plugin)
+{
+    if (plugin != 0) {
+        cap.present = true;
+        cap.stack = plugin->stackUsage();
+        cap.description = plugin->getDescription();
+        delete plugin;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // List all tsp processors.
 //----------------------------------------------------------------------------
@@ -226,26 +444,61 @@ ts::UString ts::PluginRepository::listPlugins(bool loadAll, Report& report, int
     UString out;
     out.reserve(5000);
 
-    // Load all shareable plugins first.
+    // Descriptions of all plugins, by capability.
+    DescriptionMap inputs;
+    DescriptionMap outputs;
+    DescriptionMap processors;
+
+    // Registered plugins, including bundled ones, are instantiated to get their description.
     if (loadAll) {
-        loadAllPlugins(report);
+        loadBundle(report);
+    }
+    if ((flags & LIST_INPUT) != 0) {
+        for (InputMap::const_iterator it = _inputPlugins.begin(); it != _inputPlugins.end(); ++it) {
+            CacheCapability cap;
+            GetCapability(cap, it->second(0));
+            inputs[it->first] = cap.description;
+        }
+    }
+    if ((flags & LIST_OUTPUT) != 0) {
+        for (OutputMap::const_iterator it = _outputPlugins.begin(); it != _outputPlugins.end(); ++it) {
+            CacheCapability cap;
+            GetCapability(cap, it->second(0));
+            outputs[it->first] = cap.description;
+        }
+    }
+    if ((flags & LIST_PACKET) != 0) {
+        for (ProcessorMap::const_iterator it = _processorPlugins.begin(); it != _processorPlugins.end(); ++it) {
+            CacheCapability cap;
+            GetCapability(cap, it->second(0));
+            processors[it->first] = cap.description;
+        }
     }
 
-    // Compute max name width of all plugins.
-    size_t name_width = 0;
-    if ((flags & LIST_COMPACT) == 0) {
-        if ((flags & LIST_INPUT) != 0) {
-            for (InputMap::const_iterator it = _inputPlugins.begin(); it != _inputPlugins.end(); ++it) {
-                name_width = std::max(name_width, it->first.width());
+    // Other plugin shared libraries are described by the index, without loading them.
+    if (loadAll && _sharedLibraryAllowed) {
+        CacheMap cache;
+        updateCache(cache, report);
+        for (CacheMap::const_iterator it = cache.begin(); it != cache.end(); ++it) {
+            const CacheEntry& entry(it->second);
+            if (entry.input.present && (flags & LIST_INPUT) != 0 && inputs.find(entry.name) == inputs.end()) {
+                inputs[entry.name] = entry.input.description;
             }
-        }
-        if ((flags & LIST_PACKET) != 0) {
-            for (ProcessorMap::const_iterator it = _processorPlugins.begin(); it != _processorPlugins.end(); ++it) {
-                name_width = std::max(name_width, it->first.width());
+            if (entry.output.present && (flags & LIST_OUTPUT) != 0 && outputs.find(entry.name) == outputs.end()) {
+                outputs[entry.name] = entry.output.description;
+            }
+            if (entry.processor.present && (flags & LIST_PACKET) != 0 && processors.find(entry.name) == processors.end()) {
+                processors[entry.name] = entry.processor.description;
             }
         }
-        if ((flags & LIST_OUTPUT) != 0) {
-            for (OutputMap::const_iterator it = _outputPlugins.begin(); it != _outputPlugins.end(); ++it) {
+    }
+
+    // Compute max name width of all plugins.
+    size_t name_width = 0;
+    if ((flags & LIST_COMPACT) == 0) {
+        const DescriptionMap* const maps[] = {&inputs, &outputs, &processors};
+        for (size_t i = 0; i < 3; ++i) {
+            for (DescriptionMap::const_iterator it = maps[i]->begin(); it != maps[i]->end(); ++it) {
                 name_width = std::max(name_width, it->first.width());
             }
         }
@@ -256,10 +509,8 @@ ts::UString ts::PluginRepository::listPlugins(bool loadAll, Report& report, int
         if ((flags & LIST_COMPACT) == 0) {
             out += u"\nList of tsp input plugins:\n\n";
         }
-        for (InputMap::const_iterator it = _inputPlugins.begin(); it != _inputPlugins.end(); ++it) {
-            Plugin* p = it->second(0);
-            ListOnePlugin(out, it->first, p, name_width, flags);
-            delete p;
+        for (DescriptionMap::const_iterator it = inputs.begin(); it != inputs.end(); ++it) {
+            ListOnePlugin(out, it->first, it->second, name_width, flags);
         }
     }
 
@@ -267,10 +518,8 @@ ts::UString ts::PluginRepository::listPlugins(bool loadAll, Report& report, int
         if ((flags & LIST_COMPACT) == 0) {
             out += u"\nList of tsp output plugins:\n\n";
         }
-        for (OutputMap::const_iterator it = _outputPlugins.begin(); it != _outputPlugins.end(); ++it) {
-            Plugin* p = it->second(0);
-            ListOnePlugin(out, it->first, p, name_width, flags);
-            delete p;
+        for (DescriptionMap::const_iterator it = outputs.begin(); it != outputs.end(); ++it) {
+            ListOnePlugin(out, it->first, it->second, name_width, flags);
         }
     }
 
@@ -278,10 +527,8 @@ ts::UString ts::PluginRepository::listPlugins(bool loadAll, Report& report, int
         if ((flags & LIST_COMPACT) == 0) {
             out += u"\nList of tsp packet processor plugins:\n\n";
         }
-        for (ProcessorMap::const_iterator it = _processorPlugins.begin(); it != _processorPlugins.end(); ++it) {
-            Plugin* p = it->second(0);
-            ListOnePlugin(out, it->first, p, name_width, flags);
-            delete p;
+        for (DescriptionMap::const_iterator it = processors.begin(); it != processors.end(); ++it) {
+            ListOnePlugin(out, it->first, it->second, name_width, flags);
         }
     }
 
@@ -293,19 +540,19 @@ ts::UString ts::PluginRepository::listPlugins(bool loadAll, Report& report, int
 // List one plugin.
 //----------------------------------------------------------------------------
 
-void ts::PluginRepository::ListOnePlugin(UString& out, const UString& name, Plugin* plugin, size_t name_width, int flags)
+void ts::PluginRepository::ListOnePlugin(UString& out, const UString& name, const UString& description, size_t name_width, int flags)
 {
     if ((flags & LIST_COMPACT) != 0) {
         out += name;
         out += u":";
-        out += plugin->getDescription();
+        out += description;
         out += u"\n";
     }
     else {
         out += u"  ";
         out += name.toJustifiedLeft(name_width + 1, u'.', false, 1);
         out += u" ";
-        out += plugin->getDescription();
+        out += description;
         out += u"\n";
     }
-}
\ No newline at end of file
+}
@@ -44,6 +44,17 @@ namespace ts {
     //!
     //! This class is a singleton. Use static Instance() method to access the single instance.
     //!
+    //! When dynamic loading is allowed, a shared library named @c tsplugins (if present
+    //! in the plugin search path) is loaded once, before searching individual plugins.
+    //! This library bundles all plugins of a distribution, statically registered, so that
+    //! no per-plugin shared library needs to be searched and loaded.
+    //!
+    //! Listing all plugins uses a persistent index of the plugin shared libraries (plugin
+    //! name, capabilities, description, stack usage). Only new or modified shared libraries
+    //! are loaded to update the index. The default index file is @c .tsplugins.cache in the
+    //! user's home directory. It can be overridden using the environment variable
+    //! @c TSPLUGINS_CACHE. An empty value disables the index.
+    //!
     class TSDUCKDLL PluginRepository
     {
         TS_DECLARE_SINGLETON(PluginRepository);
@@ -57,6 +68,18 @@ namespace ts {
         //!
         void setSharedLibraryAllowed(bool allowed) { _sharedLibraryAllowed = allowed; }
 
+        //!
+        //! Set the path of the persistent index of plugin shared libraries.
+        //! @param [in] path Index file path. When empty, no index is used.
+        //!
+        void setCacheFile(const UString& path) { _cacheFile = path; }
+
+        //!
+        //! Get the path of the persistent index of plugin shared libraries.
+        //! @return The index file path or an empty string when no index is used.
+        //!
+        UString cacheFile() const { return _cacheFile; }
+
         //!
         //! Register an input plugin.
         //! @param [in] name Plugin name.
@@ -144,7 +167,8 @@ namespace ts {
         //!
         //! List all tsp processors.
         //! This function is typically used to implement the <code>tsp -\-list-processors</code> option.
-        //! @param [in] loadAll When true, all available plugins are loaded first.
+        //! @param [in] loadAll When true, all available plugins are listed, using the
+        //! persistent index of plugin shared libraries. Only new or modified shared libraries are loaded.
         //! Ignored when dynamic loading of plugins is disabled.
         //! @param [in,out] report Where to report errors.
         //! @param [in] flags List options, an or'ed mask of ListFlags values.
@@ -198,8 +222,46 @@ namespace ts {
         InputMap     _inputPlugins;
         ProcessorMap _processorPlugins;
         OutputMap    _outputPlugins;
+        bool         _bundleChecked;
+        UString      _cacheFile;
+
+        // Description of one capability of a plugin shared library in the index.
+        struct CacheCapability
+        {
+            bool    present;
+            size_t  stack;
+            UString description;
+            CacheCapability() : present(false), stack(0), description() {}
+        };
+
+        // Description of one plugin shared library in the index.
+        struct CacheEntry
+        {
+            int64_t         size;
+            int64_t         mtime;
+            UString         name;
+            CacheCapability input;
+            CacheCapability output;
+            CacheCapability processor;
+            CacheEntry() : size(0), mtime(0), name(), input(), output(), processor() {}
+        };
+        typedef std::map<UString, CacheEntry> CacheMap;
+
+        // Descriptions of plugins to list, indexed by name.
+        typedef std::map<UString, UString> DescriptionMap;
+
+        // Load the bundle of all plugins, once.
+        void loadBundle(Report& report);
+
+        // Load the plugin index file, update it from the plugin shared libraries, save it when modified.
+        void updateCache(CacheMap& cache, Report& report);
+        bool loadCacheFile(CacheMap& cache, Report& report) const;
+        bool saveCacheFile(const CacheMap& cache, Report& report) const;
+
+        // Instantiate a plugin to get its description and stack usage.
+        static void GetCapability(CacheCapability& cap, Plugin* plugin);
 
         // List one plugin.
-        static void ListOnePlugin(UString& out, const UString& name, Plugin* plugin, size_t name_width, int flags);
+        static void ListOnePlugin(UString& out, const UString& name, const UString& description, size_t name_width, int flags);
     };
 }
@@ -126,7 +126,9 @@ namespace ts {
         //!
         //! Subclasses should override writeLog() to implement a specific reporting
         //! device. It is not necessary to override log() unless the subclass needs
-        //! to implement a different severity filtering policy.
+        //! to implement a different severity filtering policy. Such a policy shall
+        //! never report messages above maxSeverity() since the macros TS_LOG() and
+        //! TS_DEBUG() drop these messages without calling log().
         //!
         //! @param [in] severity Message severity.
         //! @param [in] msg Message text.
@@ -324,3 +326,38 @@ namespace ts {
         virtual void writeLog(int severity, const UString& msg) = 0;
     };
 }
+
+//!
+//! @hideinitializer
+//! Report a message with a printf-like interface, only when its severity is reported.
+//!
+//! The arguments of the message are evaluated and log() is called only when the
+//! severity of the message does not exceed the maximum severity of the report.
+//! Otherwise, the cost of the message is only one comparison. This macro shall be
+//! used in performance-critical code paths, typically for debug messages which are
+//! logged for each packet or each buffer.
+//!
+//! Example:
+//! @code
+//! TS_LOG(report, 10, u"received %d bytes from %s", {size, sender.toString()});
+//! @endcode
+//!
+//! @param [in,out] report A ts::Report object (not a pointer).
+//! @param [in] severity Message severity.
+//! @param ... Message text or format string and list of arguments, as in ts::Report::log().
+//!
+#define TS_LOG(report, severity, ...)                               \
+    do {                                                            \
+        if ((severity) <= (report).maxSeverity()) {                 \
+            (report).log((severity), __VA_ARGS__);                  \
+        }                                                           \
+    } while (false)
+
+//!
+//! @hideinitializer
+//! Report a debug message with a printf-like interface, only when debug messages are reported.
+//! @param [in,out] report A ts::Report object (not a pointer).
+//! @param ... Message text or format string and list of arguments, as in ts::Report::debug().
+//! @see TS_LOG()
+//!
+#define TS_DEBUG(report, ...) TS_LOG(report, ts::Severity::Debug, __VA_ARGS__)
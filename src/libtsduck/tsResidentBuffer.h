@@ -50,8 +50,10 @@ namespace ts {
         //! Abort application if memory allocation fails.
         //! Do not abort if memory locking fails.
         //! @param [in] elem_count Number of @a T elements.
+        //! @param [in] numa_node If not negative, the buffer is preferably allocated on this
+        //! NUMA node. Do not abort if the NUMA placement fails. See ts::SetMemoryNUMANode().
         //!
-        ResidentBuffer(size_t elem_count);
+        ResidentBuffer(size_t elem_count, int numa_node = -1);
 
         //!
         //! Destructor.
@@ -76,6 +78,16 @@ namespace ts {
             return _error_code;
         }
 
+        //!
+        //! Get error code of the NUMA placement.
+        //! @return The system error code when the NUMA placement failed, SYS_SUCCESS
+        //! on success or when no NUMA node was specified.
+        //!
+        ErrorCode numaErrorCode() const
+        {
+            return _numa_error;
+        }
+
         //!
         //! Return base address of the buffer.
         //! @return The address of the first @a T element in the buffer.
@@ -109,6 +121,7 @@ namespace ts {
         size_t    _elem_count;       // Element count in locked region
         bool      _is_locked;        // False if mlock failed.
         ErrorCode _error_code;       // Lock error code
+        ErrorCode _numa_error;       // NUMA placement error code
     };
 
 }
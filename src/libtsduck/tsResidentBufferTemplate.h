@@ -46,7 +46,7 @@
 //----------------------------------------------------------------------------
 
 template <typename T>
-ts::ResidentBuffer<T>::ResidentBuffer(size_t elem_count) :
+ts::ResidentBuffer<T>::ResidentBuffer(size_t elem_count, int numa_node) :
     _allocated_base(0),
     _locked_base(0),
     _base(0),
@@ -54,7 +54,8 @@ ts::ResidentBuffer<T>::ResidentBuffer(size_t elem_count) :
     _locked_size(0),
     _elem_count(elem_count),
     _is_locked(false),
-    _error_code(SYS_SUCCESS)
+    _error_code(SYS_SUCCESS),
+    _numa_error(SYS_SUCCESS)
 {
     const size_t requested_size = elem_count * sizeof(T);
     const size_t page_size = SysInfo::Instance()->memoryPageSize();
@@ -70,6 +71,12 @@ ts::ResidentBuffer<T>::ResidentBuffer(size_t elem_count) :
     _locked_base = (char*)(RoundUp(uint64_t(_allocated_base), uint64_t(page_size)));
     _locked_size = RoundUp(requested_size, page_size);
 
+    // Place the memory pages on the requested NUMA node before initializing them.
+
+    if (numa_node >= 0) {
+        _numa_error = SetMemoryNUMANode(_locked_base, _locked_size, numa_node);
+    }
+
     _base = new (_locked_base) T[elem_count];
 
     // Integrity checks
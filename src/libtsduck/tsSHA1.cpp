@@ -14,6 +14,8 @@
 //----------------------------------------------------------------------------
 
 #include "tsSHA1.h"
+#include "tsSHANI.h"
+#include "tsSHAMultiBuffer.h"
 TSDUCK_SOURCE;
 
 #define F0(x,y,z)  (z ^ (x & (y ^ z)))
@@ -22,6 +24,61 @@ TSDUCK_SOURCE;
 #define F3(x,y,z)  (x ^ y ^ z)
 
 
+//----------------------------------------------------------------------------
+// Implementations of the SHA-1 computation.
+//----------------------------------------------------------------------------
+
+namespace {
+    // Initial hash state.
+    const uint32_t init_state[5] = {
+        0x67452301UL,
+        0xEFCDAB89UL,
+        0x98BADCFEUL,
+        0x10325476UL,
+        0xC3D2E1F0UL
+    };
+
+    // SHA-NI compression and AVX2 multi-buffer compression functions, zero if not supported.
+    const ts::SHACompressFunction compress_ni = ts::SHA1CompressNI();
+    const ts::SHAMultiCompressFunction multi_avx2 = ts::SHA1MultiAVX2();
+
+    // Current implementation. Before static initialization of this module (from other
+    // static initializers), this variable is zero, meaning SCALAR, which is always safe.
+    ts::SHA1::Implementation current_impl =
+        compress_ni != 0 ? ts::SHA1::SHANI : (multi_avx2 != 0 ? ts::SHA1::AVX2 : ts::SHA1::SCALAR);
+}
+
+bool ts::SHA1::IsSupported(Implementation impl)
+{
+    switch (impl) {
+        case SCALAR:
+            return true;
+        case SHANI:
+            return compress_ni != 0;
+        case AVX2:
+            return multi_avx2 != 0;
+        default:
+            return false;
+    }
+}
+
+ts::SHA1::Implementation ts::SHA1::GetImplementation()
+{
+    return current_impl;
+}
+
+bool ts::SHA1::SetImplementation(Implementation impl)
+{
+    if (IsSupported(impl)) {
+        current_impl = impl;
+        return true;
+    }
+    else {
+        return false;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Constructor
 //----------------------------------------------------------------------------
@@ -41,13 +98,9 @@ ts::SHA1::SHA1() :
 
 bool ts::SHA1::init()
 {
-    _state[0] = 0x67452301UL;
-    _state[1] = 0xEFCDAB89UL;
-    _state[2] = 0x98BADCFEUL;
-    _state[3] = 0x10325476UL;
-    _state[4] = 0xC3D2E1F0UL;
     _curlen = 0;
     _length = 0;
+    ::memcpy(_state, init_state, sizeof(_state));  // Flawfinder: ignore: memcpy()
     return true;
 }
 
@@ -133,6 +186,23 @@ void ts::SHA1::compress(const uint8_t* buf)
 }
 
 
+//----------------------------------------------------------------------------
+// Compress consecutive blocks, using the current implementation.
+//----------------------------------------------------------------------------
+
+void ts::SHA1::compressBlocks(const uint8_t* data, size_t count)
+{
+    if (current_impl == SHANI) {
+        compress_ni(_state, data, count);
+    }
+    else {
+        for (; count > 0; --count, data += BLOCK_SIZE) {
+            compress(data);
+        }
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Add some part of the message to hash. Can be called several times.
 // Return true on success, false on error.
@@ -148,10 +218,12 @@ bool ts::SHA1::add(const void* data, size_t size)
     }
     while (size > 0) {
         if (_curlen == 0 && size >= BLOCK_SIZE) {
-            compress (in);
-            _length += BLOCK_SIZE * 8;
-            in += BLOCK_SIZE;
-            size -= BLOCK_SIZE;
+            // Compress all complete blocks directly from the message.
+            const size_t count = size / BLOCK_SIZE;
+            compressBlocks(in, count);
+            _length += count * BLOCK_SIZE * 8;
+            in += count * BLOCK_SIZE;
+            size -= count * BLOCK_SIZE;
         }
         else {
             n = std::min(size, (BLOCK_SIZE - _curlen));
@@ -160,7 +232,7 @@ bool ts::SHA1::add(const void* data, size_t size)
             in += n;
             size -= n;
             if (_curlen == BLOCK_SIZE) {
-                compress (_buf);
+                compressBlocks(_buf, 1);
                 _length += 8 * BLOCK_SIZE;
                 _curlen = 0;
             }
@@ -196,7 +268,7 @@ bool ts::SHA1::getHash (void* hash, size_t bufsize, size_t* retsize)
         while (_curlen < 64) {
             _buf[_curlen++] = 0;
         }
-        compress (_buf);
+        compressBlocks(_buf, 1);
         _curlen = 0;
     }
 
@@ -207,7 +279,7 @@ bool ts::SHA1::getHash (void* hash, size_t bufsize, size_t* retsize)
 
     /* store length */
     PutUInt64 (_buf + 56, _length);
-    compress (_buf);
+    compressBlocks(_buf, 1);
 
     /* copy output */
     uint8_t* out = reinterpret_cast<uint8_t*> (hash);
@@ -220,3 +292,20 @@ bool ts::SHA1::getHash (void* hash, size_t bufsize, size_t* retsize)
     }
     return true;
 }
+
+
+//----------------------------------------------------------------------------
+// Compute the hashes of several independent messages.
+//----------------------------------------------------------------------------
+
+bool ts::SHA1::hashBatch(const void* const* data, const size_t* sizes, size_t count, void* hashes, size_t hashes_maxsize)
+{
+    if (current_impl == AVX2 && count > 1 && hashes_maxsize >= count * HASH_SIZE) {
+        // Interleave the messages in the lanes of the AVX2 multi-buffer implementation.
+        SHAMultiBufferHash(multi_avx2, init_state, HASH_SIZE / 4, data, sizes, count, reinterpret_cast<uint8_t*>(hashes));
+        return true;
+    }
+    else {
+        return Hash::hashBatch(data, sizes, count, hashes, hashes_maxsize);
+    }
+}
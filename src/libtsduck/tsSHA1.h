@@ -53,12 +53,46 @@ namespace ts {
         virtual bool init() override;
         virtual bool add(const void* data, size_t size) override;
         virtual bool getHash(void* hash, size_t bufsize, size_t* retsize = 0) override;
+        virtual bool hashBatch(const void* const* data, const size_t* sizes, size_t count, void* hashes, size_t hashes_maxsize) override;
+
+        //!
+        //! Implementations of the SHA-1 computation.
+        //! The fastest implementation which is supported by the CPU is selected at startup.
+        //!
+        enum Implementation {
+            SCALAR,  //!< Portable implementation, the reference one.
+            SHANI,   //!< SHA-NI instructions on x86 CPU's.
+            AVX2     //!< Portable implementation for one message, AVX2 multi-buffer for batches of messages in hashBatch().
+        };
+
+        //!
+        //! Check if an implementation of SHA-1 is supported on this system.
+        //! @param [in] impl The implementation to check.
+        //! @return True if @a impl is supported.
+        //!
+        static bool IsSupported(Implementation impl);
+
+        //!
+        //! Get the current implementation of SHA-1.
+        //! @return The current implementation.
+        //!
+        static Implementation GetImplementation();
+
+        //!
+        //! Select the implementation of SHA-1.
+        //! This is a global setting which is typically used for tests and benchmarks.
+        //! It shall not be changed while hashes are computed in other threads.
+        //! @param [in] impl The implementation to use.
+        //! @return True on success, false if @a impl is not supported (unchanged implementation).
+        //!
+        static bool SetImplementation(Implementation impl);
 
         //! Constructor
         SHA1();
 
     private:
         void compress(const uint8_t* buf);
+        void compressBlocks(const uint8_t* data, size_t count);
         uint64_t _length;
         uint32_t _state[HASH_SIZE / 4];
         size_t   _curlen;
@@ -14,6 +14,8 @@
 //----------------------------------------------------------------------------
 
 #include "tsSHA256.h"
+#include "tsSHANI.h"
+#include "tsSHAMultiBuffer.h"
 TSDUCK_SOURCE;
 
 #define Ch(x,y,z)  (z ^ (x & (y ^ z)))
@@ -26,6 +28,64 @@ TSDUCK_SOURCE;
 #define Gamma1(x)  (S(x, 17) ^ S(x, 19) ^ R(x, 10))
 
 
+//----------------------------------------------------------------------------
+// Implementations of the SHA-256 computation.
+//----------------------------------------------------------------------------
+
+namespace {
+    // Initial hash state.
+    const uint32_t init_state[8] = {
+        0x6A09E667UL,
+        0xBB67AE85UL,
+        0x3C6EF372UL,
+        0xA54FF53AUL,
+        0x510E527FUL,
+        0x9B05688CUL,
+        0x1F83D9ABUL,
+        0x5BE0CD19UL
+    };
+
+    // SHA-NI compression and AVX2 multi-buffer compression functions, zero if not supported.
+    const ts::SHACompressFunction compress_ni = ts::SHA256CompressNI();
+    const ts::SHAMultiCompressFunction multi_avx2 = ts::SHA256MultiAVX2();
+
+    // Current implementation. Before static initialization of this module (from other
+    // static initializers), this variable is zero, meaning SCALAR, which is always safe.
+    ts::SHA256::Implementation current_impl =
+        compress_ni != 0 ? ts::SHA256::SHANI : (multi_avx2 != 0 ? ts::SHA256::AVX2 : ts::SHA256::SCALAR);
+}
+
+bool ts::SHA256::IsSupported(Implementation impl)
+{
+    switch (impl) {
+        case SCALAR:
+            return true;
+        case SHANI:
+            return compress_ni != 0;
+        case AVX2:
+            return multi_avx2 != 0;
+        default:
+            return false;
+    }
+}
+
+ts::SHA256::Implementation ts::SHA256::GetImplementation()
+{
+    return current_impl;
+}
+
+bool ts::SHA256::SetImplementation(Implementation impl)
+{
+    if (IsSupported(impl)) {
+        current_impl = impl;
+        return true;
+    }
+    else {
+        return false;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Constructor
 //----------------------------------------------------------------------------
@@ -47,14 +107,7 @@ bool ts::SHA256::init()
 {
     _curlen = 0;
     _length = 0;
-    _state[0] = 0x6A09E667UL;
-    _state[1] = 0xBB67AE85UL;
-    _state[2] = 0x3C6EF372UL;
-    _state[3] = 0xA54FF53AUL;
-    _state[4] = 0x510E527FUL;
-    _state[5] = 0x9B05688CUL;
-    _state[6] = 0x1F83D9ABUL;
-    _state[7] = 0x5BE0CD19UL;
+    ::memcpy(_state, init_state, sizeof(_state));  // Flawfinder: ignore: memcpy()
     return true;
 }
 
@@ -163,6 +216,23 @@ void ts::SHA256::compress (const uint8_t* buf)
 }
 
 
+//----------------------------------------------------------------------------
+// Compress consecutive blocks, using the current implementation.
+//----------------------------------------------------------------------------
+
+void ts::SHA256::compressBlocks(const uint8_t* data, size_t count)
+{
+    if (current_impl == SHANI) {
+        compress_ni(_state, data, count);
+    }
+    else {
+        for (; count > 0; --count, data += BLOCK_SIZE) {
+            compress(data);
+        }
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Add some part of the message to hash. Can be called several times.
 // Return true on success, false on error.
@@ -178,10 +248,12 @@ bool ts::SHA256::add (const void* data, size_t size)
     }
     while (size > 0) {
         if (_curlen == 0 && size >= BLOCK_SIZE) {
-            compress (in);
-            _length += BLOCK_SIZE * 8;
-            in += BLOCK_SIZE;
-            size -= BLOCK_SIZE;
+            // Compress all complete blocks directly from the message.
+            const size_t count = size / BLOCK_SIZE;
+            compressBlocks(in, count);
+            _length += count * BLOCK_SIZE * 8;
+            in += count * BLOCK_SIZE;
+            size -= count * BLOCK_SIZE;
         }
         else {
             n = std::min (size, (BLOCK_SIZE - _curlen));
@@ -190,7 +262,7 @@ bool ts::SHA256::add (const void* data, size_t size)
             in += n;
             size -= n;
             if (_curlen == BLOCK_SIZE) {
-                compress (_buf);
+                compressBlocks(_buf, 1);
                 _length += 8 * BLOCK_SIZE;
                 _curlen = 0;
             }
@@ -226,7 +298,7 @@ bool ts::SHA256::getHash (void* hash, size_t bufsize, size_t* retsize)
         while (_curlen < 64) {
             _buf[_curlen++] = 0;
         }
-        compress (_buf);
+        compressBlocks(_buf, 1);
         _curlen = 0;
     }
 
@@ -237,7 +309,7 @@ bool ts::SHA256::getHash (void* hash, size_t bufsize, size_t* retsize)
 
     /* store length */
     PutUInt64 (_buf + 56, _length);
-    compress (_buf);
+    compressBlocks(_buf, 1);
 
     /* copy output */
     uint8_t* out = reinterpret_cast<uint8_t*> (hash);
@@ -250,3 +322,20 @@ bool ts::SHA256::getHash (void* hash, size_t bufsize, size_t* retsize)
     }
     return true;
 }
+
+
+//----------------------------------------------------------------------------
+// Compute the hashes of several independent messages.
+//----------------------------------------------------------------------------
+
+bool ts::SHA256::hashBatch(const void* const* data, const size_t* sizes, size_t count, void* hashes, size_t hashes_maxsize)
+{
+    if (current_impl == AVX2 && count > 1 && hashes_maxsize >= count * HASH_SIZE) {
+        // Interleave the messages in the lanes of the AVX2 multi-buffer implementation.
+        SHAMultiBufferHash(multi_avx2, init_state, HASH_SIZE / 4, data, sizes, count, reinterpret_cast<uint8_t*>(hashes));
+        return true;
+    }
+    else {
+        return Hash::hashBatch(data, sizes, count, hashes, hashes_maxsize);
+    }
+}
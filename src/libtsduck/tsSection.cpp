@@ -259,6 +259,24 @@ size_t ts::Section::SectionSize(const void* content, size_t content_size)
 }
 
 
+//----------------------------------------------------------------------------
+// Reload from full binary content.
+//----------------------------------------------------------------------------
+
+void ts::Section::reload(const void* content, size_t content_size, PID source_pid, CRC32::Validation crc_op)
+{
+    if (!_data.isNull() && _data.count() == 1) {
+        // The data buffer is not shared with another section, reuse it.
+        const ByteBlockPtr data(_data);
+        data->copy(content, content_size);
+        initialize(data, source_pid, crc_op);
+    }
+    else {
+        initialize(new ByteBlock(content, content_size), source_pid, crc_op);
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Private method: Helper for constructors.
 //----------------------------------------------------------------------------
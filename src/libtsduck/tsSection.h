@@ -154,6 +154,7 @@ namespace ts {
         //!
         //! Reload from full binary content.
         //! The content is copied into the section if valid.
+        //! The previous data buffer of the section is reused if it is not shared.
         //! @param [in] content Address of the binary section data.
         //! @param [in] content_size Size in bytes of the section.
         //! @param [in] source_pid PID from which the section was read.
@@ -162,10 +163,7 @@ namespace ts {
         void reload(const void* content,
                     size_t content_size,
                     PID source_pid = PID_NULL,
-                    CRC32::Validation crc_op = CRC32::IGNORE)
-        {
-            initialize(new ByteBlock(content, content_size), source_pid, crc_op);
-        }
+                    CRC32::Validation crc_op = CRC32::IGNORE);
 
         //!
         //! Reload from full binary content.
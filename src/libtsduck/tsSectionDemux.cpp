@@ -194,7 +194,8 @@ ts::SectionDemux::SectionDemux(TableHandlerInterface* table_handler,
     _table_handler(table_handler),
     _section_handler(section_handler),
     _pids(),
-    _status()
+    _status(),
+    _free_sections()
 {
 }
 
@@ -211,6 +212,7 @@ void ts::SectionDemux::immediateReset()
 {
     SuperClass::immediateReset();
     _pids.clear();
+    _free_sections.clear();
 }
 
 void ts::SectionDemux::immediateResetPID(PID pid)
@@ -341,14 +343,18 @@ void ts::SectionDemux::processPacket(const TSPacket& pkt)
         pc.sync = true;
     }
 
-    // Copy TS packet payload in PID context
+    // Locate TS buffer by address and size. When there is no pending section data
+    // in the PID context, the sections are analyzed directly in the TS packet,
+    // without copy. Otherwise, the TS packet payload is appended to the PID context.
 
-    pc.ts.append (payload, payload_size);
+    const uint8_t* ts_start = payload;
+    size_t ts_size = payload_size;
 
-    // Locate TS buffer by address and size.
-
-    const uint8_t* ts_start = pc.ts.data();
-    size_t ts_size = pc.ts.size();
+    if (!pc.ts.empty()) {
+        pc.ts.append(payload, payload_size);
+        ts_start = pc.ts.data();
+        ts_size = pc.ts.size();
+    }
 
     // If current packet has a PUSI, locate start of this new section
     // inside the TS buffer. This is not useful to locate the section but
@@ -461,7 +467,7 @@ void ts::SectionDemux::processPacket(const TSPacket& pkt)
             SectionPtr sect_ptr;
 
             if (section_ok && (_section_handler != 0 || tc.sects[section_number].isNull())) {
-                sect_ptr = new Section(ts_start, section_length, pid, CRC32::CHECK);
+                sect_ptr = newSection(ts_start, section_length, pid);
                 sect_ptr->setFirstTSPacketIndex(pusi_pkt_index);
                 sect_ptr->setLastTSPacketIndex(_packet_count);
                 if (!sect_ptr->isValid()) {
@@ -498,6 +504,9 @@ void ts::SectionDemux::processPacket(const TSPacket& pkt)
             if (afterCallingHandler(true)) {
                 return;  // the PID of this packet or the complete demux was reset.
             }
+
+            // If the section was only used by the section handler, reuse it later.
+            recycleSection(sect_ptr);
         }
 
         // Move to next section in the buffer
@@ -523,6 +532,10 @@ void ts::SectionDemux::processPacket(const TSPacket& pkt)
         // TS buffer becomes empty
         pc.ts.clear();
     }
+    else if (pc.ts.empty()) {
+        // Sections were analyzed in the TS packet, keep the start of the incomplete section.
+        pc.ts.copy(ts_start, ts_size);
+    }
     else if (ts_start > pc.ts.data()) {
         // Remove start of TS buffer
         pc.ts.erase(0, ts_start - pc.ts.data());
@@ -530,6 +543,39 @@ void ts::SectionDemux::processPacket(const TSPacket& pkt)
 }
 
 
+//----------------------------------------------------------------------------
+// Pool of free sections.
+//----------------------------------------------------------------------------
+
+namespace {
+    // Maximum number of free sections to keep.
+    const size_t MAX_FREE_SECTIONS = 16;
+}
+
+ts::SectionPtr ts::SectionDemux::newSection(const uint8_t* data, size_t size, PID pid)
+{
+    if (_free_sections.empty()) {
+        return new Section(data, size, pid, CRC32::CHECK);
+    }
+    else {
+        // Reuse a free section and its data buffer.
+        SectionPtr sect(_free_sections.back());
+        _free_sections.pop_back();
+        sect->reload(data, size, pid, CRC32::CHECK);
+        return sect;
+    }
+}
+
+void ts::SectionDemux::recycleSection(SectionPtr& sect)
+{
+    // The section may be reused only when the caller holds the only reference.
+    if (!sect.isNull() && sect.count() == 1 && _free_sections.size() < MAX_FREE_SECTIONS) {
+        _free_sections.push_back(sect);
+    }
+    sect.clear();
+}
+
+
 //----------------------------------------------------------------------------
 // Pack sections and in all incomplete tables and notify these rebuilt tables.
 //----------------------------------------------------------------------------
@@ -35,6 +35,7 @@
 #pragma once
 #include "tsAbstractDemux.h"
 #include "tsETID.h"
+#include "tsPIDMap.h"
 #include "tsTableHandlerInterface.h"
 #include "tsSectionHandlerInterface.h"
 
@@ -180,6 +181,12 @@ namespace ts {
         // Feed the depacketizer with a TS packet (PID already filtered).
         void processPacket(const TSPacket&);
 
+        // Get a new section, from the pool of free sections when possible.
+        SectionPtr newSection(const uint8_t* data, size_t size, PID pid);
+
+        // Return a section to the pool of free sections if nobody else references it.
+        void recycleSection(SectionPtr& sect);
+
         // This internal structure contains the analysis context for one TID/TIDext into one PID.
         struct ETIDContext
         {
@@ -220,8 +227,9 @@ namespace ts {
         // Private members:
         TableHandlerInterface*   _table_handler;
         SectionHandlerInterface* _section_handler;
-        std::map<PID,PIDContext> _pids;
+        PIDMap<PIDContext>       _pids;
         Status                   _status;
+        SectionPtrVector         _free_sections;  // Pool of free sections, reused to avoid reallocations.
 
         // Inacessible operations
         SectionDemux(const SectionDemux&) = delete;
@@ -38,6 +38,10 @@
 #include "tsTablesDisplay.h"
 #include "tsTablesFactory.h"
 #include "tsSysUtils.h"
+#include "tsxmlReader.h"
+#include "tsxmlWriter.h"
+#include "tsxmlElement.h"
+#include "tsxmlText.h"
 TSDUCK_SOURCE;
 
 
@@ -277,15 +281,18 @@ bool ts::SectionFile::saveBinary(std::ostream& strm, Report& report) const
 bool ts::SectionFile::loadXML(const UString& file_name, Report& report, const DVBCharset* charset)
 {
     clear();
-    xml::Document doc(report);
-    return doc.load(file_name, false) && parseDocument(doc, charset);
+    std::ifstream strm(file_name.toUTF8().c_str(), std::ios::in | std::ios::binary);
+    if (!strm.is_open()) {
+        report.error(u"cannot open %s", {file_name});
+        return false;
+    }
+    return parseStream(strm, report, charset);
 }
 
 bool ts::SectionFile::loadXML(std::istream& strm, Report& report, const DVBCharset* charset)
 {
     clear();
-    xml::Document doc(report);
-    return doc.load(strm) && parseDocument(doc, charset);
+    return parseStream(strm, report, charset);
 }
 
 bool ts::SectionFile::parseXML(const UString& xml_content, Report& report, const DVBCharset* charset)
@@ -295,12 +302,21 @@ bool ts::SectionFile::parseXML(const UString& xml_content, Report& report, const
     return doc.parse(xml_content) && parseDocument(doc, charset);
 }
 
-bool ts::SectionFile::parseDocument(const xml::Document& doc, const DVBCharset* charset)
+bool ts::SectionFile::LoadModel(xml::Document& model)
 {
     // Load the XML model for TSDuck files. Search it in TSDuck directory.
-    xml::Document model(doc.report());
     if (!model.load(u"tsduck.xml", true)) {
-        doc.report().error(u"Model for TSDuck XML files not found");
+        model.report().error(u"Model for TSDuck XML files not found");
+        return false;
+    }
+    return true;
+}
+
+bool ts::SectionFile::parseDocument(const xml::Document& doc, const DVBCharset* charset)
+{
+    // Load the XML model for TSDuck files.
+    xml::Document model(doc.report());
+    if (!LoadModel(model)) {
         return false;
     }
 
@@ -329,14 +345,140 @@ bool ts::SectionFile::parseDocument(const xml::Document& doc, const DVBCharset*
 }
 
 
+//----------------------------------------------------------------------------
+// Load an XML stream, table by table.
+//----------------------------------------------------------------------------
+
+namespace {
+    // Handler of XML events, converting each table as soon as its XML element is complete.
+    // Only the root element and the table being parsed are present in the XML document.
+    class XMLTableLoader : public ts::xml::Reader::Handler
+    {
+    public:
+        XMLTableLoader(ts::SectionFile& file, const ts::xml::Document& model, ts::Report& report);
+        bool success() const { return _success; }
+
+        // Implementation of xml::Reader::Handler.
+        virtual bool handleElementStart(ts::xml::Reader& reader, const ts::UString& name, const ts::xml::Reader::AttributeList& attributes, size_t line) override;
+        virtual bool handleElementEnd(ts::xml::Reader& reader, const ts::UString& name, size_t line) override;
+        virtual bool handleText(ts::xml::Reader& reader, const ts::UString& text, bool cdata, size_t line) override;
+
+    private:
+        ts::SectionFile&         _file;     // Where to add the tables.
+        const ts::xml::Document& _model;    // Model for TSDuck XML files.
+        ts::xml::Document        _doc;      // Partial XML document.
+        ts::xml::Node*           _current;  // Current open element, the document itself at top level.
+        bool                     _success;  // No error so far.
+
+        // Inaccessible operations.
+        XMLTableLoader(const XMLTableLoader&) = delete;
+        XMLTableLoader& operator=(const XMLTableLoader&) = delete;
+    };
+}
+
+XMLTableLoader::XMLTableLoader(ts::SectionFile& file, const ts::xml::Document& model, ts::Report& report) :
+    _file(file),
+    _model(model),
+    _doc(report),
+    _current(&_doc),
+    _success(true)
+{
+}
+
+bool XMLTableLoader::handleElementStart(ts::xml::Reader& reader, const ts::UString& name, const ts::xml::Reader::AttributeList& attributes, size_t line)
+{
+    ts::xml::Element* elem = new ts::xml::Element(_doc.report(), line);
+    CheckNonNull(elem);
+    elem->setValue(name);
+    for (ts::xml::Reader::AttributeList::const_iterator it = attributes.begin(); it != attributes.end(); ++it) {
+        elem->setAttribute(it->name(), it->value(), it->lineNumber());
+    }
+    elem->reparent(_current);
+    _current = elem;
+
+    // Check the root element and its attributes. An invalid root is not worth continuing.
+    if (reader.depth() == 1 && !_doc.validate(_model, elem)) {
+        _success = false;
+        return false;
+    }
+    return true;
+}
+
+bool XMLTableLoader::handleElementEnd(ts::xml::Reader& reader, const ts::UString& name, size_t line)
+{
+    ts::xml::Element* elem = dynamic_cast<ts::xml::Element*>(_current);
+    assert(elem != 0);
+    _current = elem->parent();
+
+    // A table element is complete, validate it, convert it and drop it.
+    if (reader.depth() == 2) {
+        if (!_doc.validate(_model, elem)) {
+            _success = false;
+        }
+        else {
+            ts::BinaryTablePtr bin(new ts::BinaryTable);
+            CheckNonNull(bin.pointer());
+            if (bin->fromXML(elem) && bin->isValid()) {
+                _file.add(bin);
+            }
+            else {
+                _doc.report().error(u"Error in table <%s> at line %d", {elem->name(), elem->lineNumber()});
+                _success = false;
+            }
+        }
+        delete elem;
+    }
+    return true;
+}
+
+bool XMLTableLoader::handleText(ts::xml::Reader& reader, const ts::UString& text, bool cdata, size_t line)
+{
+    // Texts directly inside the root element are meaningless, drop them.
+    if (reader.depth() > 1) {
+        ts::xml::Text* node = new ts::xml::Text(_doc.report(), line, cdata);
+        CheckNonNull(node);
+        node->setValue(text);
+        node->reparent(_current);
+    }
+    return true;
+}
+
+bool ts::SectionFile::parseStream(std::istream& strm, Report& report, const DVBCharset* charset)
+{
+    xml::Document model(report);
+    if (!LoadModel(model)) {
+        return false;
+    }
+    xml::Reader reader(report);
+    XMLTableLoader loader(*this, model, report);
+    return reader.parse(strm, loader) && loader.success();
+}
+
+
 //----------------------------------------------------------------------------
 // Create XML file or text.
 //----------------------------------------------------------------------------
 
 bool ts::SectionFile::saveXML(const UString& file_name, Report& report, const DVBCharset* charset) const
 {
-    xml::Document doc(report);
-    return generateDocument(doc, charset) && doc.save(file_name);
+    // Format and write tables one by one, the complete document is never built in memory.
+    xml::Writer out(report);
+    if (!out.open(file_name, u"tsduck")) {
+        return false;
+    }
+    for (BinaryTablePtrVector::const_iterator it = _tables.begin(); it != _tables.end(); ++it) {
+        const BinaryTablePtr& table(*it);
+        if (!table.isNull() && table->toXML(out.rootElement(), false, charset) != 0) {
+            out.flush();
+        }
+    }
+    out.close();
+
+    // Issue a warning if incomplete tables were not saved.
+    if (!_orphanSections.empty()) {
+        report.warning(u"%d orphan sections not saved in XML document (%d tables saved)", {_orphanSections.size(), _tables.size()});
+    }
+    return true;
 }
 
 ts::UString ts::SectionFile::toXML(Report& report, const DVBCharset* charset) const
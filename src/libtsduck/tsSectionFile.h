@@ -349,6 +349,24 @@ namespace ts {
         //!
         bool parseDocument(const xml::Document& doc, const DVBCharset* charset);
 
+        //!
+        //! Load an XML stream using a streaming reader.
+        //! Each table is converted as soon as its XML element is complete
+        //! and the complete XML document is never built in memory.
+        //! @param [in,out] strm A standard stream in input mode, UTF-8 XML text.
+        //! @param [in,out] report Where to report errors.
+        //! @param [in] charset If not zero, default character set to encode strings.
+        //! @return True on success, false on error.
+        //!
+        bool parseStream(std::istream& strm, Report& report, const DVBCharset* charset);
+
+        //!
+        //! Load the model for TSDuck XML files.
+        //! @param [out] model The model document.
+        //! @return True on success, false on error.
+        //!
+        static bool LoadModel(xml::Document& model);
+
         //!
         //! Generate an XML document.
         //! @param [in,out] doc XML document.
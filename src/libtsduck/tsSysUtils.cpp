@@ -323,6 +323,67 @@ bool ts::IsPrivilegedUser()
 }
 
 
+//----------------------------------------------------------------------------
+// NUMA memory placement.
+//----------------------------------------------------------------------------
+
+#if defined(TS_LINUX)
+namespace {
+    // Max number of NUMA nodes in a node mask.
+    const size_t NUMA_MASK_WORDS = 16;
+    const size_t NUMA_MASK_BITS = 8 * sizeof(unsigned long) * NUMA_MASK_WORDS;
+
+    // Build a node mask with one single node. Return false if the node is out of range.
+    bool SingleNodeMask(int node, unsigned long (&mask)[NUMA_MASK_WORDS])
+    {
+        ::memset(mask, 0, sizeof(mask));
+        if (node < 0 || size_t(node) >= NUMA_MASK_BITS) {
+            return false;
+        }
+        mask[node / (8 * sizeof(unsigned long))] = 1UL << (node % (8 * sizeof(unsigned long)));
+        return true;
+    }
+}
+#endif
+
+ts::ErrorCode ts::SetThreadNUMANode(int node)
+{
+#if defined(TS_LINUX)
+    unsigned long mask[NUMA_MASK_WORDS];
+    if (node < 0) {
+        return ::syscall(SYS_set_mempolicy, MPOL_DEFAULT, 0, 0) == 0 ? SYS_SUCCESS : LastErrorCode();
+    }
+    else if (!SingleNodeMask(node, mask)) {
+        return EINVAL;
+    }
+    else {
+        return ::syscall(SYS_set_mempolicy, MPOL_PREFERRED, mask, NUMA_MASK_BITS) == 0 ? SYS_SUCCESS : LastErrorCode();
+    }
+#elif defined(TS_WINDOWS)
+    return ERROR_NOT_SUPPORTED;
+#else
+    return ENOSYS;
+#endif
+}
+
+ts::ErrorCode ts::SetMemoryNUMANode(void* address, size_t size, int node)
+{
+#if defined(TS_LINUX)
+    unsigned long mask[NUMA_MASK_WORDS];
+    if (!SingleNodeMask(node, mask)) {
+        return EINVAL;
+    }
+    else {
+        return ::syscall(SYS_mbind, address, size, MPOL_PREFERRED, mask, NUMA_MASK_BITS, MPOL_MF_MOVE) == 0 ? SYS_SUCCESS : LastErrorCode();
+    }
+#elif defined(TS_WINDOWS)
+    return ERROR_NOT_SUPPORTED;
+#else
+    return ENOSYS;
+#endif
+}
+
+
 //----------------------------------------------------------------------------
 // Create a directory
 //----------------------------------------------------------------------------
@@ -221,6 +221,26 @@ namespace ts {
     //!
     TSDUCKDLL bool IsPrivilegedUser();
 
+    //!
+    //! Set the preferred NUMA node for all subsequent memory allocations of the current thread.
+    //! This is currently implemented on Linux only.
+    //! @param [in] node NUMA node index. A negative value restores the default memory policy.
+    //! @return A system-specific error code (SYS_SUCCESS on success).
+    //!
+    TSDUCKDLL ErrorCode SetThreadNUMANode(int node);
+
+    //!
+    //! Set the preferred NUMA node of a memory area.
+    //! The physical pages of the memory area are preferably allocated on the specified
+    //! node. The pages which were already allocated are moved to this node when possible.
+    //! This is currently implemented on Linux only.
+    //! @param [in] address Address of the memory area. Must be aligned on a memory page boundary.
+    //! @param [in] size Size in bytes of the memory area.
+    //! @param [in] node NUMA node index.
+    //! @return A system-specific error code (SYS_SUCCESS on success).
+    //!
+    TSDUCKDLL ErrorCode SetMemoryNUMANode(void* address, size_t size, int node);
+
     //!
     //! Create a directory
     //! @param [in] path A directory path.
@@ -123,7 +123,7 @@ namespace ts {
 
         // Map of safe pointers to PIDContext, indexed by PID.
         typedef SafePtr<PIDContext, NullMutex> PIDContextPtr;
-        typedef std::map<PID, PIDContextPtr> PIDContextMap;
+        typedef PIDMap<PIDContextPtr> PIDContextMap;
 
         // Inherited methods from TableHandlerInterface.
         virtual void handleTable(SectionDemux&, const BinaryTable&) override;
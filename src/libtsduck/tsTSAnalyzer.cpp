@@ -35,11 +35,16 @@
 #include "tsT2MIPacket.h"
 #include "tsNames.h"
 #include "tsAlgorithm.h"
+#include "tsGuardCondition.h"
 TSDUCK_SOURCE;
 
 // Constant string "Unreferenced"
 const ts::UString ts::TSAnalyzer::UNREFERENCED(u"Unreferenced");
 
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+const size_t ts::TSAnalyzer::DEFAULT_CHUNK_PACKETS;
+#endif
+
 
 //----------------------------------------------------------------------------
 // Constructor for the TS analyzer
@@ -82,6 +87,8 @@ ts::TSAnalyzer::TSAnalyzer(BitRate bitrate_hint) :
     _pids(),
     _services(),
     _modified(false),
+    _generation(0),
+    _generation_start(Time::CurrentUTC()),
     _ts_bitrate_sum(0),
     _ts_bitrate_cnt(0),
     _preceding_errors(0),
@@ -91,7 +98,17 @@ ts::TSAnalyzer::TSAnalyzer(BitRate bitrate_hint) :
     _default_charset(0),
     _demux(this, this),
     _pes_demux(this),
-    _t2mi_demux(this)
+    _t2mi_demux(this),
+    _chunk_packets(DEFAULT_CHUNK_PACKETS),
+    _chunk(0),
+    _chunk_pending(),
+    _chunk_free(),
+    _chunk_threads(),
+    _chunk_mutex(),
+    _chunk_todo(),
+    _chunk_done(),
+    _chunk_queue(),
+    _chunk_stop(false)
 {
     // Specify the PID filters to collect PSI tables.
     _demux.addPID(PID_PAT);
@@ -111,6 +128,8 @@ ts::TSAnalyzer::TSAnalyzer(BitRate bitrate_hint) :
 ts::TSAnalyzer::~TSAnalyzer()
 {
     this->reset();
+    stopChunkThreads();
+    deleteChunks();
 }
 
 
@@ -120,7 +139,12 @@ ts::TSAnalyzer::~TSAnalyzer()
 
 void ts::TSAnalyzer::reset()
 {
+    // Drop all chunks which are pending in a parallel analysis.
+    flushChunks(false);
+
     _modified = false;
+    _generation++;
+    _generation_start = Time::CurrentUTC();
     _ts_id = 0;
     _ts_id_valid = false;
     _ts_pkt_cnt = 0;
@@ -171,6 +195,17 @@ void ts::TSAnalyzer::reset()
 }
 
 
+//----------------------------------------------------------------------------
+// Start a new generation of the analysis.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzer::setGeneration(uint64_t generation)
+{
+    _generation = generation;
+    _generation_start = Time::CurrentUTC();
+}
+
+
 //----------------------------------------------------------------------------
 // Constructor for the PID context
 //----------------------------------------------------------------------------
@@ -1268,13 +1303,100 @@ void ts::TSAnalyzer::handleTSPacket(T2MIDemux& demux, const T2MIPacket& t2mi, co
 
 
 //----------------------------------------------------------------------------
-// The following method feeds the analyzer with a TS packet.
+// Continuity processing, common to the sequential and parallel analysis.
+// Return true if a discontinuity breaks the PCR-based bitrate evaluation.
 //----------------------------------------------------------------------------
 
-void ts::TSAnalyzer::feedPacket(const TSPacket& pkt)
-{
-    bool broken_rate(false);
+namespace {
+    template <class CONTEXT>
+    inline bool UpdateContinuity(CONTEXT& ps, const ts::TSPacket& pkt, bool first_packet)
+    {
+        bool broken_rate = false;
+        if (first_packet) {
+            // First packet, initialize continuity
+        }
+        else if (pkt.getDiscontinuityIndicator()) {
+            // Expected discontinuity
+            ps.exp_discont++;
+            broken_rate = true;
+        }
+        else if (pkt.hasPayload()) {
+            // Packet has payload.
+            if (pkt.getCC() == ps.cur_continuity) {
+                // Same counter means duplicated packet.
+                ps.duplicated++;
+            }
+            else if (pkt.getCC() != (ps.cur_continuity + 1) % ts::CC_MAX) {
+                // Counter not following previous -> discountinuity
+                ps.unexp_discont++;
+                broken_rate = true;
+            }
+        }
+        else if (pkt.getCC() != ps.cur_continuity) {
+            // Packet has no payload -> should have same counter
+            ps.unexp_discont++;
+            broken_rate = true;
+        }
+        ps.cur_continuity = pkt.getCC();
+        return broken_rate;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// PES start code processing, common to the sequential and parallel analysis.
+// Return the PES stream_id or -1 if the packet does not start a PES packet.
+//----------------------------------------------------------------------------
+
+namespace {
+    template <class CONTEXT>
+    inline int CheckPESStart(CONTEXT& ps, const ts::TSPacket& pkt, ts::PID pid)
+    {
+        // Check PES start code: PES packet headers start with the constant
+        // sequence 00 00 01. Check this on all clear packets. This test is
+        // actually meaningful only on TS packets carrying PES packets.
+        // Note that "carrying PES" is an information that is not
+        // available from the packet itself but from the environment
+        // (for instance if the PID is referenced as a video PID in a PMT).
+        // So, before getting the PMT referencing a PID, we do not know if
+        // this PID carries PES or not.
+
+        size_t header_size(pkt.getHeaderSize());
+
+        if (pkt.getPUSI() && pkt.getScrambling() == ts::SC_CLEAR && header_size <= ts::PKT_SIZE - 3) {
+
+            // Got a "unit start indicator" in a clear packet.
+            // This may be the start of a section or a PES packet.
+
+            if (pkt.b [header_size] != 0x00 || pkt.b [header_size + 1] != 0x00 || pkt.b [header_size + 2] != 0x01) {
+                // Got an invalid PES start code. This is not an error if the
+                // PID carries sections (we may not yet know this, so count
+                // all these errors now and ignore them later if we know
+                // that the PID does not carry PES packets).
+                ps.inv_pes_start++;
+            }
+            else if (header_size <= ts::PKT_SIZE - 4 && pid != 0) {
+                // Here, the start of the packet payload is 00 00 01.
+                // The only case where this can happen on a section is a PAT
+                // (first 00 = "pointer field", second 00 = table_id = PAT).
+                // A PAT is normally available on PID 0 only. Since we have
+                // excluded PID 0 in the test above, this cannot be a PAT.
+                // As a consequence, we are pretty sure to have a PES packet.
+                // The PES stream_id is next byte after PES start code.
+                return pkt.b [header_size + 3];
+            }
+        }
+        return -1;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Process the part of a packet which depends on the complete stream history.
+//----------------------------------------------------------------------------
 
+bool ts::TSAnalyzer::feedOrderedPacket(const TSPacket& pkt)
+{
     // Store system times of first packet
     if (_first_utc == Time::Epoch) {
         _first_utc = Time::CurrentUTC();
@@ -1286,7 +1408,6 @@ void ts::TSAnalyzer::feedPacket(const TSPacket& pkt)
 
     // Count TS packets
     _ts_pkt_cnt++;
-    uint64_t packet_index(_ts_pkt_cnt);
 
     // Detect and ignore invalid packets
     bool invalid_packet = false;
@@ -1301,7 +1422,7 @@ void ts::TSAnalyzer::feedPacket(const TSPacket& pkt)
     if (invalid_packet) {
         _preceding_errors++;
         _preceding_suspects = 0;
-        return;
+        return false;
     }
 
     // Detect and ignore suspect packets
@@ -1311,7 +1432,7 @@ void ts::TSAnalyzer::feedPacket(const TSPacket& pkt)
             _suspect_ignored++;
             _preceding_suspects++;
             _preceding_errors = 0;
-            return;
+            return false;
         }
     }
 
@@ -1323,6 +1444,75 @@ void ts::TSAnalyzer::feedPacket(const TSPacket& pkt)
     _demux.feedPacket(pkt);
     _pes_demux.feedPacket(pkt);
     _t2mi_demux.feedPacket(pkt);
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Process a change of scrambling control value in a PID.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzer::changeScrambling(PIDContext& ps, uint8_t scrambling, uint64_t packet_index)
+{
+    if (ps.cur_ts_sc != SC_CLEAR) {
+        // End of a crypto-period, not a clear/scramble transition.
+        // Count number of crypto-periods:
+        ps.cryptop_cnt++;
+        // Count number of TS packets in all crypto-periods.
+        // Ignore first crypto-period since it is truncated and
+        // not significant for evaluation of duration.
+        if (ps.cryptop_cnt > 1) {
+            ps.cryptop_ts_cnt += packet_index - ps.cur_ts_sc_pkt;
+        }
+    }
+    ps.cur_ts_sc = scrambling;
+    ps.cur_ts_sc_pkt = packet_index;
+}
+
+
+//----------------------------------------------------------------------------
+// Process a PCR in a PID, after continuity processing.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzer::processPCR(PIDContext& ps, uint64_t pcr, uint64_t packet_index)
+{
+    // If last PCR valid, compute transport rate between the two
+    if (ps.last_pcr != 0 && ps.last_pcr < pcr) {
+        // Compute transport rate in b/s since last PCR
+        uint64_t ts_bitrate =
+            (uint64_t(packet_index - ps.last_pcr_pkt) * SYSTEM_CLOCK_FREQ * PKT_SIZE * 8) /
+            (pcr - ps.last_pcr);
+        // Per-PID statistics:
+        ps.ts_bitrate_sum += ts_bitrate;
+        ps.ts_bitrate_cnt++;
+        // Transport stream statistics:
+        _ts_bitrate_sum += ts_bitrate;
+        _ts_bitrate_cnt++;
+    }
+    // Save PCR for next calculation
+    ps.last_pcr = pcr;
+    ps.last_pcr_pkt = packet_index;
+}
+
+
+//----------------------------------------------------------------------------
+// The following method feeds the analyzer with a TS packet.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzer::feedPacket(const TSPacket& pkt)
+{
+    // In parallel analysis, the packet statistics are computed by chunks.
+    if (!_chunk_threads.empty()) {
+        feedChunkPacket(pkt);
+        return;
+    }
+
+    // Ordered processing, ignore invalid and suspect packets.
+    if (!feedOrderedPacket(pkt)) {
+        return;
+    }
+
+    const uint64_t packet_index(_ts_pkt_cnt);
 
     // Get PID context
     PIDContextPtr ps(getPID(pkt.getPID()));
@@ -1352,52 +1542,12 @@ void ts::TSAnalyzer::feedPacket(const TSPacket& pkt)
     }
     if (pkt.getScrambling() != ps->cur_ts_sc) {
         // Change of crypto-period
-        if (ps->cur_ts_sc != SC_CLEAR) {
-            // End of a crypto-period, not a clear/scramble transition.
-            // Count number of crypto-periods:
-            ps->cryptop_cnt++;
-            // Count number of TS packets in all crypto-periods.
-            // Ignore first crypto-period since it is truncated and
-            // not significant for evaluation of duration.
-            if (ps->cryptop_cnt > 1) {
-                ps->cryptop_ts_cnt += packet_index - ps->cur_ts_sc_pkt;
-            }
-        }
-        ps->cur_ts_sc = pkt.getScrambling();
-        ps->cur_ts_sc_pkt = packet_index;
+        changeScrambling(*ps, pkt.getScrambling(), packet_index);
     }
 
     // Process discontinuities.
     // The continuity counter of null packets is undefined.
-    if (ps->pid != PID_NULL) {
-        if (ps->ts_pkt_cnt == 1) {
-            // First packet, initialize continuity
-            ps->cur_continuity = pkt.getCC();
-        }
-        else if (pkt.getDiscontinuityIndicator()) {
-            // Expected discontinuity
-            ps->exp_discont++;
-            broken_rate = true;
-        }
-        else if (pkt.hasPayload()) {
-            // Packet has payload.
-            if (pkt.getCC() == ps->cur_continuity) {
-                // Same counter means duplicated packet.
-                ps->duplicated++;
-            }
-            else if (pkt.getCC() != (ps->cur_continuity + 1) % CC_MAX) {
-                // Counter not following previous -> discountinuity
-                ps->unexp_discont++;
-                broken_rate = true;
-            }
-        }
-        else if (pkt.getCC() != ps->cur_continuity) {
-            // Packet has no payload -> should have same counter
-            ps->unexp_discont++;
-            broken_rate = true;
-        }
-        ps->cur_continuity = pkt.getCC();
-    }
+    const bool broken_rate = ps->pid != PID_NULL && UpdateContinuity(*ps, pkt, ps->ts_pkt_cnt == 1);
 
     // Process PCR
     if (broken_rate) {
@@ -1405,70 +1555,590 @@ void ts::TSAnalyzer::feedPacket(const TSPacket& pkt)
         ps->last_pcr = 0;
     }
     if (pkt.hasPCR()) {
-        uint64_t pcr(pkt.getPCR());
         // Count PID's with PCR
-        if (ps->pcr_cnt++ == 0)
+        if (ps->pcr_cnt++ == 0) {
             _pcr_pid_cnt++;
-        // If last PCR valid, compute transport rate between the two
-        if (ps->last_pcr != 0 && ps->last_pcr < pcr) {
-            // Compute transport rate in b/s since last PCR
-            uint64_t ts_bitrate =
-                (uint64_t(packet_index - ps->last_pcr_pkt) * SYSTEM_CLOCK_FREQ * PKT_SIZE * 8) /
-                (pcr - ps->last_pcr);
-            // Per-PID statistics:
-            ps->ts_bitrate_sum += ts_bitrate;
-            ps->ts_bitrate_cnt++;
-            // Transport stream statistics:
-            _ts_bitrate_sum += ts_bitrate;
-            _ts_bitrate_cnt++;
-        }
-        // Save PCR for next calculation
-        ps->last_pcr = pcr;
-        ps->last_pcr_pkt = packet_index;
-    }
-
-    // Check PES start code: PES packet headers start with the constant
-    // sequence 00 00 01. Check this on all clear packets. This test is
-    // actually meaningful only on TS packets carrying PES packets.
-    // Note that "carrying PES" is an information that is not
-    // available from the packet itself but from the environment
-    // (for instance if the PID is referenced as a video PID in a PMT).
-    // So, before getting the PMT referencing a PID, we do not know if
-    // this PID carries PES or not.
-
-    size_t header_size(pkt.getHeaderSize());
-
-    if (pkt.getPUSI() && pkt.getScrambling() == SC_CLEAR && header_size <= PKT_SIZE - 3) {
-
-        // Got a "unit start indicator" in a clear packet.
-        // This may be the start of a section or a PES packet.
-
-        if (pkt.b [header_size] != 0x00 || pkt.b [header_size + 1] != 0x00 || pkt.b [header_size + 2] != 0x01) {
-            // Got an invalid PES start code. This is not an error if the
-            // PID carries sections (we may not yet know this, so count
-            // all these errors now and ignore them later if we know
-            // that the PID does not carry PES packets).
-            ps->inv_pes_start++;
-        }
-        else if (header_size <= PKT_SIZE - 4 && ps->pid != 0) {
-            // Here, the start of the packet payload is 00 00 01.
-            // The only case where this can happen on a section is a PAT
-            // (first 00 = "pointer field", second 00 = table_id = PAT).
-            // A PAT is normally available on PID 0 only. Since we have
-            // excluded PID 0 in the test above, this cannot be a PAT.
-            // As a consequence, we are pretty sure to have a PES packet.
-            // Remember the stream_id of the PES packets on this PID
-            // (the PES stream_id is next byte after PES start code).
-            if (ps->pes_stream_id == 0) {
-                // First PES stream_id found on this PID
-                ps->pes_stream_id = pkt.b [header_size + 3];
-                ps->same_stream_id = true;
+        }
+        processPCR(*ps, pkt.getPCR(), packet_index);
+    }
+
+    // Check PES start code. Remember the stream_id of the PES packets on this PID.
+    const int stream_id = CheckPESStart(*ps, pkt, ps->pid);
+    if (stream_id < 0) {
+        // Not a PES packet start.
+    }
+    else if (ps->pes_stream_id == 0) {
+        // First PES stream_id found on this PID
+        ps->pes_stream_id = uint8_t(stream_id);
+        ps->same_stream_id = true;
+    }
+    else if (ps->pes_stream_id != stream_id) {
+        // Got different values of stream_id in PES packets
+        ps->same_stream_id = false;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Parallel analysis: per-PID packet statistics of a chunk.
+//----------------------------------------------------------------------------
+
+// The statistics of a PID in a chunk are computed without knowing the state
+// of the PID at the end of the previous chunks. The processing of the first
+// packet of the PID in the chunk and the evaluations which depend on the
+// previous state (first crypto-period, first PCR) are deferred to the merge.
+
+class ts::TSAnalyzer::ChunkPIDStats
+{
+public:
+    // Additive counters, same meaning as in PIDContext.
+    uint64_t ts_pkt_cnt;
+    uint64_t ts_af_cnt;
+    uint64_t unit_start_cnt;
+    uint64_t pl_start_cnt;
+    uint64_t ts_sc_cnt;
+    uint64_t inv_ts_sc_cnt;
+    uint64_t inv_pes_start;
+    uint64_t exp_discont;
+    uint64_t unexp_discont;
+    uint64_t duplicated;
+    uint64_t pcr_cnt;
+    uint64_t ts_bitrate_sum;
+    uint64_t ts_bitrate_cnt;
+    bool     scrambled;
+
+    // Index in the chunk of the first packet of the PID.
+    size_t   first_offset;
+
+    // Continuity and scrambling state after the last packet of the PID.
+    // The index of the last scrambling change is zero when unchanged since the first packet.
+    uint8_t  cur_continuity;
+    uint8_t  cur_ts_sc;
+    uint64_t cur_ts_sc_pkt;
+
+    // Crypto-periods which completed after the first packet: start and end packet indexes.
+    // The start index of the first one is zero when it started before the first packet.
+    std::vector<std::pair<uint64_t, uint64_t>> cryptoperiods;
+
+    // PCR state after the last packet of the PID (unknown when pcr_known is false).
+    bool     pcr_known;
+    uint64_t last_pcr;
+    uint64_t last_pcr_pkt;
+
+    // First PCR while the previous PCR is unknown (seam_pcr_pkt is zero when there is none).
+    uint64_t seam_pcr;
+    uint64_t seam_pcr_pkt;
+
+    // PES stream_id as evaluated on this chunk alone (see PIDContext) and
+    // summary of all stream_id values in the chunk (all identical or not).
+    uint8_t  pes_stream_id;
+    bool     same_stream_id;
+    bool     has_stream_id;
+    uint8_t  first_stream_id;
+    bool     all_same_stream_id;
+
+    // Constructor.
+    ChunkPIDStats();
+
+    // Register a PES stream_id.
+    void addStreamId(uint8_t id);
+};
+
+ts::TSAnalyzer::ChunkPIDStats::ChunkPIDStats() :
+    ts_pkt_cnt(0),
+    ts_af_cnt(0),
+    unit_start_cnt(0),
+    pl_start_cnt(0),
+    ts_sc_cnt(0),
+    inv_ts_sc_cnt(0),
+    inv_pes_start(0),
+    exp_discont(0),
+    unexp_discont(0),
+    duplicated(0),
+    pcr_cnt(0),
+    ts_bitrate_sum(0),
+    ts_bitrate_cnt(0),
+    scrambled(false),
+    first_offset(0),
+    cur_continuity(0),
+    cur_ts_sc(0),
+    cur_ts_sc_pkt(0),
+    cryptoperiods(),
+    pcr_known(false),
+    last_pcr(0),
+    last_pcr_pkt(0),
+    seam_pcr(0),
+    seam_pcr_pkt(0),
+    pes_stream_id(0),
+    same_stream_id(false),
+    has_stream_id(false),
+    first_stream_id(0),
+    all_same_stream_id(true)
+{
+}
+
+void ts::TSAnalyzer::ChunkPIDStats::addStreamId(uint8_t id)
+{
+    if (pes_stream_id == 0) {
+        pes_stream_id = id;
+        same_stream_id = true;
+    }
+    else if (pes_stream_id != id) {
+        same_stream_id = false;
+    }
+    if (!has_stream_id) {
+        has_stream_id = true;
+        first_stream_id = id;
+    }
+    else if (id != first_stream_id) {
+        all_same_stream_id = false;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Parallel analysis: a chunk of packets.
+//----------------------------------------------------------------------------
+
+class ts::TSAnalyzer::Chunk
+{
+public:
+    TSPacketVector           packets;      // Packets in the chunk.
+    size_t                   count;        // Number of packets in the chunk.
+    uint64_t                 first_index;  // Index in the stream of the first packet in the chunk.
+    std::vector<size_t>      ignored;      // Sorted indexes in chunk of invalid or suspect packets.
+    PIDMap<ChunkPIDStats>    pids;         // Statistics of all PID's in the chunk.
+    bool                     done;         // Statistics completed (protected by analyzer's mutex).
+
+    // Constructor.
+    Chunk(size_t size) : packets(size), count(0), first_index(0), ignored(), pids(), done(false) {}
+
+    // Compute the statistics of the chunk.
+    void computeStatistics();
+
+private:
+    Chunk() = delete;
+    Chunk(const Chunk&) = delete;
+    Chunk& operator=(const Chunk&) = delete;
+};
+
+void ts::TSAnalyzer::Chunk::computeStatistics()
+{
+    std::vector<size_t>::const_iterator next_ignored(ignored.begin());
+
+    for (size_t i = 0; i < count; ++i) {
+
+        // Skip invalid and suspect packets.
+        if (next_ignored != ignored.end() && *next_ignored == i) {
+            ++next_ignored;
+            continue;
+        }
+
+        const TSPacket& pkt(packets[i]);
+        const PID pid = pkt.getPID();
+        const uint64_t packet_index = first_index + i;
+        const uint8_t scrambling = pkt.getScrambling();
+        ChunkPIDStats& ps(pids[pid]);
+
+        // Stateless counters.
+        const bool first_packet = ps.ts_pkt_cnt++ == 0;
+        if (pkt.hasAF()) {
+            ps.ts_af_cnt++;
+        }
+        if (pkt.getPUSI()) {
+            ps.unit_start_cnt++;
+        }
+        if (pkt.getPUSI() && pkt.hasPayload()) {
+            ps.pl_start_cnt++;
+        }
+        if (scrambling != SC_CLEAR) {
+            ps.scrambled = true;
+        }
+        if (scrambling == SC_DVB_RESERVED) {
+            ps.inv_ts_sc_cnt++;
+        }
+        else if (scrambling != SC_CLEAR) {
+            ps.ts_sc_cnt++;
+        }
+        if (pkt.hasPCR()) {
+            ps.pcr_cnt++;
+        }
+
+        if (first_packet) {
+            // The seam with the previous chunk is processed during the merge.
+            // After the first packet, the continuity counter and scrambling
+            // control are known, the PCR is known only if present.
+            ps.first_offset = i;
+            ps.cur_continuity = pkt.getCC();
+            ps.cur_ts_sc = scrambling;
+            if (pkt.hasPCR()) {
+                ps.pcr_known = true;
+                ps.last_pcr = pkt.getPCR();
+                ps.last_pcr_pkt = packet_index;
+            }
+        }
+        else {
+            // Change of crypto-period.
+            if (scrambling != ps.cur_ts_sc) {
+                if (ps.cur_ts_sc != SC_CLEAR) {
+                    ps.cryptoperiods.push_back(std::make_pair(ps.cur_ts_sc_pkt, packet_index));
+                }
+                ps.cur_ts_sc = scrambling;
+                ps.cur_ts_sc_pkt = packet_index;
+            }
+
+            // Process discontinuities. After a discontinuity, the last PCR is forgotten.
+            if (pid != PID_NULL && UpdateContinuity(ps, pkt, false)) {
+                ps.pcr_known = true;
+                ps.last_pcr = 0;
+            }
+
+            // Process PCR.
+            if (pkt.hasPCR()) {
+                const uint64_t pcr = pkt.getPCR();
+                if (!ps.pcr_known) {
+                    // Depends on the last PCR in previous chunks.
+                    ps.seam_pcr = pcr;
+                    ps.seam_pcr_pkt = packet_index;
+                }
+                else if (ps.last_pcr != 0 && ps.last_pcr < pcr) {
+                    ps.ts_bitrate_sum += (uint64_t(packet_index - ps.last_pcr_pkt) * SYSTEM_CLOCK_FREQ * PKT_SIZE * 8) / (pcr - ps.last_pcr);
+                    ps.ts_bitrate_cnt++;
+                }
+                ps.pcr_known = true;
+                ps.last_pcr = pcr;
+                ps.last_pcr_pkt = packet_index;
+            }
+        }
+
+        // Check PES start code.
+        const int stream_id = CheckPESStart(ps, pkt, pid);
+        if (stream_id >= 0) {
+            ps.addStreamId(uint8_t(stream_id));
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Parallel analysis: thread which computes the statistics of chunks.
+//----------------------------------------------------------------------------
+
+class ts::TSAnalyzer::ChunkThread : public Thread
+{
+public:
+    // Constructor.
+    ChunkThread(TSAnalyzer* parent) : _parent(parent) {}
+
+    // Thread entry point.
+    virtual void main() override;
+
+private:
+    TSAnalyzer* _parent;
+
+    ChunkThread() = delete;
+    ChunkThread(const ChunkThread&) = delete;
+    ChunkThread& operator=(const ChunkThread&) = delete;
+};
+
+void ts::TSAnalyzer::ChunkThread::main()
+{
+    for (;;) {
+
+        // Wait for a chunk to process or a termination request.
+        Chunk* chunk = 0;
+        {
+            GuardCondition lock(_parent->_chunk_mutex, _parent->_chunk_todo);
+            while (!_parent->_chunk_stop && _parent->_chunk_queue.empty()) {
+                lock.waitCondition();
             }
-            else if (ps->pes_stream_id != pkt.b [header_size + 3]) {
-                // Got different values of stream_id in PES packets
-                ps->same_stream_id = false;
+            if (!_parent->_chunk_queue.empty() && !_parent->_chunk_stop) {
+                chunk = _parent->_chunk_queue.front();
+                _parent->_chunk_queue.pop_front();
             }
+            // Propagate the notification to other threads if there is more to do.
+            if (_parent->_chunk_stop || !_parent->_chunk_queue.empty()) {
+                lock.signal();
+            }
+        }
+        if (chunk == 0) {
+            break;
+        }
+
+        // Compute the chunk statistics without holding the mutex.
+        chunk->computeStatistics();
+
+        // Notify the analyzer.
+        GuardCondition lock(_parent->_chunk_mutex, _parent->_chunk_done);
+        chunk->done = true;
+        lock.signal();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Set the number of threads which compute the packet statistics.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzer::setAnalysisThreads(size_t count, size_t chunk_packets)
+{
+    // Complete the pending analysis with the previous configuration.
+    flushChunks(true);
+    stopChunkThreads();
+
+    // Drop previous chunks, the size may have changed.
+    deleteChunks();
+
+    _chunk_packets = std::max<size_t>(1, chunk_packets);
+    _chunk_stop = false;
+    for (size_t i = 0; i < count; ++i) {
+        ChunkThread* thread = new ChunkThread(this);
+        _chunk_threads.push_back(thread);
+        thread->start();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Parallel analysis: stop all statistics threads.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzer::stopChunkThreads()
+{
+    if (!_chunk_threads.empty()) {
+        {
+            GuardCondition lock(_chunk_mutex, _chunk_todo);
+            _chunk_stop = true;
+            lock.signal();
+        }
+        for (size_t i = 0; i < _chunk_threads.size(); ++i) {
+            _chunk_threads[i]->waitForTermination();
+            delete _chunk_threads[i];
+        }
+        _chunk_threads.clear();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Parallel analysis: deallocate all unused chunks.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzer::deleteChunks()
+{
+    delete _chunk;
+    _chunk = 0;
+    for (size_t i = 0; i < _chunk_free.size(); ++i) {
+        delete _chunk_free[i];
+    }
+    _chunk_free.clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Parallel analysis: add a packet in the current chunk.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzer::feedChunkPacket(const TSPacket& pkt)
+{
+    // Get a new chunk if necessary.
+    if (_chunk == 0) {
+        if (_chunk_free.empty()) {
+            _chunk = new Chunk(_chunk_packets);
+        }
+        else {
+            _chunk = _chunk_free.back();
+            _chunk_free.pop_back();
+        }
+        _chunk->count = 0;
+        _chunk->first_index = _ts_pkt_cnt + 1;
+        _chunk->ignored.clear();
+        _chunk->pids.clear();
+        _chunk->done = false;
+    }
+
+    // The ordered processing is done immediately, the statistics are computed later.
+    const size_t offset = _chunk->count++;
+    _chunk->packets[offset] = pkt;
+    if (feedOrderedPacket(pkt)) {
+        // Create the PID context now, it is used by the suspect packet detection.
+        getPID(pkt.getPID());
+    }
+    else {
+        _chunk->ignored.push_back(offset);
+    }
+
+    if (_chunk->count >= _chunk_packets) {
+        submitChunk();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Parallel analysis: submit the current chunk to the statistics threads.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzer::submitChunk()
+{
+    if (_chunk != 0) {
+        _chunk_pending.push_back(_chunk);
+        {
+            GuardCondition lock(_chunk_mutex, _chunk_todo);
+            _chunk_queue.push_back(_chunk);
+            lock.signal();
         }
+        _chunk = 0;
+    }
+
+    // Merge completed chunks. Limit the number of pending chunks to two per thread.
+    const size_t max_pending = 2 * _chunk_threads.size();
+    mergeChunks(_chunk_pending.size() > max_pending ? _chunk_pending.size() - max_pending : 0);
+}
+
+
+//----------------------------------------------------------------------------
+// Parallel analysis: merge completed chunks in stream order.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzer::mergeChunks(size_t min_count)
+{
+    for (size_t merged = 0; !_chunk_pending.empty(); ++merged) {
+        Chunk* chunk = _chunk_pending.front();
+        {
+            GuardCondition lock(_chunk_mutex, _chunk_done);
+            while (merged < min_count && !chunk->done) {
+                lock.waitCondition();
+            }
+            if (!chunk->done) {
+                break;
+            }
+        }
+        _chunk_pending.pop_front();
+        mergeChunk(*chunk);
+        _chunk_free.push_back(chunk);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Parallel analysis: wait for all submitted chunks and merge or drop them.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzer::flushChunks(bool merge)
+{
+    if (_chunk != 0) {
+        if (merge && _chunk->count > 0) {
+            submitChunk();
+        }
+        else {
+            _chunk_free.push_back(_chunk);
+            _chunk = 0;
+        }
+    }
+    if (merge) {
+        mergeChunks(_chunk_pending.size());
+    }
+    else {
+        GuardCondition lock(_chunk_mutex, _chunk_done);
+        while (!_chunk_pending.empty()) {
+            if (_chunk_pending.front()->done) {
+                _chunk_free.push_back(_chunk_pending.front());
+                _chunk_pending.pop_front();
+            }
+            else {
+                lock.waitCondition();
+            }
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Parallel analysis: merge the statistics of one chunk in the analyzer.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzer::mergeChunk(const Chunk& chunk)
+{
+    for (PIDMap<ChunkPIDStats>::const_iterator it = chunk.pids.begin(); it != chunk.pids.end(); ++it) {
+
+        const PID pid = it->first;
+        const ChunkPIDStats& cs(it->second);
+        const TSPacket& first_pkt(chunk.packets[cs.first_offset]);
+        const uint64_t first_index = chunk.first_index + cs.first_offset;
+        PIDContextPtr ps(getPID(pid));
+
+        // Process the first packet of the PID in the chunk as in feedPacket(),
+        // using the state at the end of the previous chunks.
+        if (first_pkt.getScrambling() != ps->cur_ts_sc) {
+            changeScrambling(*ps, first_pkt.getScrambling(), first_index);
+        }
+        if (pid != PID_NULL && UpdateContinuity(*ps, first_pkt, ps->ts_pkt_cnt == 0)) {
+            ps->last_pcr = 0;
+        }
+        if (first_pkt.hasPCR()) {
+            processPCR(*ps, first_pkt.getPCR(), first_index);
+        }
+
+        // Crypto-periods which completed after the first packet.
+        for (size_t i = 0; i < cs.cryptoperiods.size(); ++i) {
+            const uint64_t start = cs.cryptoperiods[i].first != 0 ? cs.cryptoperiods[i].first : ps->cur_ts_sc_pkt;
+            ps->cryptop_cnt++;
+            if (ps->cryptop_cnt > 1) {
+                ps->cryptop_ts_cnt += cs.cryptoperiods[i].second - start;
+            }
+        }
+        ps->cur_ts_sc = cs.cur_ts_sc;
+        if (cs.cur_ts_sc_pkt != 0) {
+            ps->cur_ts_sc_pkt = cs.cur_ts_sc_pkt;
+        }
+
+        // Continuity and PCR state at the end of the chunk.
+        if (pid != PID_NULL) {
+            ps->cur_continuity = cs.cur_continuity;
+        }
+        if (cs.seam_pcr_pkt != 0) {
+            processPCR(*ps, cs.seam_pcr, cs.seam_pcr_pkt);
+        }
+        if (cs.pcr_known) {
+            ps->last_pcr = cs.last_pcr;
+            ps->last_pcr_pkt = cs.last_pcr_pkt;
+        }
+
+        // PES stream_id.
+        if (!cs.has_stream_id) {
+            // No PES packet start in the chunk.
+        }
+        else if (ps->pes_stream_id == 0) {
+            ps->pes_stream_id = cs.pes_stream_id;
+            ps->same_stream_id = cs.same_stream_id;
+        }
+        else if (!cs.all_same_stream_id || cs.first_stream_id != ps->pes_stream_id) {
+            ps->same_stream_id = false;
+        }
+
+        // Additive counters.
+        if (cs.scrambled && !ps->scrambled) {
+            ps->scrambled = true;
+            _scrambled_pid_cnt++;
+        }
+        if (cs.pcr_cnt > 0 && ps->pcr_cnt == 0) {
+            _pcr_pid_cnt++;
+        }
+        ps->ts_pkt_cnt += cs.ts_pkt_cnt;
+        ps->ts_af_cnt += cs.ts_af_cnt;
+        ps->unit_start_cnt += cs.unit_start_cnt;
+        ps->pl_start_cnt += cs.pl_start_cnt;
+        ps->ts_sc_cnt += cs.ts_sc_cnt;
+        ps->inv_ts_sc_cnt += cs.inv_ts_sc_cnt;
+        ps->inv_pes_start += cs.inv_pes_start;
+        ps->exp_discont += cs.exp_discont;
+        ps->unexp_discont += cs.unexp_discont;
+        ps->duplicated += cs.duplicated;
+        ps->pcr_cnt += cs.pcr_cnt;
+        ps->ts_bitrate_sum += cs.ts_bitrate_sum;
+        ps->ts_bitrate_cnt += cs.ts_bitrate_cnt;
+        _ts_bitrate_sum += cs.ts_bitrate_sum;
+        _ts_bitrate_cnt += cs.ts_bitrate_cnt;
     }
 }
 
@@ -1492,6 +2162,9 @@ void ts::TSAnalyzer::setBitrateHint(BitRate bitrate)
 
 void ts::TSAnalyzer::recomputeStatistics()
 {
+    // Complete the pending chunks in a parallel analysis.
+    flushChunks(true);
+
     // Don't do anything if not necessary
     if (!_modified) {
         return;
@@ -1610,6 +2283,168 @@ void ts::TSAnalyzer::recomputeStatistics()
 }
 
 
+//----------------------------------------------------------------------------
+// Snapshots of the cumulative counters.
+//----------------------------------------------------------------------------
+
+ts::TSAnalyzer::Snapshot::PIDCounters::PIDCounters(PID p) :
+    pid(p),
+    packets(0),
+    unit_start(0),
+    discontinuities(0),
+    duplicated(0),
+    scrambled(0),
+    pcr(0)
+{
+}
+
+ts::TSAnalyzer::Snapshot::Snapshot() :
+    generation(0),
+    start(),
+    utc(),
+    duration(0),
+    packets(0),
+    invalid_sync(0),
+    transport_errors(0),
+    suspect_ignored(0),
+    pcr_bitrate_sum(0),
+    pcr_bitrate_cnt(0),
+    user_bitrate(0),
+    pids()
+{
+}
+
+void ts::TSAnalyzer::Snapshot::clear()
+{
+    generation = 0;
+    start = Time::Epoch;
+    utc = Time::Epoch;
+    duration = 0;
+    packets = 0;
+    invalid_sync = 0;
+    transport_errors = 0;
+    suspect_ignored = 0;
+    pcr_bitrate_sum = 0;
+    pcr_bitrate_cnt = 0;
+    user_bitrate = 0;
+    pids.clear();
+}
+
+void ts::TSAnalyzer::getSnapshot(Snapshot& snapshot)
+{
+    // Complete the pending chunks in a parallel analysis.
+    flushChunks(true);
+
+    snapshot.generation = _generation;
+    snapshot.start = _generation_start;
+    snapshot.utc = Time::CurrentUTC();
+    snapshot.duration = 0;
+    snapshot.packets = _ts_pkt_cnt;
+    snapshot.invalid_sync = _invalid_sync;
+    snapshot.transport_errors = _transport_errors;
+    snapshot.suspect_ignored = _suspect_ignored;
+    snapshot.pcr_bitrate_sum = _ts_bitrate_sum;
+    snapshot.pcr_bitrate_cnt = _ts_bitrate_cnt;
+    snapshot.user_bitrate = _ts_user_bitrate;
+
+    // The PID map is iterated in increasing PID order.
+    snapshot.pids.clear();
+    for (PIDContextMap::const_iterator it = _pids.begin(); it != _pids.end(); ++it) {
+        const PIDContext& pc(*it->second);
+        if (pc.ts_pkt_cnt > 0) {
+            snapshot.pids.push_back(Snapshot::PIDCounters(pc.pid));
+            Snapshot::PIDCounters& cnt(snapshot.pids.back());
+            cnt.packets = pc.ts_pkt_cnt;
+            cnt.unit_start = pc.unit_start_cnt;
+            cnt.discontinuities = pc.unexp_discont;
+            cnt.duplicated = pc.duplicated;
+            cnt.scrambled = pc.ts_sc_cnt;
+            cnt.pcr = pc.pcr_cnt;
+        }
+    }
+}
+
+void ts::TSAnalyzer::Snapshot::getDelta(const Snapshot& previous, Snapshot& delta) const
+{
+    // In a new generation, the counters restarted from zero at the start of the generation.
+    const bool reset = generation != previous.generation || packets < previous.packets || pcr_bitrate_cnt < previous.pcr_bitrate_cnt;
+    const Snapshot empty;
+    const Snapshot& prev(reset ? empty : previous);
+
+    delta.generation = generation;
+    delta.start = start;
+    delta.utc = utc;
+    delta.duration = utc - (reset ? std::max(start, previous.utc) : previous.utc);
+    delta.packets = packets - prev.packets;
+    delta.invalid_sync = invalid_sync - std::min(invalid_sync, prev.invalid_sync);
+    delta.transport_errors = transport_errors - std::min(transport_errors, prev.transport_errors);
+    delta.suspect_ignored = suspect_ignored - std::min(suspect_ignored, prev.suspect_ignored);
+    delta.pcr_bitrate_sum = pcr_bitrate_sum - prev.pcr_bitrate_sum;
+    delta.pcr_bitrate_cnt = pcr_bitrate_cnt - prev.pcr_bitrate_cnt;
+    delta.user_bitrate = user_bitrate;
+
+    // Both lists of PID's are sorted, merge them. PID's which disappeared are ignored.
+    delta.pids.clear();
+    delta.pids.reserve(pids.size());
+    std::vector<PIDCounters>::const_iterator old = prev.pids.begin();
+    for (std::vector<PIDCounters>::const_iterator cur = pids.begin(); cur != pids.end(); ++cur) {
+        while (old != prev.pids.end() && old->pid < cur->pid) {
+            ++old;
+        }
+        delta.pids.push_back(*cur);
+        if (old != prev.pids.end() && old->pid == cur->pid && old->packets <= cur->packets) {
+            PIDCounters& cnt(delta.pids.back());
+            cnt.packets -= old->packets;
+            cnt.unit_start -= std::min(cnt.unit_start, old->unit_start);
+            cnt.discontinuities -= std::min(cnt.discontinuities, old->discontinuities);
+            cnt.duplicated -= std::min(cnt.duplicated, old->duplicated);
+            cnt.scrambled -= std::min(cnt.scrambled, old->scrambled);
+            cnt.pcr -= std::min(cnt.pcr, old->pcr);
+        }
+    }
+}
+
+ts::BitRate ts::TSAnalyzer::Snapshot::bitrate() const
+{
+    return user_bitrate != 0 ? user_bitrate : (pcr_bitrate_cnt == 0 ? 0 : BitRate(pcr_bitrate_sum / pcr_bitrate_cnt));
+}
+
+ts::BitRate ts::TSAnalyzer::Snapshot::bitrate(const PIDCounters& counters) const
+{
+    return packets == 0 ? 0 : BitRate((uint64_t(bitrate()) * counters.packets) / packets);
+}
+
+ts::json::ValuePtr ts::TSAnalyzer::Snapshot::toJSON() const
+{
+    json::ValuePtr root(new json::Object);
+    root->add(u"time", json::ValuePtr(new json::String(utc.format(Time::DATE | Time::TIME | Time::MILLISECOND))));
+    if (duration > 0) {
+        root->add(u"duration_ms", json::ValuePtr(new json::Number(duration)));
+    }
+    root->add(u"packets", json::ValuePtr(new json::Number(int64_t(packets))));
+    root->add(u"bitrate", json::ValuePtr(new json::Number(int64_t(bitrate()))));
+    root->add(u"invalid_sync", json::ValuePtr(new json::Number(int64_t(invalid_sync))));
+    root->add(u"transport_errors", json::ValuePtr(new json::Number(int64_t(transport_errors))));
+    root->add(u"suspect_ignored", json::ValuePtr(new json::Number(int64_t(suspect_ignored))));
+
+    json::ValuePtr jpids(new json::Array);
+    for (std::vector<PIDCounters>::const_iterator it = pids.begin(); it != pids.end(); ++it) {
+        json::ValuePtr jp(new json::Object);
+        jp->add(u"pid", json::ValuePtr(new json::Number(it->pid)));
+        jp->add(u"packets", json::ValuePtr(new json::Number(int64_t(it->packets))));
+        jp->add(u"bitrate", json::ValuePtr(new json::Number(int64_t(bitrate(*it)))));
+        jp->add(u"unit_start", json::ValuePtr(new json::Number(int64_t(it->unit_start))));
+        jp->add(u"discontinuities", json::ValuePtr(new json::Number(int64_t(it->discontinuities))));
+        jp->add(u"duplicated", json::ValuePtr(new json::Number(int64_t(it->duplicated))));
+        jp->add(u"scrambled", json::ValuePtr(new json::Number(int64_t(it->scrambled))));
+        jp->add(u"pcr", json::ValuePtr(new json::Number(int64_t(it->pcr))));
+        jpids->set(jp);
+    }
+    root->add(u"pids", jpids);
+    return root;
+}
+
+
 //----------------------------------------------------------------------------
 // Return the list of service ids
 //----------------------------------------------------------------------------
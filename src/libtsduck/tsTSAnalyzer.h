@@ -47,6 +47,11 @@
 #include "tsTime.h"
 #include "tsUString.h"
 #include "tsSafePtr.h"
+#include "tsPIDMap.h"
+#include "tsThread.h"
+#include "tsMutex.h"
+#include "tsCondition.h"
+#include "tsjson.h"
 
 namespace ts {
     //!
@@ -86,6 +91,56 @@ namespace ts {
         //!
         void reset();
 
+        //!
+        //! Start a new generation of the analysis.
+        //! The generation is reported in snapshots. Two snapshots with distinct generations
+        //! are unrelated and the delta between them starts at the new generation.
+        //! The generation is automatically incremented by reset(). An application which
+        //! switches between several analyzers can set distinct generations on them.
+        //! @param [in] generation New generation number.
+        //!
+        void setGeneration(uint64_t generation);
+
+        //!
+        //! Get the current generation of the analysis.
+        //! @return The current generation number.
+        //!
+        uint64_t getGeneration() const
+        {
+            return _generation;
+        }
+
+        //!
+        //! Default number of TS packets per chunk in parallel analysis.
+        //!
+        static const size_t DEFAULT_CHUNK_PACKETS = 8192;
+
+        //!
+        //! Set the number of threads which compute the packet statistics in parallel.
+        //!
+        //! By default, the analysis is entirely performed in the thread which calls feedPacket().
+        //! When @a count is not zero, the packets are grouped in chunks. The PSI, PES and T2-MI
+        //! analysis, which depends on the complete history of the stream, remains in the thread
+        //! which calls feedPacket(). The per-PID packet statistics of each chunk (counters,
+        //! continuity, scrambling, PCR's) are computed by a pool of @a count threads. The
+        //! statistics of the chunks are merged in stream order, reconciling the continuity,
+        //! crypto-period and PCR state at chunk seams. The results are identical to a
+        //! sequential analysis.
+        //!
+        //! @param [in] count Number of statistics threads. Zero means sequential analysis.
+        //! @param [in] chunk_packets Number of TS packets per chunk.
+        //!
+        void setAnalysisThreads(size_t count, size_t chunk_packets = DEFAULT_CHUNK_PACKETS);
+
+        //!
+        //! Get the number of threads which compute the packet statistics in parallel.
+        //! @return The number of statistics threads, zero for a sequential analysis.
+        //!
+        size_t getAnalysisThreads() const
+        {
+            return _chunk_threads.size();
+        }
+
         //!
         //! Specify a "bitrate hint" for the analysis.
         //! @param [in] bitrate_hint Optional bitrate "hint" for the analysis.
@@ -166,6 +221,98 @@ namespace ts {
         //!
         void getPIDsWithPES(std::vector<PID>& list);
 
+        //!
+        //! A snapshot of the cumulative counters of the analysis.
+        //!
+        //! A snapshot is cheap to get: it does not recompute the global statistics,
+        //! services and tables. Two successive snapshots give the statistics of the
+        //! interval between them (packets, errors, bitrates), without resetting the
+        //! analysis. This is typically used for periodic monitoring.
+        //!
+        class TSDUCKDLL Snapshot
+        {
+        public:
+            //!
+            //! Cumulative counters of one PID.
+            //!
+            class TSDUCKDLL PIDCounters
+            {
+            public:
+                PID      pid;              //!< PID value.
+                uint64_t packets;          //!< Number of TS packets.
+                uint64_t unit_start;       //!< Number of TS packets with payload unit start.
+                uint64_t discontinuities;  //!< Number of unexpected discontinuities.
+                uint64_t duplicated;       //!< Number of duplicated packets.
+                uint64_t scrambled;        //!< Number of scrambled packets.
+                uint64_t pcr;              //!< Number of PCR's.
+                //!
+                //! Constructor.
+                //! @param [in] p PID value.
+                //!
+                PIDCounters(PID p = PID_NULL);
+            };
+
+            uint64_t    generation;        //!< Generation of the analysis, see TSAnalyzer::setGeneration().
+            Time        start;             //!< System UTC time of the start of the generation.
+            Time        utc;               //!< System UTC time of the snapshot.
+            MilliSecond duration;          //!< Duration of the interval in a delta snapshot, zero otherwise.
+            uint64_t    packets;           //!< Number of TS packets.
+            uint64_t    invalid_sync;      //!< Number of packets with invalid sync byte.
+            uint64_t    transport_errors;  //!< Number of packets with transport error.
+            uint64_t    suspect_ignored;   //!< Number of suspect packets, ignored.
+            uint64_t    pcr_bitrate_sum;   //!< Sum of all TS bitrates which were computed from PCR's.
+            uint64_t    pcr_bitrate_cnt;   //!< Number of TS bitrates which were computed from PCR's.
+            BitRate     user_bitrate;      //!< User-specified TS bitrate or bitrate hint, zero if unknown.
+            std::vector<PIDCounters> pids; //!< Counters of all PID's with packets, sorted by PID.
+
+            //!
+            //! Default constructor.
+            //!
+            Snapshot();
+
+            //!
+            //! Clear the content of the snapshot.
+            //!
+            void clear();
+
+            //!
+            //! Compute the statistics of the interval since a previous snapshot.
+            //! If the analysis was reset or if the generation changed between the
+            //! two snapshots, the interval starts at the new generation.
+            //! @param [in] previous A previous snapshot of the same analysis.
+            //! @param [out] delta The counters of the interval between @a previous and this snapshot.
+            //!
+            void getDelta(const Snapshot& previous, Snapshot& delta) const;
+
+            //!
+            //! Get the TS bitrate, as evaluated from the PCR's, or the user-specified bitrate.
+            //! On a delta snapshot, this is the average bitrate during the interval.
+            //! @return The TS bitrate in b/s or zero if unknown.
+            //!
+            BitRate bitrate() const;
+
+            //!
+            //! Get the bitrate of a PID, relatively to the TS bitrate.
+            //! @param [in] counters The counters of a PID in this snapshot.
+            //! @return The PID bitrate in b/s or zero if unknown.
+            //!
+            BitRate bitrate(const PIDCounters& counters) const;
+
+            //!
+            //! Build a JSON representation of the snapshot.
+            //! Use json::Value::oneLiner() to get a compact one-line text.
+            //! @return A JSON object.
+            //!
+            json::ValuePtr toJSON() const;
+        };
+
+        //!
+        //! Get a snapshot of the cumulative counters of the analysis.
+        //! The cost is proportional to the number of PID's, the global statistics are not recomputed.
+        //! @param [out] snapshot The returned snapshot.
+        //!
+        void getSnapshot(Snapshot& snapshot);
+
     protected:
 
         // -------------------
@@ -387,7 +534,7 @@ namespace ts {
         //!
         //! Map of PIDContext, indexed by PID.
         //!
-        typedef std::map <PID, PIDContextPtr> PIDContextMap;
+        typedef PIDMap<PIDContextPtr> PIDContextMap;
 
     protected:
 
@@ -449,6 +596,37 @@ namespace ts {
         // Return a PID context. Allocate a new entry if PID not found.
         PIDContextPtr getPID(PID pid, const UString& description = UNREFERENCED);
 
+        // Process the part of a packet which depends on the complete stream history
+        // (invalid and suspect packets, PSI, PES, T2-MI). Return false if the packet
+        // shall be ignored in the packet statistics.
+        bool feedOrderedPacket(const TSPacket& pkt);
+
+        // Process a change of scrambling control value in a PID.
+        void changeScrambling(PIDContext& ps, uint8_t scrambling, uint64_t packet_index);
+
+        // Process a PCR in a PID, after continuity processing.
+        void processPCR(PIDContext& ps, uint64_t pcr, uint64_t packet_index);
+
+        // Parallel analysis: the per-PID statistics of a chunk, a chunk of packets
+        // and a thread which computes the statistics of chunks.
+        class ChunkPIDStats;
+        class Chunk;
+        class ChunkThread;
+        typedef std::deque<Chunk*> ChunkQueue;
+
+        // Parallel analysis: add a packet in the current chunk, submit the current chunk
+        // to the statistics threads, merge completed chunks in stream order (waiting for
+        // at least min_count chunks), merge the statistics of one chunk, wait for all
+        // submitted chunks and merge them or drop them, stop all statistics threads,
+        // deallocate all unused chunks.
+        void feedChunkPacket(const TSPacket& pkt);
+        void submitChunk();
+        void mergeChunks(size_t min_count);
+        void mergeChunk(const Chunk& chunk);
+        void flushChunks(bool merge);
+        void stopChunkThreads();
+        void deleteChunks();
+
         // Return an ETID context. Allocate a new entry if ETID not found.
         ETIDContextPtr getETID(const Section&);
 
@@ -493,6 +671,8 @@ namespace ts {
 
         // TSAnalyzer private members (state data, used during analysis):
         bool              _modified;                  // Internal data modified, need recomputeStatistics
+        uint64_t          _generation;                // Generation of the analysis, for snapshots
+        Time              _generation_start;          // System UTC time of the start of the generation
         uint64_t          _ts_bitrate_sum;            // Sum of all computed TS bitrates
         uint64_t          _ts_bitrate_cnt;            // Number of computed TS bitrates
         uint64_t          _preceding_errors;          // Number of contiguous invalid packets before current packet
@@ -503,6 +683,16 @@ namespace ts {
         SectionDemux      _demux;                     // PSI tables analysis
         PESDemux          _pes_demux;                 // Audio/video analysis
         T2MIDemux         _t2mi_demux;                // T2-MI analysis
+        size_t            _chunk_packets;             // Number of packets per chunk in parallel analysis
+        Chunk*            _chunk;                     // Current chunk, being filled
+        ChunkQueue        _chunk_pending;             // Submitted chunks, in stream order, not yet merged
+        std::vector<Chunk*> _chunk_free;              // Unused chunks, to be reused
+        std::vector<ChunkThread*> _chunk_threads;     // Statistics threads
+        Mutex             _chunk_mutex;               // Exclusive access to fields below
+        Condition         _chunk_todo;                // Notify statistics threads that a chunk is available
+        Condition         _chunk_done;                // Notify analyzer that a chunk is completed
+        ChunkQueue        _chunk_queue;               // Submitted chunks, not yet processed by a thread
+        bool              _chunk_stop;                // Request statistics threads to terminate
 
         // Inaccessible operations.
         TSAnalyzer(const TSAnalyzer&) = delete;
@@ -36,6 +36,14 @@
 #include "tsSysUtils.h"
 TSDUCK_SOURCE;
 
+const size_t ts::TSFileInput::DEFAULT_WINDOW_SIZE;
+
+// Alignment of memory-mapped windows in file (huge page size) and of direct I/O.
+namespace {
+    const size_t MMAP_ALIGNMENT = 2 * 1024 * 1024;
+    const size_t DIRECT_ALIGNMENT = 4096;
+}
+
 
 //----------------------------------------------------------------------------
 // Default constructor.
@@ -51,6 +59,15 @@ ts::TSFileInput::TSFileInput() :
     _severity(Severity::Error),
     _at_eof(false),
     _rewindable(false),
+    _mode(READ_ACCESS),
+    _actual_mode(READ_ACCESS),
+    _window_size(DEFAULT_WINDOW_SIZE),
+    _file_size(0),
+    _position(0),
+    _win_offset(0),
+    _win_size(0),
+    _win_data(0),
+    _zc_buffer(),
 #if defined(TS_WINDOWS)
     _handle(INVALID_HANDLE_VALUE)
 #else
@@ -72,6 +89,17 @@ ts::TSFileInput::~TSFileInput()
 }
 
 
+//----------------------------------------------------------------------------
+// Set the file access mode for the next open().
+//----------------------------------------------------------------------------
+
+void ts::TSFileInput::setAccessMode(AccessMode mode, size_t window_size)
+{
+    _mode = mode;
+    _window_size = window_size == 0 ? DEFAULT_WINDOW_SIZE : window_size;
+}
+
+
 //----------------------------------------------------------------------------
 // Open file in a rewindable mode (must be a rewindable file, eg. not a pipe).
 //----------------------------------------------------------------------------
@@ -126,7 +154,9 @@ bool ts::TSFileInput::openInternal (Report& report)
 {
 #if defined (TS_WINDOWS)
 
-    // Windows implementation
+    // Windows implementation, memory-mapped and direct modes not supported.
+
+    _actual_mode = READ_ACCESS;
 
     if (_filename.empty()) {
         _handle = ::GetStdHandle (STD_INPUT_HANDLE);
@@ -169,19 +199,37 @@ bool ts::TSFileInput::openInternal (Report& report)
 
     // UNIX implementation
 
+    _actual_mode = READ_ACCESS;
+
     if (_filename.empty()) {
         _fd = STDIN_FILENO;
     }
-    else if ((_fd = ::open(_filename.toUTF8().c_str(), O_RDONLY | O_LARGEFILE)) < 0) {
-        ErrorCode error_code = LastErrorCode();
-        report.log(_severity, u"cannot open file %s: %s", {_filename, ErrorCodeMessage(error_code)});
-        return false;
+    else {
+        _fd = -1;
+#if defined(O_DIRECT)
+        // Direct I/O is not supported by all filesystems, revert to standard I/O on error.
+        if (_mode == DIRECT_ACCESS && (_fd = ::open(_filename.toUTF8().c_str(), O_RDONLY | O_LARGEFILE | O_DIRECT)) < 0) {
+            report.debug(u"cannot open %s with direct I/O, using system cache: %s", {_filename, ErrorCodeMessage()});
+        }
+#endif
+        if (_fd < 0 && (_fd = ::open(_filename.toUTF8().c_str(), O_RDONLY | O_LARGEFILE)) < 0) {
+            ErrorCode error_code = LastErrorCode();
+            report.log(_severity, u"cannot open file %s: %s", {_filename, ErrorCodeMessage(error_code)});
+            return false;
+        }
+#if defined(F_NOCACHE)
+        // macOS equivalent of O_DIRECT.
+        if (_mode == DIRECT_ACCESS) {
+            ::fcntl(_fd, F_NOCACHE, 1);
+        }
+#endif
     }
 
     // If a repeat count or initial offset is specified, the input file
-    // must be a regular file
+    // must be a regular file. Memory-mapped and direct modes are used
+    // on regular files only.
 
-    if (_repeat != 1 || _start_offset != 0) {
+    if (_repeat != 1 || _start_offset != 0 || _mode != READ_ACCESS) {
         struct stat st;
         if (::fstat(_fd, &st) < 0) {
             ErrorCode error_code = LastErrorCode ();
@@ -191,15 +239,46 @@ bool ts::TSFileInput::openInternal (Report& report)
             }
             return false;
         }
-        if (!S_ISREG(st.st_mode)) {
+        if (!S_ISREG(st.st_mode) && (_repeat != 1 || _start_offset != 0)) {
             report.log(_severity, u"input file %s is not a regular file, cannot %s", {_filename, _repeat != 1 ? u"repeat" : u"specify start offset"});
             if (!_filename.empty()) {
                 ::close(_fd);
             }
             return false;
         }
+        if (S_ISREG(st.st_mode)) {
+            _actual_mode = _mode;
+            _file_size = uint64_t(st.st_size);
+        }
+        else if (_mode != READ_ACCESS) {
+            report.debug(u"input file %s is not a regular file, using standard read access", {_filename});
+        }
     }
 
+    // Prepare the memory-mapped or direct access.
+    _position = _start_offset;
+    _win_offset = _win_size = 0;
+    _win_data = 0;
+    if (_actual_mode == DIRECT_ACCESS) {
+        // Use an anonymous mapping as page-aligned direct I/O buffer.
+        void* addr = ::mmap(0, windowSize(), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (addr == MAP_FAILED) {
+            ErrorCode error_code = LastErrorCode();
+            report.log(_severity, u"error allocating direct I/O buffer: %s", {ErrorCodeMessage(error_code)});
+            if (!_filename.empty()) {
+                ::close(_fd);
+            }
+            return false;
+        }
+        _win_data = reinterpret_cast<uint8_t*>(addr);
+    }
+#if defined(TS_LINUX)
+    else if (_actual_mode == READ_ACCESS && _repeat == 1 && !_filename.empty()) {
+        // Sequential read of a file, enlarge the kernel read-ahead.
+        ::posix_fadvise(_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+#endif
+
     // If an initial offset is specified, move here
 
     if (_start_offset != 0 && ::lseek (_fd, off_t (_start_offset), SEEK_SET) == off_t (-1)) {
@@ -225,6 +304,13 @@ bool ts::TSFileInput::openInternal (Report& report)
 
 bool ts::TSFileInput::seekInternal(uint64_t index, Report& report)
 {
+    // In memory-mapped and direct modes, there is no file pointer.
+    if (_actual_mode != READ_ACCESS) {
+        _position = _start_offset + index;
+        _at_eof = false;
+        return true;
+    }
+
 #if defined (TS_WINDOWS)
     // In Win32, LARGE_INTEGER is a 64-bit structure, not an integer type
     uint64_t where = _start_offset + index;
@@ -276,6 +362,8 @@ bool ts::TSFileInput::close(Report& report)
         return false;
     }
 
+    releaseWindow();
+
     if (!_filename.empty()) {
 #if defined (TS_WINDOWS)
         ::CloseHandle(_handle);
@@ -308,6 +396,19 @@ size_t ts::TSFileInput::read(TSPacket* buffer, size_t max_packets, Report& repor
         return 0;
     }
 
+    // Memory-mapped and direct modes: copy packets from the windows.
+    if (_actual_mode != READ_ACCESS) {
+        size_t count = 0;
+        size_t win_count = 0;
+        const TSPacket* packets = 0;
+        while (count < max_packets && (win_count = readWindow(packets, max_packets - count, report)) > 0) {
+            TSPacket::Copy(buffer + count, packets, win_count);
+            count += win_count;
+        }
+        _total_packets += count;
+        return count;
+    }
+
     char* data = reinterpret_cast <char*> (buffer);
     const size_t req_size = max_packets * PKT_SIZE;
     size_t got_size = 0;
@@ -371,3 +472,163 @@ size_t ts::TSFileInput::read(TSPacket* buffer, size_t max_packets, Report& repor
     _total_packets += count;
     return count;
 }
+
+
+//----------------------------------------------------------------------------
+// Read TS packets without copy, when possible.
+//----------------------------------------------------------------------------
+
+size_t ts::TSFileInput::readZeroCopy(const TSPacket*& packets, size_t max_packets, Report& report)
+{
+    packets = 0;
+
+    if (!_is_open) {
+        report.log(_severity, u"not open");
+        return 0;
+    }
+    else if (_at_eof || max_packets == 0) {
+        return 0;
+    }
+    else if (_actual_mode == READ_ACCESS) {
+        // No mapping, read into the internal buffer.
+        if (_zc_buffer.size() < max_packets) {
+            _zc_buffer.resize(max_packets);
+        }
+        packets = &_zc_buffer[0];
+        return read(&_zc_buffer[0], max_packets, report);
+    }
+    else {
+        const size_t count = readWindow(packets, max_packets, report);
+        _total_packets += count;
+        return count;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Get the size of windows for the current access mode.
+//----------------------------------------------------------------------------
+
+size_t ts::TSFileInput::windowSize() const
+{
+    // The packet at the current position is at most one alignment unit after
+    // the start of the window. Use at least two units to always get packets.
+    const size_t align = _actual_mode == MMAP_ACCESS ? MMAP_ALIGNMENT : DIRECT_ALIGNMENT;
+    return std::max(2 * align, ((_window_size + align - 1) / align) * align);
+}
+
+
+//----------------------------------------------------------------------------
+// Get packets from the current window in memory-mapped or direct modes.
+//----------------------------------------------------------------------------
+
+size_t ts::TSFileInput::readWindow(const TSPacket*& packets, size_t max_packets, Report& report)
+{
+    for (;;) {
+
+        // Return packets from the current window when there are some.
+        if (_win_data != 0 && _position >= _win_offset && _position + PKT_SIZE <= _win_offset + _win_size) {
+            const size_t offset = size_t(_position - _win_offset);
+            const size_t count = std::min(max_packets, (_win_size - offset) / PKT_SIZE);
+            packets = reinterpret_cast<const TSPacket*>(_win_data + offset);
+            _position += count * PKT_SIZE;
+            return count;
+        }
+
+#if !defined(TS_WINDOWS)
+        // At end of file, check if the file has grown since open.
+        struct stat st;
+        if (_position + PKT_SIZE > _file_size && ::fstat(_fd, &st) == 0) {
+            _file_size = uint64_t(st.st_size);
+        }
+#endif
+
+        if (_position + PKT_SIZE <= _file_size) {
+            // Get a new window at the current position.
+            if (!loadWindow(report)) {
+                return 0;
+            }
+        }
+        else if ((_repeat == 0 || ++_counter < _repeat) && _start_offset + PKT_SIZE <= _file_size) {
+            // End of file, the file must be repeated again, rewind to original start offset.
+            _position = _start_offset;
+        }
+        else {
+            // End of file, partial packet truncated.
+            _at_eof = true;
+            return 0;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Load a window containing the current position in memory-mapped or direct modes.
+//----------------------------------------------------------------------------
+
+bool ts::TSFileInput::loadWindow(Report& report)
+{
+#if defined(TS_WINDOWS)
+
+    report.log(_severity, u"memory-mapped and direct access modes not supported");
+    return false;
+
+#else
+
+    if (_actual_mode == MMAP_ACCESS) {
+
+        // Unmap previous window, map the next one, starting on a huge page boundary.
+        releaseWindow();
+        _win_offset = _position - _position % MMAP_ALIGNMENT;
+        const size_t size = size_t(std::min<uint64_t>(windowSize(), _file_size - _win_offset));
+        void* addr = ::mmap(0, size, PROT_READ, MAP_PRIVATE, _fd, off_t(_win_offset));
+        if (addr == MAP_FAILED) {
+            ErrorCode error_code = LastErrorCode();
+            report.log(_severity, u"error mapping file %s: %s", {_filename, ErrorCodeMessage(error_code)});
+            return false;
+        }
+        // Sequential access, aggressive read-ahead.
+        ::madvise(addr, size, MADV_SEQUENTIAL);
+        _win_data = reinterpret_cast<uint8_t*>(addr);
+        _win_size = size;
+        return true;
+    }
+    else {
+
+        // Direct I/O: read a complete aligned buffer at an aligned offset.
+        _win_offset = _position - _position % DIRECT_ALIGNMENT;
+        _win_size = 0;
+        ssize_t insize;
+        while ((insize = ::pread(_fd, _win_data, windowSize(), off_t(_win_offset))) < 0) {
+            ErrorCode error_code = LastErrorCode();
+            if (error_code != EINTR) {
+                report.log(_severity, u"error reading file %s: %s (%d)", {_filename, ErrorCodeMessage(error_code), error_code});
+                return false;
+            }
+        }
+        _win_size = size_t(insize);
+        if (_position + PKT_SIZE > _win_offset + _win_size) {
+            // File truncated since last check.
+            _file_size = _win_offset + _win_size;
+        }
+        return true;
+    }
+
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Release the current window in memory-mapped or direct modes.
+//----------------------------------------------------------------------------
+
+void ts::TSFileInput::releaseWindow()
+{
+#if !defined(TS_WINDOWS)
+    if (_win_data != 0) {
+        ::munmap(_win_data, _actual_mode == MMAP_ACCESS ? _win_size : windowSize());
+    }
+#endif
+    _win_data = 0;
+    _win_offset = _win_size = 0;
+}
@@ -49,6 +49,42 @@ namespace ts {
         //!
         TSFileInput();
 
+        //!
+        //! Methods to access the content of the file.
+        //!
+        enum AccessMode {
+            READ_ACCESS,    //!< Sequential read() system calls into the application buffer (default).
+            MMAP_ACCESS,    //!< Memory-mapped windows over the file, sequential access advice to the kernel.
+            DIRECT_ACCESS,  //!< Direct I/O (O_DIRECT on Linux), large aligned reads bypassing the system cache.
+        };
+
+        //!
+        //! Default size in bytes of the memory-mapped windows or direct I/O buffer.
+        //!
+        static const size_t DEFAULT_WINDOW_SIZE = 16 * 1024 * 1024;
+
+        //!
+        //! Set the file access mode for the next open().
+        //! The memory-mapped and direct access modes are not supported on Windows and
+        //! are valid only on regular files. In other cases, the file is silently read
+        //! using READ_ACCESS.
+        //! @param [in] mode File access mode.
+        //! @param [in] window_size Size in bytes of the memory-mapped windows or direct I/O buffer.
+        //! The size is rounded up to a multiple of 2 MB (the size of huge pages on most
+        //! systems) in memory-mapped mode and to a multiple of 4 kB in direct access mode.
+        //! Zero means DEFAULT_WINDOW_SIZE.
+        //!
+        void setAccessMode(AccessMode mode, size_t window_size = 0);
+
+        //!
+        //! Get the access mode of the file.
+        //! @return The actual access mode when the file is open, the requested one otherwise.
+        //!
+        AccessMode getAccessMode() const
+        {
+            return _is_open ? _actual_mode : _mode;
+        }
+
         //!
         //! Destructor.
         //!
@@ -137,6 +173,19 @@ namespace ts {
         //!
         size_t read(TSPacket* buffer, size_t max_packets, Report& report);
 
+        //!
+        //! Read TS packets without copying them into an application buffer, when possible.
+        //! In memory-mapped mode, the returned packets are located in the mapped file.
+        //! In the other modes, they are located in an internal buffer.
+        //! The returned packets remain valid until the next read operation on the file.
+        //! @param [out] packets Address of the first read packet.
+        //! @param [in] max_packets Maximum number of packets to read.
+        //! @param [in,out] report Where to report errors.
+        //! @return The actual number of read packets. Returning zero means
+        //! error or end of file repetition.
+        //!
+        size_t readZeroCopy(const TSPacket*& packets, size_t max_packets, Report& report);
+
         //!
         //! Rewind the file.
         //! The file must have been opened in rewindable mode.
@@ -181,6 +230,15 @@ namespace ts {
         int      _severity;      //!< Severity level for error reporting
         bool     _at_eof;        //!< End of file has been reached
         bool     _rewindable;    //!< Opened in rewindable mode
+        AccessMode _mode;        //!< Requested access mode for next open
+        AccessMode _actual_mode; //!< Actual access mode of the open file
+        size_t   _window_size;   //!< Size of memory-mapped windows or direct I/O buffer
+        uint64_t _file_size;     //!< File size in mapped or direct modes
+        uint64_t _position;      //!< Offset of next packet in file in mapped or direct modes
+        uint64_t _win_offset;    //!< Offset in file of current window in mapped or direct modes
+        size_t   _win_size;      //!< Size of valid data in current window
+        uint8_t* _win_data;      //!< Address of current window (mapped file or direct I/O buffer)
+        TSPacketVector _zc_buffer; //!< Internal buffer for readZeroCopy() in read mode
 #if defined(TS_WINDOWS)
         ::HANDLE _handle;        //!< File handle
 #else
@@ -194,5 +252,9 @@ namespace ts {
         // Internal methods
         bool openInternal(Report& report);
         bool seekInternal(uint64_t, Report& report);
+        size_t windowSize() const;
+        size_t readWindow(const TSPacket*& packets, size_t max_packets, Report& report);
+        bool loadWindow(Report& report);
+        void releaseWindow();
     };
 }
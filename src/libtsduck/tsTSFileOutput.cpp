@@ -31,21 +31,78 @@
 //
 //----------------------------------------------------------------------------
 
+
 #include "tsTSFileOutput.h"
+#include "tsResidentBuffer.h"
+#include "tsIntegerUtils.h"
+#include "tsMemoryUtils.h"
+#include "tsGuardCondition.h"
+#include "tsGuard.h"
+#include "tsMonotonic.h"
+#include "tsThread.h"
 #include "tsNullReport.h"
 #include "tsSysUtils.h"
+#if !defined(TS_NO_IO_URING)
+#include <linux/io_uring.h>
+#include <sys/uio.h>
+#endif
 TSDUCK_SOURCE;
 
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+const size_t ts::TSFileOutput::DEFAULT_BUFFER_PACKETS;
+const size_t ts::TSFileOutput::DEFAULT_BUFFER_COUNT;
+#endif
+
+namespace {
+    // Alignment of direct I/O in memory and in file.
+    const size_t DIRECT_ALIGNMENT = 4096;
+
+    // Write-behind buffers are a multiple of 1024 packets, 47 memory pages of 4 kB.
+    const size_t BUFFER_PACKETS_ALIGNMENT = 1024;
+
+    // No buffer index.
+    const size_t NO_BUFFER = ~size_t(0);
+
+#if !defined(TS_NO_IO_URING)
+    // Completion tag of io_uring flush operations.
+    const uint64_t SYNC_TAG = ~uint64_t(0);
+#endif
+}
+
 
 //----------------------------------------------------------------------------
-// Default constructor.
+// Constructors.
 //----------------------------------------------------------------------------
 
+ts::TSFileOutput::WriteStatistics::WriteStatistics() :
+    mode(SYNC_WRITE),
+    direct(false),
+    writes(0),
+    bytes(0),
+    total_latency(0),
+    max_latency(0),
+    stalls(0),
+    stall_time(0),
+    syncs(0)
+{
+}
+
 ts::TSFileOutput::TSFileOutput() :
     _filename(),
     _is_open(false),
     _severity(Severity::Error),
     _total_packets(0),
+    _mode(SYNC_WRITE),
+    _actual_mode(SYNC_WRITE),
+    _buffer_packets(DEFAULT_BUFFER_PACKETS),
+    _buffer_count(DEFAULT_BUFFER_COUNT),
+    _direct(false),
+    _sync_interval(0),
+    _sync_start(0),
+    _sync_end(0),
+    _written(0),
+    _async(0),
+    _stats(),
 #if defined(TS_WINDOWS)
     _handle(INVALID_HANDLE_VALUE)
 #else
@@ -55,6 +112,669 @@ ts::TSFileOutput::TSFileOutput() :
 }
 
 
+//----------------------------------------------------------------------------
+// Base class of the write-behind engines.
+// The caller's thread fills a bounded pool of page-aligned buffers. Each full
+// buffer is submitted to the engine. The caller waits only when all buffers
+// are in flight. Errors are latched and reported at the next write or close.
+//----------------------------------------------------------------------------
+
+class ts::TSFileOutput::AsyncWriter
+{
+public:
+    AsyncWriter(TSFileOutput* file, WriteMode mode, bool direct) :
+        _file(file),
+        _buffer_size(file->_buffer_packets * PKT_SIZE),
+        _pool(file->_buffer_packets * file->_buffer_count * PKT_SIZE),
+        _sizes(file->_buffer_count, 0),
+        _offsets(file->_buffer_count, 0),
+        _times(file->_buffer_count),
+        _state_mutex(),
+        _freed(),
+        _free(),
+        _error(SYS_SUCCESS),
+        _broken(false),
+        _stats(),
+        _current(NO_BUFFER),
+        _fill(0),
+        _reported(false)
+    {
+        _stats.mode = mode;
+        _stats.direct = direct;
+        for (size_t i = file->_buffer_count; i > 0; --i) {
+            _free.push_back(i - 1);
+        }
+    }
+
+    virtual ~AsyncWriter() {}
+
+    // Start the engine. Return false if it is not available.
+    virtual bool start(ErrorCode& error_code) = 0;
+
+    // Copy packets into the write-behind buffers, submit the full ones.
+    bool write(const TSPacket* buffer, size_t packet_count, Report& report)
+    {
+        const uint8_t* data = buffer->b;
+        size_t remain = packet_count * PKT_SIZE;
+
+        while (remain > 0 && !failed()) {
+            if (_current == NO_BUFFER && (_current = acquireBuffer()) == NO_BUFFER) {
+                break;
+            }
+            const size_t size = std::min(remain, _buffer_size - _fill);
+            ::memcpy(address(_current) + _fill, data, size);
+            data += size;
+            remain -= size;
+            _fill += size;
+            if (_fill == _buffer_size) {
+                submitCurrent();
+            }
+        }
+        return checkError(report);
+    }
+
+    // Wait for all buffers in flight, write the last partial buffer and stop the engine.
+    bool close(Report& report)
+    {
+        while (inFlight() > 0) {
+            reap(true);
+        }
+
+#if !defined(TS_WINDOWS)
+        // Writes were done at explicit offsets, the file position was not updated.
+        // Move it after the written data, for the last partial buffer and for the
+        // subsequent users of the file descriptor (standard output for instance).
+        if (_stats.mode == URING_WRITE) {
+            ::lseek(_file->_fd, off_t(_file->_written), SEEK_SET);
+        }
+#endif
+
+        // The last partial buffer is written synchronously, without direct I/O when its size is not aligned.
+        if (_current != NO_BUFFER && _fill > 0 && !failed()) {
+#if defined(O_DIRECT)
+            if (_stats.direct && _fill % DIRECT_ALIGNMENT != 0) {
+                ::fcntl(_file->_fd, F_SETFL, ::fcntl(_file->_fd, F_GETFL) & ~O_DIRECT);
+            }
+#endif
+            size_t written = 0;
+            ErrorCode error_code = SYS_SUCCESS;
+            if (!_file->writeData(address(_current), _fill, written, error_code)) {
+                Guard lock(_state_mutex);
+                setError(error_code);
+            }
+            _file->_written += written;
+        }
+        _current = NO_BUFFER;
+        _fill = 0;
+
+        stop();
+        return checkError(report);
+    }
+
+    // Get a copy of the statistics.
+    WriteStatistics statistics()
+    {
+        Guard lock(_state_mutex);
+        return _stats;
+    }
+
+protected:
+    TSFileOutput* const      _file;
+    const size_t             _buffer_size;   // Size in bytes of each buffer.
+    ResidentBuffer<uint8_t>  _pool;          // All buffers, contiguous, page-aligned.
+    std::vector<size_t>      _sizes;         // Size of each buffer in flight.
+    std::vector<uint64_t>    _offsets;       // File offset of each buffer in flight.
+    std::vector<Monotonic>   _times;         // Submission time of each buffer in flight.
+    Mutex                    _state_mutex;   // Protect the fields below in multi-threaded engines.
+    Condition                _freed;         // Signaled when a buffer is freed.
+    std::vector<size_t>      _free;          // Indexes of free buffers.
+    ErrorCode                _error;         // First write error.
+    bool                     _broken;        // Broken pipe, error without message.
+    WriteStatistics          _stats;         // Statistics.
+
+    // Address of a buffer.
+    uint8_t* address(size_t index) const
+    {
+        return _pool.base() + index * _buffer_size;
+    }
+
+    // Submit a write of _sizes[index] bytes at _offsets[index].
+    virtual void submit(size_t index) = 0;
+
+    // Submit the flush of a range of the file: write back [start, end), complete [prev_start, start).
+    virtual void submitSync(uint64_t prev_start, uint64_t start, uint64_t end) = 0;
+
+    // Process completed writes. When wait is true, wait for at least one completion.
+    virtual void reap(bool wait) = 0;
+
+    // Stop the engine. All buffers are complete.
+    virtual void stop() = 0;
+
+    // Latch an error, must be called with the mutex held.
+    void setError(ErrorCode error_code)
+    {
+        if (error_code == SYS_SUCCESS) {
+            _broken = true;
+        }
+        else if (_error == SYS_SUCCESS) {
+            _error = error_code;
+        }
+    }
+
+    // Record the completion of a buffer write, must be called with the mutex held.
+    void completed(size_t index, bool success, ErrorCode error_code)
+    {
+        Monotonic now;
+        now.getSystemTime();
+        const NanoSecond latency = now - _times[index];
+        _stats.writes++;
+        _stats.bytes += _sizes[index];
+        _stats.total_latency += latency;
+        _stats.max_latency = std::max(_stats.max_latency, latency);
+        if (!success) {
+            setError(error_code);
+        }
+        _free.push_back(index);
+    }
+
+private:
+    size_t _current;   // Index of the buffer being filled.
+    size_t _fill;      // Number of bytes in the current buffer.
+    bool   _reported;  // The write error was already reported.
+
+    // Check if an error was latched.
+    bool failed()
+    {
+        Guard lock(_state_mutex);
+        return _error != SYS_SUCCESS || _broken;
+    }
+
+    // Number of buffers in flight.
+    size_t inFlight()
+    {
+        Guard lock(_state_mutex);
+        return _sizes.size() - _free.size() - (_current == NO_BUFFER ? 0 : 1);
+    }
+
+    // Get a free buffer, wait if necessary. Return NO_BUFFER on error.
+    size_t acquireBuffer()
+    {
+        reap(false);
+        bool stalled = false;
+        Monotonic start;
+        {
+            Guard lock(_state_mutex);
+            if (_free.empty()) {
+                stalled = true;
+                start.getSystemTime();
+            }
+        }
+        if (stalled) {
+            while (inFlight() > 0 && !failed() && _free.empty()) {
+                reap(true);
+            }
+            Monotonic end;
+            end.getSystemTime();
+            Guard lock(_state_mutex);
+            _stats.stalls++;
+            _stats.stall_time += end - start;
+        }
+        Guard lock(_state_mutex);
+        if (_free.empty() || _error != SYS_SUCCESS || _broken) {
+            return NO_BUFFER;
+        }
+        const size_t index = _free.back();
+        _free.pop_back();
+        return index;
+    }
+
+    // Submit the current buffer, and possibly a flush of the file.
+    void submitCurrent()
+    {
+        const size_t index = _current;
+        _sizes[index] = _fill;
+        _offsets[index] = _file->_written;
+        _times[index].getSystemTime();
+        _file->_written += _fill;
+        _current = NO_BUFFER;
+        _fill = 0;
+        submit(index);
+
+        uint64_t prev_start = 0;
+        uint64_t start = 0;
+        uint64_t end = 0;
+        if (_file->nextSyncRange(prev_start, start, end)) {
+            {
+                Guard lock(_state_mutex);
+                _stats.syncs++;
+            }
+            submitSync(prev_start, start, end);
+        }
+    }
+
+    // Report a latched error, once.
+    bool checkError(Report& report)
+    {
+        Guard lock(_state_mutex);
+        if (_error != SYS_SUCCESS && !_reported) {
+            report.log(_file->_severity, u"error writing output file %s: %s (%d)", {_file->_filename, ErrorCodeMessage(_error), _error});
+            _reported = true;
+        }
+        return _error == SYS_SUCCESS && !_broken;
+    }
+
+    // Inaccessible operations
+    AsyncWriter() = delete;
+    AsyncWriter(const AsyncWriter&) = delete;
+    AsyncWriter& operator=(const AsyncWriter&) = delete;
+};
+
+
+//----------------------------------------------------------------------------
+// Write-behind engine using a writer thread. Portable, also valid on pipes.
+//----------------------------------------------------------------------------
+
+class ts::TSFileOutput::ThreadWriter : public AsyncWriter, private Thread
+{
+public:
+    ThreadWriter(TSFileOutput* file, bool direct) :
+        AsyncWriter(file, THREAD_WRITE, direct),
+        Thread(ThreadAttributes().setPriority(ThreadAttributes::GetHighPriority())),
+        _todo(),
+        _jobs(),
+        _terminate(false)
+    {
+    }
+
+    virtual ~ThreadWriter() override
+    {
+        stop();
+    }
+
+    virtual bool start(ErrorCode& error_code) override
+    {
+        const bool ok = Thread::start();
+        error_code = ok ? SYS_SUCCESS : LastErrorCode();
+        return ok;
+    }
+
+protected:
+    virtual void submit(size_t index) override
+    {
+        GuardCondition lock(_state_mutex, _todo);
+        _jobs.push_back(Job(index, 0, 0, 0));
+        lock.signal();
+    }
+
+    virtual void submitSync(uint64_t prev_start, uint64_t start, uint64_t end) override
+    {
+        GuardCondition lock(_state_mutex, _todo);
+        _jobs.push_back(Job(NO_BUFFER, prev_start, start, end));
+        lock.signal();
+    }
+
+    virtual void reap(bool wait) override
+    {
+        GuardCondition lock(_state_mutex, _freed);
+        if (wait && !_jobs.empty()) {
+            lock.waitCondition();
+        }
+    }
+
+    virtual void stop() override
+    {
+        {
+            GuardCondition lock(_state_mutex, _todo);
+            _terminate = true;
+            lock.signal();
+        }
+        waitForTermination();
+    }
+
+private:
+    // A write job (buffer index) or a flush job (NO_BUFFER).
+    struct Job
+    {
+        size_t   index;
+        uint64_t prev_start;
+        uint64_t start;
+        uint64_t end;
+        Job(size_t i, uint64_t p, uint64_t s, uint64_t e) : index(i), prev_start(p), start(s), end(e) {}
+    };
+
+    Condition       _todo;       // Signaled when a job is queued or on termination.
+    std::deque<Job> _jobs;       // Queued jobs, the first one is being processed.
+    bool            _terminate;  // Terminate after the last job.
+
+    virtual void main() override
+    {
+        for (;;) {
+            // Wait for a job, leave it in the queue while processing it.
+            bool skip = false;
+            Job job(NO_BUFFER, 0, 0, 0);
+            {
+                GuardCondition lock(_state_mutex, _todo);
+                while (_jobs.empty() && !_terminate) {
+                    lock.waitCondition();
+                }
+                if (_jobs.empty()) {
+                    break;
+                }
+                job = _jobs.front();
+                skip = _error != SYS_SUCCESS || _broken;
+            }
+
+            // Perform the I/O outside the mutex.
+            bool success = true;
+            ErrorCode error_code = SYS_SUCCESS;
+            if (job.index == NO_BUFFER) {
+                _file->syncRange(job.start, job.end, false);
+                _file->syncRange(job.prev_start, job.start, true);
+            }
+            else if (!skip) {
+                size_t written = 0;
+                success = _file->writeData(address(job.index), _sizes[job.index], written, error_code);
+            }
+
+            // Report completion.
+            GuardCondition lock(_state_mutex, _freed);
+            _jobs.pop_front();
+            if (job.index != NO_BUFFER) {
+                completed(job.index, success, error_code);
+            }
+            lock.signal();
+        }
+    }
+};
+
+
+//----------------------------------------------------------------------------
+// Write-behind engine using io_uring (Linux only, regular files only).
+// The rings are directly managed using the system calls, without liburing.
+// All operations are done in the caller's thread, the kernel performs the
+// writes asynchronously at explicit file offsets.
+//----------------------------------------------------------------------------
+
+#if !defined(TS_NO_IO_URING)
+
+class ts::TSFileOutput::UringWriter : public AsyncWriter
+{
+public:
+    UringWriter(TSFileOutput* file, bool direct) :
+        AsyncWriter(file, URING_WRITE, direct),
+        _ring(-1),
+        _sq_ptr(MAP_FAILED),
+        _sq_size(0),
+        _cq_ptr(MAP_FAILED),
+        _cq_size(0),
+        _sqes(reinterpret_cast<::io_uring_sqe*>(MAP_FAILED)),
+        _sqes_size(0),
+        _sq_head(0),
+        _sq_tail(0),
+        _sq_mask(0),
+        _sq_entries(0),
+        _sq_array(0),
+        _cq_head(0),
+        _cq_tail(0),
+        _cq_mask(0),
+        _cqes(0),
+        _iov(file->_buffer_count),
+        _ops(0)
+    {
+        for (size_t i = 0; i < _iov.size(); ++i) {
+            _iov[i].iov_base = address(i);
+            _iov[i].iov_len = 0;
+        }
+    }
+
+    virtual ~UringWriter() override
+    {
+        stop();
+    }
+
+    virtual bool start(ErrorCode& error_code) override
+    {
+        // Room for all buffers and a few flush operations.
+        ::io_uring_params params;
+        TS_ZERO(params);
+        if ((_ring = int(::syscall(__NR_io_uring_setup, unsigned(_iov.size() + 4), &params))) < 0) {
+            error_code = LastErrorCode();
+            return false;
+        }
+
+        // Map the submission and completion rings and the submission entries.
+        _sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        _cq_size = params.cq_off.cqes + params.cq_entries * sizeof(::io_uring_cqe);
+        const bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single) {
+            _sq_size = _cq_size = std::max(_sq_size, _cq_size);
+        }
+        _sq_ptr = ::mmap(0, _sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring, IORING_OFF_SQ_RING);
+        _cq_ptr = single ? _sq_ptr : ::mmap(0, _cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring, IORING_OFF_CQ_RING);
+        _sqes_size = params.sq_entries * sizeof(::io_uring_sqe);
+        _sqes = reinterpret_cast<::io_uring_sqe*>(::mmap(0, _sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring, IORING_OFF_SQES));
+        if (_sq_ptr == MAP_FAILED || _cq_ptr == MAP_FAILED || _sqes == MAP_FAILED) {
+            error_code = LastErrorCode();
+            release();
+            return false;
+        }
+
+        uint8_t* const sq = reinterpret_cast<uint8_t*>(_sq_ptr);
+        uint8_t* const cq = reinterpret_cast<uint8_t*>(_cq_ptr);
+        _sq_head = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        _sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        _sq_mask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        _sq_entries = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_entries);
+        _sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        _cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        _cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        _cq_mask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        _cqes = reinterpret_cast<::io_uring_cqe*>(cq + params.cq_off.cqes);
+        error_code = SYS_SUCCESS;
+        return true;
+    }
+
+protected:
+    virtual void submit(size_t index) override
+    {
+        _iov[index].iov_len = _sizes[index];
+        ::io_uring_sqe* sqe = getEntry();
+        sqe->opcode = IORING_OP_WRITEV;
+        sqe->fd = _file->_fd;
+        sqe->off = _offsets[index];
+        sqe->addr = uint64_t(reinterpret_cast<uintptr_t>(&_iov[index]));
+        sqe->len = 1;
+        sqe->user_data = index;
+        if (!push()) {
+            Guard lock(_state_mutex);
+            completed(index, false, LastErrorCode());
+        }
+    }
+
+    virtual void submitSync(uint64_t prev_start, uint64_t start, uint64_t end) override
+    {
+        // Flush operations are optional, skip them when the ring is busy.
+        if (_ops + 2 <= _sq_entries) {
+            submitSyncRange(start, end, SYNC_FILE_RANGE_WRITE);
+            submitSyncRange(prev_start, start, SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+        }
+    }
+
+    virtual void reap(bool wait) override
+    {
+        for (;;) {
+            unsigned head = *_cq_head;
+            const unsigned tail = __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE);
+            if (head != tail) {
+                while (head != tail) {
+                    const ::io_uring_cqe& cqe(_cqes[head & _cq_mask]);
+                    complete(cqe.user_data, cqe.res);
+                    head++;
+                }
+                __atomic_store_n(_cq_head, head, __ATOMIC_RELEASE);
+                break;
+            }
+            if (!wait || _ops == 0 || (enter(0, 1, IORING_ENTER_GETEVENTS) < 0 && LastErrorCode() != EINTR)) {
+                break;
+            }
+        }
+    }
+
+    virtual void stop() override
+    {
+        while (_ops > 0 && _ring >= 0) {
+            reap(true);
+        }
+        release();
+    }
+
+private:
+    int                    _ring;        // io_uring file descriptor.
+    void*                  _sq_ptr;      // Submission ring mapping.
+    size_t                 _sq_size;
+    void*                  _cq_ptr;      // Completion ring mapping (may be the same as the submission ring).
+    size_t                 _cq_size;
+    ::io_uring_sqe*        _sqes;        // Submission entries mapping.
+    size_t                 _sqes_size;
+    unsigned*              _sq_head;
+    unsigned*              _sq_tail;
+    unsigned               _sq_mask;
+    unsigned               _sq_entries;
+    unsigned*              _sq_array;
+    unsigned*              _cq_head;
+    unsigned*              _cq_tail;
+    unsigned               _cq_mask;
+    ::io_uring_cqe*        _cqes;
+    std::vector<::iovec>   _iov;         // One I/O vector per buffer.
+    size_t                 _ops;         // Number of operations in flight.
+
+    // Invoke io_uring_enter().
+    int enter(unsigned to_submit, unsigned min_complete, unsigned flags)
+    {
+        return int(::syscall(__NR_io_uring_enter, _ring, to_submit, min_complete, flags, 0, 0));
+    }
+
+    // Get the next free submission entry. There is always room since _ops is bounded.
+    ::io_uring_sqe* getEntry()
+    {
+        const unsigned index = *_sq_tail & _sq_mask;
+        ::io_uring_sqe* sqe = &_sqes[index];
+        TS_ZERO(*sqe);
+        _sq_array[index] = index;
+        return sqe;
+    }
+
+    // Submit the last prepared entry.
+    bool push()
+    {
+        __atomic_store_n(_sq_tail, *_sq_tail + 1, __ATOMIC_RELEASE);
+        int ret = 0;
+        while ((ret = enter(1, 0, 0)) < 0 && LastErrorCode() == EINTR) {}
+        if (ret == 1) {
+            _ops++;
+            return true;
+        }
+        else {
+            // Not consumed by the kernel, withdraw the entry.
+            __atomic_store_n(_sq_tail, *_sq_tail - 1, __ATOMIC_RELEASE);
+            return false;
+        }
+    }
+
+    // Submit one sync_file_range() operation.
+    void submitSyncRange(uint64_t start, uint64_t end, unsigned flags)
+    {
+        if (end > start) {
+            ::io_uring_sqe* sqe = getEntry();
+            sqe->opcode = IORING_OP_SYNC_FILE_RANGE;
+            sqe->fd = _file->_fd;
+            sqe->off = start;
+            sqe->len = uint32_t(std::min<uint64_t>(end - start, 0xFFFFF000));
+            sqe->sync_range_flags = flags;
+            sqe->user_data = SYNC_TAG;
+            // The writes are not linked to the flush: make sure that all previously
+            // submitted writes are complete before flushing their range.
+            sqe->flags = IOSQE_IO_DRAIN;
+            push();
+        }
+    }
+
+    // Process the completion of an operation.
+    void complete(uint64_t tag, int32_t res)
+    {
+        assert(_ops > 0);
+        _ops--;
+        if (tag == SYNC_TAG) {
+            // Flush operations are advisory, ignore errors.
+            return;
+        }
+        const size_t index = size_t(tag);
+        bool success = res >= 0;
+        ErrorCode error_code = success ? SYS_SUCCESS : ErrorCode(-res);
+
+        // Complete a short write synchronously.
+        for (size_t done = success ? size_t(res) : 0; success && done < _sizes[index]; ) {
+            const ssize_t ret = ::pwrite(_file->_fd, address(index) + done, _sizes[index] - done, off_t(_offsets[index] + done));
+            if (ret > 0) {
+                done += size_t(ret);
+            }
+            else if (ret == 0 || (error_code = LastErrorCode()) != EINTR) {
+                error_code = ret == 0 ? ErrorCode(EIO) : error_code;
+                success = false;
+            }
+        }
+
+        Guard lock(_state_mutex);
+        completed(index, success, error_code);
+    }
+
+    // Release all system resources.
+    void release()
+    {
+        if (_sqes != MAP_FAILED) {
+            ::munmap(_sqes, _sqes_size);
+            _sqes = reinterpret_cast<::io_uring_sqe*>(MAP_FAILED);
+        }
+        if (_cq_ptr != MAP_FAILED && _cq_ptr != _sq_ptr) {
+            ::munmap(_cq_ptr, _cq_size);
+        }
+        _cq_ptr = MAP_FAILED;
+        if (_sq_ptr != MAP_FAILED) {
+            ::munmap(_sq_ptr, _sq_size);
+            _sq_ptr = MAP_FAILED;
+        }
+        if (_ring >= 0) {
+            ::close(_ring);
+            _ring = -1;
+        }
+    }
+};
+
+#endif
+
+
+//----------------------------------------------------------------------------
+// Set the write mode for the next open().
+//----------------------------------------------------------------------------
+
+void ts::TSFileOutput::setWriteMode(WriteMode mode, size_t buffer_packets, size_t buffer_count)
+{
+    _mode = mode;
+    _buffer_packets = RoundUp(buffer_packets == 0 ? DEFAULT_BUFFER_PACKETS : buffer_packets, BUFFER_PACKETS_ALIGNMENT);
+    _buffer_count = buffer_count == 0 ? DEFAULT_BUFFER_COUNT : buffer_count;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the statistics of the write-behind modes.
+//----------------------------------------------------------------------------
+
+ts::TSFileOutput::WriteStatistics ts::TSFileOutput::getWriteStatistics() const
+{
+    return _async != 0 ? _async->statistics() : _stats;
+}
+
+
 //----------------------------------------------------------------------------
 // Open method
 //----------------------------------------------------------------------------
@@ -68,6 +788,9 @@ bool ts::TSFileOutput::open(const UString& filename, bool append, bool keep, Rep
 
     _filename = filename;
     bool got_error = false;
+    bool regular = false;
+    bool append_fd = false;
+    bool direct = false;
     ErrorCode error_code = SYS_SUCCESS;
 
 #if defined (TS_WINDOWS)
@@ -100,10 +823,14 @@ bool ts::TSFileOutput::open(const UString& filename, bool append, bool keep, Rep
             ::CloseHandle(_handle);
         }
     }
+    _written = 0;
 
 #else
 
     // UNIX implementation
+    // In write-behind modes, there is only one writer at a time and the end of file
+    // is explicitly located at open. Writes at explicit offsets are not compatible
+    // with O_APPEND.
     int flags = O_CREAT | O_WRONLY | O_LARGEFILE;
     const mode_t mode = 0666; // -rw-rw-rw (minus umask)
 
@@ -111,7 +838,7 @@ bool ts::TSFileOutput::open(const UString& filename, bool append, bool keep, Rep
         flags |= O_EXCL;
     }
     else if (append) {
-        flags |= O_APPEND;
+        flags |= _mode == SYNC_WRITE ? O_APPEND : 0;
     }
     else {
         flags |= O_TRUNC;
@@ -121,20 +848,105 @@ bool ts::TSFileOutput::open(const UString& filename, bool append, bool keep, Rep
         _fd = STDOUT_FILENO;
     }
     else {
-        _fd = ::open(_filename.toUTF8().c_str(), flags, mode);
+        _fd = -1;
+#if defined(O_DIRECT)
+        // Direct I/O is not supported by all filesystems, revert to standard I/O on error.
+        if (_direct && _mode != SYNC_WRITE) {
+            if ((_fd = ::open(_filename.toUTF8().c_str(), flags | O_DIRECT, mode)) < 0) {
+                report.debug(u"cannot open %s with direct I/O, using system cache: %s", {_filename, ErrorCodeMessage()});
+            }
+            else {
+                direct = true;
+            }
+        }
+#endif
+        if (_fd < 0) {
+            _fd = ::open(_filename.toUTF8().c_str(), flags, mode);
+        }
         got_error = _fd < 0;
         error_code = LastErrorCode();
         report.debug(u"creating file %s, fd=%d, error_code=%d", {filename, _fd, error_code});
     }
 
+    if (!got_error) {
+        // An inherited file descriptor (standard output redirected with >>) may be in
+        // append mode. Each write is then done at the end of file, whatever its position.
+        const int fd_flags = ::fcntl(_fd, F_GETFL);
+        append_fd = fd_flags >= 0 && (fd_flags & O_APPEND) != 0;
+
+        // Locate the current position, when the file is seekable.
+        if ((append && _mode != SYNC_WRITE) || append_fd) {
+            ::lseek(_fd, 0, SEEK_END);
+        }
+        const off_t pos = ::lseek(_fd, 0, SEEK_CUR);
+        _written = pos < 0 ? 0 : uint64_t(pos);
+
+        // Direct I/O and io_uring are used on regular files only, at an aligned position.
+        struct stat st;
+        regular = ::fstat(_fd, &st) == 0 && S_ISREG(st.st_mode);
+#if defined(O_DIRECT)
+        if (direct && (!regular || _written % DIRECT_ALIGNMENT != 0)) {
+            report.debug(u"not using direct I/O on %s, not a regular file or unaligned end of file", {_filename});
+            ::fcntl(_fd, F_SETFL, ::fcntl(_fd, F_GETFL) & ~O_DIRECT);
+            direct = false;
+        }
+#endif
+    }
+
 #endif
 
     if (got_error) {
         report.log(_severity, u"cannot create output file %s: %s", {_filename, ErrorCodeMessage(error_code)});
+        return false;
     }
 
+    // Start the write-behind engine.
+    _actual_mode = SYNC_WRITE;
+    _async = 0;
+    _stats = WriteStatistics();
+    if (_mode != SYNC_WRITE) {
+#if !defined(TS_NO_IO_URING)
+        // In append mode, the kernel ignores the explicit offsets of io_uring writes
+        // and the buffers in flight would be appended in order of completion.
+        if (_mode == URING_WRITE && regular && append_fd) {
+            report.debug(u"not using io_uring on %s, file descriptor is in append mode", {_filename.empty() ? u"standard output" : _filename});
+        }
+        if (_mode == URING_WRITE && regular && !append_fd) {
+            _async = new UringWriter(this, direct);
+            if (_async->start(error_code)) {
+                _actual_mode = URING_WRITE;
+            }
+            else {
+                report.debug(u"io_uring not available for %s (%s), using a writer thread", {_filename, ErrorCodeMessage(error_code)});
+                delete _async;
+                _async = 0;
+            }
+        }
+#endif
+        if (_async == 0) {
+            _async = new ThreadWriter(this, direct);
+            if (_async->start(error_code)) {
+                _actual_mode = THREAD_WRITE;
+            }
+            else {
+                report.log(_severity, u"cannot start writer thread for %s: %s", {_filename, ErrorCodeMessage(error_code)});
+                delete _async;
+                _async = 0;
+                if (!_filename.empty()) {
+#if defined(TS_WINDOWS)
+                    ::CloseHandle(_handle);
+#else
+                    ::close(_fd);
+#endif
+                }
+                return false;
+            }
+        }
+    }
+
+    _sync_start = _sync_end = _written;
     _total_packets = 0;
-    return _is_open = !got_error;
+    return _is_open = true;
 }
 
 
@@ -149,6 +961,15 @@ bool ts::TSFileOutput::close(Report& report)
         return false;
     }
 
+    // Complete all pending writes.
+    bool success = true;
+    if (_async != 0) {
+        success = _async->close(report);
+        _stats = _async->statistics();
+        delete _async;
+        _async = 0;
+    }
+
     if (!_filename.empty()) {
 #if defined (TS_WINDOWS)
         ::CloseHandle(_handle);
@@ -158,7 +979,7 @@ bool ts::TSFileOutput::close(Report& report)
     }
 
     _is_open = false;
-    return true;
+    return success;
 }
 
 
@@ -185,26 +1006,62 @@ bool ts::TSFileOutput::write(const TSPacket* buffer, size_t packet_count, Report
         return false;
     }
 
-    // Loop on write until everything is gone
+    // In write-behind modes, the packets are only copied in the buffers.
+    if (_async != 0) {
+        const bool success = _async->write(buffer, packet_count, report);
+        if (success) {
+            _total_packets += packet_count;
+        }
+        return success;
+    }
 
-    bool got_error = false;
+    // Synchronous write, loop until everything is gone.
+    size_t written = 0;
     ErrorCode error_code = SYS_SUCCESS;
-    const char* const data_buffer = reinterpret_cast <const char*> (buffer);
-    const char* data = data_buffer;
+    const bool success = writeData(buffer, packet_count * PKT_SIZE, written, error_code);
+
+    if (!success && error_code != SYS_SUCCESS) {
+        report.log(_severity, u"error writing output file %s: %s (%d)", {_filename, ErrorCodeMessage(error_code), error_code});
+    }
+
+    _total_packets += written / PKT_SIZE;
+    _written += written;
+
+    // Periodically flush the file, without waiting for the last range.
+    uint64_t prev_start = 0;
+    uint64_t start = 0;
+    uint64_t end = 0;
+    if (nextSyncRange(prev_start, start, end)) {
+        _stats.syncs++;
+        syncRange(start, end, false);
+        syncRange(prev_start, start, true);
+    }
+
+    return success;
+}
+
+
+//----------------------------------------------------------------------------
+// Write a memory area at the current position of the file.
+//----------------------------------------------------------------------------
+
+bool ts::TSFileOutput::writeData(const void* data, size_t size, size_t& written, ErrorCode& error_code)
+{
+    bool got_error = false;
+    const char* ptr = reinterpret_cast<const char*>(data);
+    written = 0;
+    error_code = SYS_SUCCESS;
 
 #if defined (TS_WINDOWS)
 
     // Windows implementation
 
-    ::DWORD remain = ::DWORD (packet_count) * PKT_SIZE;
     ::DWORD outsize;
 
-    while (remain > 0 && !got_error) {
-        if (::WriteFile (_handle, data, remain, &outsize, NULL) != 0)  {
+    while (written < size && !got_error) {
+        if (::WriteFile(_handle, ptr + written, ::DWORD(size - written), &outsize, NULL) != 0)  {
             // Normal case, some data were written
-            outsize = std::min (outsize, remain);
-            data += outsize;
-            remain -= std::max (remain, outsize);
+            written += std::min<size_t>(outsize, size - written);
         }
         else if ((error_code = LastErrorCode()) == ERROR_BROKEN_PIPE || error_code == ERROR_NO_DATA) {
             // Broken pipe: error state but don't report error.
@@ -224,20 +1081,17 @@ bool ts::TSFileOutput::write(const TSPacket* buffer, size_t packet_count, Report
 
     // UNIX implementation
 
-    size_t remain = packet_count * PKT_SIZE;
     ssize_t outsize;
 
-    while (remain > 0 && !got_error) {
-        outsize = ::write (_fd, data, remain);
+    while (written < size && !got_error) {
+        outsize = ::write(_fd, ptr + written, size - written);
         if (outsize > 0) {
             // Normal case, some data were written
-            assert (size_t (outsize) <= remain);
-            data += outsize;
-            remain -= std::max (remain, size_t (outsize));
+            assert(size_t(outsize) <= size - written);
+            written += size_t(outsize);
         }
         else if ((error_code = LastErrorCode()) != EINTR) {
             // Actual error (not an interrupt)
-            report.debug(u"write error on %s, fd=%d, error_code=%d", {_filename, _fd, error_code});
             got_error = true;
             if (error_code == EPIPE) {
                 // Broken pipe: keep the error state but don't report error.
@@ -248,10 +1102,34 @@ bool ts::TSFileOutput::write(const TSPacket* buffer, size_t packet_count, Report
 
 #endif
 
-    if (got_error && error_code != SYS_SUCCESS) {
-        report.log(_severity, u"error writing output file %s: %s (%d)", {_filename, ErrorCodeMessage(error_code), error_code});
+    return !got_error;
+}
+
+
+//----------------------------------------------------------------------------
+// Periodic flush of the file.
+//----------------------------------------------------------------------------
+
+bool ts::TSFileOutput::nextSyncRange(uint64_t& prev_start, uint64_t& start, uint64_t& end)
+{
+    if (_sync_interval == 0 || _written < _sync_end + _sync_interval) {
+        return false;
     }
+    prev_start = _sync_start;
+    start = _sync_end;
+    end = _written;
+    _sync_start = start;
+    _sync_end = end;
+    return true;
+}
 
-    _total_packets += (data - data_buffer) / PKT_SIZE;
-    return !got_error;
+void ts::TSFileOutput::syncRange(uint64_t start, uint64_t end, bool wait)
+{
+#if defined(TS_LINUX)
+    if (end > start) {
+        // Advisory only, errors are ignored (pipes for instance).
+        ::sync_file_range(_fd, off64_t(start), off64_t(end - start),
+                          wait ? (SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER) : SYNC_FILE_RANGE_WRITE);
+    }
+#endif
 }
@@ -54,6 +54,103 @@ namespace ts {
         //!
         virtual ~TSFileOutput();
 
+        //!
+        //! Methods to write packets into the file.
+        //!
+        enum WriteMode {
+            SYNC_WRITE,    //!< Synchronous write() system calls from the caller's thread (default).
+            THREAD_WRITE,  //!< Write-behind: packets are copied into aligned buffers which are written by a separate thread.
+            URING_WRITE,   //!< Write-behind using io_uring on Linux, falls back to THREAD_WRITE when not available.
+        };
+
+        //!
+        //! Default size in packets of a write-behind buffer.
+        //!
+        static const size_t DEFAULT_BUFFER_PACKETS = 4096;
+
+        //!
+        //! Default number of write-behind buffers.
+        //!
+        static const size_t DEFAULT_BUFFER_COUNT = 8;
+
+        //!
+        //! Statistics of the write-behind modes.
+        //!
+        class TSDUCKDLL WriteStatistics
+        {
+        public:
+            WriteMode  mode;           //!< Actual write mode.
+            bool       direct;         //!< Direct I/O was actually used.
+            uint64_t   writes;         //!< Number of completed buffer writes.
+            uint64_t   bytes;          //!< Number of bytes in completed buffer writes.
+            NanoSecond total_latency;  //!< Cumulated latency of buffer writes.
+            NanoSecond max_latency;    //!< Maximum latency of one buffer write.
+            uint64_t   stalls;         //!< Number of times write() waited for a free buffer.
+            NanoSecond stall_time;     //!< Total time write() waited for a free buffer.
+            uint64_t   syncs;          //!< Number of written ranges which were flushed using sync_file_range().
+
+            //!
+            //! Constructor.
+            //!
+            WriteStatistics();
+        };
+
+        //!
+        //! Set the write mode for the next open().
+        //!
+        //! In the write-behind modes, the packets are copied into a bounded pool of
+        //! page-aligned buffers. write() returns as soon as the packets are copied and
+        //! waits only when all buffers are in flight. Write errors are reported by the
+        //! next call to write() or close(). The io_uring mode is used on regular files
+        //! only, other files (pipes, standard output) use a writer thread.
+        //!
+        //! @param [in] mode Write mode.
+        //! @param [in] buffer_packets Size in packets of each write-behind buffer. It is
+        //! rounded up to a multiple of 1024 packets (47 memory pages). Zero means DEFAULT_BUFFER_PACKETS.
+        //! @param [in] buffer_count Maximum number of write-behind buffers in flight.
+        //! Zero means DEFAULT_BUFFER_COUNT.
+        //!
+        void setWriteMode(WriteMode mode, size_t buffer_packets = 0, size_t buffer_count = 0);
+
+        //!
+        //! Get the write mode of the file.
+        //! @return The actual write mode when the file is open, the requested one otherwise.
+        //!
+        WriteMode getWriteMode() const
+        {
+            return _is_open ? _actual_mode : _mode;
+        }
+
+        //!
+        //! Use direct I/O (O_DIRECT on Linux) for the next open(), bypassing the system cache.
+        //! Direct I/O is used only in write-behind modes, on regular files, and when the
+        //! filesystem supports it. Silently ignored otherwise.
+        //! @param [in] on True to use direct I/O.
+        //!
+        void setDirectIO(bool on)
+        {
+            _direct = on;
+        }
+
+        //!
+        //! Set the interval for flushing the written data to disk, for the next open().
+        //! Each time @a bytes bytes have been written, the write-back of the last range
+        //! is started and the completion of the previous range is waited for, using
+        //! sync_file_range() on Linux. This bounds the amount of dirty pages in the system
+        //! cache without flushing the complete file. Ignored on other systems.
+        //! @param [in] bytes Flush interval in bytes. Zero (the default) means never flush.
+        //!
+        void setSyncInterval(uint64_t bytes)
+        {
+            _sync_interval = bytes;
+        }
+
+        //!
+        //! Get the statistics of the write-behind modes.
+        //! @return A copy of the statistics of the open file or of the last closed file.
+        //!
+        WriteStatistics getWriteStatistics() const;
+
         //!
         //! Open or create the file.
         //! @param [in] filename File name. If empty, use standard output.
@@ -123,15 +220,43 @@ namespace ts {
         }
 
     private:
-        UString       _filename;      // Output file name
-        bool          _is_open;       // Check if file is actually open
-        int           _severity;      // Severity level for error reporting
-        PacketCounter _total_packets; // Total written packets
+        // Write-behind engines, see the implementation file.
+        class AsyncWriter;
+        class ThreadWriter;
+        class UringWriter;
+
+        UString         _filename;      // Output file name
+        bool            _is_open;       // Check if file is actually open
+        int             _severity;      // Severity level for error reporting
+        PacketCounter   _total_packets; // Total written packets
+        WriteMode       _mode;          // Requested write mode
+        WriteMode       _actual_mode;   // Actual write mode of the open file
+        size_t          _buffer_packets;// Size in packets of a write-behind buffer
+        size_t          _buffer_count;  // Number of write-behind buffers
+        bool            _direct;        // Requested direct I/O
+        uint64_t        _sync_interval; // Flush interval in bytes, zero if none
+        uint64_t        _sync_start;    // Start of the last flushed range
+        uint64_t        _sync_end;      // End of the last flushed range
+        uint64_t        _written;       // Total bytes written or submitted since open
+        AsyncWriter*    _async;         // Write-behind engine, null in SYNC_WRITE mode
+        WriteStatistics _stats;         // Statistics of the last closed file
 #if defined(TS_WINDOWS)
-        ::HANDLE      _handle;        // File handle
+        ::HANDLE        _handle;        // File handle
 #else
-        int           _fd;            // File descriptor
+        int             _fd;            // File descriptor
 #endif
+
+        // Write a memory area at the current position of the file, loop on partial writes.
+        // Errors are not reported, broken pipes are returned as SYS_SUCCESS with a false result.
+        bool writeData(const void* data, size_t size, size_t& written, ErrorCode& error_code);
+
+        // Check if a range must be flushed after writing up to _written bytes.
+        // Return false if there is nothing to flush. Otherwise, [start, end) must be
+        // written back without waiting and [prev_start, start) must be completed.
+        bool nextSyncRange(uint64_t& prev_start, uint64_t& start, uint64_t& end);
+
+        // Flush a range of the file using sync_file_range().
+        void syncRange(uint64_t start, uint64_t end, bool wait);
         // Inaccessible operations
         TSFileOutput(const TSFileOutput&) = delete;
         TSFileOutput& operator=(const TSFileOutput&) = delete;
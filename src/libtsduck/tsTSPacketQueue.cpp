@@ -28,10 +28,13 @@
 //----------------------------------------------------------------------------
 
 #include "tsTSPacketQueue.h"
-#include "tsGuard.h"
 #include "tsGuardCondition.h"
 TSDUCK_SOURCE;
 
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+const size_t ts::TSPacketQueue::DEFAULT_SIZE;
+#endif
+
 
 //----------------------------------------------------------------------------
 // Constructors and destructors.
@@ -40,14 +43,15 @@ TSDUCK_SOURCE;
 ts::TSPacketQueue::TSPacketQueue(size_t size) :
     _eof(false),
     _stopped(false),
+    _inCount(0),
+    _outCount(0),
+    _bitrate(0),
+    _pcrBitrate(0),
+    _waiting(false),
     _mutex(),
     _freed(),
-    _buffer(size),
-    _pcr(1, 12),
-    _inCount(0),
-    _readIndex(0),
-    _writeIndex(0),
-    _bitrate(0)
+    _buffer(std::max<size_t>(size, 1)),
+    _pcr(1, 12)
 {
 }
 
@@ -58,28 +62,28 @@ ts::TSPacketQueue::TSPacketQueue(size_t size) :
 
 void ts::TSPacketQueue::reset(size_t size)
 {
-    Guard lock(_mutex);
-
     // Refuse to shrink too much. Keep at least one packet.
     _buffer.resize(std::max<size_t>(size, 1));
 
     _eof = false;
     _stopped = false;
     _inCount = 0;
-    _readIndex = 0;
-    _writeIndex = 0;
+    _outCount = 0;
     _bitrate = 0;
+    _pcrBitrate = 0;
+    _waiting = false;
+    _pcr.reset();
 }
 
 
 //----------------------------------------------------------------------------
-// Get the size of the buffer in packets.
+// Get the number of packets which are currently in the buffer.
 //----------------------------------------------------------------------------
 
-size_t ts::TSPacketQueue::bufferSize() const
+size_t ts::TSPacketQueue::currentSize() const
 {
-    Guard lock(_mutex);
-    return _buffer.size();
+    const uint64_t out = _outCount.load(std::memory_order_acquire);
+    return size_t(_inCount.load(std::memory_order_acquire) - out);
 }
 
 
@@ -89,36 +93,45 @@ size_t ts::TSPacketQueue::bufferSize() const
 
 bool ts::TSPacketQueue::lockWriteBuffer(TSPacket*& buffer, size_t& buffer_size, size_t min_size)
 {
-    GuardCondition lock(_mutex, _freed);
+    // The write counter is only modified by this thread.
+    const uint64_t in = _inCount.load(std::memory_order_relaxed);
+    const size_t size = _buffer.size();
+    const size_t write_index = size_t(in % size);
 
     // Maximum size we can allocate to the write window.
-    assert(_readIndex < _buffer.size());
-    assert(_writeIndex < _buffer.size());
-    const size_t max_size = _buffer.size() - _writeIndex;
+    const size_t max_size = size - write_index;
 
     // We cannot ask for more than the distance to the end of the buffer.
     // But we also need to wait for at least one packet.
     min_size = std::max<size_t>(1, std::min(min_size, max_size));
 
-    // Wait until we get enough free space.
-    while (!_stopped && _buffer.size() - _inCount < min_size) {
-        lock.waitCondition();
+    // Fast path: enough free space, no synchronization other than the reader's counter.
+    uint64_t out = _outCount.load(std::memory_order_acquire);
+
+    if (size - size_t(in - out) < min_size && !_stopped) {
+        // Not enough free space, wait until the reader thread frees some packets.
+        // The _waiting flag is set before checking the free space again, under
+        // the protection of the mutex. The reader thread checks the _waiting flag
+        // after updating its counter and signals the condition under the mutex.
+        // Consequently, a wake-up cannot be lost.
+        GuardCondition lock(_mutex, _freed);
+        _waiting = true;
+        while (!_stopped && size - size_t(in - (out = _outCount.load())) < min_size) {
+            lock.waitCondition();
+        }
+        _waiting = false;
     }
 
     // Return the write window.
-    buffer = &_buffer[_writeIndex];
+    buffer = &_buffer[write_index];
     if (_stopped) {
         // The reader thread has reported a stop condition, we can no longer write into the buffer.
         buffer_size = 0;
     }
-    else if (_readIndex > _writeIndex) {
-        // The write window extends up to the read index (where packets were not yet consumed).
-        buffer_size = _readIndex - _writeIndex;
-    }
     else {
-        // The write window wraps up at the end of the buffer.
-        // Return only the first contiguous part of the write window.
-        buffer_size = max_size;
+        // The write window extends up to the read index (where packets were not yet consumed)
+        // or wraps up at the end of the buffer. Return only the first contiguous part.
+        buffer_size = std::min(max_size, size - size_t(in - out));
     }
 
     // A write buffer is returned only when the reader thread does not want to terminate.
@@ -132,12 +145,13 @@ bool ts::TSPacketQueue::lockWriteBuffer(TSPacket*& buffer, size_t& buffer_size,
 
 void ts::TSPacketQueue::releaseWriteBuffer(size_t count)
 {
-    Guard lock(_mutex);
+    const uint64_t in = _inCount.load(std::memory_order_relaxed);
+    const uint64_t out = _outCount.load(std::memory_order_acquire);
+    const size_t size = _buffer.size();
+    const size_t write_index = size_t(in % size);
 
     // Verify that the specified size is compatible with the current write window.
-    assert(_readIndex < _buffer.size());
-    assert(_writeIndex < _buffer.size());
-    const size_t max_count = (_readIndex > _writeIndex ? _readIndex : _buffer.size()) - _writeIndex;
+    const size_t max_count = std::min(size - write_index, size - size_t(in - out));
 
     // This is a bug in the application to specify more than the max size.
     assert(count <= max_count);
@@ -148,15 +162,17 @@ void ts::TSPacketQueue::releaseWriteBuffer(size_t count)
     }
 
     // When the writer thread did not specify a bitrate, analyze PCR's.
-    if (_bitrate == 0) {
+    if (_bitrate.load(std::memory_order_relaxed) == 0) {
         for (size_t i = 0; i < count; ++i) {
-            _pcr.feedPacket(_buffer[_writeIndex + i]);
+            _pcr.feedPacket(_buffer[write_index + i]);
+        }
+        if (_pcr.bitrateIsValid()) {
+            _pcrBitrate.store(_pcr.bitrate188(), std::memory_order_relaxed);
         }
     }
 
-    // Mark written packets as part of the buffer.
-    _inCount += count;
-    _writeIndex = (_writeIndex + count) % _buffer.size();
+    // Publish the written packets to the reader thread.
+    _inCount.store(in + count, std::memory_order_release);
 }
 
 
@@ -166,14 +182,13 @@ void ts::TSPacketQueue::releaseWriteBuffer(size_t count)
 
 void ts::TSPacketQueue::setBitrate(BitRate bitrate)
 {
-    Guard lock(_mutex);
-
     // Remember the bitrate value.
     _bitrate = bitrate;
 
     // If a specific value is given, reset PCR analysis.
     if (bitrate > 0) {
         _pcr.reset();
+        _pcrBitrate = 0;
     }
 }
 
@@ -190,40 +205,84 @@ void ts::TSPacketQueue::setEOF()
 
 
 //----------------------------------------------------------------------------
-// Called by the reader thread to get the next packet.
+// Get the current bitrate, either from writer thread or from PCR analysis.
 //----------------------------------------------------------------------------
 
-bool ts::TSPacketQueue::getPacket(TSPacket& packet, BitRate& bitrate)
+ts::BitRate ts::TSPacketQueue::currentBitrate() const
 {
-    GuardCondition lock(_mutex, _freed);
+    const BitRate bitrate = _bitrate.load(std::memory_order_relaxed);
+    return bitrate != 0 ? bitrate : _pcrBitrate.load(std::memory_order_relaxed);
+}
 
-    // Get bitrate, either from reader thread or from PCR analysis.
-    if (_bitrate != 0) {
-        bitrate = _bitrate;
-    }
-    else if (_pcr.bitrateIsValid()) {
-        bitrate = _pcr.bitrate188();
-    }
-    else {
-        bitrate = 0;
-    }
 
-    // Get packet when available.
-    if (_inCount == 0) {
-        // No packet available.
-        return false;
+//----------------------------------------------------------------------------
+// Called by the reader thread to directly access the next packets.
+//----------------------------------------------------------------------------
+
+bool ts::TSPacketQueue::lockReadBuffer(const TSPacket*& buffer, size_t& buffer_size, BitRate& bitrate)
+{
+    // The read counter is only modified by this thread.
+    const uint64_t out = _outCount.load(std::memory_order_relaxed);
+    const uint64_t in = _inCount.load(std::memory_order_acquire);
+    const size_t size = _buffer.size();
+    const size_t read_index = size_t(out % size);
+
+    bitrate = currentBitrate();
+    buffer = &_buffer[read_index];
+    buffer_size = std::min(size - read_index, size_t(in - out));
+    return buffer_size > 0;
+}
+
+
+//----------------------------------------------------------------------------
+// Called by the reader thread to release packets from lockReadBuffer().
+//----------------------------------------------------------------------------
+
+void ts::TSPacketQueue::releaseReadBuffer(size_t count)
+{
+    const uint64_t out = _outCount.load(std::memory_order_relaxed);
+
+    // This is a bug in the application to release more than the available packets.
+    assert(count <= size_t(_inCount.load(std::memory_order_acquire) - out));
+
+    if (count > 0) {
+        // Publish the freed packets to the writer thread. Sequential consistency
+        // is required between this store and the load of the _waiting flag.
+        _outCount.store(out + count);
+
+        // Wake up the writer thread if it is waiting for free space.
+        if (_waiting.load()) {
+            GuardCondition lock(_mutex, _freed);
+            lock.signal();
+        }
     }
-    else {
-        // Return next packet.
-        packet = _buffer[_readIndex];
-        _readIndex = (_readIndex + 1) % _buffer.size();
-        _inCount--;
+}
 
-        // Signal the condition that a packet was freed.
-        lock.signal();
 
-        return true;
+//----------------------------------------------------------------------------
+// Called by the reader thread to get the next packets.
+//----------------------------------------------------------------------------
+
+size_t ts::TSPacketQueue::getPackets(TSPacket* buffer, size_t count, BitRate& bitrate)
+{
+    size_t done = 0;
+    const TSPacket* data = 0;
+    size_t data_size = 0;
+
+    // Copy at most two contiguous parts (before and after wrapping up the circular buffer).
+    while (done < count && lockReadBuffer(data, data_size, bitrate)) {
+        data_size = std::min(data_size, count - done);
+        TSPacket::Copy(buffer + done, data, data_size);
+        releaseReadBuffer(data_size);
+        done += data_size;
     }
+
+    return done;
+}
+
+bool ts::TSPacketQueue::getPacket(TSPacket& packet, BitRate& bitrate)
+{
+    return getPackets(&packet, 1, bitrate) == 1;
 }
 
 
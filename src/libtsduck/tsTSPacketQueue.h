@@ -43,13 +43,20 @@ namespace ts {
     //! Transport stream packet queue for inter-thread communication.
     //! @ingroup mpeg
     //!
+    //! This is a single-producer single-consumer queue: exactly one writer thread
+    //! and one reader thread. The transfer of packets is lock-free: the writer and
+    //! the reader only publish monotonic packet counters using atomic operations.
+    //! The writer thread is suspended only when the buffer is full.
+    //!
     //! A writer thread produces packets. The input packets are directly written
     //! into the buffer. The writer thread invokes lockWriteBuffer() to get
     //! a write window inside the buffer. When packets have been written into
     //! this buffer, the writer thread calls releaseWriteBuffer().
     //!
-    //! A reader thread consumes packets. The packets are consumed one by one
-    //! and copied out of the buffer using getPacket().
+    //! A reader thread consumes packets. The packets can be copied out of the buffer,
+    //! one by one using getPacket() or by batches using getPackets(). Alternatively,
+    //! the reader thread can directly access the packets inside the buffer, without
+    //! copy, using lockReadBuffer() and releaseReadBuffer().
     //!
     //! The input bitrate, if known, is transmitted to the reader thread. If the
     //! writer thread is aware of the exact bitrate, it calls setBitrate() and
@@ -74,7 +81,7 @@ namespace ts {
 
         //!
         //! Reset and resize the buffer.
-        //! It is illegal to reset the buffer while the writer thread has locked the buffer.
+        //! It is illegal to reset the buffer while the writer or reader thread is using the buffer.
         //! This is not enforced by this class. It is the responsibility of the application
         //! to check this.
         //! @param [in] size New size of the buffer in packets.
@@ -85,7 +92,14 @@ namespace ts {
         //! Get the size of the buffer in packets.
         //! @return The size of the buffer in packets.
         //!
-        size_t bufferSize() const;
+        size_t bufferSize() const { return _buffer.size(); }
+
+        //!
+        //! Get the number of packets which are currently in the buffer.
+        //! @return The number of packets in the buffer. This is only a snapshot
+        //! when the writer and reader threads are active.
+        //!
+        size_t currentSize() const;
 
         //!
         //! Called by the writer thread to get a write buffer.
@@ -138,6 +152,37 @@ namespace ts {
         //!
         bool getPacket(TSPacket& packet, BitRate& bitrate);
 
+        //!
+        //! Called by the reader thread to get the next packets.
+        //! The reader thread is never suspended. The packets are copied out of the buffer.
+        //! @param [out] buffer Address of an array of packets.
+        //! @param [in] count Maximum number of packets to get.
+        //! @param [out] bitrate Input bitrate or zero if unknown.
+        //! @return The number of packets which were returned in @a buffer.
+        //! Zero if none was available or an end of file occured.
+        //!
+        size_t getPackets(TSPacket* buffer, size_t count, BitRate& bitrate);
+
+        //!
+        //! Called by the reader thread to directly access the next packets in the buffer.
+        //! The reader thread is never suspended. The packets remain in the buffer until
+        //! releaseReadBuffer() is called. The writer thread does not overwrite them.
+        //! @param [out] buffer Address of the first available packet in the buffer.
+        //! @param [out] buffer_size Number of contiguous packets at @a buffer. This can be
+        //! less than the total number of available packets when the read window wraps
+        //! up at the end of the circular buffer. Zero if no packet is available.
+        //! @param [out] bitrate Input bitrate or zero if unknown.
+        //! @return True if at least one packet is available, false otherwise.
+        //!
+        bool lockReadBuffer(const TSPacket*& buffer, size_t& buffer_size, BitRate& bitrate);
+
+        //!
+        //! Called by the reader thread to release packets which were returned by lockReadBuffer().
+        //! @param [in] count Number of packets which were consumed by the reader thread.
+        //! Must be no greater than the size which was returned by lockReadBuffer().
+        //!
+        void releaseReadBuffer(size_t count);
+
         //!
         //! Check if the writer thread has reported an end of file condition.
         //! @return True if the writer thread has reported an end of file condition.
@@ -150,16 +195,23 @@ namespace ts {
         void stop();
 
     private:
-        volatile bool  _eof;         // The writer thread has reported an end of file.
-        volatile bool  _stopped;     // The read thread has reported a stop condition.
-        mutable Mutex  _mutex;       // Protect access to shared data.
-        Condition      _freed;       // Condition to signal when packets were freed.
-        TSPacketVector _buffer;      // The packet buffer.
-        PCRAnalyzer    _pcr;         // PCR analyzer to get the bitrate.
-        size_t         _inCount;     // Number of packets currently inside the buffer.
-        size_t         _readIndex;   // Index of next packet to read.
-        size_t         _writeIndex;  // Index of next packet to write.
-        BitRate        _bitrate;     // Bitrate as set by the writer thread.
+        // The packet counters are monotonic, they are never reset except in reset().
+        // The index in the buffer of a packet counter is the counter modulo the buffer size.
+        // Each counter has only one writer thread.
+        std::atomic<bool>     _eof;         // The writer thread has reported an end of file.
+        std::atomic<bool>     _stopped;     // The read thread has reported a stop condition.
+        std::atomic<uint64_t> _inCount;     // Total number of packets written (updated by writer).
+        std::atomic<uint64_t> _outCount;    // Total number of packets read (updated by reader).
+        std::atomic<BitRate>  _bitrate;     // Bitrate as set by the writer thread.
+        std::atomic<BitRate>  _pcrBitrate;  // Bitrate as computed from PCR's by the writer thread.
+        std::atomic<bool>     _waiting;     // The writer thread is waiting for free space.
+        Mutex                 _mutex;       // Only used to suspend the writer thread.
+        Condition             _freed;       // Condition to signal when packets were freed.
+        TSPacketVector        _buffer;      // The packet buffer.
+        PCRAnalyzer           _pcr;         // PCR analyzer to get the bitrate (used by writer only).
+
+        // Get the current bitrate (reader thread).
+        BitRate currentBitrate() const;
 
         // Inaccessible operations
         TSPacketQueue(const TSPacketQueue&) = delete;
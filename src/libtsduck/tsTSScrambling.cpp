@@ -39,13 +39,17 @@ ts::TSScrambling::TSScrambling(Report& report, uint8_t scrambling) :
     _report(report),
     _scrambling_type(scrambling),
     _explicit_type(false),
+    _batch(true),
     _cw_list(),
     _next_cw(_cw_list.end()),
     _encrypt_scv(SC_CLEAR),
     _decrypt_scv(SC_CLEAR),
     _dvbcsa(),
     _idsa(),
-    _scrambler{0, 0}
+    _scrambler{0, 0},
+    _batch_pkts(),
+    _batch_data(),
+    _batch_size()
 {
     setScramblingType(scrambling);
 }
@@ -54,13 +58,17 @@ ts::TSScrambling::TSScrambling(const TSScrambling& other) :
     _report(other._report),
     _scrambling_type(other._scrambling_type),
     _explicit_type(other._explicit_type),
+    _batch(other._batch),
     _cw_list(other._cw_list),
     _next_cw(_cw_list.end()),
     _encrypt_scv(SC_CLEAR),
     _decrypt_scv(SC_CLEAR),
     _dvbcsa(),
     _idsa(),
-    _scrambler{0, 0}
+    _scrambler{0, 0},
+    _batch_pkts(),
+    _batch_data(),
+    _batch_size()
 {
     setScramblingType(_scrambling_type);
 }
@@ -135,6 +143,11 @@ void ts::TSScrambling::addHelp(Args& args) const
         u"      \"scrambling_control\" changes in the TS packets header. When all control\n"
         u"      words are used, the first one is used again, and so on.\n"
         u"\n"
+        u"  --no-batch\n"
+        u"      With DVB-CSA2, process packets one by one. By default, packets are\n"
+        u"      processed in batches using a parallel bitsliced implementation. This\n"
+        u"      option is useful to compare the performances of the two implementations.\n"
+        u"\n"
         u"  -n\n"
         u"  --no-entropy-reduction\n"
         u"      With DVB-CSA2, do not perform control word entropy reduction to 48 bits.\n"
@@ -154,6 +167,7 @@ void ts::TSScrambling::defineOptions(Args& args) const
     args.option(u"cw",                   'c', Args::STRING);
     args.option(u"cw-file",              'f', Args::STRING);
     args.option(u"dvb-csa2",              0);
+    args.option(u"no-batch",              0);
     args.option(u"no-entropy-reduction", 'n');
 }
 
@@ -180,6 +194,9 @@ bool ts::TSScrambling::loadArgs(Args& args)
     // ignore scrambling descriptors when descrambling.
     _explicit_type = args.present(u"atis-idsa") || args.present(u"dvb-csa2");
 
+    // Batch processing of DVB-CSA2 packets.
+    _batch = !args.present(u"no-batch");
+
     // Set DVB-CSA2 entropy mode regardless of --atis-idsa in case we switch later to DVB-CSA2.
     setEntropyMode(args.present(u"no-entropy-reduction") ? DVBCSA2::FULL_CW : DVBCSA2::REDUCE_ENTROPY);
 
@@ -269,7 +286,7 @@ bool ts::TSScrambling::setCW(const ByteBlock& cw, int parity)
     assert(algo != 0);
 
     if (algo->setKey(cw.data(), cw.size())) {
-        _report.debug(u"using scrambling key: " + UString::Dump(cw, UString::SINGLE_LINE));
+        TS_DEBUG(_report, u"using scrambling key: " + UString::Dump(cw, UString::SINGLE_LINE));
         return true;
     }
     else {
@@ -361,3 +378,135 @@ bool ts::TSScrambling::decrypt(TSPacket& pkt)
     }
     return ok;
 }
+
+
+//----------------------------------------------------------------------------
+// Process the collected batch of packets with one key.
+//----------------------------------------------------------------------------
+
+bool ts::TSScrambling::processBatch(int parity, bool encrypt)
+{
+    assert(batchEnabled());
+    assert(_batch_data.size() == _batch_size.size());
+
+    DVBCSA2& csa(_dvbcsa[parity & 1]);
+    return _batch_data.empty() ||
+        (encrypt ? csa.encryptBatch(&_batch_data[0], &_batch_size[0], _batch_data.size()) :
+                   csa.decryptBatch(&_batch_data[0], &_batch_size[0], _batch_data.size()));
+}
+
+
+//----------------------------------------------------------------------------
+// Encrypt several TS packets with the current parity and corresponding CW.
+//----------------------------------------------------------------------------
+
+bool ts::TSScrambling::encrypt(TSPacket* const* pkts, size_t count)
+{
+    // Without batch processing, encrypt packets one by one.
+    if (!batchEnabled()) {
+        bool ok = true;
+        for (size_t i = 0; ok && i < count; ++i) {
+            ok = encrypt(*pkts[i]);
+        }
+        return ok;
+    }
+
+    // Collect payloads of packets to encrypt.
+    _batch_pkts.clear();
+    _batch_data.clear();
+    _batch_size.clear();
+    for (size_t i = 0; i < count; ++i) {
+        TSPacket* pkt = pkts[i];
+        if (pkt->isScrambled()) {
+            _report.error(u"try to scramble an already scrambled packet");
+            return false;
+        }
+        if (pkt->hasPayload()) {
+            _batch_pkts.push_back(pkt);
+            _batch_data.push_back(pkt->getPayload());
+            _batch_size.push_back(pkt->getPayloadSize());
+        }
+    }
+    if (_batch_pkts.empty()) {
+        return true;
+    }
+
+    // If no current parity is set, start with even by default.
+    if (_encrypt_scv == SC_CLEAR && !setEncryptParity(SC_EVEN_KEY)) {
+        return false;
+    }
+    assert(_encrypt_scv == SC_EVEN_KEY || _encrypt_scv == SC_ODD_KEY);
+
+    // Encrypt all packets.
+    if (!processBatch(_encrypt_scv, true)) {
+        return false;
+    }
+    for (size_t i = 0; i < _batch_pkts.size(); ++i) {
+        _batch_pkts[i]->setScrambling(_encrypt_scv);
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Decrypt several TS packets with the CW corresponding to their parity.
+//----------------------------------------------------------------------------
+
+bool ts::TSScrambling::decrypt(TSPacket* const* pkts, size_t count)
+{
+    // Without batch processing, decrypt packets one by one.
+    if (!batchEnabled()) {
+        bool ok = true;
+        for (size_t i = 0; ok && i < count; ++i) {
+            ok = decrypt(*pkts[i]);
+        }
+        return ok;
+    }
+
+    size_t i = 0;
+    while (i < count) {
+
+        // Collect all consecutive packets with the same scrambling control value.
+        // Clear or invalid packets are silently accepted.
+        uint8_t scv = SC_CLEAR;
+        _batch_pkts.clear();
+        _batch_data.clear();
+        _batch_size.clear();
+        for (; i < count; ++i) {
+            TSPacket* pkt = pkts[i];
+            const uint8_t pkt_scv = pkt->getScrambling();
+            if (pkt_scv == SC_EVEN_KEY || pkt_scv == SC_ODD_KEY) {
+                if (scv == SC_CLEAR) {
+                    scv = pkt_scv;
+                }
+                else if (pkt_scv != scv) {
+                    break;
+                }
+                _batch_pkts.push_back(pkt);
+                _batch_data.push_back(pkt->getPayload());
+                _batch_size.push_back(pkt->getPayloadSize());
+            }
+        }
+        if (_batch_pkts.empty()) {
+            break;
+        }
+
+        // Update current parity.
+        const uint8_t previous_scv = _decrypt_scv;
+        _decrypt_scv = scv;
+
+        // In case of fixed control word, use next key when the scrambling control changes.
+        if (hasFixedCW() && previous_scv != _decrypt_scv && !setNextFixedCW(_decrypt_scv)) {
+            return false;
+        }
+
+        // Decrypt the packets.
+        if (!processBatch(_decrypt_scv, false)) {
+            return false;
+        }
+        for (size_t n = 0; n < _batch_pkts.size(); ++n) {
+            _batch_pkts[n]->setScrambling(SC_CLEAR);
+        }
+    }
+    return true;
+}
@@ -180,6 +180,33 @@ namespace ts {
         //!
         bool decrypt(TSPacket& pkt);
 
+        //!
+        //! Encrypt several TS packets with the current parity and corresponding CW.
+        //! With DVB-CSA2, the packets are processed in parallel, unless disabled by
+        //! option @c --no-batch. Packets without payload are ignored.
+        //! @param [in,out] pkts Array of @a count addresses of packets to encrypt.
+        //! @param [in] count Number of packets.
+        //! @return True on success, false on error. An already encrypted packet is an error.
+        //!
+        bool encrypt(TSPacket* const* pkts, size_t count);
+
+        //!
+        //! Decrypt several TS packets with the CW corresponding to the parity in each packet.
+        //! With DVB-CSA2, the packets are processed in parallel, unless disabled by
+        //! option @c --no-batch. Changes of parity are processed in packet order.
+        //! @param [in,out] pkts Array of @a count addresses of packets to decrypt.
+        //! @param [in] count Number of packets.
+        //! @return True on success, false on error. A clear packet is not an error.
+        //!
+        bool decrypt(TSPacket* const* pkts, size_t count);
+
+        //!
+        //! Check if packets are processed in parallel by the batch operations.
+        //! @return True if encrypt() and decrypt() on several packets use the parallel
+        //! implementation of the current algorithm.
+        //!
+        bool batchEnabled() const { return _batch && _scrambler[0] == &_dvbcsa[0]; }
+
     private:
         // List of control words
         typedef std::list<ByteBlock> CWList;
@@ -187,6 +214,7 @@ namespace ts {
         Report&          _report;
         uint8_t          _scrambling_type;
         bool             _explicit_type;
+        bool             _batch;        // Use the batch operations of DVB-CSA2.
         CWList           _cw_list;
         CWList::iterator _next_cw;
         uint8_t          _encrypt_scv;  // Encryption: key to use (SC_EVEN_KEY or SC_ODD_KEY).
@@ -194,6 +222,12 @@ namespace ts {
         DVBCSA2          _dvbcsa[2];    // Index 0 = even key, 1 = odd key. 
         IDSA             _idsa[2];
         CipherChaining*  _scrambler[2];
+        std::vector<TSPacket*> _batch_pkts;  // Batch processing: packets in current parity.
+        std::vector<uint8_t*>  _batch_data;  // Batch processing: payload addresses.
+        std::vector<size_t>    _batch_size;  // Batch processing: payload sizes.
+
+        // Process the collected batch of DVB-CSA2 packets with the key of the given parity.
+        bool processBatch(int parity, bool encrypt);
 
         // Set the next fixed control word as scrambling key.
         bool setNextFixedCW(int parity);
@@ -59,8 +59,6 @@ ts::TablesLogger::TablesLogger(const TablesLoggerArgs& opt, TablesDisplay& displ
     _demux(0, 0, opt.pid),
     _cas_mapper(report),
     _xmlOut(report),
-    _xmlDoc(report),
-    _xmlOpen(false),
     _binfile(),
     _sock(false, report),
     _shortSections(),
@@ -82,16 +80,12 @@ ts::TablesLogger::TablesLogger(const TablesLoggerArgs& opt, TablesDisplay& displ
 
     // Open/create the XML output.
     if (_opt.use_xml) {
-        if (_opt.xml_destination.empty()) {
-            // Use standard output.
-            _xmlOut.setStream(std::cout);
-        }
-        else if (!_xmlOut.setFile(_opt.xml_destination)) {
+        // Use standard output if no file is specified.
+        const bool ok = _opt.xml_destination.empty() ? _xmlOut.open(std::cout, u"tsduck") : _xmlOut.open(_opt.xml_destination, u"tsduck");
+        if (!ok) {
             _abort = true;
             return;
         }
-        // Initialize the XML document.
-        _xmlDoc.initialize(u"tsduck");
     }
 
     // Open/create the binary output.
@@ -147,10 +141,7 @@ void ts::TablesLogger::close()
         }
 
         // Close files and documents.
-        if (_xmlOpen) {
-            _xmlDoc.printClose(_xmlOut);
-            _xmlOpen = false;
-        }
+        _xmlOut.close();
         if (_binfile.is_open()) {
             _binfile.close();
         }
@@ -238,7 +229,7 @@ void ts::TablesLogger::handleTable(SectionDemux&, const BinaryTable& table)
 
     if (_opt.use_xml) {
         // Convert the table into an XML structure.
-        xml::Element* elem = table.toXML(_xmlDoc.rootElement(), false, _display.dvbCharset());
+        xml::Element* elem = table.toXML(_xmlOut.rootElement(), false, _display.dvbCharset());
         if (elem != 0) {
             // Add an XML comment as first child of the table.
             UString comment(UString::Format(u" PID 0x%X (%d)", {pid, pid}));
@@ -250,21 +241,8 @@ void ts::TablesLogger::handleTable(SectionDemux&, const BinaryTable& table)
             }
             new xml::Comment(elem, comment + u" ", false); // first position
 
-            // Print the new table.
-            if (_xmlOpen) {
-                _xmlOut << ts::margin;
-                elem->print(_xmlOut, false);
-                _xmlOut << std::endl;
-            }
-            else {
-                // If this is the first table, print the document header with it.
-                _xmlOpen = true;
-                _xmlDoc.print(_xmlOut, true);
-            }
-
-            // Now remove the table from the document. Keeping them would eat up memory for no use.
-            // Deallocating the element forces the removal from the document through the destructor.
-            delete elem;
+            // Print the new table and remove it from the document. Keeping them would eat up memory for no use.
+            _xmlOut.flush();
         }
     }
 
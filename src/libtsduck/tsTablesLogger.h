@@ -41,7 +41,7 @@
 #include "tsSocketAddress.h"
 #include "tsUDPSocket.h"
 #include "tsCASMapper.h"
-#include "tsxmlDocument.h"
+#include "tsxmlWriter.h"
 
 namespace ts {
     //!
@@ -145,9 +145,7 @@ namespace ts {
         PacketCounter            _packet_count;
         SectionDemux             _demux;
         CASMapper                _cas_mapper;
-        TextFormatter            _xmlOut;          // XML output formatter.
-        xml::Document            _xmlDoc;          // XML root document.
-        bool                     _xmlOpen;         // The XML root element is open.
+        xml::Writer              _xmlOut;          // Streaming XML output.
         std::ofstream            _binfile;         // Binary output file.
         UDPSocket                _sock;            // Output socket.
         std::map<PID,SectionPtr> _shortSections;   // Tracking duplicate short sections by PID.
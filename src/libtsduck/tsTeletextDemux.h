@@ -167,7 +167,7 @@ namespace ts {
         //!
         //! Map of PID analysis contexts, indexed by PID value.
         //!
-        typedef std::map<PID, PIDContext> PIDContextMap;
+        typedef PIDMap<PIDContext> PIDContextMap;
 
         //!
         //! Process one Teletext packet.
@@ -44,6 +44,7 @@ ts::Thread::Thread() :
     _mutex(),
     _started(false),
     _waiting(false),
+    _sched_error(SYS_SUCCESS),
 #if defined(TS_WINDOWS)
     _handle(INVALID_HANDLE_VALUE),
     _thread_id(0)
@@ -63,6 +64,7 @@ ts::Thread::Thread(const ThreadAttributes& attributes) :
     _mutex(),
     _started(false),
     _waiting(false),
+    _sched_error(SYS_SUCCESS),
 #if defined(TS_WINDOWS)
     _handle(INVALID_HANDLE_VALUE),
     _thread_id(0)
@@ -304,6 +306,69 @@ bool ts::Thread::waitForTermination()
 }
 
 
+//----------------------------------------------------------------------------
+// Apply CPU affinity, scheduling policy and NUMA node in the context of the thread.
+//----------------------------------------------------------------------------
+
+void ts::Thread::applySchedulingAttributes()
+{
+    _sched_error = SYS_SUCCESS;
+
+    // CPU affinity. Without explicit affinity, use the CPU's of the NUMA node, if any.
+    ThreadAttributes::CPUSet cpus(_attributes._affinity);
+    if (cpus.empty() && _attributes._numaNode >= 0) {
+        ThreadAttributes::GetNUMANodeCPUs(_attributes._numaNode, cpus);
+    }
+
+#if defined(TS_LINUX)
+
+    // Memory placement on the NUMA node.
+    if (_attributes._numaNode >= 0) {
+        _sched_error = SetThreadNUMANode(_attributes._numaNode);
+    }
+
+    if (!cpus.empty()) {
+        ::cpu_set_t set;
+        CPU_ZERO(&set);
+        for (ThreadAttributes::CPUSet::const_iterator it = cpus.begin(); it != cpus.end() && *it < CPU_SETSIZE; ++it) {
+            CPU_SET(*it, &set);
+        }
+        const int err = ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set);
+        if (err != 0) {
+            _sched_error = err;
+        }
+    }
+
+#elif defined(TS_WINDOWS)
+
+    if (!cpus.empty()) {
+        ::DWORD_PTR mask = 0;
+        for (ThreadAttributes::CPUSet::const_iterator it = cpus.begin(); it != cpus.end() && *it < 8 * sizeof(mask); ++it) {
+            mask |= ::DWORD_PTR(1) << *it;
+        }
+        if (mask == 0 || ::SetThreadAffinityMask(::GetCurrentThread(), mask) == 0) {
+            _sched_error = mask == 0 ? ERROR_INVALID_PARAMETER : LastErrorCode();
+        }
+    }
+
+#endif
+
+#if defined(TS_UNIX)
+
+    // Real-time scheduling policy.
+    if (_attributes._policy != ThreadAttributes::DEFAULT_POLICY) {
+        ::sched_param sparam;
+        sparam.sched_priority = _attributes._rtPriority;
+        const int err = ::pthread_setschedparam(::pthread_self(), _attributes._policy == ThreadAttributes::FIFO_POLICY ? SCHED_FIFO : SCHED_RR, &sparam);
+        if (err != 0) {
+            _sched_error = err;
+        }
+    }
+
+#endif
+}
+
+
 //----------------------------------------------------------------------------
 // Static method. Actual starting point of threads. Parameter is "this".
 //----------------------------------------------------------------------------
@@ -314,6 +379,7 @@ bool ts::Thread::waitForTermination()
 {
     // Execute thread code.
     Thread* thread(reinterpret_cast<Thread*>(parameter));
+    thread->applySchedulingAttributes();
     thread->main();
 
     // Perform auto-deallocation
@@ -332,6 +398,7 @@ void* ts::Thread::ThreadProc(void* parameter)
 {
     // Execute thread code.
     Thread* thread(reinterpret_cast<Thread*>(parameter));
+    thread->applySchedulingAttributes();
     thread->main();
 
     // Perform auto-deallocation
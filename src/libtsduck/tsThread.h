@@ -180,6 +180,23 @@ namespace ts {
         //!
         bool isCurrentThread() const;
 
+        //!
+        //! Get the error code of the execution attributes of the thread.
+        //!
+        //! The CPU affinity, real-time scheduling policy and NUMA node of the
+        //! thread (see ts::ThreadAttributes) are applied in the context of the
+        //! thread, before invoking main(). When some of them cannot be applied,
+        //! the thread runs without them. This method is typically invoked from
+        //! main() to report such errors.
+        //!
+        //! @return A system-specific error code, SYS_SUCCESS if all execution
+        //! attributes were successfully applied.
+        //!
+        ErrorCode schedulingErrorCode() const
+        {
+            return _sched_error;
+        }
+
         //!
         //! This hook is invoked in the context of the thread.
         //!
@@ -206,10 +223,14 @@ namespace ts {
         mutable Mutex _mutex;
         volatile bool _started;
         volatile bool _waiting;
+        ErrorCode _sched_error;
 
         // Internal version of isCurrentThread(), bypass checks
         bool isCurrentThreadUnchecked() const;
 
+        // Apply CPU affinity, scheduling policy and NUMA node in the context of the thread.
+        void applySchedulingAttributes();
+
 #if defined(TS_WINDOWS)
         ::HANDLE _handle;
         ::DWORD _thread_id;
@@ -152,7 +152,11 @@ int ts::ThreadAttributes::Win32Priority(int priority)
 ts::ThreadAttributes::ThreadAttributes() :
     _stackSize(0),
     _deleteWhenTerminated(false),
-    _priority(0)
+    _priority(0),
+    _affinity(),
+    _policy(DEFAULT_POLICY),
+    _rtPriority(0),
+    _numaNode(-1)
 {
     if (!_priorityInitialized) {
         InitializePriorities();
@@ -172,3 +176,87 @@ ts::ThreadAttributes& ts::ThreadAttributes::setPriority(int priority)
     _priority = std::max(_minimumPriority, std::min(_maximumPriority, priority));
     return *this;
 }
+
+
+//----------------------------------------------------------------------------
+// Set a real-time scheduling policy for the thread.
+//----------------------------------------------------------------------------
+
+ts::ThreadAttributes& ts::ThreadAttributes::setSchedulingPolicy(SchedulingPolicy policy, int priority)
+{
+    _policy = policy;
+    _rtPriority = priority;
+
+#if defined(TS_UNIX)
+    if (policy != DEFAULT_POLICY) {
+        // Force within allowed range of the real-time policy.
+        const int sched = policy == FIFO_POLICY ? SCHED_FIFO : SCHED_RR;
+        const int prioMin = ::sched_get_priority_min(sched);
+        const int prioMax = ::sched_get_priority_max(sched);
+        if (prioMin >= 0 && prioMax >= prioMin) {
+            _rtPriority = std::max(prioMin, std::min(prioMax, priority));
+        }
+    }
+#endif
+
+    return *this;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the set of CPU's of a NUMA node.
+//----------------------------------------------------------------------------
+
+bool ts::ThreadAttributes::GetNUMANodeCPUs(int node, CPUSet& cpus)
+{
+    cpus.clear();
+
+#if defined(TS_LINUX)
+    // The CPU list of each node is available in sysfs.
+    UStringList lines;
+    return node >= 0 &&
+        UString::Load(lines, UString::Format(u"/sys/devices/system/node/node%d/cpulist", {node})) &&
+        !lines.empty() &&
+        DecodeCPUSet(lines.front(), cpus);
+#else
+    return false;
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Decode a list of CPU indexes.
+//----------------------------------------------------------------------------
+
+// Upper bound of CPU indexes, just to reject absurd values.
+#define MAX_CPU_COUNT 65536
+
+bool ts::ThreadAttributes::DecodeCPUSet(const UString& list, CPUSet& cpus)
+{
+    cpus.clear();
+
+    UStringVector ranges;
+    list.toTrimmed().split(ranges, u',', true, true);
+
+    for (UStringVector::const_iterator it = ranges.begin(); it != ranges.end(); ++it) {
+        size_t first = 0;
+        size_t last = 0;
+        const size_t dash = it->find(u'-');
+        if (dash == UString::NPOS) {
+            if (!it->toInteger(first)) {
+                return false;
+            }
+            last = first;
+        }
+        else if (!it->substr(0, dash).toInteger(first) || !it->substr(dash + 1).toInteger(last) || last < first) {
+            return false;
+        }
+        if (last >= MAX_CPU_COUNT) {
+            return false;
+        }
+        for (size_t cpu = first; cpu <= last; ++cpu) {
+            cpus.insert(cpu);
+        }
+    }
+    return !cpus.empty();
+}
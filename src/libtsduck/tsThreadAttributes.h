@@ -33,7 +33,7 @@
 //----------------------------------------------------------------------------
 
 #pragma once
-#include "tsPlatform.h"
+#include "tsUString.h"
 
 namespace ts {
     //!
@@ -237,10 +237,138 @@ namespace ts {
             return GetPriority(_maximumPriority);
         }
 
+        //!
+        //! A set of CPU indexes, as used in thread affinity.
+        //!
+        typedef std::set<size_t> CPUSet;
+
+        //!
+        //! Set the CPU affinity of the thread.
+        //!
+        //! The thread is allowed to run only on the specified CPU's. This is currently
+        //! implemented on Linux and Windows only (on Windows, only the first 64 CPU's
+        //! can be specified). The affinity is ignored on other operating systems.
+        //!
+        //! @param [in] cpus Set of CPU indexes. An empty set means all CPU's (the default).
+        //! @return A reference to this object.
+        //!
+        ThreadAttributes& setAffinity(const CPUSet& cpus)
+        {
+            _affinity = cpus;
+            return *this;
+        }
+
+        //!
+        //! Get the CPU affinity of the thread.
+        //! @return A constant reference to the set of CPU indexes. An empty set means all CPU's.
+        //! @see setAffinity()
+        //!
+        const CPUSet& getAffinity() const
+        {
+            return _affinity;
+        }
+
+        //!
+        //! Scheduling policy of a thread.
+        //!
+        enum SchedulingPolicy {
+            DEFAULT_POLICY,  //!< Same scheduling policy as the process, use the priority from setPriority().
+            FIFO_POLICY,     //!< Real-time first-in first-out policy (SCHED_FIFO on UNIX systems).
+            RR_POLICY        //!< Real-time round-robin policy (SCHED_RR on UNIX systems).
+        };
+
+        //!
+        //! Set a real-time scheduling policy for the thread.
+        //!
+        //! This is currently implemented on UNIX systems only. The policy is ignored on
+        //! Windows. Using a real-time scheduling policy usually requires privileges.
+        //! If the policy cannot be applied, the thread runs with the scheduling policy
+        //! of the process (see ts::Thread::schedulingErrorCode()).
+        //!
+        //! @param [in] policy Scheduling policy.
+        //! @param [in] priority Real-time priority of the thread, using the operating system
+        //! range of real-time priorities for @a policy (typically 1 to 99 on Linux). If the
+        //! specified priority is out of range, the nearest valid value is used. With
+        //! DEFAULT_POLICY, the real-time priority is ignored and the priority from
+        //! setPriority() is used.
+        //! @return A reference to this object.
+        //!
+        ThreadAttributes& setSchedulingPolicy(SchedulingPolicy policy, int priority = 0);
+
+        //!
+        //! Get the scheduling policy of the thread.
+        //! @return The scheduling policy of the thread.
+        //! @see setSchedulingPolicy()
+        //!
+        SchedulingPolicy getSchedulingPolicy() const
+        {
+            return _policy;
+        }
+
+        //!
+        //! Get the real-time priority of the thread.
+        //! @return The real-time priority of the thread, meaningful with real-time policies only.
+        //! @see setSchedulingPolicy()
+        //!
+        int getRealTimePriority() const
+        {
+            return _rtPriority;
+        }
+
+        //!
+        //! Set the NUMA node of the thread.
+        //!
+        //! The memory which is allocated by the thread is preferably taken from this node.
+        //! If no CPU affinity is specified, the thread is also restricted to the CPU's
+        //! of this node. This is currently implemented on Linux only and ignored on
+        //! other operating systems.
+        //!
+        //! @param [in] node NUMA node index. A negative value means no NUMA placement (the default).
+        //! @return A reference to this object.
+        //!
+        ThreadAttributes& setNUMANode(int node)
+        {
+            _numaNode = node;
+            return *this;
+        }
+
+        //!
+        //! Get the NUMA node of the thread.
+        //! @return The NUMA node index of the thread or a negative value if unspecified.
+        //! @see setNUMANode()
+        //!
+        int getNUMANode() const
+        {
+            return _numaNode;
+        }
+
+        //!
+        //! Get the set of CPU's of a NUMA node.
+        //! This is currently implemented on Linux only.
+        //! @param [in] node NUMA node index.
+        //! @param [out] cpus Set of CPU indexes in the node.
+        //! @return True on success, false if the node does not exist or NUMA is not supported.
+        //!
+        static bool GetNUMANodeCPUs(int node, CPUSet& cpus);
+
+        //!
+        //! Decode a list of CPU indexes.
+        //! The format is the same as the Linux "cpulist" format, a comma-separated
+        //! list of CPU indexes or ranges of CPU indexes, for instance "0-3,8,10-11".
+        //! @param [in] list String representation of the list of CPU's.
+        //! @param [out] cpus Set of CPU indexes.
+        //! @return True on success, false on invalid list.
+        //!
+        static bool DecodeCPUSet(const UString& list, CPUSet& cpus);
+
     private:
         size_t _stackSize;
         bool _deleteWhenTerminated;
         int _priority;
+        CPUSet _affinity;
+        SchedulingPolicy _policy;
+        int _rtPriority;
+        int _numaNode;
 
         //
         // These fields describe the operating system priority range.
@@ -34,6 +34,7 @@
 
 #pragma once
 #include "tsAbstractDemux.h"
+#include "tsPIDMap.h"
 
 namespace ts {
     //!
@@ -114,7 +115,7 @@ namespace ts {
             uint64_t       _offset; //!< Accumulated offsets after wrapping up at max value once or more.
         };
 
-        typedef std::map<PID, TimeTracker> PIDContextMap;
+        typedef PIDMap<TimeTracker> PIDContextMap;
         
         PID           _pcrPID;    //!< First detected PID with PCR's.
         TimeTracker   _pcrTime;   //!< PCR time tracker on _pcrPID.
@@ -317,66 +317,111 @@ bool ts::UDPReceiver::receive(void* data,
             return false;
         }
 
-        // Debug (level 2) message for each message.
-        report.log(2, u"received UDP packet, source: %s, destination: %s", {sender.toString(), destination.toString()});
-
-        // Check the destination address to exclude packets from other streams.
-        // When several multicast streams use the same destination port and several
-        // applications on the same system listen to these distinct streams,
-        // the multicast MAC address management is such that any socket which
-        // is bound to the common port will receive the traffic for all streams.
-        // This is why we need to check the destination address and exclude
-        // packets which are not from the intended stream.
-        //
-        // We accept a packet in any of:
-        // 1) Actual packet destination is unknown. Probably, the system cannot
-        //    report the destination address.
-        // 2) We listen to a multicast address and the actual destination is the same.
-        // 3) If we listen to unicast traffic and the actual destination is unicast.
-        //    In that case, unicast is by definition sent to us.
-
-        if (destination.hasAddress() && ((_dest_addr.hasAddress() && destination != _dest_addr) || (!_dest_addr.hasAddress() && destination.isMulticast()))) {
-            // This is a spurious packet.
-            report.debug(u"rejecting packet, destination: %s, expecting: %s", {destination.toString(), _dest_addr.toString()});
-            continue;
+        // Check the message against the filtering criteria.
+        if (accept(sender, destination, report)) {
+            return true;
         }
+    }
+}
 
-        // Keep track of the first sender address.
-        if (!_first_source.hasAddress()) {
-            // First packet, keep address of the sender.
-            _first_source = sender;
-            _sources.insert(sender);
-
-            // With option --first-source, use this one to filter packets.
-            if (_use_first_source) {
-                assert(!_use_source.hasAddress());
-                _use_source = sender;
-                report.verbose(u"now filtering on source address %s", {sender.toString()});
-            }
+
+//----------------------------------------------------------------------------
+// Receive a batch of messages. Override UDPSocket::receiveBatch().
+//----------------------------------------------------------------------------
+
+bool ts::UDPReceiver::receiveBatch(Message* msgs, size_t max_count, size_t& ret_count, const AbortInterface* abort, Report& report)
+{
+    // Loop on batch reception until at least one message matches the filtering criteria.
+    for (;;) {
+
+        // Wait for UDP messages from the superclass.
+        if (!UDPSocket::receiveBatch(msgs, max_count, ret_count, abort, report)) {
+            return false;
         }
 
-        // Keep track of senders (sources) to detect or filter multiple sources.
-        if (_sources.count(sender) == 0) {
-            // Detected an additional source, warn the user that distinct streams are potentially mixed.
-            // If no source filtering is applied, this is a warning since this may affect the resulting stream.
-            // With source filtering, this is just an informational verbose-level message.
-            const int level = _use_source.hasAddress() ? Severity::Verbose : Severity::Warning;
-            if (_sources.size() == 1) {
-                report.log(level, u"detected multiple sources for the same destination %s with potentially distinct streams", {destination.toString()});
-                report.log(level, u"detected source: %s", {_first_source.toString()});
+        // Keep the matching messages at the beginning of the array, in reception order.
+        size_t count = 0;
+        for (size_t i = 0; i < ret_count; ++i) {
+            if (accept(msgs[i].sender, msgs[i].destination, report)) {
+                if (count != i) {
+                    std::swap(msgs[count], msgs[i]);
+                }
+                ++count;
             }
-            report.log(level, u"detected source: %s", {sender.toString()});
-            _sources.insert(sender);
         }
+        ret_count = count;
+        if (ret_count > 0) {
+            return true;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Check if a received message matches the filtering criteria.
+//----------------------------------------------------------------------------
+
+bool ts::UDPReceiver::accept(const SocketAddress& sender, const SocketAddress& destination, Report& report)
+{
+    // Debug (level 2) message for each message.
+    TS_LOG(report, 2, u"received UDP packet, source: %s, destination: %s", {sender.toString(), destination.toString()});
+
+    // Check the destination address to exclude packets from other streams.
+    // When several multicast streams use the same destination port and several
+    // applications on the same system listen to these distinct streams,
+    // the multicast MAC address management is such that any socket which
+    // is bound to the common port will receive the traffic for all streams.
+    // This is why we need to check the destination address and exclude
+    // packets which are not from the intended stream.
+    //
+    // We accept a packet in any of:
+    // 1) Actual packet destination is unknown. Probably, the system cannot
+    //    report the destination address.
+    // 2) We listen to a multicast address and the actual destination is the same.
+    // 3) If we listen to unicast traffic and the actual destination is unicast.
+    //    In that case, unicast is by definition sent to us.
+
+    if (destination.hasAddress() && ((_dest_addr.hasAddress() && destination != _dest_addr) || (!_dest_addr.hasAddress() && destination.isMulticast()))) {
+        // This is a spurious packet.
+        TS_DEBUG(report, u"rejecting packet, destination: %s, expecting: %s", {destination.toString(), _dest_addr.toString()});
+        return false;
+    }
+
+    // Keep track of the first sender address.
+    if (!_first_source.hasAddress()) {
+        // First packet, keep address of the sender.
+        _first_source = sender;
+        _sources.insert(sender);
+
+        // With option --first-source, use this one to filter packets.
+        if (_use_first_source) {
+            assert(!_use_source.hasAddress());
+            _use_source = sender;
+            report.verbose(u"now filtering on source address %s", {sender.toString()});
+        }
+    }
 
-        // Filter packets based on source address if requested.
-        if (!sender.match(_use_source)) {
-            // Not the expected source, this is a spurious packet.
-            report.debug(u"rejecting packet, source: %s, expecting: %s", {sender.toString(), _use_source.toString()});
-            continue;
+    // Keep track of senders (sources) to detect or filter multiple sources.
+    if (_sources.count(sender) == 0) {
+        // Detected an additional source, warn the user that distinct streams are potentially mixed.
+        // If no source filtering is applied, this is a warning since this may affect the resulting stream.
+        // With source filtering, this is just an informational verbose-level message.
+        const int level = _use_source.hasAddress() ? Severity::Verbose : Severity::Warning;
+        if (_sources.size() == 1) {
+            report.log(level, u"detected multiple sources for the same destination %s with potentially distinct streams", {destination.toString()});
+            report.log(level, u"detected source: %s", {_first_source.toString()});
         }
+        report.log(level, u"detected source: %s", {sender.toString()});
+        _sources.insert(sender);
+    }
 
-        // Now found a packet matching all criteria.
-        return true;
+    // Filter packets based on source address if requested.
+    if (!sender.match(_use_source)) {
+        // Not the expected source, this is a spurious packet.
+        TS_DEBUG(report, u"rejecting packet, source: %s, expecting: %s", {sender.toString(), _use_source.toString()});
+        return false;
     }
+
+    // Now found a packet matching all criteria.
+    return true;
 }
@@ -35,6 +35,8 @@
 #include "tsNullReport.h"
 TSDUCK_SOURCE;
 
+const size_t ts::UDPSocket::MAX_BATCH_MESSAGES;
+
 // Furiously idiotic Windows feature, see comment in receiveOne()
 #if defined(TS_WINDOWS)
 volatile ::LPFN_WSARECVMSG ts::UDPSocket::_wsaRevcMsg = 0;
@@ -49,7 +51,8 @@ ts::UDPSocket::UDPSocket(bool auto_open, Report& report) :
     Socket(),
     _local_address(),
     _default_destination(),
-    _mcast()
+    _mcast(),
+    _txtime(false)
 {
     if (auto_open) {
         // Returned value ignored on purpose, the socket is marked as closed in the object on error.
@@ -106,6 +109,7 @@ bool ts::UDPSocket::close(Report& report)
         }
         _mcast.clear();
     }
+    _txtime = false;
 
     // Close socket
     return Socket::close(report);
@@ -351,6 +355,269 @@ bool ts::UDPSocket::send(const void* data, size_t size, const SocketAddress& des
 }
 
 
+//----------------------------------------------------------------------------
+// Send a batch of messages.
+//----------------------------------------------------------------------------
+
+bool ts::UDPSocket::sendBatch(const Message* msgs, size_t count, Report& report)
+{
+#if defined(TS_LINUX)
+
+    ::mmsghdr hdr[MAX_BATCH_MESSAGES];
+    ::iovec vec[MAX_BATCH_MESSAGES];
+    ::sockaddr addr[MAX_BATCH_MESSAGES];
+#if defined(SCM_TXTIME)
+    // Ancillary data for SCM_TXTIME, aligned as a cmsghdr.
+    union {
+        ::cmsghdr align;
+        uint8_t   data[CMSG_SPACE(sizeof(uint64_t))];
+    } ancil[MAX_BATCH_MESSAGES];
+#endif
+
+    while (count > 0) {
+
+        // Build the message headers for one system call.
+        const size_t chunk = std::min<size_t>(count, MAX_BATCH_MESSAGES);
+        TS_ZERO(hdr);
+        for (size_t i = 0; i < chunk; ++i) {
+            (msgs[i].destination.hasAddress() ? msgs[i].destination : _default_destination).copy(addr[i]);
+            vec[i].iov_base = msgs[i].data;
+            vec[i].iov_len = msgs[i].size;
+            hdr[i].msg_hdr.msg_name = &addr[i];
+            hdr[i].msg_hdr.msg_namelen = sizeof(addr[i]);
+            hdr[i].msg_hdr.msg_iov = &vec[i];
+            hdr[i].msg_hdr.msg_iovlen = 1;
+#if defined(SCM_TXTIME)
+            if (_txtime && msgs[i].txtime >= 0) {
+                hdr[i].msg_hdr.msg_control = ancil[i].data;
+                hdr[i].msg_hdr.msg_controllen = sizeof(ancil[i].data);
+                ::cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr[i].msg_hdr);
+                cmsg->cmsg_level = SOL_SOCKET;
+                cmsg->cmsg_type = SCM_TXTIME;
+                cmsg->cmsg_len = CMSG_LEN(sizeof(uint64_t));
+                const uint64_t txtime = uint64_t(msgs[i].txtime);
+                ::memcpy(CMSG_DATA(cmsg), &txtime, sizeof(txtime));
+            }
+#endif
+        }
+
+        // The kernel may send less messages than requested.
+        const int sent = ::sendmmsg(getSocket(), hdr, ::socklen_t(chunk), 0);
+        if (sent < 0) {
+            const SocketErrorCode err = LastSocketErrorCode();
+            if (err != EINTR) {
+                report.error(u"error sending UDP message: " + SocketErrorCodeMessage(err));
+                return false;
+            }
+        }
+        else {
+            msgs += sent;
+            count -= size_t(sent);
+        }
+    }
+    return true;
+
+#else
+
+    // No batch operation, send messages one by one.
+    for (size_t i = 0; i < count; ++i) {
+        if (!send(msgs[i].data, msgs[i].size, msgs[i].destination.hasAddress() ? msgs[i].destination : _default_destination, report)) {
+            return false;
+        }
+    }
+    return true;
+
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Enable or disable the kernel reception time stamps of messages.
+//----------------------------------------------------------------------------
+
+bool ts::UDPSocket::setReceiveTimestamps(bool on, Report& report)
+{
+#if defined(TS_LINUX)
+    int opt = int(on);
+    if (::setsockopt(getSocket(), SOL_SOCKET, SO_TIMESTAMPNS, TS_SOCKOPT_T(&opt), sizeof(opt)) != 0) {
+        report.error(u"error setting socket SO_TIMESTAMPNS option: %s", {SocketErrorCodeMessage()});
+        return false;
+    }
+    return true;
+#else
+    if (on) {
+        report.error(u"kernel reception time stamps are not supported on this system");
+    }
+    return !on;
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Enable or disable the kernel-side pacing of outgoing messages.
+//----------------------------------------------------------------------------
+
+bool ts::UDPSocket::setTransmitTime(bool on, Report& report)
+{
+#if defined(TS_LINUX) && defined(SO_TXTIME)
+    // The socket option cannot be removed. When disabled, the messages are simply sent without time.
+    if (on && !_txtime) {
+        ::sock_txtime opt;
+        TS_ZERO(opt);
+        opt.clockid = CLOCK_MONOTONIC;
+        if (::setsockopt(getSocket(), SOL_SOCKET, SO_TXTIME, TS_SOCKOPT_T(&opt), sizeof(opt)) != 0) {
+            report.error(u"error setting socket SO_TXTIME option: %s", {SocketErrorCodeMessage()});
+            return false;
+        }
+    }
+    _txtime = on;
+    return true;
+#else
+    if (on) {
+        report.error(u"kernel-side transmission times are not supported on this system");
+    }
+    return !on;
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Get the current value of the clock for kernel-side transmission times.
+//----------------------------------------------------------------------------
+
+ts::NanoSecond ts::UDPSocket::TransmitClock()
+{
+#if defined(TS_LINUX) && defined(SO_TXTIME)
+    ::timespec now;
+    ::clock_gettime(CLOCK_MONOTONIC, &now);
+    return NanoSecond(now.tv_sec) * NanoSecPerSec + NanoSecond(now.tv_nsec);
+#else
+    return 0;
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Receive a batch of messages.
+//----------------------------------------------------------------------------
+
+bool ts::UDPSocket::receiveBatch(Message* msgs, size_t max_count, size_t& ret_count, const AbortInterface* abort, Report& report)
+{
+    ret_count = 0;
+    if (max_count == 0) {
+        return true;
+    }
+
+    // Loop on unsollicited interrupts, same logic as receive().
+    for (;;) {
+
+        const SocketErrorCode err = receiveMany(msgs, max_count, ret_count, report);
+
+        if (abort != 0 && abort->aborting()) {
+            return false;
+        }
+        else if (err == SYS_SUCCESS) {
+            // Remove the "successful" empty messages coming from nowhere.
+            size_t count = 0;
+            for (size_t i = 0; i < ret_count; ++i) {
+                if (msgs[i].size > 0 || msgs[i].sender.hasAddress()) {
+                    if (count != i) {
+                        std::swap(msgs[count], msgs[i]);
+                    }
+                    ++count;
+                }
+            }
+            ret_count = count;
+            if (ret_count > 0) {
+                return true;
+            }
+        }
+#if !defined(TS_WINDOWS)
+        else if (err == EINTR) {
+            report.debug(u"signal, not user interrupt");
+        }
+#endif
+        else {
+            report.error(u"error receiving from UDP socket: %s", {SocketErrorCodeMessage(err)});
+            return false;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Perform one batch receive operation. Hide the system mud.
+//----------------------------------------------------------------------------
+
+ts::SocketErrorCode ts::UDPSocket::receiveMany(Message* msgs, size_t max_count, size_t& ret_count, Report& report)
+{
+    ret_count = 0;
+
+#if defined(TS_LINUX)
+
+    // Size of ancillary data per message: IP_PKTINFO and SO_TIMESTAMPNS.
+    static const size_t ANCIL_SIZE = 256;
+
+    const size_t count = std::min<size_t>(max_count, MAX_BATCH_MESSAGES);
+    ::mmsghdr hdr[MAX_BATCH_MESSAGES];
+    ::iovec vec[MAX_BATCH_MESSAGES];
+    ::sockaddr sender_sock[MAX_BATCH_MESSAGES];
+    uint8_t ancil_data[MAX_BATCH_MESSAGES][ANCIL_SIZE];
+
+    TS_ZERO(hdr);
+    for (size_t i = 0; i < count; ++i) {
+        vec[i].iov_base = msgs[i].data;
+        vec[i].iov_len = msgs[i].max_size;
+        hdr[i].msg_hdr.msg_name = &sender_sock[i];
+        hdr[i].msg_hdr.msg_namelen = sizeof(sender_sock[i]);
+        hdr[i].msg_hdr.msg_iov = &vec[i];
+        hdr[i].msg_hdr.msg_iovlen = 1;
+        hdr[i].msg_hdr.msg_control = ancil_data[i];
+        hdr[i].msg_hdr.msg_controllen = ANCIL_SIZE;
+    }
+
+    // Wait for the first message, then get all immediately available messages.
+    const int received = ::recvmmsg(getSocket(), hdr, ::socklen_t(count), MSG_WAITFORONE, 0);
+    if (received < 0) {
+        return LastSocketErrorCode();
+    }
+
+    for (size_t i = 0; i < size_t(received); ++i) {
+        Message& msg(msgs[i]);
+        msg.size = hdr[i].msg_len;
+        msg.sender = SocketAddress(sender_sock[i]);
+        msg.destination.clear();
+        msg.timestamp = -1;
+
+        // Browse returned ancillary data.
+        for (::cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr[i].msg_hdr); cmsg != 0; cmsg = CMSG_NXTHDR(&hdr[i].msg_hdr, cmsg)) {
+            if (cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_PKTINFO && cmsg->cmsg_len >= sizeof(::in_pktinfo)) {
+                const ::in_pktinfo* info = reinterpret_cast<const ::in_pktinfo*>(CMSG_DATA(cmsg));
+                msg.destination = SocketAddress(info->ipi_addr, _local_address.port());
+            }
+            else if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS && cmsg->cmsg_len >= CMSG_LEN(sizeof(::timespec))) {
+                const ::timespec* ts = reinterpret_cast<const ::timespec*>(CMSG_DATA(cmsg));
+                msg.timestamp = MicroSecond(ts->tv_sec) * MicroSecPerSec + MicroSecond(ts->tv_nsec) / NanoSecPerMicroSec;
+            }
+        }
+    }
+    ret_count = size_t(received);
+    return SYS_SUCCESS;
+
+#else
+
+    // No batch operation, receive one message at a time.
+    const SocketErrorCode err = receiveOne(msgs[0].data, msgs[0].max_size, msgs[0].size, msgs[0].sender, msgs[0].destination, report);
+    msgs[0].timestamp = -1;
+    if (err == SYS_SUCCESS) {
+        ret_count = 1;
+    }
+    return err;
+
+#endif
+}
+
+
 //----------------------------------------------------------------------------
 // Receive a message.
 // If abort interface is non-zero, invoke it when I/O is interrupted
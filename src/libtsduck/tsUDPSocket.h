@@ -296,6 +296,120 @@ namespace ts {
                              const AbortInterface* abort = 0,
                              Report& report = CERR);
 
+        //!
+        //! Description of one UDP message in a batch of messages.
+        //! @see sendBatch()
+        //! @see receiveBatch()
+        //!
+        struct TSDUCKDLL Message
+        {
+            void*         data;         //!< Address of the message buffer.
+            size_t        max_size;     //!< Size in bytes of the message buffer (reception only).
+            size_t        size;         //!< Size in bytes of the message.
+            SocketAddress sender;       //!< Socket address of the sender (reception only).
+            SocketAddress destination;  //!< Socket address of the destination. When sending, use the default destination if the address is unspecified.
+            MicroSecond   timestamp;    //!< Kernel reception time in microseconds since the UNIX epoch, -1 if unavailable (reception only).
+            NanoSecond    txtime;       //!< Requested transmission time on TransmitClock(), -1 to send immediately (sending only, see setTransmitTime()).
+
+            //!
+            //! Constructor.
+            //! @param [in] data_ Address of the message buffer.
+            //! @param [in] max_size_ Size in bytes of the message buffer.
+            //! @param [in] size_ Size in bytes of the message.
+            //!
+            Message(void* data_ = 0, size_t max_size_ = 0, size_t size_ = 0) :
+                data(data_),
+                max_size(max_size_),
+                size(size_),
+                sender(),
+                destination(),
+                timestamp(-1),
+                txtime(-1)
+            {
+            }
+        };
+
+        //!
+        //! Maximum number of messages which are sent or received in one system call.
+        //! Larger batches are split into several system calls.
+        //!
+        static const size_t MAX_BATCH_MESSAGES = 64;
+
+        //!
+        //! Send a batch of messages.
+        //! On Linux, the messages are sent using sendmmsg(), with one system call for
+        //! up to MAX_BATCH_MESSAGES messages. On other systems, each message is sent
+        //! individually.
+        //! @param [in] msgs Address of an array of messages to send. In each message, the fields
+        //! @a data, @a size, @a destination and @a txtime are used. When the address of @a destination
+        //! is unspecified, the message is sent to the default destination. The field @a txtime is
+        //! used only when setTransmitTime() was enabled.
+        //! @param [in] count Number of messages in @a msgs.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        virtual bool sendBatch(const Message* msgs, size_t count, Report& report = CERR);
+
+        //!
+        //! Receive a batch of messages.
+        //! Wait for at least one message and then return all messages which are immediately
+        //! available, up to @a max_count. On Linux, the messages are received using recvmmsg(),
+        //! with one system call for up to MAX_BATCH_MESSAGES messages. On other systems, one
+        //! message is returned per call.
+        //! @param [in,out] msgs Address of an array of messages. On input, the fields @a data
+        //! and @a max_size of each message describe the reception buffers. On output, the
+        //! first @a ret_count messages are filled with the received messages. The elements
+        //! of the array may be reordered, a buffer is always returned in the same message
+        //! structure as its @a data and @a max_size.
+        //! @param [in] max_count Number of messages in @a msgs.
+        //! @param [out] ret_count Number of received messages.
+        //! @param [in] abort If non-zero, invoked when I/O is interrupted
+        //! (in case of user-interrupt, return, otherwise retry).
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //! @see setReceiveTimestamps()
+        //!
+        virtual bool receiveBatch(Message* msgs,
+                                  size_t max_count,
+                                  size_t& ret_count,
+                                  const AbortInterface* abort = 0,
+                                  Report& report = CERR);
+
+        //!
+        //! Enable or disable the kernel reception time stamps of messages.
+        //! When enabled, the field @a timestamp of the messages which are returned by
+        //! receiveBatch() contains the reception time, as recorded by the kernel.
+        //! Currently supported on Linux only.
+        //! @param [in] on True to enable, false to disable.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        bool setReceiveTimestamps(bool on, Report& report = CERR);
+
+        //!
+        //! Enable or disable the kernel-side pacing of outgoing messages.
+        //! When enabled, the field @a txtime of the messages which are sent by sendBatch()
+        //! is passed to the kernel which transmits the message at that time. On Linux, this
+        //! is the SO_TXTIME socket option, using CLOCK_MONOTONIC. It requires the @c fq
+        //! network queueing discipline on the outgoing interface. The @c etf queueing
+        //! discipline is not supported since it requires CLOCK_TAI.
+        //! Currently supported on Linux only.
+        //! @param [in] on True to enable, false to disable.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //! @see TransmitClock()
+        //!
+        bool setTransmitTime(bool on, Report& report = CERR);
+
+        //!
+        //! Get the current value of the clock which is used for kernel-side transmission times.
+        //! @return The current time in nanoseconds, in the reference of the @a txtime field
+        //! of the messages. On Linux, this is CLOCK_MONOTONIC. Zero on systems which do not
+        //! support kernel-side pacing.
+        //! @see setTransmitTime()
+        //!
+        static NanoSecond TransmitClock();
+
         // Implementation of Socket interface.
         virtual bool open(Report& report = CERR) override;
         virtual bool close(Report& report = CERR) override;
@@ -332,10 +446,14 @@ namespace ts {
         SocketAddress _local_address;
         SocketAddress _default_destination;
         MReqSet       _mcast; // Current list of multicast memberships
+        bool          _txtime; // Kernel-side pacing is enabled
 
         // Perform one receive operation. Hide the system mud.
         SocketErrorCode receiveOne(void* data, size_t max_size, size_t& ret_size, SocketAddress& sender, SocketAddress& destination, Report& report);
 
+        // Perform one batch receive operation, at least one message. Hide the system mud.
+        SocketErrorCode receiveMany(Message* msgs, size_t max_count, size_t& ret_count, Report& report);
+
         // Furiously idiotic Windows feature, see comment in receiveOne()
 #if defined(TS_WINDOWS)
         static volatile ::LPFN_WSARECVMSG _wsaRevcMsg;
@@ -179,6 +179,7 @@
 #include "tsISO639LanguageDescriptor.h"
 #include "tsISPAccessModeDescriptor.h"
 #include "tsjson.h"
+#include "tsLatencyHistogram.h"
 #include "tsLinkageDescriptor.h"
 #include "tsLNB.h"
 #include "tsLocalTimeOffsetDescriptor.h"
@@ -217,6 +218,7 @@
 #include "tsOneShotPacketizer.h"
 #include "tsOutputPager.h"
 #include "tsOutputRedirector.h"
+#include "tsPacingTimer.h"
 #include "tsPacketizer.h"
 #include "tsParentalRatingDescriptor.h"
 #include "tsPartialTransportStreamDescriptor.h"
@@ -227,6 +229,7 @@
 #include "tsPESDemux.h"
 #include "tsPESHandlerInterface.h"
 #include "tsPESPacket.h"
+#include "tsPIDMap.h"
 #include "tsPIDOperator.h"
 #include "tsPlatform.h"
 #include "tsPlugin.h"
@@ -411,8 +414,10 @@
 #include "tsxmlDocument.h"
 #include "tsxmlElement.h"
 #include "tsxmlNode.h"
+#include "tsxmlReader.h"
 #include "tsxmlText.h"
 #include "tsxmlUnknown.h"
+#include "tsxmlWriter.h"
 
 #if defined(TS_LINUX)
 #include "tsDTVProperties.h"
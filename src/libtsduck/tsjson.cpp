@@ -182,6 +182,15 @@ ts::UString ts::json::Value::printed(size_t indent, Report& report) const
     return str;
 }
 
+ts::UString ts::json::Value::oneLiner(Report& report) const
+{
+    // Line breaks are only used for formatting, they are escaped in strings.
+    UString str(printed(0, report));
+    str.remove(LINE_FEED);
+    str.remove(CARRIAGE_RETURN);
+    return str;
+}
+
 
 //----------------------------------------------------------------------------
 // Format a JSON object.
@@ -65,8 +65,10 @@ namespace ts {
         class Document;
         class Element;
         class Node;
+        class Reader;
         class Text;
         class Unknown;
+        class Writer;
 
         //!
         //! Vector of constant elements.
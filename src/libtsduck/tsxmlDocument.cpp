@@ -177,6 +177,40 @@ bool ts::xml::Document::validate(const Document& model) const
     }
 }
 
+bool ts::xml::Document::validate(const Document& model, const Element* elem) const
+{
+    // Build the path of elements from the root of the document to elem.
+    std::vector<const Element*> path;
+    for (const Element* e = elem; e != 0; e = dynamic_cast<const Element*>(e->parent())) {
+        path.push_back(e);
+    }
+    if (path.empty() || path.back() != rootElement()) {
+        _report.error(u"invalid XML document, element not found in document");
+        return false;
+    }
+
+    // Locate the corresponding element in the model.
+    const Element* modelElem = model.rootElement();
+    if (modelElem == 0) {
+        _report.error(u"invalid XML model, no root element");
+        return false;
+    }
+    else if (!modelElem->haveSameName(path.back())) {
+        _report.error(u"invalid XML document, expected <%s> as root, found <%s>", {modelElem->name(), path.back()->name()});
+        return false;
+    }
+    for (size_t i = path.size() - 1; i > 0; --i) {
+        modelElem = findModelElement(modelElem, path[i-1]->name());
+        if (modelElem == 0) {
+            _report.error(u"unexpected node <%s> in <%s>, line %d", {path[i-1]->name(), path[i]->name(), path[i-1]->lineNumber()});
+            return false;
+        }
+    }
+
+    // Validate the element and its children.
+    return validateElement(modelElem, elem);
+}
+
 // Validate an XML tree of elements, used by validate().
 bool ts::xml::Document::validateElement(const Element* model, const Element* doc) const
 {
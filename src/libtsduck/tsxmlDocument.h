@@ -100,6 +100,19 @@ namespace ts {
             //!
             bool validate(const Document& model) const;
 
+            //!
+            //! Validate one element of the XML document and its children.
+            //!
+            //! Same as validate() but only @a elem and its children are checked, not the
+            //! rest of the document. This is typically used when the document is built
+            //! progressively and only one subtree is present at a time.
+            //!
+            //! @param [in] model The model document.
+            //! @param [in] elem An element of this document.
+            //! @return True if @a elem matches @a model, false if it does not.
+            //!
+            bool validate(const Document& model, const Element* elem) const;
+
             //!
             //! Save an XML file.
             //! @param [in] fileName Name of the XML file to save.
@@ -310,9 +310,9 @@ ts::xml::Element::AttributeMap::const_iterator ts::xml::Element::findAttribute(c
     return _attributes.find(attributeKey(attributeName));
 }
 
-void ts::xml::Element::setAttribute(const UString& name, const UString& value)
+void ts::xml::Element::setAttribute(const UString& name, const UString& value, size_t line)
 {
-    _attributes[attributeKey(name)] = Attribute(name, value);
+    _attributes[attributeKey(name)] = Attribute(name, value, line);
 }
 
 bool ts::xml::Element::hasAttribute(const UString& name) const
@@ -230,8 +230,9 @@ namespace ts {
             //! Set an attribute.
             //! @param [in] name Attribute name.
             //! @param [in] value Attribute value.
+            //! @param [in] line Line number in input document, zero if the attribute is built programmatically.
             //!
-            void setAttribute(const UString& name, const UString& value);
+            void setAttribute(const UString& name, const UString& value, size_t line = 0);
 
             //!
             //! Set a bool attribute to a node.
@@ -0,0 +1,521 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsxmlReader.h"
+TSDUCK_SOURCE;
+
+namespace {
+    // Size of chunks when reading a stream.
+    const size_t READ_CHUNK_SIZE = 65536;
+
+    // UTF-8 Byte Order Mark.
+    const char UTF8_BOM[] = "\xEF\xBB\xBF";
+    const size_t UTF8_BOM_SIZE = 3;
+
+    // Longest construct prefix to identify.
+    const char CDATA_PREFIX[] = "<![CDATA[";
+    const size_t CDATA_PREFIX_SIZE = 9;
+
+    // Characters which are allowed in XML names, same rules as TextParser.
+    // All non-ASCII characters are accepted since they are multi-byte UTF-8 sequences.
+    inline bool IsNameStartChar(char c)
+    {
+        return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || c == ':' || c == '_' || (c & 0x80) != 0;
+    }
+    inline bool IsNameChar(char c)
+    {
+        return IsNameStartChar(c) || (c >= '0' && c <= '9') || c == '.' || c == '-';
+    }
+    inline bool IsSpaceChar(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+    }
+
+    // Case-insensitive match of an ASCII token in a buffer.
+    bool MatchNoCase(const std::string& buffer, size_t pos, const char* token, size_t size)
+    {
+        if (pos + size > buffer.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < size; ++i) {
+            if (std::tolower(static_cast<unsigned char>(buffer[pos + i])) != std::tolower(static_cast<unsigned char>(token[i]))) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Default handlers.
+//----------------------------------------------------------------------------
+
+ts::xml::Reader::Handler::~Handler()
+{
+}
+
+bool ts::xml::Reader::Handler::handleDeclaration(Reader& reader, const UString& value, size_t line)
+{
+    return true;
+}
+
+bool ts::xml::Reader::Handler::handleComment(Reader& reader, const UString& value, size_t line)
+{
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Constructor and reset.
+//----------------------------------------------------------------------------
+
+ts::xml::Reader::Reader(Report& report) :
+    _report(report),
+    _buffer(),
+    _line(1),
+    _stack(),
+    _started(false),
+    _rootDone(false),
+    _error(false)
+{
+}
+
+void ts::xml::Reader::reset()
+{
+    _buffer.clear();
+    _line = 1;
+    _stack.clear();
+    _started = false;
+    _rootDone = false;
+    _error = false;
+}
+
+
+//----------------------------------------------------------------------------
+// Parse complete documents.
+//----------------------------------------------------------------------------
+
+bool ts::xml::Reader::parse(std::istream& strm, Handler& handler)
+{
+    reset();
+    std::vector<char> chunk(READ_CHUNK_SIZE);
+    bool ok = true;
+    while (ok && strm) {
+        strm.read(&chunk[0], std::streamsize(chunk.size()));
+        ok = feed(&chunk[0], size_t(strm.gcount()), handler);
+    }
+    return ok && finish(handler);
+}
+
+bool ts::xml::Reader::parseFile(const UString& fileName, Handler& handler)
+{
+    std::ifstream strm(fileName.toUTF8().c_str(), std::ios::in | std::ios::binary);
+    if (!strm.is_open()) {
+        _report.error(u"cannot open %s", {fileName});
+        return false;
+    }
+    return parse(strm, handler);
+}
+
+
+//----------------------------------------------------------------------------
+// Feed the reader with input data.
+//----------------------------------------------------------------------------
+
+bool ts::xml::Reader::feed(const void* data, size_t size, Handler& handler)
+{
+    if (_error) {
+        return false;
+    }
+    if (data != 0 && size > 0) {
+        _buffer.append(reinterpret_cast<const char*>(data), size);
+    }
+    return process(false, handler);
+}
+
+bool ts::xml::Reader::finish(Handler& handler)
+{
+    if (!process(true, handler)) {
+        return false;
+    }
+
+    // At end of document, all elements must have been closed.
+    if (!_stack.empty()) {
+        _report.error(u"line %d: unexpected end of document, expected </%s>", {_line, _stack.back()});
+        _error = true;
+    }
+    else if (!_rootDone) {
+        _report.error(u"invalid XML document, no root element found");
+        _error = true;
+    }
+    return !_error;
+}
+
+
+//----------------------------------------------------------------------------
+// Process all complete constructs in the buffer.
+//----------------------------------------------------------------------------
+
+bool ts::xml::Reader::process(bool eof, Handler& handler)
+{
+    if (_error) {
+        return false;
+    }
+
+    // Remove the optional BOM at start of document.
+    if (!_started) {
+        if (_buffer.size() < UTF8_BOM_SIZE && !eof) {
+            return true;
+        }
+        if (_buffer.compare(0, UTF8_BOM_SIZE, UTF8_BOM) == 0) {
+            _buffer.erase(0, UTF8_BOM_SIZE);
+        }
+        _started = true;
+    }
+
+    // Loop on all complete constructs.
+    Status status = DONE;
+    size_t pos = 0;
+    while (pos < _buffer.size() && (status = parseConstruct(pos, eof, handler)) == DONE) {
+    }
+
+    // Keep only the incomplete last construct.
+    _buffer.erase(0, pos);
+    _error = status == FAILED;
+    return !_error;
+}
+
+
+//----------------------------------------------------------------------------
+// Analyze the next construct in the buffer.
+//----------------------------------------------------------------------------
+
+ts::xml::Reader::Status ts::xml::Reader::parseConstruct(size_t& pos, bool eof, Handler& handler)
+{
+    const size_t start = pos;
+    const size_t startLine = _line;
+    Status status = DONE;
+    UString value;
+
+    if (_buffer[pos] != '<') {
+        status = parseText(pos, eof, handler);
+    }
+    else if (!eof && _buffer.size() - pos < CDATA_PREFIX_SIZE && find(">", pos) == std::string::npos) {
+        // Cannot identify the construct yet.
+        status = NEED_MORE;
+    }
+    else if (_buffer.compare(pos, 2, "<?") == 0) {
+        status = parseDelimited(pos, eof, 2, "?>", value, u"XML declaration");
+        if (status == DONE) {
+            if (!_stack.empty()) {
+                _report.error(u"line %d: misplaced declaration, not directly inside a document", {startLine});
+                status = FAILED;
+            }
+            else if (!handler.handleDeclaration(*this, value, startLine)) {
+                status = FAILED;
+            }
+        }
+    }
+    else if (_buffer.compare(pos, 4, "<!--") == 0) {
+        status = parseDelimited(pos, eof, 4, "-->", value, u"XML comment");
+        if (status == DONE && !handler.handleComment(*this, value, startLine)) {
+            status = FAILED;
+        }
+    }
+    else if (MatchNoCase(_buffer, pos, CDATA_PREFIX, CDATA_PREFIX_SIZE)) {
+        status = parseDelimited(pos, eof, CDATA_PREFIX_SIZE, "]]>", value, u"<![CDATA[");
+        if (status == DONE) {
+            if (_stack.empty()) {
+                _report.error(u"line %d: CDATA outside root element, invalid XML document", {startLine});
+                status = FAILED;
+            }
+            else if (!handler.handleText(*this, value, true, startLine)) {
+                status = FAILED;
+            }
+        }
+    }
+    else if (_buffer.compare(pos, 2, "<!") == 0) {
+        // Should be a DTD, we ignore it.
+        status = parseDelimited(pos, eof, 2, ">", value, u"unknown or DTD node");
+    }
+    else if (_buffer.compare(pos, 2, "</") == 0) {
+        status = parseEndTag(pos, eof, handler);
+    }
+    else {
+        status = parseStartTag(pos, eof, handler);
+    }
+
+    // Keep track of line numbers.
+    if (status == NEED_MORE) {
+        pos = start;
+    }
+    else {
+        _line = startLine + countLines(start, pos);
+    }
+    return status;
+}
+
+
+//----------------------------------------------------------------------------
+// Parse a construct up to a delimiter.
+//----------------------------------------------------------------------------
+
+ts::xml::Reader::Status ts::xml::Reader::parseDelimited(size_t& pos, bool eof, size_t prefixSize, const char* endToken, UString& value, const UChar* what)
+{
+    const size_t end = find(endToken, pos + prefixSize);
+    if (end == std::string::npos) {
+        if (eof) {
+            _report.error(u"line %d: error parsing %s, not properly terminated", {_line, what});
+            return FAILED;
+        }
+        return NEED_MORE;
+    }
+    value.assignFromUTF8(_buffer.data() + pos + prefixSize, end - pos - prefixSize);
+    pos = end + ::strlen(endToken);
+    return DONE;
+}
+
+
+//----------------------------------------------------------------------------
+// Parse a text node, up to the next tag.
+//----------------------------------------------------------------------------
+
+ts::xml::Reader::Status ts::xml::Reader::parseText(size_t& pos, bool eof, Handler& handler)
+{
+    size_t end = _buffer.find('<', pos);
+    if (end == std::string::npos) {
+        if (!eof) {
+            return NEED_MORE;
+        }
+        end = _buffer.size();
+    }
+
+    // Texts which contain only spaces between tags are ignored.
+    size_t first = pos;
+    skipSpaces(first, end);
+    if (first < end) {
+        if (_stack.empty()) {
+            _report.error(u"line %d: trailing character sequence, invalid XML document", {_line + countLines(pos, first)});
+            return FAILED;
+        }
+        UString text(UString::FromUTF8(_buffer.data() + pos, end - pos));
+        text.convertFromHTML();
+        if (!handler.handleText(*this, text, false, _line)) {
+            return FAILED;
+        }
+    }
+    pos = end;
+    return DONE;
+}
+
+
+//----------------------------------------------------------------------------
+// Parse a start tag or an empty-element tag.
+//----------------------------------------------------------------------------
+
+ts::xml::Reader::Status ts::xml::Reader::parseStartTag(size_t& pos, bool eof, Handler& handler)
+{
+    // Locate the end of tag, skipping quoted attribute values.
+    size_t end = pos + 1;
+    char quote = 0;
+    while (end < _buffer.size() && (quote != 0 || _buffer[end] != '>')) {
+        const char c = _buffer[end++];
+        if (quote != 0) {
+            quote = c == quote ? 0 : quote;
+        }
+        else if (c == '"' || c == '\'') {
+            quote = c;
+        }
+    }
+    if (end >= _buffer.size()) {
+        if (eof) {
+            _report.error(u"line %d: parsing error, tag not properly terminated", {_line});
+            return FAILED;
+        }
+        return NEED_MORE;
+    }
+
+    // Read the tag name.
+    size_t cur = pos + 1;
+    UString name;
+    skipSpaces(cur, end);
+    if (!parseName(cur, end, name)) {
+        _report.error(u"line %d: parsing error, tag name expected", {_line});
+        return FAILED;
+    }
+
+    // Read the list of attributes.
+    AttributeList attributes;
+    bool empty = false;
+    for (;;) {
+        skipSpaces(cur, end);
+        if (cur >= end) {
+            // Found end of tag.
+            break;
+        }
+        else if (cur + 1 == end && _buffer[cur] == '/') {
+            // Found end of empty-element tag, without children.
+            empty = true;
+            break;
+        }
+
+        // Expect name, spaces, '=', spaces, quoted value.
+        const size_t line = _line + countLines(pos, cur);
+        UString attrName;
+        bool ok = parseName(cur, end, attrName);
+        size_t valueEnd = std::string::npos;
+        if (ok) {
+            skipSpaces(cur, end);
+            ok = cur < end && _buffer[cur++] == '=';
+        }
+        if (ok) {
+            skipSpaces(cur, end);
+            ok = cur < end && (_buffer[cur] == '"' || _buffer[cur] == '\'');
+        }
+        if (ok) {
+            const char q = _buffer[cur++];
+            valueEnd = _buffer.find(q, cur);
+            ok = valueEnd != std::string::npos && valueEnd < end;
+        }
+        if (!ok) {
+            _report.error(u"line %d: parsing error, tag <%s>", {line, name});
+            return FAILED;
+        }
+
+        // Check that the attribute is not duplicated. Attribute names are case-insensitive.
+        for (AttributeList::const_iterator it = attributes.begin(); it != attributes.end(); ++it) {
+            if (it->name().similar(attrName)) {
+                _report.error(u"line %d: duplicate attribute '%s' in tag <%s>", {line, attrName, name});
+                return FAILED;
+            }
+        }
+
+        UString attrValue(UString::FromUTF8(_buffer.data() + cur, valueEnd - cur));
+        attrValue.convertFromHTML();
+        attributes.push_back(Attribute(attrName, attrValue, line));
+        cur = valueEnd + 1;
+    }
+
+    // Check document structure.
+    if (_stack.empty() && _rootDone) {
+        _report.error(u"line %d: trailing element <%s> after root element, invalid XML document", {_line, name});
+        return FAILED;
+    }
+
+    // Notify the application.
+    const size_t line = _line;
+    pos = end + 1;
+    _stack.push_back(name);
+    if (!handler.handleElementStart(*this, name, attributes, line) || (empty && !handler.handleElementEnd(*this, name, line))) {
+        return FAILED;
+    }
+    if (empty) {
+        _stack.pop_back();
+        _rootDone = _stack.empty();
+    }
+    return DONE;
+}
+
+
+//----------------------------------------------------------------------------
+// Parse an end tag.
+//----------------------------------------------------------------------------
+
+ts::xml::Reader::Status ts::xml::Reader::parseEndTag(size_t& pos, bool eof, Handler& handler)
+{
+    const size_t end = find(">", pos + 2);
+    if (end == std::string::npos) {
+        if (eof) {
+            _report.error(u"line %d: parsing error, tag not properly terminated", {_line});
+            return FAILED;
+        }
+        return NEED_MORE;
+    }
+
+    size_t cur = pos + 2;
+    UString name;
+    skipSpaces(cur, end);
+    const bool ok = parseName(cur, end, name);
+    skipSpaces(cur, end);
+
+    if (_stack.empty()) {
+        _report.error(u"line %d: parsing error, unexpected </%s>", {_line, name});
+        return FAILED;
+    }
+    if (!ok || cur < end || !name.similar(_stack.back())) {
+        _report.error(u"line %d: parsing error, expected </%s>", {_line, _stack.back()});
+        return FAILED;
+    }
+
+    // Notify the application while the element is still open.
+    pos = end + 1;
+    if (!handler.handleElementEnd(*this, name, _line)) {
+        return FAILED;
+    }
+    _stack.pop_back();
+    _rootDone = _stack.empty();
+    return DONE;
+}
+
+
+//----------------------------------------------------------------------------
+// Low-level buffer analysis.
+//----------------------------------------------------------------------------
+
+size_t ts::xml::Reader::find(const char* token, size_t pos) const
+{
+    return _buffer.find(token, pos);
+}
+
+size_t ts::xml::Reader::countLines(size_t start, size_t end) const
+{
+    return size_t(std::count(_buffer.begin() + start, _buffer.begin() + std::min(end, _buffer.size()), '\n'));
+}
+
+bool ts::xml::Reader::parseName(size_t& pos, size_t end, UString& name) const
+{
+    if (pos >= end || !IsNameStartChar(_buffer[pos])) {
+        name.clear();
+        return false;
+    }
+    const size_t start = pos;
+    while (pos < end && IsNameChar(_buffer[pos])) {
+        pos++;
+    }
+    name.assignFromUTF8(_buffer.data() + start, pos - start);
+    return true;
+}
+
+void ts::xml::Reader::skipSpaces(size_t& pos, size_t end) const
+{
+    while (pos < end && IsSpaceChar(_buffer[pos])) {
+        pos++;
+    }
+}
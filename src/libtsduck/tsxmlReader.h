@@ -0,0 +1,228 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Streaming (event-based) XML reader.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsxmlAttribute.h"
+#include "tsReport.h"
+#include "tsNullReport.h"
+
+namespace ts {
+    namespace xml {
+        //!
+        //! Streaming (event-based) XML reader.
+        //! @ingroup xml
+        //!
+        //! Unlike xml::Document, this class does not build a tree of nodes.
+        //! The input is read by chunks of UTF-8 data and each XML construct is reported
+        //! to an application handler as soon as it is complete. Only the pending incomplete
+        //! construct is kept in memory. This is suitable for very large XML files which
+        //! are processed element by element.
+        //!
+        //! The input is well-formed-checked (balanced tags, one single root element)
+        //! but not validated. The application may use the handler events to build
+        //! partial xml::Element trees and validate them using xml::Document::validate().
+        //!
+        class TSDUCKDLL Reader
+        {
+        public:
+            //!
+            //! List of attributes of an element, in order of appearance.
+            //!
+            typedef std::list<Attribute> AttributeList;
+
+            //!
+            //! Abstract interface of an application handler for XML events.
+            //! In all handlers, returning false aborts the parsing.
+            //!
+            class TSDUCKDLL Handler
+            {
+            public:
+                //!
+                //! Invoked on the start tag of an element.
+                //! @param [in,out] reader The calling reader.
+                //! @param [in] name Element name.
+                //! @param [in] attributes List of attributes of the element.
+                //! @param [in] line Line number of the start tag in the input document.
+                //! @return True to continue parsing, false to abort.
+                //!
+                virtual bool handleElementStart(Reader& reader, const UString& name, const AttributeList& attributes, size_t line) = 0;
+
+                //!
+                //! Invoked at the end of an element, after its end tag or after an empty-element tag.
+                //! @param [in,out] reader The calling reader.
+                //! @param [in] name Element name.
+                //! @param [in] line Line number of the end tag in the input document.
+                //! @return True to continue parsing, false to abort.
+                //!
+                virtual bool handleElementEnd(Reader& reader, const UString& name, size_t line) = 0;
+
+                //!
+                //! Invoked on a text node inside an element.
+                //! Texts containing only spaces between two tags are not reported.
+                //! @param [in,out] reader The calling reader.
+                //! @param [in] text Text content, HTML entities already translated, CDATA content unmodified.
+                //! @param [in] cdata True if the text is a CDATA section.
+                //! @param [in] line Line number of the start of text in the input document.
+                //! @return True to continue parsing, false to abort.
+                //!
+                virtual bool handleText(Reader& reader, const UString& text, bool cdata, size_t line) = 0;
+
+                //!
+                //! Invoked on an XML declaration. The default implementation ignores it.
+                //! @param [in,out] reader The calling reader.
+                //! @param [in] value Content of the declaration, between "<?" and "?>".
+                //! @param [in] line Line number of the declaration in the input document.
+                //! @return True to continue parsing, false to abort.
+                //!
+                virtual bool handleDeclaration(Reader& reader, const UString& value, size_t line);
+
+                //!
+                //! Invoked on an XML comment. The default implementation ignores it.
+                //! @param [in,out] reader The calling reader.
+                //! @param [in] value Content of the comment, between "<!--" and "-->".
+                //! @param [in] line Line number of the comment in the input document.
+                //! @return True to continue parsing, false to abort.
+                //!
+                virtual bool handleComment(Reader& reader, const UString& value, size_t line);
+
+                //!
+                //! Virtual destructor.
+                //!
+                virtual ~Handler();
+            };
+
+            //!
+            //! Constructor.
+            //! @param [in,out] report Where to report errors.
+            //!
+            explicit Reader(Report& report = NULLREP);
+
+            //!
+            //! Reset the reader, discarding any partially parsed input.
+            //!
+            void reset();
+
+            //!
+            //! Feed the reader with the next chunk of input document.
+            //! All complete XML constructs are immediately reported to the handler.
+            //! @param [in] data Address of UTF-8 data. The chunk may end in the middle of any construct.
+            //! @param [in] size Size in bytes of the data.
+            //! @param [in,out] handler Application handler.
+            //! @return True on success, false on error or if the handler aborted the parsing.
+            //!
+            bool feed(const void* data, size_t size, Handler& handler);
+
+            //!
+            //! Signal the end of the input document.
+            //! @param [in,out] handler Application handler.
+            //! @return True if the document is complete, false on error.
+            //!
+            bool finish(Handler& handler);
+
+            //!
+            //! Parse a complete XML document from a stream.
+            //! @param [in,out] strm A standard stream in input mode.
+            //! @param [in,out] handler Application handler.
+            //! @return True on success, false on error.
+            //!
+            bool parse(std::istream& strm, Handler& handler);
+
+            //!
+            //! Parse a complete XML document from a file.
+            //! @param [in] fileName Name of the XML file.
+            //! @param [in,out] handler Application handler.
+            //! @return True on success, false on error.
+            //!
+            bool parseFile(const UString& fileName, Handler& handler);
+
+            //!
+            //! Get the current line number in the input document.
+            //! @return The current line number.
+            //!
+            size_t lineNumber() const { return _line; }
+
+            //!
+            //! Get the current depth of open elements.
+            //! Inside the handler of an element start or end, the depth includes this element.
+            //! @return The number of currently open elements, zero at document level.
+            //!
+            size_t depth() const { return _stack.size(); }
+
+            //!
+            //! Get a reference to the report object for the XML reader.
+            //! @return A reference to the report object for the XML reader.
+            //!
+            Report& report() const { return _report; }
+
+        private:
+            // Status of the analysis of one construct in the buffer.
+            enum Status {DONE, NEED_MORE, FAILED};
+
+            Report&       _report;     // Where to report errors.
+            std::string   _buffer;     // Pending UTF-8 data, starting with an incomplete construct.
+            size_t        _line;       // Line number at current parsing point (start of _buffer between calls).
+            UStringVector _stack;      // Names of currently open elements.
+            bool          _started;    // Some data were already received (BOM already checked).
+            bool          _rootDone;   // The root element was closed.
+            bool          _error;      // An error was found, the document is rejected.
+
+            // Analyze the next construct in _buffer at index pos.
+            // On return, pos is updated after the construct, unless NEED_MORE is returned.
+            Status parseConstruct(size_t& pos, bool eof, Handler& handler);
+            Status parseText(size_t& pos, bool eof, Handler& handler);
+            Status parseStartTag(size_t& pos, bool eof, Handler& handler);
+            Status parseEndTag(size_t& pos, bool eof, Handler& handler);
+            Status parseDelimited(size_t& pos, bool eof, size_t prefixSize, const char* endToken, UString& value, const UChar* what);
+
+            // Process all complete constructs in _buffer.
+            bool process(bool eof, Handler& handler);
+
+            // Find a delimiter in _buffer, from pos. Return std::string::npos if not found.
+            size_t find(const char* token, size_t pos) const;
+
+            // Count lines in a range of the buffer.
+            size_t countLines(size_t start, size_t end) const;
+
+            // Parse an XML name in the buffer. Return false if there is no name.
+            bool parseName(size_t& pos, size_t end, UString& name) const;
+
+            // Skip spaces in the buffer.
+            void skipSpaces(size_t& pos, size_t end) const;
+
+            // Inaccessible operations.
+            Reader(const Reader&) = delete;
+            Reader& operator=(const Reader&) = delete;
+        };
+    }
+}
@@ -0,0 +1,117 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsxmlWriter.h"
+#include "tsxmlElement.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Constructor and destructor.
+//----------------------------------------------------------------------------
+
+ts::xml::Writer::Writer(Report& report) :
+    _out(report),
+    _doc(report),
+    _open(false)
+{
+}
+
+ts::xml::Writer::~Writer()
+{
+    close();
+}
+
+
+//----------------------------------------------------------------------------
+// Open the output and start the document.
+//----------------------------------------------------------------------------
+
+bool ts::xml::Writer::open(const UString& fileName, const UString& rootName, size_t indent)
+{
+    close();
+    return _out.setFile(fileName) && start(rootName, indent);
+}
+
+bool ts::xml::Writer::open(std::ostream& strm, const UString& rootName, size_t indent)
+{
+    close();
+    _out.setStream(strm);
+    return start(rootName, indent);
+}
+
+bool ts::xml::Writer::start(const UString& rootName, size_t indent)
+{
+    if (_doc.initialize(rootName) == 0) {
+        _out.close();
+        return false;
+    }
+
+    // Print the declaration and keep the root element open.
+    _out.setIndentSize(indent);
+    _doc.print(_out, true);
+    _open = true;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Print and delete all pending elements.
+//----------------------------------------------------------------------------
+
+void ts::xml::Writer::flush()
+{
+    Element* root = rootElement();
+    if (root != 0) {
+        Node* node;
+        while ((node = root->firstChild()) != 0) {
+            _out << ts::margin;
+            node->print(_out, false);
+            _out << std::endl;
+            // Deallocating the node removes it from the document through the destructor.
+            delete node;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Close the document.
+//----------------------------------------------------------------------------
+
+void ts::xml::Writer::close()
+{
+    if (_open) {
+        flush();
+        _doc.printClose(_out);
+        _doc.clear();
+        _out.close();
+        _open = false;
+    }
+}
@@ -0,0 +1,121 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Streaming XML writer.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsxmlDocument.h"
+#include "tsTextFormatter.h"
+
+namespace ts {
+    namespace xml {
+        //!
+        //! Streaming XML writer.
+        //! @ingroup xml
+        //!
+        //! This class writes an XML document with a potentially very large number
+        //! of elements under the root, without keeping the whole document in memory.
+        //! The XML declaration and the root element start tag are written when the
+        //! writer is open. The application builds new elements under rootElement()
+        //! and calls flush() to print and delete them. The root element is closed
+        //! when the writer is closed.
+        //!
+        class TSDUCKDLL Writer
+        {
+        public:
+            //!
+            //! Constructor.
+            //! @param [in,out] report Where to report errors.
+            //!
+            explicit Writer(Report& report = NULLREP);
+
+            //!
+            //! Destructor, close the document.
+            //!
+            ~Writer();
+
+            //!
+            //! Create an XML file and start the document.
+            //! @param [in] fileName Name of the XML file to create.
+            //! @param [in] rootName Name of the root element.
+            //! @param [in] indent Indentation width of each level.
+            //! @return True on success, false on error.
+            //!
+            bool open(const UString& fileName, const UString& rootName, size_t indent = 2);
+
+            //!
+            //! Start the document on an open text stream.
+            //! @param [in,out] strm The output text stream. The referenced stream
+            //! object must remain valid until close() is called.
+            //! @param [in] rootName Name of the root element.
+            //! @param [in] indent Indentation width of each level.
+            //! @return True on success, false on error.
+            //!
+            bool open(std::ostream& strm, const UString& rootName, size_t indent = 2);
+
+            //!
+            //! Check if the writer is open.
+            //! @return True if the writer is open.
+            //!
+            bool isOpen() const { return _open; }
+
+            //!
+            //! Get the root element of the document.
+            //! New elements to write shall be created as children of the root element.
+            //! @return The root element of the document or zero if the writer is not open.
+            //!
+            Element* rootElement() { return _open ? _doc.rootElement() : 0; }
+
+            //!
+            //! Print all pending children of the root element and delete them.
+            //!
+            void flush();
+
+            //!
+            //! Flush all pending elements, close the root element and the document.
+            //!
+            void close();
+
+        private:
+            TextFormatter _out;   // Output formatter.
+            Document      _doc;   // Document, with the pending children of the root only.
+            bool          _open;  // The document is started.
+
+            // Write the document header after opening the output.
+            bool start(const UString& rootName, size_t indent);
+
+            // Inaccessible operations.
+            Writer(const Writer&) = delete;
+            Writer& operator=(const Writer&) = delete;
+        };
+    }
+}
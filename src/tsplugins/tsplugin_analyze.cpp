@@ -36,9 +36,15 @@
 #include "tsPluginRepository.h"
 #include "tsTSAnalyzerReport.h"
 #include "tsTSSpeedMetrics.h"
+#include "tsMessageQueue.h"
+#include "tsGuard.h"
+#include "tsThread.h"
 #include "tsSysUtils.h"
 TSDUCK_SOURCE;
 
+#define MAX_PENDING_REPORTS      4            // Max number of reports waiting for the report thread
+#define REPORTER_STACK_SIZE (512 * 1024)      // Stack size of the report thread
+
 
 //----------------------------------------------------------------------------
 // Plugin definition
@@ -55,19 +61,82 @@ namespace ts {
         virtual Status processPacket(TSPacket&, bool&, bool&) override;
 
     private:
+        // Analyzers are passed between the packet thread and the report thread.
+        // An analyzer is used by only one thread at a time.
+        typedef MessageQueue<TSAnalyzerReport, Mutex> AnalyzerQueue;
+        typedef AnalyzerQueue::MessagePtr AnalyzerPtr;
+        typedef SafePtr<TSAnalyzer::Snapshot, Mutex> SnapshotPtr;
+
+        // A request from the packet thread to the report thread.
+        // Either a full report of an analyzer, or a JSON line from a snapshot.
+        // When both are null, this is a termination request.
+        class ReportRequest
+        {
+        public:
+            AnalyzerPtr analyzer;  // Produce a full report of this analyzer, then recycle it.
+            SnapshotPtr snapshot;  // Produce a JSON line with the delta from the previous snapshot.
+            ReportRequest() : analyzer(), snapshot() {}
+        };
+        typedef MessageQueue<ReportRequest, Mutex> RequestQueue;
+
+        // Report thread: with --interval or --json-interval, reports are formatted and
+        // written out of the packet processing thread.
+        class Reporter : public Thread
+        {
+        public:
+            Reporter(AnalyzePlugin* plugin);
+            bool start();
+            void stop();
+            bool failed() const;
+
+        private:
+            AnalyzePlugin* const _plugin;
+            mutable Mutex        _mutex;   // Protect _failed.
+            bool                 _failed;  // An output error occurred.
+
+            // Implementation of Thread.
+            virtual void main() override;
+
+            // Inaccessible operations.
+            Reporter() = delete;
+            Reporter(const Reporter&) = delete;
+            Reporter& operator=(const Reporter&) = delete;
+        };
+
+        // The following fields are used by the report thread while it is active.
         UString           _output_name;
         std::ofstream     _output_stream;
         std::ostream*     _output;
-        NanoSecond        _output_interval;
         bool              _multiple_output;
+        UString           _json_name;
+        std::ofstream     _json_stream;
+        std::ostream*     _json_output;
+        TSAnalyzer::Snapshot _snapshot;
+        TSAnalyzer::Snapshot _delta;
+
+        // The following fields are used by the packet thread only.
+        NanoSecond        _output_interval;
         TSSpeedMetrics    _metrics;
         NanoSecond        _next_report;
-        TSAnalyzerReport  _analyzer;
+        NanoSecond        _json_interval;
+        NanoSecond        _next_json;
+        AnalyzerPtr       _analyzer;
+        uint64_t          _generation;        // Analysis generation, incremented at each new analyzer
         TSAnalyzerOptions _analyzer_options;
 
+        // Communication between the packet thread and the report thread.
+        RequestQueue      _requests;          // Reports to produce
+        AnalyzerQueue     _free_analyzers;    // Reset analyzers, ready for reuse
+        Reporter          _reporter;          // Report thread
+
         bool openOutput();
         void closeOutput();
-        bool produceReport();
+        bool produceReport(TSAnalyzerReport& analyzer);
+        bool produceJSON(const TSAnalyzer::Snapshot& current);
+
+        // Send requests to the report thread. Return false if the report thread failed.
+        bool submitReport();
+        bool submitSnapshot();
 
         // Inaccessible operations
         AnalyzePlugin() = delete;
@@ -89,14 +158,27 @@ ts::AnalyzePlugin::AnalyzePlugin(TSP* tsp_) :
     _output_name(),
     _output_stream(),
     _output(),
-    _output_interval(0),
     _multiple_output(false),
+    _json_name(),
+    _json_stream(),
+    _json_output(0),
+    _snapshot(),
+    _delta(),
+    _output_interval(0),
     _metrics(),
     _next_report(0),
+    _json_interval(0),
+    _next_json(0),
     _analyzer(),
-    _analyzer_options()
+    _generation(0),
+    _analyzer_options(),
+    _requests(MAX_PENDING_REPORTS),
+    _free_analyzers(),
+    _reporter(this)
 {
     option(u"interval",       'i', POSITIVE);
+    option(u"json-file",       0,  STRING);
+    option(u"json-interval",   0,  POSITIVE);
     option(u"multiple-files", 'm');
     option(u"output-file",    'o', STRING);
     copyOptions(_analyzer_options);
@@ -111,7 +193,18 @@ ts::AnalyzePlugin::AnalyzePlugin(TSP* tsp_) :
         u"  --interval seconds\n"
         u"      Produce a new output file at regular intervals. After outputing a file,\n"
         u"      the analysis context is reset, ie. each output file contains a fully\n"
-        u"      independent analysis.\n"
+        u"      independent analysis. The reports are computed and written in a separate\n"
+        u"      thread, the packet processing is not interrupted.\n"
+        u"\n"
+        u"  --json-file filename\n"
+        u"      Specify the output file for --json-interval. By default, use the standard\n"
+        u"      output.\n"
+        u"\n"
+        u"  --json-interval seconds\n"
+        u"      Output one line of compact JSON at regular intervals with the statistics\n"
+        u"      of the last interval: packets, errors and bitrates, globally and per PID.\n"
+        u"      This is cheap and does not reset the analysis. It can be combined with\n"
+        u"      --interval.\n"
         u"\n"
         u"  -m\n"
         u"  --multiple-files\n"
@@ -141,13 +234,21 @@ bool ts::AnalyzePlugin::start()
     _output_name = value(u"output-file");
     _output_interval = NanoSecPerSec * intValue<Second>(u"interval", 0);
     _multiple_output = present(u"multiple-files");
+    _json_interval = NanoSecPerSec * intValue<Second>(u"json-interval", 0);
+    _json_name = value(u"json-file");
     _output = _output_name.empty() ? &std::cout : &_output_stream;
     _analyzer_options.getOptions(*this);
-    _analyzer.setAnalysisOptions(_analyzer_options);
+    _analyzer = new TSAnalyzerReport;
+    _analyzer->setAnalysisOptions(_analyzer_options);
+    _analyzer->setGeneration(++_generation);
+    _requests.clear();
+    _free_analyzers.clear();
 
     // For production of multiple reports at regular intervals.
     _metrics.start();
     _next_report = _output_interval;
+    _next_json = _json_interval;
+    _snapshot.clear();
 
     // Create the output file. Note that this file is used only in the stop
     // method and could be created there. However, if the file cannot be
@@ -156,6 +257,28 @@ bool ts::AnalyzePlugin::start()
         return false;
     }
 
+    // Create the JSON output file.
+    if (_json_interval > 0) {
+        if (_json_name.empty()) {
+            _json_output = &std::cout;
+        }
+        else {
+            _json_stream.open(_json_name.toUTF8().c_str());
+            if (!_json_stream) {
+                tsp->error(u"cannot create file %s", {_json_name});
+                return false;
+            }
+            _json_output = &_json_stream;
+        }
+        _analyzer->getSnapshot(_snapshot);
+    }
+
+    // Start the report thread for periodic reports.
+    if ((_output_interval > 0 || _json_interval > 0) && !_reporter.start()) {
+        tsp->error(u"cannot start report thread");
+        return false;
+    }
+
     return true;
 }
 
@@ -209,17 +332,13 @@ void ts::AnalyzePlugin::closeOutput()
 // Produce a report. Return true on success, false on error.
 //----------------------------------------------------------------------------
 
-bool ts::AnalyzePlugin::produceReport()
+bool ts::AnalyzePlugin::produceReport(TSAnalyzerReport& analyzer)
 {
     if (!openOutput()) {
         return false;
     }
     else {
-        // Set last known input bitrate as hint
-        _analyzer.setBitrateHint(tsp->bitrate());
-
-        // Produce the report
-        _analyzer.report(*_output, _analyzer_options);
+        analyzer.report(*_output, _analyzer_options);
         closeOutput();
         return true;
     }
@@ -232,11 +351,168 @@ bool ts::AnalyzePlugin::produceReport()
 
 bool ts::AnalyzePlugin::stop()
 {
-    produceReport();
+    // Complete all pending periodic reports before the final one.
+    _reporter.stop();
+
+    // Set last known input bitrate as hint and produce the final report.
+    if (!_analyzer.isNull()) {
+        _analyzer->setBitrateHint(tsp->bitrate());
+        produceReport(*_analyzer);
+        _analyzer.clear();
+    }
+    _free_analyzers.clear();
+
+    if (_json_stream.is_open()) {
+        _json_stream.close();
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Produce one line of JSON with the statistics of the last interval.
+//----------------------------------------------------------------------------
+
+bool ts::AnalyzePlugin::produceJSON(const TSAnalyzer::Snapshot& current)
+{
+    // Compute the delta with the previous snapshot and keep the new one.
+    current.getDelta(_snapshot, _delta);
+    _snapshot = current;
+
+    *_json_output << _delta.toJSON()->oneLiner(*tsp) << std::endl;
+    if (!*_json_output) {
+        tsp->error(u"error writing JSON output");
+        return false;
+    }
     return true;
 }
 
 
+//----------------------------------------------------------------------------
+// Send requests to the report thread.
+//----------------------------------------------------------------------------
+
+// Pass the current analyzer to the report thread and continue with a new one.
+bool ts::AnalyzePlugin::submitReport()
+{
+    if (_reporter.failed()) {
+        return false;
+    }
+
+    // Set last known input bitrate as hint.
+    _analyzer->setBitrateHint(tsp->bitrate());
+
+    RequestQueue::MessagePtr request(new ReportRequest);
+    CheckNonNull(request.pointer());
+    request->analyzer = _analyzer;
+
+    // Reuse an analyzer which was already reset by the report thread, if there is one.
+    if (!_free_analyzers.dequeue(_analyzer, 0)) {
+        _analyzer = new TSAnalyzerReport;
+        CheckNonNull(_analyzer.pointer());
+        _analyzer->setAnalysisOptions(_analyzer_options);
+    }
+
+    // The snapshots of the new analyzer are unrelated to the previous ones.
+    _analyzer->setGeneration(++_generation);
+
+    // Wait here only if the report thread is late by MAX_PENDING_REPORTS reports.
+    return _requests.enqueue(request);
+}
+
+// Pass a snapshot of the current analysis to the report thread.
+bool ts::AnalyzePlugin::submitSnapshot()
+{
+    if (_reporter.failed()) {
+        return false;
+    }
+
+    RequestQueue::MessagePtr request(new ReportRequest);
+    CheckNonNull(request.pointer());
+    request->snapshot = new TSAnalyzer::Snapshot;
+    CheckNonNull(request->snapshot.pointer());
+
+    // Only copy the counters here, the JSON line is built in the report thread.
+    _analyzer->setBitrateHint(tsp->bitrate());
+    _analyzer->getSnapshot(*request->snapshot);
+
+    return _requests.enqueue(request);
+}
+
+
+//----------------------------------------------------------------------------
+// Report thread.
+//----------------------------------------------------------------------------
+
+ts::AnalyzePlugin::Reporter::Reporter(AnalyzePlugin* plugin) :
+    Thread(ThreadAttributes().setStackSize(REPORTER_STACK_SIZE)),
+    _plugin(plugin),
+    _mutex(),
+    _failed(false)
+{
+}
+
+// Start the thread, clear errors from a previous run.
+bool ts::AnalyzePlugin::Reporter::start()
+{
+    {
+        Guard lock(_mutex);
+        _failed = false;
+    }
+    return Thread::start();
+}
+
+// Terminate the thread after completion of all pending requests.
+void ts::AnalyzePlugin::Reporter::stop()
+{
+    // An empty request means termination.
+    _plugin->_requests.forceEnqueue(new ReportRequest);
+
+    // Wait for actual thread termination, void if not started.
+    Thread::waitForTermination();
+    _plugin->_requests.clear();
+}
+
+// Check if an output error occurred.
+bool ts::AnalyzePlugin::Reporter::failed() const
+{
+    Guard lock(_mutex);
+    return _failed;
+}
+
+// Invoked in the context of the report thread.
+void ts::AnalyzePlugin::Reporter::main()
+{
+    _plugin->tsp->debug(u"report thread started");
+
+    for (;;) {
+        RequestQueue::MessagePtr request;
+        _plugin->_requests.dequeue(request);
+        if (request.isNull() || (request->analyzer.isNull() && request->snapshot.isNull())) {
+            break;
+        }
+
+        bool success = true;
+        if (!request->analyzer.isNull()) {
+            // Produce a full report, reset the analyzer and give it back to the packet thread.
+            success = _plugin->produceReport(*request->analyzer);
+            request->analyzer->reset();
+            _plugin->_free_analyzers.forceEnqueue(request->analyzer);
+        }
+        if (!request->snapshot.isNull()) {
+            success = _plugin->produceJSON(*request->snapshot) && success;
+        }
+
+        if (!success) {
+            Guard lock(_mutex);
+            _failed = true;
+        }
+    }
+
+    _plugin->tsp->debug(u"report thread completed");
+}
+
+
 //----------------------------------------------------------------------------
 // Packet processing method
 //----------------------------------------------------------------------------
@@ -244,16 +520,25 @@ bool ts::AnalyzePlugin::stop()
 ts::ProcessorPlugin::Status ts::AnalyzePlugin::processPacket (TSPacket& pkt, bool& flush, bool& bitrate_changed)
 {
     // Feed the analyzer with one packet
-    _analyzer.feedPacket (pkt);
+    _analyzer->feedPacket(pkt);
+
+    // Check the clock only when necessary.
+    const bool clock = (_output_interval > 0 || _json_interval > 0) && _metrics.processedPacket();
+
+    // With --json-interval, check if it is time to produce a JSON line.
+    if (clock && _json_interval > 0 && _metrics.sessionNanoSeconds() >= _next_json) {
+        if (!submitSnapshot()) {
+            return TSP_END;
+        }
+        _next_json += _json_interval;
+    }
 
     // With --interval, check if it is time to produce a report
-    if (_output_interval > 0 && _metrics.processedPacket() && _metrics.sessionNanoSeconds() >= _next_report) {
-        // Time to produce a report.
-        if (!produceReport()) {
+    if (clock && _output_interval > 0 && _metrics.sessionNanoSeconds() >= _next_report) {
+        // Time to produce a report. Continue with a new analysis context.
+        if (!submitReport()) {
             return TSP_END;
         }
-        // Reset analysis context.
-        _analyzer.reset();
         // Compute next report time.
         _next_report += _output_interval;
     }
@@ -49,6 +49,7 @@ namespace ts {
         ContinuityPlugin(TSP*);
         virtual bool start() override;
         virtual Status processPacket(TSPacket&, bool&, bool&) override;
+        virtual size_t processPacketBatch(TSPacket*, Status*, size_t, bool&, bool&) override;
 
     private:
         UString       _tag;             // Message tag
@@ -158,7 +159,7 @@ ts::ProcessorPlugin::Status ts::ContinuityPlugin::processPacket(TSPacket& pkt, b
 
         // Check if the CC is incorrect.
         if (_oldCC[pid] < 16 && !duplicated && ((_oldCC[pid] + 1) & 0x0F) != cc) {
-            tsp->log(_log_level, u"%sTS: %'d, PID: 0x%X, missing: %d", {_tag, _packet_count, pid, (cc < _oldCC[pid] ? 16 : 0) + cc - _oldCC[pid] - 1});
+            TS_LOG(*tsp, _log_level, u"%sTS: %'d, PID: 0x%X, missing: %d", {_tag, _packet_count, pid, (cc < _oldCC[pid] ? 16 : 0) + cc - _oldCC[pid] - 1});
         }
 
         // Fix CC if requested. Fixes are propagated all along the PID.
@@ -173,3 +174,17 @@ ts::ProcessorPlugin::Status ts::ContinuityPlugin::processPacket(TSPacket& pkt, b
     _packet_count++;
     return TSP_OK;
 }
+
+
+//----------------------------------------------------------------------------
+// Packet batch processing method
+//----------------------------------------------------------------------------
+
+size_t ts::ContinuityPlugin::processPacketBatch(TSPacket* pkt, Status* status, size_t count, bool& flush, bool& bitrate_changed)
+{
+    // Static call to the packet processing method, no virtual dispatch.
+    for (size_t i = 0; i < count; ++i) {
+        status[i] = ContinuityPlugin::processPacket(pkt[i], flush, bitrate_changed);
+    }
+    return count;
+}
@@ -52,6 +52,7 @@ namespace ts {
         virtual bool start() override;
         virtual bool stop() override;
         virtual Status processPacket(TSPacket&, bool&, bool&) override;
+        virtual size_t processPacketBatch(TSPacket*, Status*, size_t, bool&, bool&) override;
 
     private:
         // This structure is used at each --interval.
@@ -327,3 +328,30 @@ ts::ProcessorPlugin::Status ts::CountPlugin::processPacket(TSPacket& pkt, bool&
     _current_pkt++;
     return TSP_OK;
 }
+
+
+//----------------------------------------------------------------------------
+// Packet batch processing method
+//----------------------------------------------------------------------------
+
+size_t ts::CountPlugin::processPacketBatch(TSPacket* pkt, Status* status, size_t count, bool& flush, bool& bitrate_changed)
+{
+    if (_report_interval > 0 || _report_all) {
+        // Periodic or per-packet reports, use the packet processing method.
+        for (size_t i = 0; i < count; ++i) {
+            status[i] = CountPlugin::processPacket(pkt[i], flush, bitrate_changed);
+        }
+    }
+    else {
+        // Only count packets.
+        for (size_t i = 0; i < count; ++i) {
+            const PID pid = pkt[i].getPID();
+            if (_pids[pid] != _negate) {
+                _counters[pid]++;
+            }
+            status[i] = TSP_OK;
+        }
+        _current_pkt += count;
+    }
+    return count;
+}
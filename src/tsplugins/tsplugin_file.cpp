@@ -124,9 +124,12 @@ ts::FileInput::FileInput(TSP* tsp_) :
 {
     option(u"",               0,  STRING, 0, UNLIMITED_COUNT);
     option(u"byte-offset",   'b', UNSIGNED);
+    option(u"direct",         0);
     option(u"infinite",      'i');
+    option(u"mmap",           0);
     option(u"packet-offset", 'p', UNSIGNED);
     option(u"repeat",        'r', POSITIVE);
+    option(u"window-size",    0,  POSITIVE);
 
     setHelp(u"File-name:\n"
             u"  Name of the input files. The files are read in sequence. Use standard\n"
@@ -139,6 +142,12 @@ ts::FileInput::FileInput(TSP* tsp_) :
             u"      Start reading each file at the specified byte offset (default: 0).\n"
             u"      This option is allowed only if the input file is a regular file.\n"
             u"\n"
+            u"  --direct\n"
+            u"      Read the files using direct I/O (O_DIRECT on Linux), bypassing the system\n"
+            u"      cache, with large aligned buffers. Useful with very large files on cold\n"
+            u"      storage, which are read only once. Ignored if the input file is not a\n"
+            u"      regular file or on Windows.\n"
+            u"\n"
             u"  --help\n"
             u"      Display this help text.\n"
             u"\n"
@@ -147,6 +156,11 @@ ts::FileInput::FileInput(TSP* tsp_) :
             u"      Repeat the playout of the file infinitely (default: only once).\n"
             u"      This option is allowed only if the input file is a regular file.\n"
             u"\n"
+            u"  --mmap\n"
+            u"      Read the files using memory-mapped windows instead of read() system\n"
+            u"      calls. The kernel is advised of the sequential access to the file.\n"
+            u"      Ignored if the input file is not a regular file or on Windows.\n"
+            u"\n"
             u"  -p value\n"
             u"  --packet-offset value\n"
             u"      Start reading the file at the specified TS packet (default: 0).\n"
@@ -159,7 +173,11 @@ ts::FileInput::FileInput(TSP* tsp_) :
             u"      input file is a regular file.\n"
             u"\n"
             u"  --version\n"
-            u"      Display the version number.\n");
+            u"      Display the version number.\n"
+            u"\n"
+            u"  --window-size value\n"
+            u"      With --mmap or --direct, specify the size in bytes of the memory-mapped\n"
+            u"      windows or direct I/O buffer. The default is 16 MB.\n");
 }
 
 
@@ -171,9 +189,15 @@ ts::FileOutput::FileOutput(TSP* tsp_) :
     OutputPlugin(tsp_, u"Write packets to a file", u"[options] [file-name]"),
     _file()
 {
-    option(u"",        0,  STRING, 0, 1);
-    option(u"append", 'a');
-    option(u"keep",   'k');
+    option(u"",               0,  STRING, 0, 1);
+    option(u"append",        'a');
+    option(u"async",          0);
+    option(u"buffer-count",   0,  POSITIVE);
+    option(u"buffer-packets", 0,  POSITIVE);
+    option(u"direct",         0);
+    option(u"keep",          'k');
+    option(u"no-io-uring",    0);
+    option(u"sync-interval",  0,  POSITIVE);
 
     setHelp(u"File-name:\n"
             u"  Name of the created output file. Use standard output by default.\n"
@@ -185,6 +209,26 @@ ts::FileOutput::FileOutput(TSP* tsp_) :
             u"      If the file already exists, append to the end of the file.\n"
             u"      By default, existing files are overwritten.\n"
             u"\n"
+            u"  --async\n"
+            u"      Write the file asynchronously (write-behind). The packets are copied into\n"
+            u"      a bounded pool of aligned buffers which are written in the background,\n"
+            u"      using io_uring on Linux or a writer thread otherwise. The packet processing\n"
+            u"      chain is not blocked by short storage latency peaks, as long as free\n"
+            u"      buffers remain. The write latency statistics are reported in verbose mode.\n"
+            u"\n"
+            u"  --buffer-count value\n"
+            u"      With --async, specify the maximum number of buffers in flight. The\n"
+            u"      default is " + UString::Decimal(TSFileOutput::DEFAULT_BUFFER_COUNT) + u" buffers.\n"
+            u"\n"
+            u"  --buffer-packets value\n"
+            u"      With --async, specify the size in packets of each buffer. The size is\n"
+            u"      rounded up to a multiple of 1024 packets. The default is " + UString::Decimal(TSFileOutput::DEFAULT_BUFFER_PACKETS) + u" packets.\n"
+            u"\n"
+            u"  --direct\n"
+            u"      Write the file using direct I/O (O_DIRECT on Linux), bypassing the system\n"
+            u"      cache. Implies --async. Ignored if the output file is not a regular file,\n"
+            u"      if the filesystem does not support it, or on Windows.\n"
+            u"\n"
             u"  --help\n"
             u"      Display this help text.\n"
             u"\n"
@@ -193,6 +237,16 @@ ts::FileOutput::FileOutput(TSP* tsp_) :
             u"      Keep existing file (abort if the specified file already exists).\n"
             u"      By default, existing files are overwritten.\n"
             u"\n"
+            u"  --no-io-uring\n"
+            u"      With --async, always use a writer thread, never io_uring.\n"
+            u"\n"
+            u"  --sync-interval value\n"
+            u"      Each time the specified number of megabytes is written, start writing\n"
+            u"      back the last written range to disk and wait for the completion of the\n"
+            u"      previous one (sync_file_range() on Linux, ignored on other systems).\n"
+            u"      This bounds the amount of dirty data in the system cache without\n"
+            u"      flushing the complete file. By default, the system decides.\n"
+            u"\n"
             u"  --version\n"
             u"      Display the version number.\n");
 }
@@ -249,6 +303,14 @@ bool ts::FileInput::start()
         tsp->error(u"specifying --infinite is meaningless with more than one file");
         return false;
     }
+    if (present(u"mmap") && present(u"direct")) {
+        tsp->error(u"--mmap and --direct are mutually exclusive");
+        return false;
+    }
+
+    // File access mode, applies to all files.
+    _file.setAccessMode(present(u"mmap") ? TSFileInput::MMAP_ACCESS : (present(u"direct") ? TSFileInput::DIRECT_ACCESS : TSFileInput::READ_ACCESS),
+                        intValue<size_t>(u"window-size", 0));
 
     // Name of first input file (or standard input if there is not input file).
     const UString first(_filenames.empty() ? UString() : _filenames.front());
@@ -298,12 +360,31 @@ size_t ts::FileInput::receive(TSPacket* buffer, size_t max_packets)
 
 bool ts::FileOutput::start()
 {
+    const bool async = present(u"async") || present(u"direct");
+    _file.setWriteMode(!async ? TSFileOutput::SYNC_WRITE : (present(u"no-io-uring") ? TSFileOutput::THREAD_WRITE : TSFileOutput::URING_WRITE),
+                       intValue<size_t>(u"buffer-packets", 0),
+                       intValue<size_t>(u"buffer-count", 0));
+    _file.setDirectIO(present(u"direct"));
+    _file.setSyncInterval(intValue<uint64_t>(u"sync-interval", 0) * 1024 * 1024);
     return _file.open(value(u""), present(u"append"), present(u"keep"), *tsp);
 }
 
 bool ts::FileOutput::stop()
 {
-    return _file.close(*tsp);
+    const bool success = _file.close(*tsp);
+
+    // Report the write-behind statistics.
+    const TSFileOutput::WriteStatistics stats(_file.getWriteStatistics());
+    if (stats.mode != TSFileOutput::SYNC_WRITE) {
+        tsp->verbose(u"%s%s: %'d writes, %'d bytes, latency: %'d us average, %'d us max, %'d stalls (%'d ms), %'d flushes",
+                     {stats.mode == TSFileOutput::URING_WRITE ? u"io_uring" : u"writer thread",
+                      stats.direct ? u", direct I/O" : u"",
+                      stats.writes, stats.bytes,
+                      stats.writes == 0 ? 0 : stats.total_latency / NanoSecond(stats.writes) / NanoSecPerMicroSec,
+                      stats.max_latency / NanoSecPerMicroSec,
+                      stats.stalls, stats.stall_time / NanoSecPerMilliSec, stats.syncs});
+    }
+    return success;
 }
 
 bool ts::FileOutput::send (const TSPacket* buffer, size_t packet_count)
@@ -49,6 +49,8 @@ namespace ts {
         FilterPlugin (TSP*);
         virtual bool start() override;
         virtual Status processPacket(TSPacket&, bool&, bool&) override;
+        virtual size_t processPacketBatch(TSPacket*, Status*, size_t, bool&, bool&) override;
+        virtual Parallelism getParallelism() override;
 
     private:
         int           scrambling_ctrl;  // Scrambling control value (<0: no filter)
@@ -66,6 +68,10 @@ namespace ts {
         int           max_af;           // Maximum adaptation field size (<0: no filter)
         PacketCounter after_packets;
         PIDSet        pid;              // PID values to filter
+        bool          pid_only;         // Filter on PID values only
+
+        // Check if a packet matches one of the selected criteria.
+        bool match(const TSPacket&) const;
 
         // Inaccessible operations
         FilterPlugin() = delete;
@@ -213,26 +219,20 @@ bool ts::FilterPlugin::start()
 
     getPIDSet(pid, u"pid");
 
+    pid_only = scrambling_ctrl < 0 && !with_payload && !with_af && !with_pes && !has_pcr && !unit_start && !valid &&
+        min_payload < 0 && max_payload < 0 && min_af < 0 && max_af < 0;
+
     return true;
 }
 
 
 //----------------------------------------------------------------------------
-// Packet processing method
+// Check if a packet matches one of the selected criteria.
 //----------------------------------------------------------------------------
 
-ts::ProcessorPlugin::Status ts::FilterPlugin::processPacket(TSPacket& pkt, bool& flush, bool& bitrate_changed)
+bool ts::FilterPlugin::match(const TSPacket& pkt) const
 {
-    // Pass initial packets without filtering.
-
-    if (after_packets > 0) {
-        after_packets--;
-        return TSP_OK;
-    }
-
-    // Check if the packet matches one of the selected criteria.
-
-    bool ok = pid[pkt.getPID()] ||
+    return pid[pkt.getPID()] ||
         (with_payload && pkt.hasPayload()) ||
         (with_af && pkt.hasAF()) ||
         (unit_start && pkt.getPUSI()) ||
@@ -259,12 +259,25 @@ ts::ProcessorPlugin::Status ts::FilterPlugin::processPacket(TSPacket& pkt, bool&
 
         (with_pes && pkt.hasValidSync() && !pkt.getTEI() && pkt.getPayloadSize() >= 3 &&
          (GetUInt32 (pkt.b + pkt.getHeaderSize() - 1) & 0x00FFFFFF) == 0x000001);
+}
+
 
-    if (negate) {
-        ok = !ok;
+//----------------------------------------------------------------------------
+// Packet processing method
+//----------------------------------------------------------------------------
+
+ts::ProcessorPlugin::Status ts::FilterPlugin::processPacket(TSPacket& pkt, bool& flush, bool& bitrate_changed)
+{
+    // Pass initial packets without filtering.
+
+    if (after_packets > 0) {
+        after_packets--;
+        return TSP_OK;
     }
 
-    if (ok) {
+    // Check if the packet matches one of the selected criteria.
+
+    if (match(pkt) != negate) {
         return TSP_OK;
     }
     else if (stuffing) {
@@ -274,3 +287,45 @@ ts::ProcessorPlugin::Status ts::FilterPlugin::processPacket(TSPacket& pkt, bool&
         return TSP_DROP;
     }
 }
+
+
+//----------------------------------------------------------------------------
+// Data parallelism of the plugin
+//----------------------------------------------------------------------------
+
+ts::ProcessorPlugin::Parallelism ts::FilterPlugin::getParallelism()
+{
+    // Without initial packets to pass, each packet is independently filtered.
+    return after_packets == 0 ? PARALLEL_PACKET : PARALLEL_NONE;
+}
+
+
+//----------------------------------------------------------------------------
+// Packet batch processing method
+//----------------------------------------------------------------------------
+
+size_t ts::FilterPlugin::processPacketBatch(TSPacket* pkt, Status* status, size_t count, bool& flush, bool& bitrate_changed)
+{
+    const Status excluded = stuffing ? TSP_NULL : TSP_DROP;
+    size_t i = 0;
+
+    // Pass initial packets without filtering.
+    for (; i < count && after_packets > 0; ++i) {
+        after_packets--;
+        status[i] = TSP_OK;
+    }
+
+    if (pid_only) {
+        // Most common case, filter on PID values only.
+        for (; i < count; ++i) {
+            status[i] = pid[pkt[i].getPID()] != negate ? TSP_OK : excluded;
+        }
+    }
+    else {
+        for (; i < count; ++i) {
+            status[i] = match(pkt[i]) != negate ? TSP_OK : excluded;
+        }
+    }
+
+    return count;
+}
@@ -37,12 +37,18 @@
 #include "tsCyclingPacketizer.h"
 #include "tsFileNameRate.h"
 #include "tsSectionFile.h"
+#include "tsMessageQueue.h"
+#include "tsGuardCondition.h"
+#include "tsThread.h"
+#include "tsSHA1.h"
 #include "tsSysUtils.h"
 TSDUCK_SOURCE;
 
 #define DEF_EVALUATE_INTERVAL  100   // In packets
 #define DEF_POLL_FILE_MS      1000   // In milliseconds
 #define FILE_RETRY               3   // Number of retries to open files
+#define CACHE_VERSIONS           4   // Number of compiled versions of each file in cache
+#define COMPILER_STACK_SIZE (128 * 1024)  // Stack size of the compiler thread
 
 
 //----------------------------------------------------------------------------
@@ -56,9 +62,69 @@ namespace ts {
         // Implementation of plugin API
         InjectPlugin(TSP*);
         virtual bool start() override;
+        virtual bool stop() override;
         virtual Status processPacket(TSPacket&, bool&, bool&) override;
 
     private:
+        // Binary content of a section and the SHA-1 of this content.
+        typedef std::pair<ByteBlock, ByteBlock> HashedContent;
+
+        // Section contents of a file, in file order.
+        typedef std::vector<HashedContent> HashedContentVector;
+
+        // Sections of a file, indexed by SHA-1 of the section content.
+        // Several identical sections in the same file are allowed.
+        typedef std::multimap<ByteBlock, SectionPtr> SectionMap;
+
+        // A new content of an input file, sent by the compiler thread to the plugin thread.
+        // It contains binary data only, never Section objects: SectionPtr is not thread-safe
+        // and the compiler thread may release the last reference to the update.
+        class FileUpdate
+        {
+        public:
+            size_t      index;       // Index of the file in the command line.
+            UString     file_name;   // File name.
+            MilliSecond repetition;  // Repetition rate of all sections in the file.
+            HashedContentVector sections;  // New sections of the file, empty if deleted.
+            FileUpdate() : index(0), file_name(), repetition(0), sections() {}
+        };
+        typedef MessageQueue<FileUpdate, Mutex> UpdateQueue;
+
+        // Compiled versions of a file, indexed by SHA-1 of the file content.
+        typedef std::map<ByteBlock, HashedContentVector> CompiledVersions;
+
+        // Compiler thread: poll and recompile input files, out of the packet processing thread.
+        class FileCompiler : public Thread
+        {
+        public:
+            FileCompiler(InjectPlugin* plugin);
+            void stop();
+
+            // Compile all files once, in the context of the caller.
+            bool compileAll();
+
+        private:
+            InjectPlugin* const           _plugin;
+            TSP* const                    _tsp;
+            std::vector<ByteBlock>        _current;    // SHA-1 of current content of each file, empty if none.
+            std::vector<CompiledVersions> _cache;      // Cache of compiled versions of each file.
+            std::vector<std::list<ByteBlock>> _lru;    // Recently used versions in cache, most recent first.
+            Mutex                         _mutex;      // Protect _terminate and _condition.
+            Condition                     _condition;  // Signaled on termination request.
+            bool                          _terminate;  // Termination request.
+
+            // Check if a file has a new content and compile it. Return false on error.
+            bool compileFile(size_t index, FileNameRate& file);
+
+            // Implementation of Thread.
+            virtual void main() override;
+
+            // Inaccessible operations.
+            FileCompiler() = delete;
+            FileCompiler(const FileCompiler&) = delete;
+            FileCompiler& operator=(const FileCompiler&) = delete;
+        };
+
         FileNameRateList      _infiles;           // Input file names and repetition rates
         SectionFile::FileType _inType;            // Input files type
         bool                  _specific_rates;    // Some input files have specific repetition rates
@@ -67,7 +133,6 @@ namespace ts {
         bool                  _replace;           // Replace existing PID content
         bool                  _poll_files;        // Poll the presence of input files at regular intervals
         MilliSecond           _poll_files_ms;     // Interval in milliseconds between two file polling
-        Time                  _poll_file_next;    // Next UTC time of poll file
         bool                  _terminate;         // Terminate processing when insertion is complete
         bool                  _completed;         // Last cycle terminated
         size_t                _repeat_count;      // Repeat cycle, zero means infinite
@@ -80,10 +145,13 @@ namespace ts {
         PacketCounter         _cycle_count;       // Number of insertion cycles
         CyclingPacketizer     _pzer;              // Packetizer for table
         CyclingPacketizer::StuffingPolicy _stuffing_policy;
+        std::vector<SectionMap> _file_sections;   // Sections of each file in the packetizer
+        UpdateQueue           _updates;           // New file contents from the compiler thread
+        FileCompiler          _compiler;          // Compiler thread for --poll-files
 
-        // Reload files, reset packetizer.
-        // Return true on success, false on error.
-        bool reloadFiles();
+        // Apply a new content of a file in the packetizer.
+        // Unchanged sections are left untouched in the packetizer.
+        void applyUpdate(const FileUpdate& update);
 
         // Replace current packet with one from the packetizer.
         void replacePacket(TSPacket& pkt);
@@ -113,7 +181,6 @@ ts::InjectPlugin::InjectPlugin (TSP* tsp_) :
     _replace(false),
     _poll_files(false),
     _poll_files_ms(DEF_POLL_FILE_MS),
-    _poll_file_next(),
     _terminate(false),
     _completed(false),
     _repeat_count(0),
@@ -125,7 +192,10 @@ ts::InjectPlugin::InjectPlugin (TSP* tsp_) :
     _eval_interval(0),
     _cycle_count(0),
     _pzer(),
-    _stuffing_policy(CyclingPacketizer::NEVER)
+    _stuffing_policy(CyclingPacketizer::NEVER),
+    _file_sections(),
+    _updates(),
+    _compiler(this)
 {
     option(u"",                   0,  STRING, 1, UNLIMITED_COUNT);
     option(u"binary",             0);
@@ -200,10 +270,14 @@ ts::InjectPlugin::InjectPlugin (TSP* tsp_) :
             u"\n"
             u"  --poll-files\n"
             u"      Poll the presence and modification date of the input files. When a file\n"
-            u"      is created, modified or deleted, reload all files at the next section\n"
-            u"      boundary. When a file is deleted, its sections are no longer injected.\n"
-            u"      By default, all input files are loaded once at initialization time and\n"
-            u"      an error is generated if a file is missing.\n"
+            u"      is created, modified or deleted, it is reloaded in the background and its\n"
+            u"      new sections are injected from the next section boundary. Only the\n"
+            u"      sections which actually changed are replaced, the other ones keep their\n"
+            u"      position in the injection cycle. When a file is deleted, its sections\n"
+            u"      are no longer injected. The last compiled versions of each file are kept\n"
+            u"      in a cache, indexed by content, so that a file which returns to a previous\n"
+            u"      content is not recompiled. By default, all input files are loaded once at\n"
+            u"      initialization time and an error is generated if a file is missing.\n"
             u"\n"
             u"  --repeat count\n"
             u"      Repeat the insertion of a complete cycle of sections the specified number\n"
@@ -279,6 +353,11 @@ bool ts::InjectPlugin::start()
         return false;
     }
 
+    _specific_rates = false;
+    for (FileNameRateList::const_iterator it = _infiles.begin(); it != _infiles.end(); ++it) {
+        _specific_rates = _specific_rates || it->repetition != 0;
+    }
+
     if (_terminate && tsp->useJointTermination()) {
         tsp->error(u"--terminate and --joint-termination are mutually exclusive");
         return false;
@@ -289,14 +368,28 @@ bool ts::InjectPlugin::start()
         tsp->error(u"specify exactly one of --replace, --bitrate, --inter-packet");
     }
 
+    // Initialize packetizer.
+    _pzer.reset();
+    _pzer.setPID(_inject_pid);
+    _pzer.setStuffingPolicy(_stuffing_policy);
+    _pzer.setBitRate(_pid_bitrate);  // non-zero only if --bitrate is specified
+    _file_sections.clear();
+    _file_sections.resize(_infiles.size());
+    _updates.clear();
+
     // Load sections from input files.
-    if (!reloadFiles()) {
+    if (!_compiler.compileAll()) {
         return false;
     }
+    UpdateQueue::MessagePtr update;
+    while (_updates.dequeue(update, 0)) {
+        applyUpdate(*update);
+    }
 
-    // Initiate file polling.
-    if (_poll_files) {
-        _poll_file_next = Time::CurrentUTC() + _poll_files_ms;
+    // Start the compiler thread for file polling.
+    if (_poll_files && !_compiler.start()) {
+        tsp->error(u"cannot start file polling thread");
+        return false;
     }
 
     _completed = false;
@@ -309,44 +402,219 @@ bool ts::InjectPlugin::start()
 
 
 //----------------------------------------------------------------------------
-// Reload files, reset packetizer.
+// Stop method
 //----------------------------------------------------------------------------
 
-bool ts::InjectPlugin::reloadFiles()
+bool ts::InjectPlugin::stop()
 {
-    // Reinitialize packetizer
-    _pzer.reset();
-    _pzer.setPID(_inject_pid);
-    _pzer.setStuffingPolicy(_stuffing_policy);
-    _pzer.setBitRate(_pid_bitrate);  // non-zero only if --bitrate is specified
+    _compiler.stop();
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// File compiler thread.
+//----------------------------------------------------------------------------
+
+ts::InjectPlugin::FileCompiler::FileCompiler(InjectPlugin* plugin) :
+    Thread(ThreadAttributes().setStackSize(COMPILER_STACK_SIZE)),
+    _plugin(plugin),
+    _tsp(plugin->tsp),
+    _current(),
+    _cache(),
+    _lru(),
+    _mutex(),
+    _condition(),
+    _terminate(false)
+{
+}
+
+// Terminate the thread.
+void ts::InjectPlugin::FileCompiler::stop()
+{
+    // Wake up the thread if it is waiting for the next polling time.
+    {
+        GuardCondition lock(_mutex, _condition);
+        _terminate = true;
+        lock.signal();
+    }
+
+    // Wait for actual thread termination, void if not started.
+    Thread::waitForTermination();
+}
+
+// Compile all files, in the context of the caller.
+bool ts::InjectPlugin::FileCompiler::compileAll()
+{
+    const size_t count = _plugin->_infiles.size();
+    _terminate = false;
+    _current.assign(count, ByteBlock());
+    _cache.assign(count, CompiledVersions());
+    _lru.assign(count, std::list<ByteBlock>());
 
-    // Load sections from input files
     bool success = true;
-    _specific_rates = false;
-    SectionFile file;
+    size_t index = 0;
+    for (FileNameRateList::iterator it = _plugin->_infiles.begin(); it != _plugin->_infiles.end(); ++it, ++index) {
+        success = compileFile(index, *it) && success;
+        // Record the modification date for next polling.
+        it->file_date = GetFileModificationTimeLocal(it->file_name);
+    }
+    return success;
+}
+
+// Invoked in the context of the compiler thread.
+void ts::InjectPlugin::FileCompiler::main()
+{
+    _tsp->debug(u"file compiler thread started");
+
+    for (;;) {
+        // Wait for the next polling time or a termination request.
+        {
+            GuardCondition lock(_mutex, _condition);
+            if (!_terminate) {
+                lock.waitCondition(_plugin->_poll_files_ms);
+            }
+            if (_terminate) {
+                break;
+            }
+        }
 
-    for (FileNameRateList::iterator it = _infiles.begin(); it != _infiles.end(); ++it) {
-        if (_poll_files && !FileExists(it->file_name)) {
-            // With --poll-files, we ignore non-existent files.
-            it->retry_count = 0;  // no longer needed to retry
+        // Reload and recompile modified files.
+        size_t index = 0;
+        for (FileNameRateList::iterator it = _plugin->_infiles.begin(); it != _plugin->_infiles.end(); ++it, ++index) {
+            if (it->scanFile(FILE_RETRY, *_tsp)) {
+                compileFile(index, *it);
+            }
         }
-        else if (!file.load(it->file_name, *tsp, _inType, _crc_op)) {
-            success = false;
-            if (it->retry_count > 0) {
-                it->retry_count--;
+    }
+
+    _tsp->debug(u"file compiler thread completed");
+}
+
+// Check if a file has a new content and compile it.
+bool ts::InjectPlugin::FileCompiler::compileFile(size_t index, FileNameRate& file)
+{
+    UpdateQueue::MessagePtr update(new FileUpdate);
+    CheckNonNull(update.pointer());
+    update->index = index;
+    update->file_name = file.file_name;
+    update->repetition = file.repetition;
+
+    ByteBlock digest;
+    if (_plugin->_poll_files && !FileExists(file.file_name)) {
+        // With --poll-files, we ignore non-existent files.
+        file.retry_count = 0;  // no longer needed to retry
+    }
+    else {
+        // Load the file content and compute its hash.
+        ByteBlock data;
+        if (!data.loadFromFile(file.file_name, std::numeric_limits<size_t>::max(), _tsp)) {
+            if (file.retry_count > 0) {
+                file.retry_count--;
             }
+            return false;
+        }
+        digest.resize(SHA1::HASH_SIZE);
+        SHA1 sha;
+        sha.hash(data.data(), data.size(), digest.data(), digest.size());
+
+        // A file which is touched with the same content does not need any update.
+        if (digest == _current[index]) {
+            file.retry_count = 0;
+            _tsp->debug(u"file %s unchanged", {file.file_name});
+            return true;
+        }
+
+        // Look for an already compiled version with the same content.
+        CompiledVersions& cache(_cache[index]);
+        std::list<ByteBlock>& lru(_lru[index]);
+        const CompiledVersions::const_iterator cached = cache.find(digest);
+        if (cached != cache.end()) {
+            update->sections = cached->second;
+            lru.remove(digest);
+            _tsp->verbose(u"reusing %d compiled sections from %s", {update->sections.size(), file.file_name});
         }
         else {
-            // File successfully loaded.
-            it->retry_count = 0;  // no longer needed to retry
-            _pzer.addSections(file.sections(), it->repetition);
-            _specific_rates = _specific_rates || it->repetition != 0;
-            tsp->verbose(u"loaded %d sections from %s, repetition rate: %s",
-                         {file.sections().size(), it->file_name, it->repetition > 0 ? UString::Decimal(it->repetition) + u" ms" : u"unspecified"});
+            // Compile the file content.
+            SectionFile secfile;
+            std::istringstream strm(std::string(reinterpret_cast<const char*>(data.data()), data.size()), std::ios::in | std::ios::binary);
+            if (!secfile.load(strm, *_tsp, SectionFile::GetFileType(file.file_name, _plugin->_inType), _plugin->_crc_op)) {
+                _tsp->error(u"error loading %s", {file.file_name});
+                if (file.retry_count > 0) {
+                    file.retry_count--;
+                }
+                return false;
+            }
+
+            // Index all sections by content. Only the binary content is kept, the sections
+            // of the SectionFile are released in this thread when secfile is destroyed.
+            const SectionPtrVector& sections(secfile.sections());
+            for (SectionPtrVector::const_iterator it = sections.begin(); it != sections.end(); ++it) {
+                const SectionPtr& sect(*it);
+                if (!sect.isNull() && sect->isValid()) {
+                    ByteBlock secdigest(SHA1::HASH_SIZE);
+                    sha.hash(sect->content(), sect->size(), secdigest.data(), secdigest.size());
+                    update->sections.push_back(HashedContent(secdigest, ByteBlock(sect->content(), sect->size())));
+                }
+            }
+
+            // Insert the new version in the cache, drop the oldest ones.
+            cache[digest] = update->sections;
+            while (lru.size() >= CACHE_VERSIONS) {
+                cache.erase(lru.back());
+                lru.pop_back();
+            }
+            _tsp->verbose(u"loaded %d sections from %s, repetition rate: %s",
+                          {update->sections.size(), file.file_name, file.repetition > 0 ? UString::Decimal(file.repetition) + u" ms" : u"unspecified"});
         }
+        lru.push_front(digest);
     }
 
-    return success;
+    // File successfully processed, send the new content to the plugin thread.
+    file.retry_count = 0;  // no longer needed to retry
+    if (!digest.empty() || !_current[index].empty()) {
+        _current[index] = digest;
+        _plugin->_updates.forceEnqueue(update);
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Apply a new content of a file in the packetizer.
+//----------------------------------------------------------------------------
+
+void ts::InjectPlugin::applyUpdate(const FileUpdate& update)
+{
+    assert(update.index < _file_sections.size());
+    SectionMap& current(_file_sections[update.index]);
+    SectionMap next;
+    size_t added = 0;
+
+    // Keep sections which are still present, add new ones.
+    for (HashedContentVector::const_iterator it = update.sections.begin(); it != update.sections.end(); ++it) {
+        const SectionMap::iterator old = current.find(it->first);
+        if (old != current.end()) {
+            next.insert(*old);
+            current.erase(old);
+        }
+        else {
+            // New sections are built here, they are referenced by the plugin thread only.
+            const SectionPtr sect(new Section(it->second, PID_NULL, CRC32::IGNORE));
+            _pzer.addSection(sect, update.repetition);
+            next.insert(SectionMap::value_type(it->first, sect));
+            added++;
+        }
+    }
+
+    // Remove sections which are no longer present.
+    const size_t removed = current.size();
+    for (SectionMap::const_iterator it = current.begin(); it != current.end(); ++it) {
+        _pzer.removeSection(it->second);
+    }
+    current.swap(next);
+
+    tsp->verbose(u"%s: %d sections, %d added, %d removed", {update.file_name, current.size(), added, removed});
 }
 
 
@@ -425,15 +693,13 @@ ts::ProcessorPlugin::Status ts::InjectPlugin::processPacket(TSPacket& pkt, bool&
         _packet_count = 0;
     }
 
-    // Poll files when necessary.
+    // Apply new file contents from the compiler thread, never wait for them.
     // Do that only at section boundary in the output PID to avoid truncated sections.
-    if (_poll_files && _pzer.atSectionBoundary() && Time::CurrentUTC() >= _poll_file_next) {
-        if (_infiles.scanFiles(FILE_RETRY, *tsp) > 0) {
-            // Some files have changed. Reset packetizer and reload files.
-            reloadFiles();
+    if (_poll_files && _pzer.atSectionBoundary()) {
+        UpdateQueue::MessagePtr update;
+        while (_updates.dequeue(update, 0)) {
+            applyUpdate(*update);
         }
-        // Plan next file polling.
-        _poll_file_next = Time::CurrentUTC() + _poll_files_ms;
     }
 
     // Now really process the current packet.
@@ -39,6 +39,8 @@
 #include "tsUDPReceiver.h"
 #include "tsSysUtils.h"
 #include "tsTime.h"
+#include "tsMonotonic.h"
+#include "tsByteBlock.h"
 TSDUCK_SOURCE;
 
 // Grouping TS packets in UDP packets
@@ -46,6 +48,13 @@ TSDUCK_SOURCE;
 #define DEF_PACKET_BURST     7  // 1316 B, fits (with headers) in Ethernet MTU
 #define MAX_PACKET_BURST   128  // ~ 48 kB
 #define MAX_IP_SIZE      65536
+#define MAX_BATCH         ts::UDPSocket::MAX_BATCH_MESSAGES
+#define DEF_TXTIME_DELAY  2000  // microseconds
+
+namespace {
+    // Maximum advance of transmission times after the transmission delay before waiting (nanoseconds).
+    const ts::NanoSecond MAX_TXTIME_ADVANCE = 100000000;
+}
 
 
 //----------------------------------------------------------------------------
@@ -78,9 +87,15 @@ namespace ts {
         PacketCounter _packets_0;          // Number of received packets since _start_0
         Time          _start_1;            // Start of previous bitrate evaluation period
         PacketCounter _packets_1;          // Number of received packets since _start_1
-        size_t        _inbuf_count;        // Remaining TS packets in inbuf
-        size_t        _inbuf_next;         // Index in inbuf of next TS packet to return
-        uint8_t       _inbuf[MAX_IP_SIZE]; // Input buffer
+        size_t        _batch;              // Maximum number of UDP messages per receive operation
+        size_t        _msg_count;          // Number of messages with TS packets in _msgs
+        size_t        _msg_next;           // Index in _msgs of next message to return
+        std::vector<UDPSocket::Message> _msgs; // Received messages, point to remaining TS packets
+        ByteBlock     _inbuf;              // Input buffer, MAX_IP_SIZE bytes per message
+
+        // Locate the TS packets inside a UDP message, update the message to point to them.
+        // Return the number of TS packets in the message.
+        size_t locatePackets(UDPSocket::Message& msg);
 
         // Inaccessible operations
         IPInput() = delete;
@@ -101,8 +116,16 @@ namespace ts {
         virtual bool send(const TSPacket*, size_t) override;
 
     private:
-        UDPSocket _sock;        // Outgoing socket
-        size_t    _pkt_burst;   // Number of TS packets per UDP message
+        UDPSocket  _sock;        // Outgoing socket
+        size_t     _pkt_burst;   // Number of TS packets per UDP message
+        size_t     _batch;       // Maximum number of UDP messages per send operation
+        std::vector<UDPSocket::Message> _msgs; // Batch of messages to send
+        bool       _use_txtime;  // Use kernel-side pacing
+        NanoSecond _txtime_delay;// Transmission delay of kernel-side pacing
+        NanoSecond _next_txtime; // Transmission time of next message
+
+        // Send packets with kernel-side pacing at the specified bitrate.
+        bool sendPaced(const TSPacket*, size_t, BitRate);
 
         // Inaccessible operations
         IPOutput() = delete;
@@ -132,16 +155,26 @@ ts::IPInput::IPInput(TSP* tsp_) :
     _packets_0(0),
     _start_1(Time::Epoch),
     _packets_1(0),
-    _inbuf_count(0),
-    _inbuf_next(0),
+    _batch(1),
+    _msg_count(0),
+    _msg_next(0),
+    _msgs(),
     _inbuf()
 {
+    option(u"batch",                0,  INTEGER, 0, 1, 1, MAX_BATCH);
     option(u"display-interval",    'd', POSITIVE);
     option(u"evaluation-interval", 'e', POSITIVE);
 
     setHelp(u"\n"
             u"Other options:\n"
             u"\n"
+            u"  --batch value\n"
+            u"      Specify the maximum number of UDP messages to receive in one system call.\n"
+            u"      On Linux, all messages which are already queued on the socket are\n"
+            u"      received at once using recvmmsg(), up to this number. This reduces the\n"
+            u"      system call overhead with high bitrates. The default is 1, the maximum\n"
+            u"      is 64.\n"
+            u"\n"
             u"  -d value\n"
             u"  --display-interval value\n"
             u"      Specify the interval in seconds between two displays of the evaluated\n"
@@ -174,12 +207,19 @@ ts::IPInput::IPInput(TSP* tsp_) :
 ts::IPOutput::IPOutput(TSP* tsp_) :
     OutputPlugin(tsp_, u"Send TS packets using UDP/IP, multicast or unicast", u"[options] address:port"),
     _sock(false, *tsp_),
-    _pkt_burst(DEF_PACKET_BURST)
+    _pkt_burst(DEF_PACKET_BURST),
+    _batch(1),
+    _msgs(),
+    _use_txtime(false),
+    _txtime_delay(0),
+    _next_txtime(0)
 {
     option(u"",               0,  STRING, 1, 1);
+    option(u"batch",          0,  INTEGER, 0, 1, 1, MAX_BATCH);
     option(u"local-address", 'l', STRING);
     option(u"packet-burst",  'p', INTEGER, 0, 1, 1, MAX_PACKET_BURST);
     option(u"ttl",           't', INTEGER, 0, 1, 1, 255);
+    option(u"txtime",         0,  UNSIGNED, 0, 1, 0, 0, true);
 
     setHelp(u"Parameter:\n"
             u"  The parameter address:port describes the destination for UDP packets.\n"
@@ -189,6 +229,12 @@ ts::IPOutput::IPOutput(TSP* tsp_) :
             u"\n"
             u"Options:\n"
             u"\n"
+            u"  --batch value\n"
+            u"      Specify the maximum number of UDP messages to send in one system call.\n"
+            u"      On Linux, the UDP messages are sent using sendmmsg(). This reduces the\n"
+            u"      system call overhead with high bitrates. The default is 1, the maximum\n"
+            u"      is 64.\n"
+            u"\n"
             u"  --help\n"
             u"      Display this help text.\n"
             u"\n"
@@ -211,6 +257,17 @@ ts::IPOutput::IPOutput(TSP* tsp_) :
             u"      destination address. Remember that the default Multicast TTL is 1\n"
             u"      on most systems.\n"
             u"\n"
+            u"  --txtime[=value]\n"
+            u"      Let the kernel pace the UDP messages according to the TS bitrate.\n"
+            u"      Each message is sent with a transmission time (Linux SO_TXTIME socket\n"
+            u"      option). The optional value is the transmission delay in microseconds,\n"
+            u"      the time that the messages spend in the kernel before transmission.\n"
+            u"      The default is " TS_STRINGIFY(DEF_TXTIME_DELAY) u" microseconds. The outgoing network interface\n"
+            u"      must use the fq queueing discipline, which uses the monotonic clock for\n"
+            u"      transmission times. The etf queueing discipline is not supported since\n"
+            u"      it requires the TAI clock. The TS bitrate must be known. When the input\n"
+            u"      is not real-time, use the plugin regulate before the output.\n"
+            u"\n"
             u"  --version\n"
             u"      Display the version number.\n");
 }
@@ -225,6 +282,7 @@ bool ts::IPInput::start()
     // Get command line arguments
     _eval_time = MilliSecPerSec * intValue<MilliSecond>(u"evaluation-interval", 0);
     _display_time = MilliSecPerSec * intValue<MilliSecond>(u"display-interval", 0);
+    _batch = intValue<size_t>(u"batch", 1);
     if (!_sock.load(*this)) {
         return false;
     }
@@ -236,7 +294,9 @@ bool ts::IPInput::start()
 
     // Socket now ready.
     // Initialize working data.
-    _inbuf_count = _inbuf_next = 0;
+    _msg_count = _msg_next = 0;
+    _msgs.resize(_batch);
+    _inbuf.resize(_batch * MAX_IP_SIZE);
     _start = _start_0 = _start_1 = _next_display = Time::Epoch;
     _packets = _packets_0 = _packets_1 = 0;
 
@@ -290,78 +350,49 @@ ts::BitRate ts::IPInput::getBitrate()
 
 size_t ts::IPInput::receive(TSPacket* buffer, size_t max_packets)
 {
-    // Check if we receive new packets or process remain of previous buffer.
-    bool new_packets = false;
-
-    // If there is no remaining packet in the input buffer, wait for a UDP
-    // message. Loop until we get some TS packets.
-    while (_inbuf_count <= 0) {
-
-        // Wait for a UDP message
-        SocketAddress sender;
-        SocketAddress destination;
-        size_t insize;
-        if (!_sock.receive(_inbuf, sizeof(_inbuf), insize, sender, destination, tsp, *tsp)) {
-            return 0;
+    // If there is no remaining packet in the received messages, wait for UDP
+    // messages. Loop until we get some TS packets.
+    size_t new_packets = 0;
+    while (_msg_next >= _msg_count) {
+
+        // Reset the message buffers, they are modified when the TS packets are returned.
+        for (size_t i = 0; i < _msgs.size(); ++i) {
+            _msgs[i].data = &_inbuf[i * MAX_IP_SIZE];
+            _msgs[i].max_size = MAX_IP_SIZE;
         }
 
-        // Locate the TS packets inside the UDP message. Basically, we
-        // expect the message to contain only TS packets. However, we
-        // will face the following situations:
-        // - Presence of a header preceeding the first TS packet (typically
-        //   when the TS packets are encapsulated in RTP).
-        // - Presence of a truncated packet at the end of message.
-
-        // To face the first situation, we look backward from the end of
-        // the message, looking for a 0x47 sync byte every 188 bytes, going
-        // backward.
-
-        const uint8_t* p;
-        for (p = _inbuf + insize; p >= _inbuf + PKT_SIZE && p[-int(PKT_SIZE)] == SYNC_BYTE; p -= PKT_SIZE) {}
-
-        if (p < _inbuf + insize) {
-            // Some packets were found
-            _inbuf_next = p - _inbuf;
-            _inbuf_count = (_inbuf + insize - p) / PKT_SIZE;
-            new_packets = true;
-            break; // exit receive loop
+        // Wait for one or more UDP messages.
+        _msg_next = 0;
+        if (_batch > 1) {
+            if (!_sock.receiveBatch(&_msgs[0], _msgs.size(), _msg_count, tsp, *tsp)) {
+                return 0;
+            }
         }
-
-        // If no TS packet is found using the first method, we restart from
-        // the beginning of the message, looking for a 0x47 sync byte every
-        // 188 bytes, going forward. If we find this pattern, followed by
-        // less than 188 bytes, then we have found a sequence of TS packets.
-
-        const uint8_t* max = _inbuf + insize - PKT_SIZE; // max address for a TS packet
-        _inbuf_count = 0;
-
-        for (p = _inbuf; p <= max; p++) {
-            if (*p == SYNC_BYTE) {
-                // Verify that we get a 0x47 sync byte every 188 bytes up
-                // to the end of message (not leaving more than one truncated
-                // TS packet at the end of the message).
-                const uint8_t* end;
-                for (end = p; end <= max && *end == SYNC_BYTE; end += PKT_SIZE) {}
-                if (end > max) {
-                    // Less than 188 bytes after last packet. Consider we are OK
-                    _inbuf_next = p - _inbuf;
-                    _inbuf_count = (end - p) / PKT_SIZE;
-                    new_packets = true;
-                    break; // exit packet search loop
-                }
+        else {
+            UDPSocket::Message& msg(_msgs[0]);
+            if (!_sock.receive(msg.data, msg.max_size, msg.size, msg.sender, msg.destination, tsp, *tsp)) {
+                return 0;
             }
+            _msg_count = 1;
         }
 
-        if (new_packets) {
-            break; // exit receive loop
+        // Keep only the messages which contain TS packets.
+        size_t count = 0;
+        for (size_t i = 0; i < _msg_count; ++i) {
+            const size_t pkt_count = locatePackets(_msgs[i]);
+            if (pkt_count > 0) {
+                if (count != i) {
+                    std::swap(_msgs[count], _msgs[i]);
+                }
+                ++count;
+                new_packets += pkt_count;
+            }
         }
-
-        // No TS packet found in UDP message, wait for another one.
-        tsp->debug(u"no TS packet in message from %s, %s bytes", {sender.toString(), insize});
+        _msg_count = count;
     }
 
     // If new packets were received, we may need to re-evaluate the real-time input bitrate.
-    if (new_packets && _eval_time > 0) {
+    if (new_packets > 0 && _eval_time > 0) {
 
         const Time now(Time::CurrentUTC());
 
@@ -374,9 +405,9 @@ size_t ts::IPInput::receive(TSPacket* buffer, size_t max_packets)
         }
 
         // Count packets
-        _packets += _inbuf_count;
-        _packets_0 += _inbuf_count;
-        _packets_1 += _inbuf_count;
+        _packets += new_packets;
+        _packets_0 += new_packets;
+        _packets_1 += new_packets;
 
         // Detect new evaluation period
         if (now >= _start_1 + _eval_time) {
@@ -400,16 +431,83 @@ size_t ts::IPInput::receive(TSPacket* buffer, size_t max_packets)
         }
     }
 
-    // Return packets from the input buffer
-    size_t pkt_cnt = std::min(_inbuf_count, max_packets);
-    TSPacket::Copy(buffer, _inbuf + _inbuf_next, pkt_cnt);
-    _inbuf_count -= pkt_cnt;
-    _inbuf_next += pkt_cnt * PKT_SIZE;
+    // Return packets from the received messages, as many as possible.
+    size_t pkt_cnt = 0;
+    while (pkt_cnt < max_packets && _msg_next < _msg_count) {
+        UDPSocket::Message& msg(_msgs[_msg_next]);
+        const size_t count = std::min(msg.size / PKT_SIZE, max_packets - pkt_cnt);
+        TSPacket::Copy(buffer + pkt_cnt, reinterpret_cast<const uint8_t*>(msg.data), count);
+        msg.data = reinterpret_cast<uint8_t*>(msg.data) + count * PKT_SIZE;
+        msg.size -= count * PKT_SIZE;
+        pkt_cnt += count;
+        if (msg.size == 0) {
+            _msg_next++;
+        }
+    }
 
     return pkt_cnt;
 }
 
 
+//----------------------------------------------------------------------------
+// Locate the TS packets inside a UDP message.
+//----------------------------------------------------------------------------
+
+size_t ts::IPInput::locatePackets(UDPSocket::Message& msg)
+{
+    // Basically, we expect the message to contain only TS packets. However,
+    // we will face the following situations:
+    // - Presence of a header preceeding the first TS packet (typically
+    //   when the TS packets are encapsulated in RTP).
+    // - Presence of a truncated packet at the end of message.
+
+    // To face the first situation, we look backward from the end of
+    // the message, looking for a 0x47 sync byte every 188 bytes, going
+    // backward.
+
+    uint8_t* const data = reinterpret_cast<uint8_t*>(msg.data);
+    const size_t insize = msg.size;
+    uint8_t* p;
+    for (p = data + insize; p >= data + PKT_SIZE && p[-int(PKT_SIZE)] == SYNC_BYTE; p -= PKT_SIZE) {}
+
+    if (p < data + insize) {
+        // Some packets were found
+        msg.data = p;
+        msg.size = data + insize - p;
+        return msg.size / PKT_SIZE;
+    }
+
+    // If no TS packet is found using the first method, we restart from
+    // the beginning of the message, looking for a 0x47 sync byte every
+    // 188 bytes, going forward. If we find this pattern, followed by
+    // less than 188 bytes, then we have found a sequence of TS packets.
+
+    if (insize >= PKT_SIZE) {
+        const uint8_t* max = data + insize - PKT_SIZE; // max address for a TS packet
+        for (p = data; p <= max; p++) {
+            if (*p == SYNC_BYTE) {
+                // Verify that we get a 0x47 sync byte every 188 bytes up
+                // to the end of message (not leaving more than one truncated
+                // TS packet at the end of the message).
+                const uint8_t* end;
+                for (end = p; end <= max && *end == SYNC_BYTE; end += PKT_SIZE) {}
+                if (end > max) {
+                    // Less than 188 bytes after last packet. Consider we are OK
+                    msg.data = p;
+                    msg.size = ((end - p) / PKT_SIZE) * PKT_SIZE;
+                    return msg.size / PKT_SIZE;
+                }
+            }
+        }
+    }
+
+    // No TS packet found in UDP message.
+    TS_DEBUG(*tsp, u"no TS packet in message from %s, %s bytes", {msg.sender.toString(), insize});
+    msg.size = 0;
+    return 0;
+}
+
+
 //----------------------------------------------------------------------------
 // Output start method
 //----------------------------------------------------------------------------
@@ -421,6 +519,11 @@ bool ts::IPOutput::start()
     UString loc_name(value(u"local-address"));
     int ttl = intValue(u"ttl", 0);
     _pkt_burst = intValue(u"packet-burst", DEF_PACKET_BURST);
+    _batch = intValue<size_t>(u"batch", 1);
+    _msgs.resize(_batch);
+    _use_txtime = present(u"txtime");
+    _txtime_delay = intValue<NanoSecond>(u"txtime", DEF_TXTIME_DELAY) * NanoSecPerMicroSec;
+    _next_txtime = 0;
 
     // Create UDP socket
     bool ok = _sock.open(*tsp);
@@ -428,7 +531,8 @@ bool ts::IPOutput::start()
     if (ok) {
         ok = _sock.setDefaultDestination(dest_name, *tsp) &&
             (loc_name.empty() || _sock.setOutgoingMulticast(loc_name, *tsp)) &&
-            (ttl <= 0 || _sock.setTTL(ttl, _sock.setTTL(ttl, *tsp)));
+            (ttl <= 0 || _sock.setTTL(ttl, _sock.setTTL(ttl, *tsp))) &&
+            (!_use_txtime || _sock.setTransmitTime(true, *tsp));
         if (!ok) {
             _sock.close();
         }
@@ -467,6 +571,30 @@ bool ts::IPOutput::send(const TSPacket* pkt, size_t packet_count)
 {
     // Send TS packets in UDP messages, grouped according to burst size.
 
+    // With kernel-side pacing, all messages are sent with a transmission time, when the bitrate is known.
+    const BitRate bitrate = _use_txtime ? tsp->bitrate() : 0;
+    if (bitrate > 0) {
+        return sendPaced(pkt, packet_count, bitrate);
+    }
+
+    // With batch mode, send up to _batch UDP messages in one operation.
+    while (_batch > 1 && packet_count > _pkt_burst) {
+        size_t msg_count = 0;
+        while (msg_count < _batch && packet_count > 0) {
+            const size_t count = std::min(packet_count, _pkt_burst);
+            _msgs[msg_count].data = const_cast<TSPacket*>(pkt);
+            _msgs[msg_count].size = count * PKT_SIZE;
+            _msgs[msg_count].txtime = -1;  // no pacing, overwrite times from previous paced messages
+            ++msg_count;
+            pkt += count;
+            packet_count -= count;
+        }
+        if (!_sock.sendBatch(&_msgs[0], msg_count, *tsp)) {
+            return false;
+        }
+    }
+
+    // Send remaining packets, one message per operation.
     while (packet_count > 0) {
         size_t count = std::min(packet_count, _pkt_burst);
         if (!_sock.send(pkt, count * PKT_SIZE, *tsp)) {
@@ -478,3 +606,43 @@ bool ts::IPOutput::send(const TSPacket* pkt, size_t packet_count)
 
     return true;
 }
+
+
+//----------------------------------------------------------------------------
+// Send packets with kernel-side pacing.
+//----------------------------------------------------------------------------
+
+bool ts::IPOutput::sendPaced(const TSPacket* pkt, size_t packet_count, BitRate bitrate)
+{
+    const NanoSecond now = UDPSocket::TransmitClock();
+
+    if (_next_txtime < now) {
+        // First messages or late (the input is starved), restart the schedule.
+        _next_txtime = now + _txtime_delay;
+    }
+    else if (_next_txtime > now + _txtime_delay + MAX_TXTIME_ADVANCE) {
+        // Too much in advance (the input is faster than the bitrate), wait to avoid overflowing the kernel queue.
+        Monotonic due;
+        due.getSystemTime();
+        due += _next_txtime - now - _txtime_delay;
+        due.wait();
+    }
+
+    while (packet_count > 0) {
+        size_t msg_count = 0;
+        while (msg_count < _msgs.size() && packet_count > 0) {
+            const size_t count = std::min(packet_count, _pkt_burst);
+            _msgs[msg_count].data = const_cast<TSPacket*>(pkt);
+            _msgs[msg_count].size = count * PKT_SIZE;
+            _msgs[msg_count].txtime = _next_txtime;
+            _next_txtime += NanoSecond(count * PKT_SIZE * 8) * NanoSecPerSec / NanoSecond(bitrate);
+            ++msg_count;
+            pkt += count;
+            packet_count -= count;
+        }
+        if (!_sock.sendBatch(&_msgs[0], msg_count, *tsp)) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -64,6 +64,7 @@ namespace ts {
         virtual bool start() override;
         virtual bool stop() override;
         virtual Status processPacket(TSPacket&, bool&, bool&) override;
+        virtual size_t processPacketBatch(TSPacket*, Status*, size_t, bool&, bool&) override;
 
     private:
         // Definitions:
@@ -94,6 +95,9 @@ namespace ts {
         PacketCounter     _pkt_count;         // Packet counter in the main stream.
         ForkPipe          _pipe;              // Executed command.
         TSPacketQueue     _queue;             // TS packet queur from merge to main.
+        const TSPacket*   _merge_span;        // Packets from the merged stream, directly in the queue buffer.
+        size_t            _merge_span_size;   // Number of packets in _merge_span.
+        size_t            _merge_span_next;   // Index of next packet to use in _merge_span.
         PIDSet            _main_pids;         // Set of detected PID's in main stream.
         PIDSet            _merge_pids;        // Set of detected PID's in merged stream that we pass in main stream.
         PIDContextMap     _pcr_pids;          // Description of PID's with PCR's from the merged stream.
@@ -119,9 +123,18 @@ namespace ts {
         // Invoked when a complete table is available from any demux.
         virtual void handleTable(SectionDemux& demux, const BinaryTable& table) override;
 
+        // Process one packet from the main stream.
+        Status processMainPacket(TSPacket&);
+
         // Process one packet coming from the merged stream.
         Status processMergePacket(TSPacket&);
 
+        // Get the next packet from the merged stream. Return false if none is available.
+        bool nextMergePacket(TSPacket&);
+
+        // Release the packets from the merged stream which were used in the main stream.
+        void releaseMergePackets();
+
         // Generate new/merged tables.
         void mergePAT();
         void mergeCAT();
@@ -165,6 +178,9 @@ ts::MergePlugin::MergePlugin(TSP* tsp_) :
     _pkt_count(0),
     _pipe(),
     _queue(),
+    _merge_span(0),
+    _merge_span_size(0),
+    _merge_span_next(0),
     _main_pids(),
     _merge_pids(),
     _pcr_pids(),
@@ -269,6 +285,9 @@ bool ts::MergePlugin::start()
 
     // Resize the inter-thread packet queue.
     _queue.reset(max_queue);
+    _merge_span = 0;
+    _merge_span_size = 0;
+    _merge_span_next = 0;
 
     // Configure the demux. We need to analyze and modify the PAT, CAT and SDT
     // from the two transport streams.
@@ -422,10 +441,37 @@ void ts::MergePlugin::main()
 
 
 //----------------------------------------------------------------------------
-// Packet processing method
+// Packet processing methods
 //----------------------------------------------------------------------------
 
 ts::ProcessorPlugin::Status ts::MergePlugin::processPacket(TSPacket& pkt, bool& flush, bool& bitrate_changed)
+{
+    const Status status = processMainPacket(pkt);
+    releaseMergePackets();
+    return status;
+}
+
+size_t ts::MergePlugin::processPacketBatch(TSPacket* pkt, Status* status, size_t count, bool& flush, bool& bitrate_changed)
+{
+    // Packets from the merged stream are directly copied from the queue buffer.
+    // They are released to the receiver thread once per batch.
+    for (size_t i = 0; i < count; ++i) {
+        status[i] = processMainPacket(pkt[i]);
+        if (status[i] == TSP_END) {
+            count = i + 1;
+            break;
+        }
+    }
+    releaseMergePackets();
+    return count;
+}
+
+
+//----------------------------------------------------------------------------
+// Process one packet from the main stream.
+//----------------------------------------------------------------------------
+
+ts::ProcessorPlugin::Status ts::MergePlugin::processMainPacket(TSPacket& pkt)
 {
     const PID pid = pkt.getPID();
 
@@ -494,16 +540,43 @@ ts::ProcessorPlugin::Status ts::MergePlugin::processPacket(TSPacket& pkt, bool&
 }
 
 
+//----------------------------------------------------------------------------
+// Get packets from the merged stream, without intermediate copy.
+//----------------------------------------------------------------------------
+
+bool ts::MergePlugin::nextMergePacket(TSPacket& pkt)
+{
+    // Get a new span of packets from the queue when the current one is exhausted.
+    if (_merge_span_next >= _merge_span_size) {
+        releaseMergePackets();
+        BitRate merge_bitrate = 0;
+        if (!_queue.lockReadBuffer(_merge_span, _merge_span_size, merge_bitrate)) {
+            return false;
+        }
+    }
+    pkt = _merge_span[_merge_span_next++];
+    return true;
+}
+
+void ts::MergePlugin::releaseMergePackets()
+{
+    if (_merge_span_next > 0) {
+        _queue.releaseReadBuffer(_merge_span_next);
+    }
+    _merge_span = 0;
+    _merge_span_size = 0;
+    _merge_span_next = 0;
+}
+
+
 //----------------------------------------------------------------------------
 // Process one packet coming from the merged stream.
 //----------------------------------------------------------------------------
 
 ts::ProcessorPlugin::Status ts::MergePlugin::processMergePacket(TSPacket& pkt)
 {
-    BitRate merge_bitrate = 0;
-
     // Replace current null packet in main stream with next packet from merged stream.
-    if (!_queue.getPacket(pkt, merge_bitrate)) {
+    if (!nextMergePacket(pkt)) {
         // No packet available, keep original null packet.
         if (!_got_eof && _queue.eof()) {
             // Report end of input stream once.
@@ -580,7 +653,7 @@ ts::ProcessorPlugin::Status ts::MergePlugin::processMergePacket(TSPacket& pkt)
             // In debug mode, report the displacement of the PCR.
             // This may go back and forth around zero but should never diverge.
             const SubSecond moved = ctx->second.last_pcr - pcr;
-            tsp->debug(u"adjusted PCR by %'d (%'d ms) in PID 0x%X (%d)", {moved, (moved * MilliSecPerSec) / SYSTEM_CLOCK_FREQ, pid, pid});
+            TS_DEBUG(*tsp, u"adjusted PCR by %'d (%'d ms) in PID 0x%X (%d)", {moved, (moved * MilliSecPerSec) / SYSTEM_CLOCK_FREQ, pid, pid});
         }
     }
 
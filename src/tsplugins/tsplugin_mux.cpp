@@ -323,7 +323,7 @@ ts::ProcessorPlugin::Status ts::MuxPlugin::processPacket(TSPacket& pkt, bool& fl
         if (_min_pts != 0) {
             if (_pts_pid == 0 || pid == _pts_pid) {
                 if (currentpts > _min_pts  && (currentpts < _max_pts || _max_pts == 0)) {
-                    tsp->debug(u"Found minmaxpts range OK at PTS: %'d, enabling packet insertion", { currentpts });
+                    TS_DEBUG(*tsp, u"Found minmaxpts range OK at PTS: %'d, enabling packet insertion", { currentpts });
                     _pts_range_ok = true;
                 }
             }
@@ -333,7 +333,7 @@ ts::ProcessorPlugin::Status ts::MuxPlugin::processPacket(TSPacket& pkt, bool& fl
         if (_inter_time != 0 && _pts_last_inserted != 0) {
             uint64_t calculated = _pts_last_inserted + _inter_time;
             if (_youngest_pts > calculated) {
-                tsp->debug(u"Detected waiting time %d has passed, pts_last_insert: %d, youngest pts: %d, enabling packet insertion", { _inter_time, _pts_last_inserted, _youngest_pts});
+                TS_DEBUG(*tsp, u"Detected waiting time %d has passed, pts_last_insert: %d, youngest pts: %d, enabling packet insertion", { _inter_time, _pts_last_inserted, _youngest_pts});
                 _pts_range_ok = true;
             }
             else {
@@ -343,7 +343,7 @@ ts::ProcessorPlugin::Status ts::MuxPlugin::processPacket(TSPacket& pkt, bool& fl
 
         // check if max-pts is reached
         if (_max_pts != 0 && _max_pts < currentpts && (pid == _pts_pid || _pts_pid == 0)) {
-            tsp->debug(u"max-pts %d reached, disabling packet insertion at PTS: %'d", { _max_pts,currentpts });
+            TS_DEBUG(*tsp, u"max-pts %d reached, disabling packet insertion at PTS: %'d", { _max_pts,currentpts });
             _pts_range_ok = false;
         }
     }
@@ -382,7 +382,7 @@ ts::ProcessorPlugin::Status ts::MuxPlugin::processPacket(TSPacket& pkt, bool& fl
 
     _inserted_packet_count++;
     _pts_last_inserted = _youngest_pts;   // store pts of last insertion
-    tsp->debug(u"Inserting Packet at PTS: %'d, file: %s", { _pts_last_inserted,_file.getFileName() });
+    TS_DEBUG(*tsp, u"Inserting Packet at PTS: %'d, file: %s", { _pts_last_inserted,_file.getFileName() });
 
     if (_inter_time != 0) {
         _pts_range_ok = false; // reset _pts_range_ok signal if inter_time is specified
@@ -50,6 +50,8 @@ namespace ts {
         PatternPlugin(TSP*);
         virtual bool start() override;
         virtual Status processPacket(TSPacket&, bool&, bool&) override;
+        virtual size_t processPacketBatch(TSPacket*, Status*, size_t, bool&, bool&) override;
+        virtual Parallelism getParallelism() override;
 
     private:
         uint8_t   _offset_pusi;      // Start offset in packets with PUSI
@@ -173,3 +175,28 @@ ts::ProcessorPlugin::Status ts::PatternPlugin::processPacket(TSPacket& pkt, bool
 
     return TSP_OK;
 }
+
+
+//----------------------------------------------------------------------------
+// Data parallelism of the plugin
+//----------------------------------------------------------------------------
+
+ts::ProcessorPlugin::Parallelism ts::PatternPlugin::getParallelism()
+{
+    // No state, each packet is independently processed.
+    return PARALLEL_PACKET;
+}
+
+
+//----------------------------------------------------------------------------
+// Packet batch processing method
+//----------------------------------------------------------------------------
+
+size_t ts::PatternPlugin::processPacketBatch(TSPacket* pkt, Status* status, size_t count, bool& flush, bool& bitrate_changed)
+{
+    // Static call to the packet processing method, no virtual dispatch.
+    for (size_t i = 0; i < count; ++i) {
+        status[i] = PatternPlugin::processPacket(pkt[i], flush, bitrate_changed);
+    }
+    return count;
+}
@@ -144,7 +144,7 @@ bool ts::PCRBitratePlugin::start()
 
 ts::BitRate ts::PCRBitratePlugin::getBitrate()
 {
-    tsp->debug(u"getBitrate() called, returning %'d b/s", {_bitrate});
+    TS_DEBUG(*tsp, u"getBitrate() called, returning %'d b/s", {_bitrate});
     return _bitrate;
 }
 
@@ -62,6 +62,7 @@ namespace ts {
         bool            _trace_packets;
         bool            _trace_packet_index;
         bool            _dump_pes_header;
+        bool            _header_only;
         bool            _dump_pes_payload;
         bool            _dump_start_code;
         bool            _dump_nal_units;
@@ -81,8 +82,12 @@ namespace ts {
         // Process dump count. Return true when terminated. Also process error on output.
         bool lastDump(std::ostream&);
 
+        // Dump the PES header. Return true when terminated.
+        bool dumpHeader(std::ostream&, const PESPacket&);
+
         // Hooks
         virtual void handlePESPacket (PESDemux&, const PESPacket&) override;
+        virtual void handlePESHeader (PESDemux&, const PESPacket&) override;
         virtual void handleVideoStartCode (PESDemux&, const PESPacket&, uint8_t, size_t, size_t) override;
         virtual void handleNewVideoAttributes (PESDemux&, const PESPacket&, const VideoAttributes&) override;
         virtual void handleAVCAccessUnit (PESDemux&, const PESPacket&, uint8_t, size_t, size_t) override;
@@ -113,6 +118,7 @@ ts::PESPlugin::PESPlugin(TSP* tsp_) :
     _trace_packets(false),
     _trace_packet_index(false),
     _dump_pes_header(false),
+    _header_only(false),
     _dump_pes_payload(false),
     _dump_start_code(false),
     _dump_nal_units(false),
@@ -133,6 +139,7 @@ ts::PESPlugin::PESPlugin(TSP* tsp_) :
     option(u"avc-access-unit",      0);
     option(u"binary",              'b');
     option(u"header",              'h');
+    option(u"header-only",          0);
     option(u"max-dump-count",      'x', UNSIGNED);
     option(u"max-dump-size",       'm', UNSIGNED);
     option(u"max-payload-size",     0,  UNSIGNED);
@@ -168,6 +175,12 @@ ts::PESPlugin::PESPlugin(TSP* tsp_) :
             u"  --header\n"
             u"      Dump PES packet header.\n"
             u"\n"
+            u"  --header-only\n"
+            u"      Analyze the PES headers only, do not reassemble the PES payloads. This is\n"
+            u"      faster on high-bitrate PID's. The PES packets are reported as soon as their\n"
+            u"      header is received. Only options --header, --trace-packets and\n"
+            u"      --packet-index (first TS packet only) can be used with this option.\n"
+            u"\n"
             u"  --help\n"
             u"      Display this help text.\n"
             u"\n"
@@ -269,6 +282,15 @@ bool ts::PESPlugin::start()
     _max_dump_count = intValue<size_t>(u"max-dump-count", 0);
     _min_payload = intValue<int>(u"min-payload-size", -1);
     _max_payload = intValue<int>(u"max-payload-size", -1);
+    _header_only = present(u"header-only");
+
+    if (_header_only && (_dump_pes_payload || _dump_start_code || _dump_nal_units || _dump_avc_sei ||
+                         _video_attributes || _audio_attributes || _min_payload >= 0 || _max_payload >= 0))
+    {
+        error(u"--header-only can be used with --header, --trace-packets and --packet-index only");
+        return false;
+    }
+    _demux.setHeaderOnly(_header_only);
 
     // Hexa dump flags and bytes-per-line
     _hexa_flags = UString::HEXA | UString::OFFSET | UString::BPL;
@@ -414,17 +436,8 @@ void ts::PESPlugin::handlePESPacket(PESDemux&, const PESPacket& pkt)
     }
 
     // Report PES header
-    if (_dump_pes_header) {
-        size_t size = pkt.headerSize();
-        out << "  PES header";
-        if (_max_dump_size > 0 && size > _max_dump_size) {
-            size = _max_dump_size;
-            out << " (truncated)";
-        }
-        out << ":" << std::endl << UString::Dump(pkt.header(), size, _hexa_flags, 4, _hexa_bpl);
-        if (lastDump (out)) {
-            return;
-        }
+    if (_dump_pes_header && dumpHeader(out, pkt)) {
+        return;
     }
 
     // Check that video packets start with either 00 00 01 (ISO 11172-2, MPEG-1, or ISO 13818-2, MPEG-2)
@@ -451,6 +464,53 @@ void ts::PESPlugin::handlePESPacket(PESDemux&, const PESPacket& pkt)
 }
 
 
+//----------------------------------------------------------------------------
+// Invoked by the demux in header-only mode when a PES header is available.
+//----------------------------------------------------------------------------
+
+void ts::PESPlugin::handlePESHeader(PESDemux&, const PESPacket& pkt)
+{
+    std::ostream& out(_outfile.is_open() ? _outfile : std::cout);
+
+    // Report packet description, the payload size is not known.
+    if (_trace_packets) {
+        out << UString::Format(u"* PID 0x%X, stream_id %s, header: %d bytes",
+                               {pkt.getSourcePID(), names::StreamId(pkt.getStreamId(), names::FIRST), pkt.headerSize()})
+            << std::endl;
+        if (lastDump(out)) {
+            return;
+        }
+    }
+
+    // Report TS packet index
+    if (_trace_packet_index) {
+        out << UString::Format(u"  First TS packet: %'d", {pkt.getFirstTSPacketIndex()}) << std::endl;
+    }
+
+    // Report PES header
+    if (_dump_pes_header) {
+        dumpHeader(out, pkt);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Dump the PES header. Return true when terminated.
+//----------------------------------------------------------------------------
+
+bool ts::PESPlugin::dumpHeader(std::ostream& out, const PESPacket& pkt)
+{
+    size_t size = pkt.headerSize();
+    out << "  PES header";
+    if (_max_dump_size > 0 && size > _max_dump_size) {
+        size = _max_dump_size;
+        out << " (truncated)";
+    }
+    out << ":" << std::endl << UString::Dump(pkt.header(), size, _hexa_flags, 4, _hexa_bpl);
+    return lastDump(out);
+}
+
+
 //----------------------------------------------------------------------------
 // This hook is invoked when a PES start code is encountered.
 //----------------------------------------------------------------------------
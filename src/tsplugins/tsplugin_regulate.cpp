@@ -35,9 +35,25 @@
 #include "tsPlugin.h"
 #include "tsPluginRepository.h"
 #include "tsMonotonic.h"
+#include "tsPacingTimer.h"
 TSDUCK_SOURCE;
 
 #define DEF_PACKET_BURST 16
+#define DEF_MAX_SPIN     200  // microseconds
+
+namespace {
+    // Minimum delay between two bursts in precise mode (nanoseconds).
+    const ts::NanoSecond PRECISE_BURST_MIN = 50000;
+
+    // Maximum PCR distance in a PCR-synchronous regulation before re-synchronizing (one second).
+    const uint64_t MAX_PCR_DISTANCE = ts::SYSTEM_CLOCK_FREQ;
+
+    // Maximum lateness in a PCR-synchronous regulation before re-synchronizing (nanoseconds).
+    const ts::NanoSecond MAX_PCR_LATENESS = 500000000;
+
+    // Wrap-up value of PCR's.
+    const uint64_t PCR_WRAP = ts::PTS_DTS_SCALE * ts::SYSTEM_CLOCK_SUBFACTOR;
+}
 
 
 //----------------------------------------------------------------------------
@@ -51,6 +67,7 @@ namespace ts {
         // Implementation of plugin API
         RegulatePlugin(TSP*);
         virtual bool start() override;
+        virtual bool stop() override;
         virtual bool isRealTime() override {return true;}
         virtual Status processPacket(TSPacket&, bool&, bool&) override;
 
@@ -58,6 +75,25 @@ namespace ts {
         // Regulation state
         enum State {INITIAL, REGULATED, UNREGULATED};
 
+        // Statistics on the actual time of the end of bursts.
+        class JitterStatistics
+        {
+        public:
+            JitterStatistics();
+            void reset();
+            void add(const Monotonic& due, const Monotonic& actual);
+            void report(Report&) const;
+        private:
+            PacketCounter _count;       // Number of bursts
+            NanoSecond    _late_max;    // Maximum lateness
+            double        _late_sum;    // Sum of lateness
+            double        _late_sum2;   // Sum of squares of lateness
+            NanoSecond    _ival_max;    // Maximum interval error between two bursts
+            double        _ival_sum;    // Sum of absolute interval errors
+            Monotonic     _last_due;    // Due time of previous burst
+            Monotonic     _last_actual; // Actual time of previous burst
+        };
+
         // Private members
         State         _state;           // Current regulation state
         BitRate       _opt_bitrate;     // Bitrate option, zero means use input
@@ -70,6 +106,18 @@ namespace ts {
         Monotonic     _burst_end;       // End of current burst
         Monotonic     _bitrate_start;   // Time of last bitrate change
         PacketCounter _bitrate_pkt_cnt; // Passed packets since last bitrate change
+        bool          _precise;         // Use a high-precision pacing timer
+        PacingTimer   _pacer;           // High-precision pacing timer
+        bool          _pcr_sync;        // Regulate according to the PCR's of a reference PID
+        PID           _pcr_pid;         // Reference PID for PCR's, PID_NULL until found
+        bool          _pcr_locked;      // Got a first PCR, time reference is set
+        uint64_t      _last_pcr;        // Last PCR value in reference PID
+        Monotonic     _last_pcr_time;   // Due time of packet containing last PCR
+        PacketCounter _pcr_pkt_cnt;     // Number of packets since last PCR
+        PacketCounter _pcr_burst_cnt;   // Number of packets since last wait
+        NanoSecond    _pcr_pkt_duration;// Estimated packet duration from last PCR interval (ns)
+        bool          _jitter;          // Report jitter statistics
+        JitterStatistics _stats;        // Jitter statistics
 
         // Compute burst duration (_burst_duration and _burst_pkt_max), based on
         // required packets/burst (command line option) and current bitrate.
@@ -78,6 +126,12 @@ namespace ts {
         // Process one packet in a regulated burst. Wait at end of burst.
         Status regulatePacket(bool& flush, bool smoothen);
 
+        // Process one packet in PCR-synchronous regulation.
+        Status regulatePCR(const TSPacket& pkt, bool& flush);
+
+        // Wait until the end of a burst.
+        void waitBurst(const Monotonic& due, Monotonic& now);
+
         // Inaccessible operations
         RegulatePlugin() = delete;
         RegulatePlugin(const RegulatePlugin&) = delete;
@@ -105,10 +159,27 @@ ts::RegulatePlugin::RegulatePlugin(TSP* tsp_) :
     _burst_duration(0),
     _burst_end(),
     _bitrate_start(),
-    _bitrate_pkt_cnt(0)
+    _bitrate_pkt_cnt(0),
+    _precise(false),
+    _pacer(),
+    _pcr_sync(false),
+    _pcr_pid(PID_NULL),
+    _pcr_locked(false),
+    _last_pcr(0),
+    _last_pcr_time(),
+    _pcr_pkt_cnt(0),
+    _pcr_burst_cnt(0),
+    _pcr_pkt_duration(0),
+    _jitter(false),
+    _stats()
 {
-    option(u"bitrate",      'b', POSITIVE);
-    option(u"packet-burst", 'p', POSITIVE);
+    option(u"bitrate",           'b', POSITIVE);
+    option(u"jitter-statistics",  0);
+    option(u"max-spin",           0,  UNSIGNED);
+    option(u"packet-burst",      'p', POSITIVE);
+    option(u"pcr-synchronous",    0);
+    option(u"pid-pcr",            0,  PIDVAL);
+    option(u"precise",            0);
 
     setHelp(u"Regulate (slow down only) the TS packets flow according to a specified\n"
             u"bitrate. Useful to play a non-regulated input (such as a TS file) to a\n"
@@ -124,12 +195,41 @@ ts::RegulatePlugin::RegulatePlugin(TSP* tsp_) :
             u"  --help\n"
             u"      Display this help text.\n"
             u"\n"
+            u"  --jitter-statistics\n"
+            u"      At the end of the processing, report statistics on the actual time\n"
+            u"      of the end of bursts, compared to their scheduled time: lateness and\n"
+            u"      error on the interval between two consecutive bursts.\n"
+            u"\n"
+            u"  --max-spin value\n"
+            u"      With --precise, specify the maximum duration in microseconds of the\n"
+            u"      active wait at the end of each burst. Zero means no active wait.\n"
+            u"      The default is " TS_STRINGIFY(DEF_MAX_SPIN) u" microseconds.\n"
+            u"\n"
             u"  -p value\n"
             u"  --packet-burst value\n"
             u"      Number of packets to burst at a time. Does not modify the average\n"
             u"      output bitrate but influence smoothing and CPU load. The default\n"
             u"      is " TS_STRINGIFY(DEF_PACKET_BURST) u" packets.\n"
             u"\n"
+            u"  --pcr-synchronous\n"
+            u"      Regulate the flow according to the PCR's of a reference PID instead\n"
+            u"      of a bitrate. Each packet containing a PCR is passed at the time\n"
+            u"      which is computed from the first PCR. Between two PCR's, the packets\n"
+            u"      are passed at the rate of the previous PCR interval. The regulation\n"
+            u"      is re-synchronized on PCR discontinuities. The option --bitrate is\n"
+            u"      ignored.\n"
+            u"\n"
+            u"  --pid-pcr value\n"
+            u"      With --pcr-synchronous, specify the reference PID for PCR's. By\n"
+            u"      default, use the first PID containing PCR's.\n"
+            u"\n"
+            u"  --precise\n"
+            u"      Use a high-precision timer: sleep until shortly before the end of each\n"
+            u"      burst and then actively wait until the exact time. This allows much\n"
+            u"      shorter bursts, down to one packet, at the expense of some CPU load.\n"
+            u"      By default, the bursts cannot be shorter than the precision of the\n"
+            u"      system timers.\n"
+            u"\n"
             u"  --version\n"
             u"      Display the version number.\n");
 }
@@ -144,15 +244,24 @@ bool ts::RegulatePlugin::start()
     // Get command line arguments
     _opt_bitrate = intValue<BitRate>(u"bitrate", 0);
     _opt_burst = intValue<PacketCounter>(u"packet-burst", DEF_PACKET_BURST);
+    _precise = present(u"precise");
+    _pacer.setMaxSpin(intValue<NanoSecond>(u"max-spin", DEF_MAX_SPIN) * NanoSecPerMicroSec);
+    _pcr_sync = present(u"pcr-synchronous");
+    _pcr_pid = intValue<PID>(u"pid-pcr", PID_NULL);
+    _jitter = present(u"jitter-statistics");
 
     // Compute the minimum delay between two bursts, in nano-seconds.
     // This is a limitation of the operating system. If we try to use
     // wait on durations lower than the minimum, this will introduce
     // latencies which mess up the regulation. We try to request 2
     // milliseconds as time precision and we keep what the operating
-    // system gives.
+    // system gives. With the high-precision timer, the final active wait
+    // compensates the imprecision of the operating system.
 
     _burst_min = Monotonic::SetPrecision(2000000); // 2 milliseconds in nanoseconds
+    if (_precise) {
+        _burst_min = PRECISE_BURST_MIN;
+    }
 
     tsp->verbose(u"minimum packet burst duration is %'d nano-seconds", {_burst_min});
 
@@ -162,11 +271,50 @@ bool ts::RegulatePlugin::start()
     _burst_pkt_max = 0;
     _burst_pkt_cnt = 0;
     _burst_duration = 0;
+    _pcr_locked = false;
+    _last_pcr = 0;
+    _pcr_pkt_cnt = 0;
+    _pcr_burst_cnt = 0;
+    _pcr_pkt_duration = 0;
+    _stats.reset();
 
     return true;
 }
 
 
+//----------------------------------------------------------------------------
+// Stop method
+//----------------------------------------------------------------------------
+
+bool ts::RegulatePlugin::stop()
+{
+    if (_jitter) {
+        _stats.report(*tsp);
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Wait until the end of a burst.
+//----------------------------------------------------------------------------
+
+void ts::RegulatePlugin::waitBurst(const Monotonic& due, Monotonic& now)
+{
+    if (_precise) {
+        _pacer.waitUntil(due, now);
+    }
+    else {
+        Monotonic end(due);
+        end.wait();
+        now.getSystemTime();
+    }
+    if (_jitter) {
+        _stats.add(due, now);
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Handle bitrate change, compute burst duration.
 //----------------------------------------------------------------------------
@@ -219,7 +367,8 @@ ts::ProcessorPlugin::Status ts::RegulatePlugin::regulatePacket(bool& flush, bool
     // Recheck end of burst, just in case we added some more packets to smoothen.
     if (_burst_pkt_cnt == 0) {
         // Wait until scheduled end of burst.
-        _burst_end.wait();
+        Monotonic now;
+        waitBurst(_burst_end, now);
         // Restart a new burst, use monotonic time
         _burst_pkt_cnt = _burst_pkt_max;
         _burst_end += _burst_duration;
@@ -240,6 +389,11 @@ ts::ProcessorPlugin::Status ts::RegulatePlugin::regulatePacket(bool& flush, bool
 
 ts::ProcessorPlugin::Status ts::RegulatePlugin::processPacket(TSPacket& pkt, bool& flush, bool& bitrate_changed)
 {
+    // The PCR-synchronous regulation does not use bitrates.
+    if (_pcr_sync) {
+        return regulatePCR(pkt, flush);
+    }
+
     // Compute old and new bitrate (most often the same)
     BitRate old_bitrate = _cur_bitrate;
     _cur_bitrate = _opt_bitrate != 0 ? _opt_bitrate : tsp->bitrate();
@@ -351,3 +505,134 @@ ts::ProcessorPlugin::Status ts::RegulatePlugin::processPacket(TSPacket& pkt, boo
     tsp->error(u"internal error, invalid regulator state");
     return TSP_END;
 }
+
+
+//----------------------------------------------------------------------------
+// Process one packet in PCR-synchronous regulation.
+//----------------------------------------------------------------------------
+
+ts::ProcessorPlugin::Status ts::RegulatePlugin::regulatePCR(const TSPacket& pkt, bool& flush)
+{
+    // Select the first PID with PCR's as reference PID when unspecified.
+    if (_pcr_pid == PID_NULL && pkt.hasPCR()) {
+        _pcr_pid = pkt.getPID();
+        tsp->verbose(u"using PCR's from PID 0x%X (%d) as reference", {_pcr_pid, _pcr_pid});
+    }
+
+    // Transmit without regulation until the first PCR.
+    const bool has_pcr = pkt.hasPCR() && pkt.getPID() == _pcr_pid;
+    if (!_pcr_locked && !has_pcr) {
+        return TSP_OK;
+    }
+
+    // Compute the due time of this packet.
+    Monotonic due(_last_pcr_time);
+    bool wait = false;
+    ++_pcr_pkt_cnt;
+
+    if (!has_pcr) {
+        // Interpolate between PCR's at the rate of the previous PCR interval (zero means unknown yet).
+        if (_pcr_pkt_duration > 0 && ++_pcr_burst_cnt >= _opt_burst) {
+            due += NanoSecond(_pcr_pkt_cnt) * _pcr_pkt_duration;
+            wait = true;
+        }
+    }
+    else {
+        const uint64_t pcr = pkt.getPCR();
+        if (!_pcr_locked) {
+            // First PCR, this is the time reference.
+            due.getSystemTime();
+            _pcr_locked = true;
+            tsp->verbose(u"PCR-synchronous regulation started");
+        }
+        else {
+            // Distance from previous PCR, modulo the PCR wrap-up.
+            const uint64_t distance = pcr >= _last_pcr ? pcr - _last_pcr : pcr + PCR_WRAP - _last_pcr;
+            if (distance > MAX_PCR_DISTANCE || pkt.getDiscontinuityIndicator()) {
+                // PCR discontinuity or backward PCR: restart the time reference, assuming the previous packet rate.
+                tsp->verbose(u"PCR discontinuity, re-synchronizing regulation");
+                due += NanoSecond(_pcr_pkt_cnt) * _pcr_pkt_duration;
+            }
+            else {
+                const NanoSecond duration = NanoSecond(distance * 1000) / 27; // 27 MHz to nanoseconds
+                due += duration;
+                _pcr_pkt_duration = duration / NanoSecond(_pcr_pkt_cnt);
+            }
+            wait = true;
+        }
+        _last_pcr = pcr;
+        _pcr_pkt_cnt = 0;
+    }
+
+    if (wait) {
+        Monotonic now;
+        waitBurst(due, now);
+        _pcr_burst_cnt = 0;
+        flush = true;
+        if (has_pcr && now - due > MAX_PCR_LATENESS) {
+            // Too late (input starvation for instance), restart the time reference now.
+            tsp->verbose(u"regulation is late by %'d ms, re-synchronizing", {(now - due) / NanoSecPerMilliSec});
+            due = now;
+        }
+    }
+    if (has_pcr) {
+        _last_pcr_time = due;
+    }
+    return TSP_OK;
+}
+
+
+//----------------------------------------------------------------------------
+// Jitter statistics.
+//----------------------------------------------------------------------------
+
+ts::RegulatePlugin::JitterStatistics::JitterStatistics() :
+    _count(0),
+    _late_max(0),
+    _late_sum(0.0),
+    _late_sum2(0.0),
+    _ival_max(0),
+    _ival_sum(0.0),
+    _last_due(),
+    _last_actual()
+{
+}
+
+void ts::RegulatePlugin::JitterStatistics::reset()
+{
+    _count = 0;
+    _late_max = _ival_max = 0;
+    _late_sum = _late_sum2 = _ival_sum = 0.0;
+}
+
+void ts::RegulatePlugin::JitterStatistics::add(const Monotonic& due, const Monotonic& actual)
+{
+    const NanoSecond late = actual - due;
+    _late_max = std::max(_late_max, late);
+    _late_sum += double(late);
+    _late_sum2 += double(late) * double(late);
+    if (_count > 0) {
+        const NanoSecond error = std::abs((actual - _last_actual) - (due - _last_due));
+        _ival_max = std::max(_ival_max, error);
+        _ival_sum += double(error);
+    }
+    _last_due = due;
+    _last_actual = actual;
+    _count++;
+}
+
+void ts::RegulatePlugin::JitterStatistics::report(Report& rep) const
+{
+    if (_count == 0) {
+        rep.info(u"no regulated burst, no jitter statistics");
+    }
+    else {
+        const double mean = _late_sum / double(_count);
+        const double stddev = std::sqrt(std::max(0.0, _late_sum2 / double(_count) - mean * mean));
+        rep.info(u"regulated bursts: %'d", {_count});
+        rep.info(u"lateness: mean %'d ns, standard deviation %'d ns, max %'d ns", {NanoSecond(mean), NanoSecond(stddev), _late_max});
+        if (_count > 1) {
+            rep.info(u"burst interval error: mean %'d ns, max %'d ns", {NanoSecond(_ival_sum / double(_count - 1)), _ival_max});
+        }
+    }
+}
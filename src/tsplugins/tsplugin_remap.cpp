@@ -57,6 +57,8 @@ namespace ts {
         RemapPlugin(TSP*);
         virtual bool start() override;
         virtual Status processPacket(TSPacket&, bool&, bool&) override;
+        virtual size_t processPacketBatch(TSPacket*, Status*, size_t, bool&, bool&) override;
+        virtual Parallelism getParallelism() override;
 
     private:
         typedef SafePtr<CyclingPacketizer, NullMutex> CyclingPacketizerPtr;
@@ -69,6 +71,7 @@ namespace ts {
         SectionDemux  _demux;           // Section demux
         PIDSet        _new_pids;        // New (remapped) PID values
         PIDMap        _pid_map;         // Key = input pid, value = output pid
+        PID           _pid_table[PID_MAX]; // Same as _pid_map, indexed by input pid
         PacketizerMap _pzer;            // Packetizer for sections
 
         // Invoked by the demux when a complete table is available.
@@ -241,6 +244,12 @@ bool ts::RemapPlugin::start()
     // Do not care about PMT if no need to update PSI
     _pmt_ready = !_update_psi;
 
+    // Build the direct remapping table.
+    for (PID pid = 0; pid < PID_MAX; ++pid) {
+        const PIDMap::const_iterator it = _pid_map.find(pid);
+        _pid_table[pid] = it == _pid_map.end() ? pid : it->second;
+    }
+
     tsp->verbose(u"%d PID's remapped", {_pid_map.size()});
     return true;
 }
@@ -252,8 +261,7 @@ bool ts::RemapPlugin::start()
 
 ts::PID ts::RemapPlugin::remap(PID pid)
 {
-    const PIDMap::const_iterator it = _pid_map.find(pid);
-    return it == _pid_map.end() ? pid : it->second;
+    return _pid_table[pid & PID_NULL];
 }
 
 
@@ -393,3 +401,48 @@ ts::ProcessorPlugin::Status ts::RemapPlugin::processPacket (TSPacket& pkt, bool&
     pkt.setPID(new_pid);
     return TSP_OK;
 }
+
+
+//----------------------------------------------------------------------------
+// Data parallelism of the plugin
+//----------------------------------------------------------------------------
+
+ts::ProcessorPlugin::Parallelism ts::RemapPlugin::getParallelism()
+{
+    // Without PSI update, each packet is independently remapped.
+    return _update_psi ? PARALLEL_NONE : PARALLEL_PACKET;
+}
+
+
+//----------------------------------------------------------------------------
+// Packet batch processing method
+//----------------------------------------------------------------------------
+
+size_t ts::RemapPlugin::processPacketBatch(TSPacket* pkt, Status* status, size_t count, bool& flush, bool& bitrate_changed)
+{
+    if (_update_psi) {
+        // PSI processing, use the packet processing method.
+        for (size_t i = 0; i < count; ++i) {
+            if ((status[i] = RemapPlugin::processPacket(pkt[i], flush, bitrate_changed)) == TSP_END) {
+                return i + 1;
+            }
+        }
+    }
+    else {
+        // Simple remapping.
+        for (size_t i = 0; i < count; ++i) {
+            const PID pid = pkt[i].getPID();
+            const PID new_pid = _pid_table[pid];
+            if (_check_integrity && new_pid == pid && _new_pids.test(pid)) {
+                tsp->error(u"PID conflict: PID %d (0x%X) present both in input and remap", {pid, pid});
+                status[i] = TSP_END;
+                return i + 1;
+            }
+            if (new_pid != pid) {
+                pkt[i].setPID(new_pid);
+            }
+            status[i] = TSP_OK;
+        }
+    }
+    return count;
+}
@@ -47,6 +47,7 @@ TSDUCK_SOURCE;
 
 #define DEFAULT_ECM_BITRATE 30000
 #define ASYNC_HANDLER_EXTRA_STACK_SIZE (1024 * 1024)
+#define NO_BATCH_ERROR std::numeric_limits<size_t>::max()
 
 
 //----------------------------------------------------------------------------
@@ -102,6 +103,7 @@ namespace ts {
         virtual bool start() override;
         virtual bool stop() override;
         virtual Status processPacket(TSPacket&, bool&, bool&) override;
+        virtual size_t processPacketBatch(TSPacket*, Status*, size_t, bool&, bool&) override;
 
     private:
         // Description of a crypto-period.
@@ -199,6 +201,10 @@ namespace ts {
         size_t            _current_ecm;         // Index to current ECM (ECM being broadcast)
         TSScrambling      _scrambling;          // Scrambler
         CyclingPacketizer _pzer_pmt;            // Packetizer for modified PMT
+        bool              _in_batch;            // Processing a batch of packets, scrambling is deferred
+        std::vector<TSPacket*> _batch_pkts;     // Packets to scramble at end of batch or before CW change
+        TSPacket*         _batch_base;          // First packet of the current batch
+        size_t            _batch_error;         // Index of first packet which could not be scrambled in current batch, NO_BATCH_ERROR if none
 
         // Return current/next CryptoPeriod for CW or ECM
         CryptoPeriod& currentCW()  { return _cp[_current_cw]; }
@@ -216,6 +222,9 @@ namespace ts {
         // Try to exit from degraded mode
         bool tryExitDegradedMode();
 
+        // Scramble the deferred packets of the current batch, record the first failed packet on error
+        bool scrambleBatch();
+
         // Invoked when the PMT of the service is available.
         virtual void handlePMT(const PMT&) override;
 
@@ -277,7 +286,11 @@ ts::ScramblerPlugin::ScramblerPlugin(TSP* tsp_) :
     _current_cw(0),
     _current_ecm(0),
     _scrambling(*tsp),
-    _pzer_pmt()
+    _pzer_pmt(),
+    _in_batch(false),
+    _batch_pkts(),
+    _batch_base(0),
+    _batch_error(NO_BATCH_ERROR)
 {
     option(u"",                      0,  STRING, 0, 1);
     option(u"access-criteria",      'a', STRING);
@@ -479,6 +492,9 @@ bool ts::ScramblerPlugin::start()
     if (!_scrambling.loadArgs(*this)) {
         return false;
     }
+    if (_scrambling.batchEnabled()) {
+        tsp->verbose(u"DVB-CSA2 batch implementation: %s", {DVBCSA2::BatchEngineName()});
+    }
 
     // Decode hexa data.
     if (!value(u"access-criteria").hexaDecode(_access_criteria)) {
@@ -764,6 +780,11 @@ bool ts::ScramblerPlugin::changeCW()
     // Allowed to change CW only if not in degraded mode
     if (!inDegradedMode()) {
 
+        // Scramble all deferred packets with the previous control word.
+        if (!scrambleBatch()) {
+            return false;
+        }
+
         // Point to next crypto-period
         _current_cw = (_current_cw + 1) & 0x01;
 
@@ -909,8 +930,11 @@ ts::ProcessorPlugin::Status ts::ScramblerPlugin::processPacket(TSPacket& pkt, bo
         _partial_clear = _partial_scrambling - 1;
     }
 
-    // Scramble the packet payload.
-    if (!_scrambling.encrypt(pkt)) {
+    // Scramble the packet payload, now or at the end of the batch of packets.
+    if (_in_batch) {
+        _batch_pkts.push_back(&pkt);
+    }
+    else if (!_scrambling.encrypt(pkt)) {
         return TSP_END;
     }
     _scrambled_count++;
@@ -1053,7 +1077,7 @@ void ts::ScramblerPlugin::CryptoPeriod::handleECM(const ecmgscs::ECMResponse& re
         ::memcpy(&_ecm[0].b, response.ECM_datagram.data(), response.ECM_datagram.size());  // Flawfinder: ignore: memcpy()
     }
 
-    _scrambler->tsp->debug(u"got ECM for crypto-period %d, %d packets", {_cp_number, _ecm.size()});
+    TS_DEBUG(*_scrambler->tsp, u"got ECM for crypto-period %d, %d packets", {_cp_number, _ecm.size()});
 
     _ecm_pkt_index = 0;
 
@@ -1086,3 +1110,55 @@ void ts::ScramblerPlugin::CryptoPeriod::getNextECMPacket (TSPacket& pkt)
         _scrambler->_ecm_cc = (_scrambler->_ecm_cc + 1) & 0x0F;
     }
 }
+
+
+//----------------------------------------------------------------------------
+// Packet batch processing method
+//----------------------------------------------------------------------------
+
+size_t ts::ScramblerPlugin::processPacketBatch(TSPacket* pkt, Status* status, size_t count, bool& flush, bool& bitrate_changed)
+{
+    // Packets to scramble are collected and scrambled together at the end of the batch
+    // or when the control word changes. With DVB-CSA2, they are scrambled in parallel.
+    _in_batch = true;
+    _batch_base = pkt;
+    _batch_error = NO_BATCH_ERROR;
+    size_t done = 0;
+    while (done < count) {
+        status[done] = ScramblerPlugin::processPacket(pkt[done], flush, bitrate_changed);
+        if (status[done++] == TSP_END) {
+            break;
+        }
+    }
+    _in_batch = false;
+    scrambleBatch();
+
+    // On scrambling error, the processing ends at the first packet which could not be scrambled.
+    // This packet and all subsequent ones in the batch are not passed, none is passed in the clear.
+    if (_batch_error != NO_BATCH_ERROR) {
+        assert(_batch_error < done);
+        done = _batch_error + 1;
+        status[_batch_error] = TSP_END;
+    }
+    _batch_base = 0;
+    return done;
+}
+
+
+//----------------------------------------------------------------------------
+// Scramble the deferred packets of the current batch.
+//----------------------------------------------------------------------------
+
+bool ts::ScramblerPlugin::scrambleBatch()
+{
+    const bool ok = _batch_pkts.empty() || _scrambling.encrypt(&_batch_pkts[0], _batch_pkts.size());
+
+    // On error, remember the first deferred packet, the batch will be cut there.
+    if (!ok) {
+        assert(_batch_base != 0);
+        _batch_error = std::min(_batch_error, size_t(_batch_pkts[0] - _batch_base));
+    }
+
+    _batch_pkts.clear();
+    return ok;
+}
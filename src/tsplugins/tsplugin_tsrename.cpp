@@ -201,10 +201,10 @@ bool ts::TSRenamePlugin::start()
 
 void ts::TSRenamePlugin::handleTable(SectionDemux& demux, const BinaryTable& table)
 {
-    tsp->debug(u"Got %s v%d, PID %d (0x%X), TIDext %d (0x%X)",
-               {names::TID(table.tableId()), table.version(),
-                table.sourcePID(), table.sourcePID(),
-                table.tableIdExtension(), table.tableIdExtension()});
+    TS_DEBUG(*tsp, u"Got %s v%d, PID %d (0x%X), TIDext %d (0x%X)",
+             {names::TID(table.tableId()), table.version(),
+              table.sourcePID(), table.sourcePID(),
+              table.tableIdExtension(), table.tableIdExtension()});
  
     switch (table.tableId()) {
 
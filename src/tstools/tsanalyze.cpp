@@ -33,7 +33,7 @@
 
 #include "tsTSAnalyzerReport.h"
 #include "tsTSAnalyzerOptions.h"
-#include "tsInputRedirector.h"
+#include "tsTSFileInput.h"
 #include "tsVersionInfo.h"
 TSDUCK_SOURCE;
 
@@ -48,15 +48,25 @@ struct Options: public ts::TSAnalyzerOptions
 
     ts::BitRate bitrate;  // Expected bitrate (188-byte packets)
     ts::UString infile;   // Input file name
+    ts::TSFileInput::AccessMode access_mode;  // Input file access mode
+    size_t      threads;      // Number of packet statistics threads
+    size_t      chunk_size;   // Number of packets per chunk in parallel analysis
 };
 
 Options::Options(int argc, char *argv[]) :
     ts::TSAnalyzerOptions(u"Analyze the structure of a transport stream", u"[options] [filename]"),
     bitrate(0),
-    infile()
+    infile(),
+    access_mode(ts::TSFileInput::READ_ACCESS),
+    threads(0),
+    chunk_size(0)
 {
-    option(u"",         0,  Args::STRING, 0, 1);
-    option(u"bitrate", 'b', Args::UNSIGNED);
+    option(u"",            0,  Args::STRING, 0, 1);
+    option(u"bitrate",    'b', Args::UNSIGNED);
+    option(u"chunk-size",  0,  Args::POSITIVE);
+    option(u"direct",      0);
+    option(u"mmap",        0);
+    option(u"threads",    't', Args::UNSIGNED);
 
     setHelp(u"Input file:\n"
             u"\n"
@@ -70,9 +80,29 @@ Options::Options(int argc, char *argv[]) :
             u"      (based on 188-byte packets). By default, the bitrate is\n"
             u"      evaluated using the PCR in the transport stream.\n"
             u"\n"
+            u"  --chunk-size value\n"
+            u"      With --threads, number of TS packets per chunk of analysis. The default\n"
+            u"      is " + ts::UString::Decimal(ts::TSAnalyzer::DEFAULT_CHUNK_PACKETS) + u" packets.\n"
+            u"\n"
+            u"  --direct\n"
+            u"      Read the input file using direct I/O (O_DIRECT on Linux), bypassing the\n"
+            u"      system cache. Ignored with standard input or on Windows.\n"
+            u"\n"
             u"  --help\n"
             u"      Display this help text.\n"
             u"\n"
+            u"  --mmap\n"
+            u"      Read the input file using memory-mapped windows instead of read() system\n"
+            u"      calls. Ignored with standard input or on Windows.\n"
+            u"\n"
+            u"  -t value\n"
+            u"  --threads value\n"
+            u"      Number of threads which compute the packet statistics in parallel. The\n"
+            u"      stream is split into chunks of packets. The PSI, PES and T2-MI analysis\n"
+            u"      remains sequential and the statistics of the chunks are merged in stream\n"
+            u"      order. The report is identical to a sequential analysis. The default is\n"
+            u"      zero, meaning a sequential analysis.\n"
+            u"\n"
             u"  -v\n"
             u"  --verbose\n"
             u"      Produce verbose output.\n"
@@ -84,6 +114,13 @@ Options::Options(int argc, char *argv[]) :
 
     infile = value(u"");
     bitrate = intValue<ts::BitRate>(u"bitrate");
+    threads = intValue<size_t>(u"threads", 0);
+    chunk_size = intValue<size_t>(u"chunk-size", ts::TSAnalyzer::DEFAULT_CHUNK_PACKETS);
+    access_mode = present(u"mmap") ? ts::TSFileInput::MMAP_ACCESS : (present(u"direct") ? ts::TSFileInput::DIRECT_ACCESS : ts::TSFileInput::READ_ACCESS);
+
+    if (present(u"mmap") && present(u"direct")) {
+        error(u"--mmap and --direct are mutually exclusive");
+    }
 
     exitOnError();
 }
@@ -98,14 +135,34 @@ int main(int argc, char *argv[])
     TSDuckLibCheckVersion();
     Options opt(argc, argv);
     ts::TSAnalyzerReport analyzer(opt.bitrate);
-    ts::InputRedirector input(opt.infile, opt);
-    ts::TSPacket pkt;
+    ts::TSFileInput file;
 
     analyzer.setAnalysisOptions(opt);
+    analyzer.setAnalysisThreads(opt.threads, opt.chunk_size);
+
+    // Read packets by chunks, without copy when the file is memory-mapped.
+    file.setAccessMode(opt.access_mode);
+    if (!file.open(opt.infile, 1, 0, opt)) {
+        return EXIT_FAILURE;
+    }
 
-    while (pkt.read(std::cin, true, opt)) {
-        analyzer.feedPacket(pkt);
+    const ts::TSPacket* pkt = 0;
+    size_t count = 0;
+    bool sync = true;
+    while (sync && (count = file.readZeroCopy(pkt, 1024, opt)) > 0) {
+        for (size_t i = 0; sync && i < count; ++i) {
+            if (pkt[i].hasValidSync()) {
+                analyzer.feedPacket(pkt[i]);
+            }
+            else {
+                const ts::PacketCounter index = file.getPacketCount() - count + i;
+                opt.error(u"synchronization lost%s, got 0x%X instead of 0x%X at start of TS packet",
+                          {index > 0 ? ts::UString::Format(u" after %'d TS packets", {index}) : ts::UString(), pkt[i].b[0], ts::SYNC_BYTE});
+                sync = false;
+            }
+        }
     }
+    file.close(opt);
 
     analyzer.report(std::cout, opt);
 
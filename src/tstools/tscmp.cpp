@@ -67,6 +67,7 @@ struct Options: public ts::Args
     bool        pid_ignore;
     bool        cc_ignore;
     bool        continue_all;
+    ts::TSFileInput::AccessMode access_mode;
 };
 
 Options::Options(int argc, char *argv[]) :
@@ -85,7 +86,8 @@ Options::Options(int argc, char *argv[]) :
     pcr_ignore(false),
     pid_ignore(false),
     cc_ignore(false),
-    continue_all(false)
+    continue_all(false),
+    access_mode(ts::TSFileInput::READ_ACCESS)
 {
     option(u"",                 0,  Args::STRING, 2, 2);
     option(u"buffered-packets", 0,  UNSIGNED);
@@ -93,6 +95,7 @@ Options::Options(int argc, char *argv[]) :
     option(u"cc-ignore",        0);
     option(u"continue",        'c');
     option(u"dump",            'd');
+    option(u"mmap",             0);
     option(u"normalized",      'n');
     option(u"packet-offset",   'p', UNSIGNED);
     option(u"payload-only",     0);
@@ -132,6 +135,10 @@ Options::Options(int argc, char *argv[]) :
             u"  --help\n"
             u"      Display this help text.\n"
             u"\n"
+            u"  --mmap\n"
+            u"      Read the files using memory-mapped windows instead of read() system\n"
+            u"      calls. Ignored on Windows.\n"
+            u"\n"
             u"  -n\n"
             u"  --normalized\n"
             u"      Report in a normalized output format (useful for automatic analysis).\n"
@@ -197,6 +204,7 @@ Options::Options(int argc, char *argv[]) :
     quiet = present(u"quiet");
     normalized = !quiet && present(u"normalized");
     dump = !quiet && present(u"dump");
+    access_mode = present(u"mmap") ? ts::TSFileInput::MMAP_ACCESS : ts::TSFileInput::READ_ACCESS;
 
     if (quiet) {
         setMaxSeverity(ts::Severity::Info);
@@ -338,6 +346,8 @@ int main (int argc, char *argv[])
     ts::TSFileInputBuffered file2(opt.buffered_packets);
 
     // Open files
+    file1.setAccessMode(opt.access_mode);
+    file2.setAccessMode(opt.access_mode);
     file1.open(opt.filename1, 1, opt.byte_offset, opt);
     file2.open(opt.filename2, 1, opt.byte_offset, opt);
     opt.exitOnError();
@@ -0,0 +1,307 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Transport Stream file input throughput benchmark utility
+//
+//----------------------------------------------------------------------------
+
+#include "tsArgs.h"
+#include "tsTSFileInput.h"
+#include "tsTSAnalyzer.h"
+#include "tsEnumeration.h"
+#include "tsSysUtils.h"
+#include "tsTime.h"
+#include "tsVersionInfo.h"
+TSDUCK_SOURCE;
+
+namespace {
+    // Values for --mode option.
+    const ts::Enumeration AccessModeEnum({
+        {u"read",   ts::TSFileInput::READ_ACCESS},
+        {u"mmap",   ts::TSFileInput::MMAP_ACCESS},
+        {u"direct", ts::TSFileInput::DIRECT_ACCESS},
+    });
+
+    // Default number of packets per read operation.
+    const size_t DEFAULT_CHUNK_PACKETS = 10000;
+}
+
+
+//----------------------------------------------------------------------------
+//  Command line options
+//----------------------------------------------------------------------------
+
+struct Options: public ts::Args
+{
+    Options(int argc, char *argv[]);
+
+    ts::UString      filename;     // Input file name
+    std::vector<int> modes;        // Access modes to test
+    size_t           iterations;   // Number of iterations per mode
+    size_t           chunk;        // Number of packets per read operation
+    size_t           window_size;  // Size of mapped windows or direct I/O buffer
+    bool             zero_copy;    // Use readZeroCopy() instead of read()
+    bool             uncached;     // Drop file from system cache before each iteration
+    bool             analysis;     // Analyze the packets with a TSAnalyzer
+    std::vector<int> threads;      // Numbers of analysis threads to test
+};
+
+Options::Options(int argc, char *argv[]) :
+    Args(u"Benchmark the input throughput of transport stream files", u"[options] filename"),
+    filename(),
+    modes(),
+    iterations(0),
+    chunk(0),
+    window_size(0),
+    zero_copy(false),
+    uncached(false),
+    analysis(false),
+    threads()
+{
+    option(u"",             0,  Args::STRING, 1, 1);
+    option(u"analyze",     'a');
+    option(u"chunk",       'c', Args::POSITIVE);
+    option(u"iterations",  'i', Args::POSITIVE);
+    option(u"mode",        'm', AccessModeEnum, 0, Args::UNLIMITED_COUNT);
+    option(u"threads",     't', Args::UNSIGNED, 0, Args::UNLIMITED_COUNT);
+    option(u"uncached",    'u');
+    option(u"window-size", 'w', Args::POSITIVE);
+    option(u"zero-copy",   'z');
+
+    setHelp(u"File:\n"
+            u"\n"
+            u"  MPEG capture file to read. A large file is recommended.\n"
+            u"\n"
+            u"Options:\n"
+            u"\n"
+            u"  -a\n"
+            u"  --analyze\n"
+            u"      Analyze the packets with the same analyzer as tsanalyze. Combined with\n"
+            u"      --threads, this is a scaling benchmark of the parallel analysis.\n"
+            u"\n"
+            u"  -c value\n"
+            u"  --chunk value\n"
+            u"      Number of TS packets per read operation. The default is " + ts::UString::Decimal(DEFAULT_CHUNK_PACKETS) + u".\n"
+            u"\n"
+            u"  --help\n"
+            u"      Display this help text.\n"
+            u"\n"
+            u"  -i value\n"
+            u"  --iterations value\n"
+            u"      Number of times the file is read with each access mode. The default is 1.\n"
+            u"\n"
+            u"  -m name\n"
+            u"  --mode name\n"
+            u"      File access mode to test. Must be one of " + AccessModeEnum.nameList() + u".\n"
+            u"      Several --mode options may be specified. By default, all modes are tested.\n"
+            u"\n"
+            u"  -u\n"
+            u"  --uncached\n"
+            u"      Before each iteration, ask the system to drop the content of the file from\n"
+            u"      the system cache. Supported on Linux only.\n"
+            u"\n"
+            u"  -t value\n"
+            u"  --threads value\n"
+            u"      With --analyze, number of threads which compute the packet statistics.\n"
+            u"      Several --threads options may be specified, each number of threads is\n"
+            u"      tested in sequence. The default is zero, meaning a sequential analysis.\n"
+            u"\n"
+            u"  -v\n"
+            u"  --verbose\n"
+            u"      Produce verbose messages.\n"
+            u"\n"
+            u"  --version\n"
+            u"      Display the version number.\n"
+            u"\n"
+            u"  -w value\n"
+            u"  --window-size value\n"
+            u"      Size in bytes of the memory-mapped windows or direct I/O buffer.\n"
+            u"      The default is " + ts::UString::Decimal(ts::TSFileInput::DEFAULT_WINDOW_SIZE) + u" bytes.\n"
+            u"\n"
+            u"  -z\n"
+            u"  --zero-copy\n"
+            u"      Access the packets in place in the file input buffers instead of copying\n"
+            u"      them in the application buffer.\n");
+
+    analyze(argc, argv);
+
+    filename = value(u"");
+    getIntValues(modes, u"mode");
+    if (modes.empty()) {
+        modes.push_back(ts::TSFileInput::READ_ACCESS);
+        modes.push_back(ts::TSFileInput::MMAP_ACCESS);
+        modes.push_back(ts::TSFileInput::DIRECT_ACCESS);
+    }
+    iterations = intValue<size_t>(u"iterations", 1);
+    chunk = intValue<size_t>(u"chunk", DEFAULT_CHUNK_PACKETS);
+    window_size = intValue<size_t>(u"window-size", 0);
+    zero_copy = present(u"zero-copy");
+    uncached = present(u"uncached");
+    analysis = present(u"analyze");
+    getIntValues(threads, u"threads");
+    if (threads.empty()) {
+        threads.push_back(0);
+    }
+
+    exitOnError();
+}
+
+
+//----------------------------------------------------------------------------
+//  Drop the content of a file from the system cache.
+//----------------------------------------------------------------------------
+
+namespace {
+    void DropCache(const ts::UString& filename, ts::Report& report)
+    {
+#if defined(TS_LINUX)
+        const int fd = ::open(filename.toUTF8().c_str(), O_RDONLY);
+        const ts::ErrorCode err = fd < 0 ? ts::LastErrorCode() : ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        if (err != 0) {
+            report.warning(u"cannot drop %s from system cache: %s", {filename, ts::ErrorCodeMessage(err)});
+        }
+        if (fd >= 0) {
+            ::close(fd);
+        }
+#else
+        report.warning(u"dropping files from system cache is not supported on this system");
+#endif
+    }
+}
+
+
+//----------------------------------------------------------------------------
+//  Read the complete file once, return the number of packets.
+//----------------------------------------------------------------------------
+
+namespace {
+    ts::PacketCounter ReadFile(Options& opt, ts::TSFileInput::AccessMode mode, ts::TSPacketVector& buffer, uint32_t& checksum, ts::TSAnalyzer* analyzer)
+    {
+        ts::TSFileInput file;
+        file.setAccessMode(mode, opt.window_size);
+        if (!file.open(opt.filename, 1, 0, opt)) {
+            return 0;
+        }
+
+        // Touch one byte in each packet so that mapped pages are actually read.
+        const ts::TSPacket* pkt = 0;
+        size_t count = 0;
+        for (;;) {
+            if (opt.zero_copy) {
+                count = file.readZeroCopy(pkt, opt.chunk, opt);
+            }
+            else {
+                count = file.read(&buffer[0], opt.chunk, opt);
+                pkt = &buffer[0];
+            }
+            if (count == 0) {
+                break;
+            }
+            if (analyzer != 0) {
+                for (size_t i = 0; i < count; ++i) {
+                    analyzer->feedPacket(pkt[i]);
+                }
+            }
+            else {
+                for (size_t i = 0; i < count; ++i) {
+                    checksum += pkt[i].b[3];
+                }
+            }
+        }
+
+        // Complete the analysis: the number of PID's is used as checksum.
+        if (analyzer != 0) {
+            std::vector<ts::PID> pids;
+            analyzer->getPIDs(pids);
+            checksum += uint32_t(pids.size());
+        }
+
+        const ts::PacketCounter total = file.getPacketCount();
+        file.close(opt);
+        return total;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+//  Program entry point
+//----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    TSDuckLibCheckVersion();
+    Options opt(argc, argv);
+    ts::TSPacketVector buffer(opt.chunk);
+
+    // Without --analyze, the number of threads is irrelevant and only one pass is done per mode.
+    const size_t thread_passes = opt.analysis ? opt.threads.size() : 1;
+
+    for (size_t m = 0; m < opt.modes.size(); ++m) {
+        for (size_t t = 0; t < thread_passes; ++t) {
+
+            const ts::TSFileInput::AccessMode mode = ts::TSFileInput::AccessMode(opt.modes[m]);
+            ts::PacketCounter packets = 0;
+            ts::MilliSecond duration = 0;
+            uint32_t checksum = 0;
+            ts::UString name(AccessModeEnum.name(mode));
+
+            for (size_t iter = 0; iter < opt.iterations && opt.valid(); ++iter) {
+                if (opt.uncached) {
+                    DropCache(opt.filename, opt);
+                }
+                const ts::Time start(ts::Time::CurrentUTC());
+                if (opt.analysis) {
+                    ts::TSAnalyzer analyzer;
+                    analyzer.setAnalysisThreads(size_t(opt.threads[t]));
+                    packets += ReadFile(opt, mode, buffer, checksum, &analyzer);
+                }
+                else {
+                    packets += ReadFile(opt, mode, buffer, checksum, 0);
+                }
+                duration += ts::Time::CurrentUTC() - start;
+            }
+            if (opt.analysis) {
+                name += ts::UString::Format(u", %d threads", {opt.threads[t]});
+            }
+            opt.verbose(u"%s: checksum 0x%08X", {name, checksum});
+
+            // Report throughput in MB/s and packets/s.
+            const uint64_t bytes = packets * ts::PKT_SIZE;
+            std::cout << ts::UString::Format(u"%-7s %'d packets, %'d ms, %'d MB/s, %'d packets/s",
+                                             {name,
+                                              packets,
+                                              duration,
+                                              duration == 0 ? 0 : (bytes * ts::MilliSecPerSec) / (uint64_t(duration) * 1000000),
+                                              duration == 0 ? 0 : (packets * ts::MilliSecPerSec) / uint64_t(duration)})
+                      << std::endl;
+        }
+    }
+
+    return opt.valid() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,128 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Compile TSDuck names configuration files.
+//
+//----------------------------------------------------------------------------
+
+#include "tsArgs.h"
+#include "tsNames.h"
+#include "tsSysUtils.h"
+#include "tsVersionInfo.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+//  Command line options
+//----------------------------------------------------------------------------
+
+struct Options: public ts::Args
+{
+    Options(int argc, char *argv[]);
+
+    ts::UStringVector infiles;  // Input text files.
+    ts::UString       outfile;  // Output file or directory.
+};
+
+Options::Options(int argc, char *argv[]) :
+    Args(u"Compile TSDuck names configuration files", u"[options] filename ..."),
+    infiles(),
+    outfile()
+{
+    option(u"",        0,  Args::STRING, 1, Args::UNLIMITED_COUNT);
+    option(u"output", 'o', Args::STRING);
+
+    setHelp(u"Input files:\n"
+            u"\n"
+            u"  Names configuration files (tsduck.*.names) in text format.\n"
+            u"\n"
+            u"  The compiled files are binary files which are directly mapped in memory\n"
+            u"  when the names are used, avoiding the analysis of the text files. By\n"
+            u"  default, a compiled file is created in the same directory as its text\n"
+            u"  file, with the additional suffix \".bin\". The compiled file is used only\n"
+            u"  when it is up to date with the text file in the same search path.\n"
+            u"\n"
+            u"Options:\n"
+            u"\n"
+            u"  --help\n"
+            u"      Display this help text.\n"
+            u"\n"
+            u"  -o filename\n"
+            u"  --output filename\n"
+            u"      Specify the output file name. If the specified path is a directory,\n"
+            u"      the output file is built from this directory and the input file name.\n"
+            u"      With more than one input file, the specified path must be a directory.\n"
+            u"\n"
+            u"  -v\n"
+            u"  --verbose\n"
+            u"      Produce verbose output.\n"
+            u"\n"
+            u"  --version\n"
+            u"      Display the version number.\n");
+
+    analyze(argc, argv);
+
+    getValues(infiles, u"");
+    getValue(outfile, u"output");
+
+    if (infiles.size() > 1 && !outfile.empty() && !ts::IsDirectory(outfile)) {
+        error(u"the output must be a directory with more than one input file");
+    }
+
+    exitOnError();
+}
+
+
+//----------------------------------------------------------------------------
+//  Program entry point
+//----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    TSDuckLibCheckVersion();
+    Options opt(argc, argv);
+    bool success = true;
+
+    for (ts::UStringVector::const_iterator it = opt.infiles.begin(); it != opt.infiles.end(); ++it) {
+        ts::UString outfile;
+        if (opt.outfile.empty()) {
+            outfile = *it + ts::Names::COMPILED_SUFFIX;
+        }
+        else if (ts::IsDirectory(opt.outfile)) {
+            outfile = opt.outfile + ts::PathSeparator + ts::BaseName(*it) + ts::Names::COMPILED_SUFFIX;
+        }
+        else {
+            outfile = opt.outfile;
+        }
+        opt.verbose(u"compiling %s to %s", {*it, outfile});
+        success = ts::Names::Compile(*it, outfile, opt) && success;
+    }
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -35,6 +35,7 @@
 #include "tspInputExecutor.h"
 #include "tspOutputExecutor.h"
 #include "tspProcessorExecutor.h"
+#include "tspTelemetryMonitor.h"
 #include "tsPluginRepository.h"
 #include "tsAsyncReport.h"
 #include "tsSystemMonitor.h"
@@ -157,15 +158,15 @@ int main(int argc, char *argv[])
     // plugin has a hight priority to make room in the buffer, but not as
     // high as the input which must remain the top-most priority?
 
-    ts::tsp::InputExecutor* input = new ts::tsp::InputExecutor(&opt, &opt.input, ts::ThreadAttributes().setPriority(ts::ThreadAttributes::GetMaximumPriority()), global_mutex);
-    ts::tsp::OutputExecutor* output = new ts::tsp::OutputExecutor(&opt, &opt.output, ts::ThreadAttributes().setPriority(ts::ThreadAttributes::GetHighPriority()), global_mutex);
+    ts::tsp::InputExecutor* input = new ts::tsp::InputExecutor(&opt, &opt.input, opt.input.threadAttributes(ts::ThreadAttributes::GetMaximumPriority()), global_mutex);
+    ts::tsp::OutputExecutor* output = new ts::tsp::OutputExecutor(&opt, &opt.output, opt.output.threadAttributes(ts::ThreadAttributes::GetHighPriority()), global_mutex);
     output->ringInsertAfter(input);
 
     // Check if at least one plugin prefers real-time defaults.
     bool realtime = opt.realtime == ts::TRUE || input->isRealTime() || output->isRealTime();
 
     for (ts::tsp::Options::PluginOptionsVector::const_iterator it = opt.plugins.begin(); it != opt.plugins.end(); ++it) {
-        ts::tsp::PluginExecutor* p = new ts::tsp::ProcessorExecutor(&opt, &*it, ts::ThreadAttributes(), global_mutex);
+        ts::tsp::PluginExecutor* p = new ts::tsp::ProcessorExecutor(&opt, &*it, it->threadAttributes(ts::ThreadAttributes::GetNormalPriority()), global_mutex);
         p->ringInsertBefore(output);
         realtime = realtime || p->isRealTime();
     }
@@ -195,11 +196,15 @@ int main(int argc, char *argv[])
     } while ((proc = proc->ringNext<ts::tsp::PluginExecutor>()) != input);
 
     // Allocate a memory-resident buffer of TS packets
-    ts::ResidentBuffer<ts::TSPacket> packet_buffer(opt.bufsize / ts::PKT_SIZE);
+    ts::ResidentBuffer<ts::TSPacket> packet_buffer(opt.bufsize / ts::PKT_SIZE, opt.buffer_numa_node);
     if (!packet_buffer.isLocked()) {
         report.verbose(u"tsp: buffer failed to lock into physical memory (%d: %s), risk of real-time issue",
                        {packet_buffer.lockErrorCode(), ts::ErrorCodeMessage(packet_buffer.lockErrorCode())});
     }
+    if (packet_buffer.numaErrorCode() != ts::SYS_SUCCESS) {
+        report.warning(u"tsp: cannot allocate buffer on NUMA node %d (%d: %s)",
+                       {opt.buffer_numa_node, packet_buffer.numaErrorCode(), ts::ErrorCodeMessage(packet_buffer.numaErrorCode())});
+    }
     report.debug(u"tsp: buffer size: %'d TS packets, %'d bytes", {packet_buffer.count(), packet_buffer.count() * ts::PKT_SIZE});
 
     // Start all processors, except output, in reverse order (input last).
@@ -210,6 +215,13 @@ int main(int argc, char *argv[])
         }
     }
 
+    // Enable telemetry in all executors if required, before loading the buffer.
+    ts::tsp::TelemetryMonitor telemetry(opt, input, report);
+    const bool use_telemetry = ts::tsp::TelemetryMonitor::IsRequested(opt);
+    if (use_telemetry && !telemetry.open(packet_buffer.count())) {
+        return EXIT_FAILURE;
+    }
+
     // Initialize packet buffer in the ring of executors.
     // Exit application in case of error.
     if (!input->initAllBuffers(&packet_buffer)) {
@@ -231,6 +243,9 @@ int main(int argc, char *argv[])
     if (opt.monitor) {
         monitor.start();
     }
+    if (use_telemetry) {
+        telemetry.start();
+    }
 
     // Create all plugin executors threads.
     proc = input;
@@ -244,6 +259,9 @@ int main(int argc, char *argv[])
         proc->waitForTermination();
     } while ((proc = proc->ringNext<ts::tsp::PluginExecutor>()) != input);
 
+    // Send the final telemetry report before deallocating the executors.
+    telemetry.stop();
+
     // Deallocate all plugins and plugin executor
     bool last;
     proc = input;
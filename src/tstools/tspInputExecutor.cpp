@@ -33,10 +33,203 @@
 
 #include "tspInputExecutor.h"
 #include "tsPCRAnalyzer.h"
+#include "tsGuardCondition.h"
+#include "tsGuard.h"
+#include "tsMonotonic.h"
 #include "tsTime.h"
 TSDUCK_SOURCE;
 
 
+//----------------------------------------------------------------------------
+// Read-ahead thread of the input plugin (--prefetch-depth).
+// When enabled, the input plugin is invoked from this thread only. Packets
+// are received into a separate pool of page-aligned chunks, independently
+// of the free space in the global packet buffer. The input executor thread
+// moves the filled chunks into the global packet buffer.
+//----------------------------------------------------------------------------
+
+class ts::tsp::InputExecutor::Prefetcher : public Thread
+{
+public:
+    Prefetcher(InputExecutor* parent, const ThreadAttributes& attributes) :
+        Thread(attributes),
+        _parent(parent),
+        _chunk_size(parent->_options->prefetch_chunk),
+        _pool(parent->_options->prefetch_depth * parent->_options->prefetch_chunk, parent->_options->buffer_numa_node),
+        _counts(parent->_options->prefetch_depth, 0),
+        _mutex(),
+        _filled(),
+        _freed(),
+        _ready(0),
+        _bitrate(0),
+        _terminate(false),
+        _fill_index(0),
+        _read_index(0),
+        _read_offset(0),
+        _hits(0),
+        _misses(0),
+        _wait_time(0),
+        _max_wait(0)
+    {
+    }
+
+    virtual ~Prefetcher() override
+    {
+        terminate();
+    }
+
+    // Request termination of the thread and wait for it.
+    // If the plugin is currently blocked in receive(), wait for it to return.
+    void terminate()
+    {
+        {
+            GuardCondition lock(_mutex, _freed);
+            _terminate = true;
+            lock.signal();
+        }
+        waitForTermination();
+    }
+
+    // Last bitrate which was reported by the plugin, zero if unknown.
+    BitRate bitrate()
+    {
+        Guard lock(_mutex);
+        return _bitrate;
+    }
+
+    // Move prefetched packets into the global packet buffer. Wait only when
+    // no chunk is ready. Return the number of packets, zero at end of input.
+    size_t read(TSPacket* buffer, size_t max_packets)
+    {
+        // Wait for at least one filled chunk.
+        size_t ready = 0;
+        {
+            GuardCondition lock(_mutex, _filled);
+            if (_ready > 0) {
+                _hits++;
+            }
+            else {
+                _misses++;
+                Monotonic start;
+                start.getSystemTime();
+                while (_ready == 0) {
+                    lock.waitCondition();
+                }
+                Monotonic end;
+                end.getSystemTime();
+                const NanoSecond wait = end - start;
+                _wait_time += wait;
+                _max_wait = std::max(_max_wait, wait);
+            }
+            ready = _ready;
+        }
+
+        // Copy the filled chunks outside the mutex. They are not accessed
+        // by the prefetch thread until they are released. An empty chunk
+        // means end of input and is never released.
+        size_t count = 0;
+        size_t released = 0;
+        while (released < ready && count < max_packets && _counts[_read_index] > 0) {
+            const size_t chunk_count = _counts[_read_index];
+            const size_t size = std::min(chunk_count - _read_offset, max_packets - count);
+            TSPacket::Copy(buffer + count, _pool.base() + _read_index * _chunk_size + _read_offset, size);
+            count += size;
+            _read_offset += size;
+            if (_read_offset == chunk_count) {
+                _read_offset = 0;
+                _read_index = (_read_index + 1) % _counts.size();
+                released++;
+            }
+        }
+
+        // Give the consumed chunks back to the prefetch thread.
+        if (released > 0) {
+            GuardCondition lock(_mutex, _freed);
+            _ready -= released;
+            lock.signal();
+        }
+        return count;
+    }
+
+    // Report the prefetch statistics.
+    void reportStatistics()
+    {
+        Guard lock(_mutex);
+        const uint64_t total = _hits + _misses;
+        _parent->verbose(u"prefetch: %'d chunks of %'d packets, %'d hits, %'d misses (%d%% hits), wait time: %'d ms total, %'d ms max",
+                         {_counts.size(), _chunk_size, _hits, _misses, total == 0 ? 0 : (100 * _hits) / total,
+                          _wait_time / NanoSecPerMilliSec, _max_wait / NanoSecPerMilliSec});
+    }
+
+private:
+    InputExecutor*           _parent;
+    const size_t             _chunk_size;   // Size of a chunk in packets.
+    ResidentBuffer<TSPacket> _pool;         // All chunks, contiguous, page-aligned.
+    std::vector<size_t>      _counts;       // Number of packets in each filled chunk.
+    Mutex                    _mutex;        // Protect the fields below.
+    Condition                _filled;       // Signaled when a chunk is filled.
+    Condition                _freed;        // Signaled when a chunk is released or on termination.
+    size_t                   _ready;        // Number of filled chunks, starting at _read_index.
+    BitRate                  _bitrate;      // Last bitrate from the plugin.
+    bool                     _terminate;    // Termination requested.
+    size_t                   _fill_index;   // Next chunk to fill, accessed by prefetch thread only.
+    size_t                   _read_index;   // First filled chunk, accessed by input executor thread only.
+    size_t                   _read_offset;  // Packets already consumed in first filled chunk, same.
+    uint64_t                 _hits;         // Number of reads with a filled chunk immediately available.
+    uint64_t                 _misses;       // Number of reads which had to wait for the input plugin.
+    NanoSecond               _wait_time;    // Total wait time on misses.
+    NanoSecond               _max_wait;     // Maximum wait time on one miss.
+
+    virtual void main() override
+    {
+        const size_t max_packets = _parent->_options->max_input_pkt > 0 ? std::min(_chunk_size, _parent->_options->max_input_pkt) : _chunk_size;
+        Time bitrate_due_time(Time::CurrentUTC() + _parent->_options->bitrate_adj);
+
+        for (;;) {
+            // Wait for a free chunk.
+            {
+                GuardCondition lock(_mutex, _freed);
+                while (_ready >= _counts.size() && !_terminate) {
+                    lock.waitCondition();
+                }
+                if (_terminate) {
+                    break;
+                }
+            }
+
+            // Receive packets outside the mutex, the chunk is not yet visible to the consumer.
+            const size_t count = _parent->receiveAndStuff(_pool.base() + _fill_index * _chunk_size, max_packets);
+
+            // Get the plugin bitrate in this thread, next to receive().
+            BitRate bitrate = 0;
+            Time current_time;
+            if (_parent->_options->bitrate == 0 && (current_time = Time::CurrentUTC()) > bitrate_due_time) {
+                bitrate_due_time = current_time + _parent->_options->bitrate_adj;
+                bitrate = _parent->getBitrate();
+            }
+
+            // Publish the chunk. An empty chunk signals the end of input.
+            GuardCondition lock(_mutex, _filled);
+            _counts[_fill_index] = count;
+            _fill_index = (_fill_index + 1) % _counts.size();
+            _ready++;
+            if (bitrate > 0) {
+                _bitrate = bitrate;
+            }
+            lock.signal();
+            if (count == 0) {
+                break;
+            }
+        }
+    }
+
+    // Inaccessible operations
+    Prefetcher() = delete;
+    Prefetcher(const Prefetcher&) = delete;
+    Prefetcher& operator=(const Prefetcher&) = delete;
+};
+
+
 //----------------------------------------------------------------------------
 // Constructor
 //----------------------------------------------------------------------------
@@ -58,6 +251,18 @@ ts::tsp::InputExecutor::InputExecutor(Options* options,
 }
 
 
+//----------------------------------------------------------------------------
+// Set the input timestamp of received packets (telemetry).
+//----------------------------------------------------------------------------
+
+void ts::tsp::InputExecutor::stampPackets(size_t pkt_first, size_t pkt_cnt)
+{
+    if (_pkt_time != 0) {
+        std::fill(_pkt_time + pkt_first, _pkt_time + pkt_first + pkt_cnt, telemetryTime());
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Initializes the buffer for all plugin executors, starting at
 // this input executor. The buffer is pre-loaded with initial data.
@@ -76,6 +281,8 @@ bool ts::tsp::InputExecutor::initAllBuffers(PacketBuffer* buffer)
         return false; // receive error
     }
 
+    addTotalPackets(pkt_read);
+    stampPackets(0, pkt_read);
     debug(u"initial buffer load: %'d packets, %'d bytes", {pkt_read, pkt_read * PKT_SIZE});
 
     // Try to evaluate the initial input bitrate.
@@ -269,7 +476,6 @@ size_t ts::tsp::InputExecutor::receiveAndStuff(TSPacket* buffer, size_t max_pack
         }
     }
 
-    addTotalPackets(pkt_done);
     return pkt_done;
 }
 
@@ -281,6 +487,7 @@ size_t ts::tsp::InputExecutor::receiveAndStuff(TSPacket* buffer, size_t max_pack
 void ts::tsp::InputExecutor::main()
 {
     debug(u"input thread started");
+    reportSchedulingError();
 
     Time current_time(Time::CurrentUTC());
     Time bitrate_due_time(current_time + _options->bitrate_adj);
@@ -288,6 +495,19 @@ void ts::tsp::InputExecutor::main()
     bool input_end = false;
     bool aborted = false;
 
+    // With --prefetch-depth, the input plugin is invoked from a separate read-ahead thread.
+    Prefetcher* prefetcher = 0;
+    if (_options->prefetch_depth > 0) {
+        ThreadAttributes attributes;
+        getAttributes(attributes);
+        prefetcher = new Prefetcher(this, attributes);
+        if (!prefetcher->start()) {
+            error(u"cannot start input prefetch thread");
+            delete prefetcher;
+            prefetcher = 0;
+        }
+    }
+
     do {
         size_t pkt_first = 0;
         size_t pkt_max = 0;
@@ -313,7 +533,13 @@ void ts::tsp::InputExecutor::main()
 
         // Read from the plugin if not already terminated.
         if (!plugin_completed) {
-            pkt_read = receiveAndStuff(_buffer->base() + pkt_first, pkt_max);
+            if (prefetcher != 0) {
+                pkt_read = prefetcher->read(_buffer->base() + pkt_first, pkt_max);
+            }
+            else {
+                pkt_read = receiveAndStuff(_buffer->base() + pkt_first, pkt_max);
+            }
+            addTotalPackets(pkt_read);
             plugin_completed = pkt_read == 0;
         }
 
@@ -333,8 +559,8 @@ void ts::tsp::InputExecutor::main()
             // use a monotonic time (we use current time and not due time as
             // base for next calculation).
             bitrate_due_time = current_time + _options->bitrate_adj;
-            // Call shared library to get input bitrate
-            if ((bitrate = getBitrate()) > 0) {
+            // Call shared library to get input bitrate (or last bitrate from the prefetch thread).
+            if ((bitrate = prefetcher != 0 ? prefetcher->bitrate() : getBitrate()) > 0) {
                 // Keep this bitrate
                 _tsp_bitrate = bitrate;
                 if (debug()) {
@@ -344,10 +570,18 @@ void ts::tsp::InputExecutor::main()
         }
 
         // Pass received packets to next processor
+        stampPackets(pkt_first, pkt_read);
         passPackets(pkt_read, _tsp_bitrate, input_end, false);
 
     } while (!input_end);
 
+    // Terminate the prefetch thread before closing the plugin.
+    if (prefetcher != 0) {
+        prefetcher->terminate();
+        prefetcher->reportStatistics();
+        delete prefetcher;
+    }
+
     // Close the input processor
     _input->stop();
 
@@ -71,6 +71,9 @@ namespace ts {
             bool initAllBuffers(PacketBuffer* buffer);
 
         private:
+            // Read-ahead thread of the input plugin (--prefetch-depth).
+            class Prefetcher;
+
             InputPlugin*      _input;             // Plugin API
             PacketCounter     _total_in_packets;  // Total packets from plugin (exclude added stuffing)
             bool              _in_sync_lost;      // Input synchronization lost (no 0x47 at start of packet)
@@ -94,6 +97,9 @@ namespace ts {
             // taking into account the tsp input stuffing options.
             BitRate getBitrate();
 
+            // Set the input timestamp of received packets (telemetry).
+            void stampPackets(size_t pkt_first, size_t pkt_cnt);
+
             // Inaccessible operations
             InputExecutor() = delete;
             InputExecutor(const InputExecutor&) = delete;
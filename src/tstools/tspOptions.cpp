@@ -43,6 +43,10 @@ TSDUCK_SOURCE;
 #define DEF_MAX_FLUSH_PKT_RT    1000  // packets
 #define DEF_MAX_INPUT_PKT_OFL      0  // packets
 #define DEF_MAX_INPUT_PKT_RT    1000  // packets
+#define MAX_PARALLEL_THREADS      64  // threads
+#define MAX_PREFETCH_DEPTH        64  // chunks
+#define DEF_PREFETCH_CHUNK      1024  // packets (page-aligned chunks: 1024 * 188 = 47 * 4096)
+#define DEF_TELEMETRY_INTERVAL  1000  // milliseconds
 
 // Displayable names of plugin types.
 const ts::Enumeration ts::tsp::Options::PluginTypeNames({
@@ -51,6 +55,13 @@ const ts::Enumeration ts::tsp::Options::PluginTypeNames({
     {u"packet processor", ts::tsp::Options::PROCESSOR},
 });
 
+// Options for --scheduling.
+const ts::Enumeration ts::tsp::Options::SchedulingPolicyEnum({
+    {u"default", ts::ThreadAttributes::DEFAULT_POLICY},
+    {u"fifo",    ts::ThreadAttributes::FIFO_POLICY},
+    {u"rr",      ts::ThreadAttributes::RR_POLICY},
+});
+
 // Options for --list-processor.
 //!
 const ts::Enumeration ts::tsp::Options::ListProcessorEnum({
@@ -72,10 +83,19 @@ ts::tsp::Options::Options(int argc, char *argv[]) :
     monitor(false),
     ignore_jt(false),
     sync_log(false),
+    lock_free(false),
     bufsize(0),
     log_msg_count(AsyncReport::MAX_LOG_MESSAGES),
     max_flush_pkt(0),
     max_input_pkt(0),
+    prefetch_depth(0),
+    prefetch_chunk(DEF_PREFETCH_CHUNK),
+    par_threads(1),
+    buffer_numa_node(-1),
+    telemetry_file(),
+    telemetry_udp(),
+    telemetry_tcp(),
+    telemetry_interval(DEF_TELEMETRY_INTERVAL),
     instuff_nullpkt(0),
     instuff_inpkt(0),
     instuff_start(0),
@@ -92,16 +112,28 @@ ts::tsp::Options::Options(int argc, char *argv[]) :
     option(u"add-stop-stuffing",         0,  UNSIGNED);
     option(u"bitrate",                  'b', POSITIVE);
     option(u"bitrate-adjust-interval",   0,  POSITIVE);
+    option(u"buffer-numa-node",          0,  UNSIGNED);
     option(u"buffer-size-mb",            0,  POSITIVE);
+    option(u"cpu-affinity",              0,  STRING, 0, UNLIMITED_COUNT);
     option(u"ignore-joint-termination", 'i');
     option(u"list-processors",          'l', ListProcessorEnum, 0, 1, true);
+    option(u"lock-free-buffer",          0);
     option(u"log-message-count",         0,  POSITIVE);
     option(u"max-flushed-packets",       0,  POSITIVE);
     option(u"max-input-packets",         0,  POSITIVE);
     option(u"no-realtime-clock",         0); // was a temporary workaround, now ignored
+    option(u"numa-node",                 0,  STRING, 0, UNLIMITED_COUNT);
+    option(u"parallel-threads",          0,  INTEGER, 0, 1, 1, MAX_PARALLEL_THREADS);
+    option(u"prefetch-chunk",            0,  POSITIVE);
+    option(u"prefetch-depth",            0,  INTEGER, 0, 1, 0, MAX_PREFETCH_DEPTH);
     option(u"realtime",                 'r', TRISTATE, 0, 1, -255, 256, true);
     option(u"monitor",                  'm');
+    option(u"scheduling",                0,  STRING, 0, UNLIMITED_COUNT);
     option(u"synchronous-log",          's');
+    option(u"telemetry-file",            0,  STRING);
+    option(u"telemetry-interval",        0,  POSITIVE);
+    option(u"telemetry-tcp",             0,  STRING);
+    option(u"telemetry-udp",             0,  STRING);
     option(u"timed-log",                't');
 
 #if defined(TS_WINDOWS)
@@ -164,11 +196,24 @@ ts::tsp::Options::Options(int argc, char *argv[]) :
             u"      or modulator devices use it, while file devices ignore it.\n"
             u"      This option is ignored if --bitrate is specified.\n"
             u"\n"
+            u"  --buffer-numa-node node\n"
+            u"      Allocate the buffer of TS packets on the specified NUMA node. By default,\n"
+            u"      the memory placement of the buffer is left to the operating system.\n"
+            u"      Currently supported on Linux only.\n"
+            u"\n"
             u"  --buffer-size-mb value\n"
             u"      Specify the buffer size in mega-bytes. This is the size of\n"
             u"      the buffer between the input and output devices. The default\n"
             u"      is " TS_USTRINGIFY(DEF_BUFSIZE_MB) u" MB.\n"
             u"\n"
+            u"  --cpu-affinity plugin=cpu-list\n"
+            u"      Restrict the thread which executes the specified plugin to a list of CPU's.\n"
+            u"      The plugin is either \"input\", \"output\", the index of a packet processor\n"
+            u"      in the chain (starting at 1), a plugin name (all plugins with that name)\n"
+            u"      or \"all\". The CPU list is a comma-separated list of CPU indexes or ranges,\n"
+            u"      for instance \"0-3,8\". Several --cpu-affinity options may be specified.\n"
+            u"      Currently supported on Linux and Windows only.\n"
+            u"\n"
             u"  -d[N]\n"
             u"  --debug[=N]\n"
             u"      Produce debug output. Specify an optional debug level N.\n"
@@ -191,6 +236,15 @@ ts::tsp::Options::Options(int argc, char *argv[]) :
             u"  --list-processors\n"
             u"      List all available processors.\n"
             u"\n"
+            u"  --lock-free-buffer\n"
+            u"      Use lock-free synchronization between plugin threads when passing packets\n"
+            u"      in the global packet buffer. By default, all plugin threads synchronize\n"
+            u"      through one global mutex and condition variables. With this option, each\n"
+            u"      plugin publishes its packets to the next one using atomic counters and an\n"
+            u"      idle plugin spins for a short time before sleeping. This may reduce the\n"
+            u"      contention with long chains of plugins at high bitrates, at the expense\n"
+            u"      of some additional CPU usage.\n"
+            u"\n"
             u"  --log-message-count value\n"
             u"      Specify the maximum number of buffered log messages. Log messages are\n"
             u"      displayed asynchronously in a low priority thread. This value specifies\n"
@@ -219,6 +273,36 @@ ts::tsp::Options::Options(int argc, char *argv[]) :
             u"      This includes CPU load, virtual memory usage. Useful to verify the\n"
             u"      stability of the application.\n"
             u"\n"
+            u"  --numa-node plugin=node\n"
+            u"      Run the thread which executes the specified plugin on a NUMA node. The\n"
+            u"      memory which is allocated by the plugin is preferably taken from this node.\n"
+            u"      Without --cpu-affinity for the same plugin, the thread is also restricted\n"
+            u"      to the CPU's of this node. See --cpu-affinity for the plugin designation.\n"
+            u"      Several --numa-node options may be specified. Currently supported on Linux\n"
+            u"      only.\n"
+            u"\n"
+            u"  --parallel-threads count\n"
+            u"      Specify the number of threads which process packets in each data-parallel\n"
+            u"      packet processor plugin. Some stateless plugins such as pattern, or filter\n"
+            u"      and remap in some configurations, can process distinct packets or distinct\n"
+            u"      PID's concurrently. With this option, the packet window of each of these\n"
+            u"      plugins is split into several parts which are processed simultaneously.\n"
+            u"      The other plugins always use one single thread. The default is 1 (no\n"
+            u"      parallel processing). The maximum is " + UString::Decimal(MAX_PARALLEL_THREADS) + u" threads.\n"
+            u"\n"
+            u"  --prefetch-chunk count\n"
+            u"      With --prefetch-depth, specify the size in packets of each read-ahead\n"
+            u"      chunk. The default is " + UString::Decimal(DEF_PREFETCH_CHUNK) + u" packets. The size of a chunk is also\n"
+            u"      limited by --max-input-packets.\n"
+            u"\n"
+            u"  --prefetch-depth count\n"
+            u"      Receive input packets in advance, in a separate read-ahead thread, using\n"
+            u"      the specified number of chunks. The input plugin keeps reading while the\n"
+            u"      packet buffer is full, for instance during a transient slowdown of the\n"
+            u"      output. Use at least 2 chunks for double buffering. The prefetch hit and\n"
+            u"      miss statistics are reported at the end in verbose mode. The default is 0\n"
+            u"      (no read-ahead). The maximum is " + UString::Decimal(MAX_PREFETCH_DEPTH) + u" chunks.\n"
+            u"\n"
             u"  -r[value]\n"
             u"  --realtime[=value]\n"
             u"      Specifies if tsp and all plugins should use default values for real-time\n"
@@ -229,6 +313,14 @@ ts::tsp::Options::Options(int argc, char *argv[]) :
             u"      the offline defaults and the explicit values 'yes', 'true', 'on' are used\n"
             u"      to enforce the real-time defaults.\n"
             u"\n"
+            u"  --scheduling plugin=policy[:priority]\n"
+            u"      Use a real-time scheduling policy for the thread which executes the specified\n"
+            u"      plugin. The policy is one of " + SchedulingPolicyEnum.nameList() + u". The optional\n"
+            u"      priority is the real-time priority of the thread (typically from 1 to 99 on\n"
+            u"      Linux). The default is the lowest real-time priority. See --cpu-affinity for\n"
+            u"      the plugin designation. Several --scheduling options may be specified. This\n"
+            u"      usually requires privileges. Currently supported on UNIX systems only.\n"
+            u"\n"
             u"  -s\n"
             u"  --synchronous-log\n"
             u"      Each logged message is guaranteed to be displayed, synchronously, without\n"
@@ -239,6 +331,27 @@ ts::tsp::Options::Options(int argc, char *argv[]) :
             u"      live streams, when the responsiveness of the application is more important\n"
             u"      than the logged messages.\n"
             u"\n"
+            u"  --telemetry-file filename\n"
+            u"      Periodically append telemetry data in the specified file. Telemetry data\n"
+            u"      are JSON objects, one per line, containing, for each plugin, the number of\n"
+            u"      processed packets, the throughput, the time spent processing packets and\n"
+            u"      the time spent waiting for packets, the occupancy of the plugin's window\n"
+            u"      in the packet buffer. The output plugin also reports the distribution of\n"
+            u"      the latency of packets between input and output.\n"
+            u"\n"
+            u"  --telemetry-interval milliseconds\n"
+            u"      Interval between two telemetry reports. The default is " TS_USTRINGIFY(DEF_TELEMETRY_INTERVAL) u" milliseconds.\n"
+            u"\n"
+            u"  --telemetry-tcp address:port\n"
+            u"      Periodically send telemetry data to the specified TCP server, one JSON\n"
+            u"      object per line. The connection is reestablished when lost. See\n"
+            u"      --telemetry-file for a description of telemetry data.\n"
+            u"\n"
+            u"  --telemetry-udp address:port\n"
+            u"      Periodically send telemetry data to the specified UDP destination, one\n"
+            u"      JSON object per datagram. See --telemetry-file for a description of\n"
+            u"      telemetry data.\n"
+            u"\n"
             u"  -t\n"
             u"  --timed-log\n"
             u"      Each logged message contains a time stamp.\n"
@@ -308,11 +421,20 @@ ts::tsp::Options::Options(int argc, char *argv[]) :
     list_proc_flags = present(u"list-processors") ? intValue<int>(u"list-processors", PluginRepository::LIST_ALL) : 0;
     monitor = present(u"monitor");
     sync_log = present(u"synchronous-log");
+    lock_free = present(u"lock-free-buffer");
     bufsize = 1024 * 1024 * intValue<size_t>(u"buffer-size-mb", DEF_BUFSIZE_MB);
+    buffer_numa_node = intValue<int>(u"buffer-numa-node", -1);
     bitrate = intValue<BitRate>(u"bitrate", 0);
     bitrate_adj = MilliSecPerSec * intValue(u"bitrate-adjust-interval", DEF_BITRATE_INTERVAL);
     max_flush_pkt = intValue<size_t>(u"max-flushed-packets", 0);
     max_input_pkt = intValue<size_t>(u"max-input-packets", 0);
+    par_threads = intValue<size_t>(u"parallel-threads", 1);
+    prefetch_depth = intValue<size_t>(u"prefetch-depth", 0);
+    prefetch_chunk = intValue<size_t>(u"prefetch-chunk", DEF_PREFETCH_CHUNK);
+    telemetry_file = value(u"telemetry-file");
+    telemetry_udp = value(u"telemetry-udp");
+    telemetry_tcp = value(u"telemetry-tcp");
+    telemetry_interval = intValue<MilliSecond>(u"telemetry-interval", DEF_TELEMETRY_INTERVAL);
     instuff_start = intValue<size_t>(u"add-start-stuffing", 0);
     instuff_stop = intValue<size_t>(u"add-stop-stuffing", 0);
     log_msg_count = intValue<size_t>(u"log-message-count", AsyncReport::MAX_LOG_MESSAGES);
@@ -383,6 +505,48 @@ ts::tsp::Options::Options(int argc, char *argv[]) :
         opt->args.insert(opt->args.begin(), args.begin() + start + 2, args.begin() + plugin_index);
     }
 
+    // Execution attributes of the plugin threads, now that all plugins are known.
+    std::vector<std::vector<PluginOptions*>> selected;
+    UStringVector values;
+
+    getPluginValues(u"cpu-affinity", selected, values);
+    for (size_t i = 0; i < values.size(); ++i) {
+        ThreadAttributes::CPUSet cpus;
+        if (!ThreadAttributes::DecodeCPUSet(values[i], cpus)) {
+            error(u"invalid CPU list \"%s\" in --cpu-affinity", {values[i]});
+        }
+        for (size_t j = 0; j < selected[i].size(); ++j) {
+            selected[i][j]->cpus = cpus;
+        }
+    }
+
+    getPluginValues(u"numa-node", selected, values);
+    for (size_t i = 0; i < values.size(); ++i) {
+        int node = -1;
+        if (!values[i].toInteger(node) || node < 0) {
+            error(u"invalid NUMA node \"%s\" in --numa-node", {values[i]});
+        }
+        for (size_t j = 0; j < selected[i].size(); ++j) {
+            selected[i][j]->numa_node = node;
+        }
+    }
+
+    getPluginValues(u"scheduling", selected, values);
+    for (size_t i = 0; i < values.size(); ++i) {
+        UStringVector fields;
+        values[i].split(fields, u':');
+        int policy = SchedulingPolicyEnum.value(fields[0], false);
+        int priority = 0;
+        if (policy == Enumeration::UNKNOWN || fields.size() > 2 || (fields.size() == 2 && !fields[1].toInteger(priority))) {
+            error(u"invalid scheduling policy \"%s\", use policy[:priority], policy is one of %s", {values[i], SchedulingPolicyEnum.nameList()});
+            policy = ThreadAttributes::DEFAULT_POLICY;
+        }
+        for (size_t j = 0; j < selected[i].size(); ++j) {
+            selected[i][j]->sched_policy = ThreadAttributes::SchedulingPolicy(policy);
+            selected[i][j]->sched_priority = priority;
+        }
+    }
+
     // Debug display
     if (maxSeverity() >= 2) {
         display(std::cerr);
@@ -393,6 +557,66 @@ ts::tsp::Options::Options(int argc, char *argv[]) :
 }
 
 
+//----------------------------------------------------------------------------
+// Decode the values of a per-plugin option, in the form "plugin=value".
+//----------------------------------------------------------------------------
+
+void ts::tsp::Options::getPluginValues(const UChar* option, std::vector<std::vector<PluginOptions*>>& selected, UStringVector& values)
+{
+    const size_t count = this->count(option);
+    selected.resize(count);
+    values.resize(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        const UString val(value(option, u"", i));
+        const size_t equal = val.find(u'=');
+        const UString plugin(equal == UString::NPOS ? UString() : val.substr(0, equal));
+        size_t index = 0;
+
+        selected[i].clear();
+        values[i] = equal == UString::NPOS ? UString() : val.substr(equal + 1);
+
+        if (plugin.similar(u"all")) {
+            selected[i].push_back(&input);
+            for (size_t j = 0; j < plugins.size(); ++j) {
+                selected[i].push_back(&plugins[j]);
+            }
+            selected[i].push_back(&output);
+        }
+        else if (plugin.similar(u"input")) {
+            selected[i].push_back(&input);
+        }
+        else if (plugin.similar(u"output")) {
+            selected[i].push_back(&output);
+        }
+        else if (plugin.toInteger(index)) {
+            // Index of a packet processor, starting at 1.
+            if (index > 0 && index <= plugins.size()) {
+                selected[i].push_back(&plugins[index - 1]);
+            }
+        }
+        else if (!plugin.empty()) {
+            // All plugins with that name.
+            if (input.name == plugin) {
+                selected[i].push_back(&input);
+            }
+            for (size_t j = 0; j < plugins.size(); ++j) {
+                if (plugins[j].name == plugin) {
+                    selected[i].push_back(&plugins[j]);
+                }
+            }
+            if (output.name == plugin) {
+                selected[i].push_back(&output);
+            }
+        }
+
+        if (selected[i].empty()) {
+            error(u"invalid value \"%s\" for --%s, no such plugin, use \"plugin=value\"", {val, option});
+        }
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Apply default values to options which were not specified.
 //----------------------------------------------------------------------------
@@ -448,12 +672,21 @@ std::ostream& ts::tsp::Options::display(std::ostream& strm, int indent) const
          << margin << "  --bitrate: " << UString::Decimal(bitrate) << " b/s" << std::endl
          << margin << "  --bitrate-adjust-interval: " << UString::Decimal(bitrate_adj) << " milliseconds" << std::endl
          << margin << "  --buffer-size-mb: " << UString::Decimal(bufsize) << " bytes" << std::endl
+         << margin << "  --buffer-numa-node: " << buffer_numa_node << std::endl
          << margin << "  --debug: " << maxSeverity() << std::endl
          << margin << "  --list-processors: " << list_proc_flags << std::endl
+         << margin << "  --lock-free-buffer: " << lock_free << std::endl
          << margin << "  --max-flushed-packets: " << UString::Decimal(max_flush_pkt) << std::endl
          << margin << "  --max-input-packets: " << UString::Decimal(max_input_pkt) << std::endl
+         << margin << "  --parallel-threads: " << UString::Decimal(par_threads) << std::endl
+         << margin << "  --prefetch-chunk: " << UString::Decimal(prefetch_chunk) << " packets" << std::endl
+         << margin << "  --prefetch-depth: " << UString::Decimal(prefetch_depth) << " chunks" << std::endl
          << margin << "  --realtime: " << UString::TristateTrueFalse(realtime) << std::endl
          << margin << "  --monitor: " << monitor << std::endl
+         << margin << "  --telemetry-file: " << telemetry_file << std::endl
+         << margin << "  --telemetry-interval: " << UString::Decimal(telemetry_interval) << " milliseconds" << std::endl
+         << margin << "  --telemetry-tcp: " << telemetry_tcp << std::endl
+         << margin << "  --telemetry-udp: " << telemetry_udp << std::endl
          << margin << "  --verbose: " << verbose() << std::endl
          << margin << "  Number of packet processors: " << plugins.size() << std::endl
          << margin << "  Input plugin:" << std::endl;
@@ -475,11 +708,30 @@ std::ostream& ts::tsp::Options::display(std::ostream& strm, int indent) const
 ts::tsp::Options::PluginOptions::PluginOptions() :
     type(PROCESSOR),
     name(),
-    args()
+    args(),
+    cpus(),
+    numa_node(-1),
+    sched_policy(ThreadAttributes::DEFAULT_POLICY),
+    sched_priority(0)
 {
 }
 
 
+//----------------------------------------------------------------------------
+// Build the attributes of the thread which executes the plugin.
+//----------------------------------------------------------------------------
+
+ts::ThreadAttributes ts::tsp::Options::PluginOptions::threadAttributes(int priority) const
+{
+    ThreadAttributes attr;
+    attr.setPriority(priority);
+    attr.setAffinity(cpus);
+    attr.setNUMANode(numa_node);
+    attr.setSchedulingPolicy(sched_policy, sched_priority);
+    return attr;
+}
+
+
 //----------------------------------------------------------------------------
 // Display the content of the object to a stream
 //----------------------------------------------------------------------------
@@ -492,5 +744,18 @@ std::ostream& ts::tsp::Options::PluginOptions::display(std::ostream& strm, int i
     for (size_t i = 0; i < args.size(); ++i) {
         strm << margin << "Arg[" << i << "]: \"" << args[i] << "\"" << std::endl;
     }
+    if (!cpus.empty()) {
+        strm << margin << "CPU affinity:";
+        for (ThreadAttributes::CPUSet::const_iterator it = cpus.begin(); it != cpus.end(); ++it) {
+            strm << " " << *it;
+        }
+        strm << std::endl;
+    }
+    if (numa_node >= 0) {
+        strm << margin << "NUMA node: " << numa_node << std::endl;
+    }
+    if (sched_policy != ThreadAttributes::DEFAULT_POLICY) {
+        strm << margin << "Scheduling: " << SchedulingPolicyEnum.name(sched_policy) << ":" << sched_priority << std::endl;
+    }
     return strm;
 }
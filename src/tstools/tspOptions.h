@@ -34,6 +34,7 @@
 
 #pragma once
 #include "tsArgs.h"
+#include "tsThreadAttributes.h"
 
 namespace ts {
     //!
@@ -73,15 +74,26 @@ namespace ts {
             //!
             struct PluginOptions
             {
-                PluginType    type;  //!< Plugin type.
-                UString       name;  //!< Plugin name.
-                UStringVector args;  //!< Plugin options.
+                PluginType    type;            //!< Plugin type.
+                UString       name;            //!< Plugin name.
+                UStringVector args;            //!< Plugin options.
+                ThreadAttributes::CPUSet cpus; //!< CPU affinity of the plugin thread, empty means all CPU's.
+                int           numa_node;       //!< NUMA node of the plugin thread, negative means unspecified.
+                ThreadAttributes::SchedulingPolicy sched_policy;  //!< Scheduling policy of the plugin thread.
+                int           sched_priority;  //!< Real-time priority of the plugin thread.
 
                 //!
                 //! Default constructor.
                 //!
                 PluginOptions();
 
+                //!
+                //! Build the attributes of the thread which executes the plugin.
+                //! @param [in] priority Priority of the thread with the default scheduling policy.
+                //! @return The thread attributes, including CPU affinity, NUMA node and scheduling policy.
+                //!
+                ThreadAttributes threadAttributes(int priority) const;
+
                 //!
                 //! Display the content of this object to a stream.
                 //! @param [in,out] strm Where to output the content.
@@ -102,10 +114,19 @@ namespace ts {
             bool          monitor;         //!< Run a resource monitoring thread.
             bool          ignore_jt;       //!< Ignore "joint termination" options in plugins.
             bool          sync_log;        //!< Synchronous log.
+            bool          lock_free;       //!< Use lock-free synchronization on the packet buffer.
             size_t        bufsize;         //!< Buffer size.
             size_t        log_msg_count;   //!< Maximum buffered log messages.
             size_t        max_flush_pkt;   //!< Max processed packets before flush.
             size_t        max_input_pkt;   //!< Max packets per input operation.
+            size_t        prefetch_depth;  //!< Number of input read-ahead chunks, zero means no prefetch thread.
+            size_t        prefetch_chunk;  //!< Size in packets of an input read-ahead chunk.
+            size_t        par_threads;     //!< Number of processing threads for data-parallel packet processors.
+            int           buffer_numa_node;  //!< NUMA node of the packet buffer, negative means unspecified.
+            UString       telemetry_file;  //!< File where telemetry data are appended.
+            UString       telemetry_udp;   //!< UDP destination of telemetry data, "address:port".
+            UString       telemetry_tcp;   //!< TCP server of telemetry data, "address:port".
+            MilliSecond   telemetry_interval;  //!< Telemetry reporting interval.
             size_t        instuff_nullpkt; //!< Add input stuffing: add @a instuff_nullpkt null packets every @a instuff_inpkt input packets.
             size_t        instuff_inpkt;   //!< Add input stuffing: add @a instuff_nullpkt null packets every @a instuff_inpkt input packets.
             size_t        instuff_start;   //!< Add input stuffing: add @a instuff_start null packets before actual input.
@@ -141,6 +162,11 @@ namespace ts {
             //!
             static const Enumeration ListProcessorEnum;
 
+            //!
+            //! Options for -\-scheduling.
+            //!
+            static const Enumeration SchedulingPolicyEnum;
+
             //!
             //! Search the next plugin option.
             //! @param [in] args Arguments from command line.
@@ -149,6 +175,14 @@ namespace ts {
             //! @return Index of plugin option or @a args.size() if not found.
             //!
             static size_t nextProcOpt(const UStringVector& args, size_t index, PluginType& type);
+
+            //!
+            //! Decode the values of a per-plugin option, in the form "plugin=value".
+            //! @param [in] option Option name.
+            //! @param [out] selected For each value, the list of selected plugins.
+            //! @param [out] values The values, after the plugin selection.
+            //!
+            void getPluginValues(const UChar* option, std::vector<std::vector<PluginOptions*>>& selected, UStringVector& values);
         };
     }
 }
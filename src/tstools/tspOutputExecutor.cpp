@@ -57,6 +57,7 @@ ts::tsp::OutputExecutor::OutputExecutor(Options* options,
 void ts::tsp::OutputExecutor::main()
 {
     debug(u"output thread started");
+    reportSchedulingError();
 
     PacketCounter output_packets = 0;
     bool aborted;
@@ -110,6 +111,7 @@ void ts::tsp::OutputExecutor::main()
                     aborted = true;
                     break;
                 }
+                addTelemetryLatency(pkt - _buffer->base(), out_cnt);
                 pkt += out_cnt;
                 pkt_remain -= out_cnt;
                 output_packets += out_cnt;
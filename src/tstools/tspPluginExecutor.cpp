@@ -37,6 +37,29 @@
 #include "tsGuard.h"
 TSDUCK_SOURCE;
 
+#if defined(TS_LINUX)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+// Bounds of the adaptive spin count in lock-free mode.
+#define LF_SPIN_MIN     16
+#define LF_SPIN_MAX  16384
+
+// Timeout of a sleep on systems without futex. This is only a safety net,
+// normal wake-up is always signaled.
+#define LF_SLEEP_TIMEOUT 100  // milliseconds
+
+namespace {
+    // Hint to the CPU that we are in a spin loop.
+    inline void CpuRelax()
+    {
+#if defined(TS_GCC) && (defined(TS_I386) || defined(TS_X86_64))
+        __builtin_ia32_pause();
+#endif
+    }
+}
+
 
 //----------------------------------------------------------------------------
 // Constructor
@@ -52,12 +75,27 @@ ts::tsp::PluginExecutor::PluginExecutor(Options* options,
     _name(pl_options->name),
     _shlib(0),
     _buffer(0),
+    _pkt_time(0),
     _report(options),
     _to_do(),
     _pkt_first(0),
     _pkt_cnt(0),
     _input_end(false),
-    _bitrate(0)
+    _bitrate(0),
+    _lock_free(options->lock_free),
+    _lf_pushed(0),
+    _lf_popped(0),
+    _lf_end(false),
+    _lf_bitrate(0),
+    _lf_wake(0),
+    _lf_sleeping(false),
+    _lf_mutex(),
+    _lf_spin(LF_SPIN_MIN),
+    _tlm_origin(0),
+    _tlm_clock(),
+    _tlm_last(0),
+    _tlm_mutex(),
+    _tlm()
 {
     const UChar* shell = 0;
 
@@ -146,6 +184,75 @@ void ts::tsp::PluginExecutor::initBuffer(PacketBuffer* buffer,
     _tsp_aborting = aborted;
     _bitrate = bitrate;
     _tsp_bitrate = bitrate;
+    _lf_pushed = pkt_cnt;
+    _lf_popped = 0;
+    _lf_end = input_end;
+    _lf_bitrate = bitrate;
+}
+
+
+//----------------------------------------------------------------------------
+// Telemetry counters.
+//----------------------------------------------------------------------------
+
+ts::tsp::PluginExecutor::Telemetry::Telemetry() :
+    packets(0),
+    busy_time(0),
+    wait_time(0),
+    window_samples(0),
+    window_total(0),
+    window_max(0),
+    latency()
+{
+}
+
+void ts::tsp::PluginExecutor::enableTelemetry(const Monotonic* origin, NanoSecond* timestamps)
+{
+    _tlm_origin = origin;
+    _pkt_time = timestamps;
+    _tlm_last = telemetryTime();
+}
+
+void ts::tsp::PluginExecutor::getTelemetry(Telemetry& tlm)
+{
+    Guard lock(_tlm_mutex);
+    tlm = _tlm;
+    _tlm.window_max = 0;
+    _tlm.latency.reset();
+}
+
+ts::NanoSecond ts::tsp::PluginExecutor::telemetryTime()
+{
+    if (_tlm_origin == 0) {
+        return 0;
+    }
+    else {
+        _tlm_clock.getSystemTime();
+        return _tlm_clock - *_tlm_origin;
+    }
+}
+
+void ts::tsp::PluginExecutor::telemetryWait(NanoSecond start, size_t pkt_cnt)
+{
+    const NanoSecond end = telemetryTime();
+    Guard lock(_tlm_mutex);
+    _tlm.busy_time += start - _tlm_last;
+    _tlm.wait_time += end - start;
+    _tlm.window_samples++;
+    _tlm.window_total += pkt_cnt;
+    _tlm.window_max = std::max(_tlm.window_max, pkt_cnt);
+    _tlm_last = end;
+}
+
+void ts::tsp::PluginExecutor::addTelemetryLatency(size_t pkt_first, size_t pkt_cnt)
+{
+    if (_pkt_time != 0 && pkt_cnt > 0) {
+        const NanoSecond now = telemetryTime();
+        Guard lock(_tlm_mutex);
+        for (size_t i = pkt_first; i < pkt_first + pkt_cnt; ++i) {
+            _tlm.latency.add(uint64_t(std::max<NanoSecond>(0, now - _pkt_time[i]) / NanoSecPerMicroSec));
+        }
+    }
 }
 
 
@@ -180,14 +287,24 @@ void ts::tsp::PluginExecutor::passPackets(size_t count,     // of packets to pas
                                           bool aborted)     // set to current processor
 
 {
-    assert(count <= _pkt_cnt);
     assert(_pkt_first + count <= _buffer->count());
 
-    log(10, u"passPackets (count = %'d, bitrate = %'d, input_end = %'d, aborted = %'d)", {count, bitrate, input_end, aborted});
+    TS_LOG(*this, 10, u"passPackets (count = %'d, bitrate = %'d, input_end = %'d, aborted = %'d)", {count, bitrate, input_end, aborted});
+
+    if (_tlm_origin != 0) {
+        Guard lock(_tlm_mutex);
+        _tlm.packets = totalPackets();
+    }
+
+    if (_lock_free) {
+        passPacketsLockFree(count, bitrate, input_end, aborted);
+        return;
+    }
 
     // We access data under the protection of the global mutex.
 
     Guard lock(_global_mutex);
+    assert(count <= _pkt_cnt);
 
     // Update our buffer
 
@@ -210,18 +327,37 @@ void ts::tsp::PluginExecutor::passPackets(size_t count,     // of packets to pas
     // Wake the previous processor when we abort
 
     if (aborted) {
-        _tsp_aborting = true; // volatile bool in TSP superclass
+        _tsp_aborting = true; // atomic bool in TSP superclass
         ringPrevious<PluginExecutor>()->_to_do.signal();
     }
 }
 
 
+//----------------------------------------------------------------------------
+// Report an error on the execution attributes of the plugin thread.
+//----------------------------------------------------------------------------
+
+void ts::tsp::PluginExecutor::reportSchedulingError()
+{
+    const ErrorCode code = schedulingErrorCode();
+    if (code != SYS_SUCCESS) {
+        warning(u"cannot set CPU affinity, NUMA node or scheduling policy of the thread (%d: %s)", {code, ErrorCodeMessage(code)});
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // This method sets the current processor in an abort state.
 //----------------------------------------------------------------------------
 
 void ts::tsp::PluginExecutor::setAbort()
 {
+    if (_lock_free) {
+        _tsp_aborting = true;
+        ringPrevious<PluginExecutor>()->wakeUpLockFree();
+        return;
+    }
+
     Guard lock(_global_mutex);
     _tsp_aborting = true;
     ringPrevious<PluginExecutor>()->_to_do.signal();
@@ -242,8 +378,35 @@ void ts::tsp::PluginExecutor::waitWork(size_t& pkt_first,
                                        bool& input_end,
                                        bool& aborted)    // get from next processor
 {
-    log(10, u"waitWork(...)");
+    TS_LOG(*this, 10, u"waitWork(...)");
+
+    const NanoSecond start = telemetryTime();
+
+    if (_lock_free) {
+        waitWorkLockFree(pkt_first, pkt_cnt, bitrate, input_end, aborted);
+    }
+    else {
+        waitWorkLocked(pkt_first, pkt_cnt, bitrate, input_end, aborted);
+    }
+
+    if (_tlm_origin != 0) {
+        telemetryWait(start, pkt_cnt);
+    }
+
+    TS_LOG(*this, 10, u"waitWork (pkt_first = %'d, pkt_cnt = %'d, bitrate = %'d, input_end = %'d, aborted = %'d)", {pkt_first, pkt_cnt, bitrate, input_end, aborted});
+}
+
 
+//----------------------------------------------------------------------------
+// Wait for something to do, using the global mutex.
+//----------------------------------------------------------------------------
+
+void ts::tsp::PluginExecutor::waitWorkLocked(size_t& pkt_first,
+                                             size_t& pkt_cnt,
+                                             BitRate& bitrate,
+                                             bool& input_end,
+                                             bool& aborted)
+{
     // We access data under the protection of the global mutex.
 
     GuardCondition lock(_global_mutex, _to_do);
@@ -263,6 +426,131 @@ void ts::tsp::PluginExecutor::waitWork(size_t& pkt_first,
     bitrate = _bitrate;
     input_end = _input_end && pkt_cnt == _pkt_cnt;
     aborted = ringNext<PluginExecutor>()->_tsp_aborting;
+}
+
 
-    log(10, u"waitWork (pkt_first = %'d, pkt_cnt = %'d, bitrate = %'d, input_end = %'d, aborted = %'d)", {pkt_first, pkt_cnt, bitrate, input_end, aborted});
+//----------------------------------------------------------------------------
+// Lock-free version of passPackets().
+// Our own area is accessed by this thread only. The area of the next
+// processor is published using atomic variables which are written by
+// this thread only (single producer / single consumer).
+//----------------------------------------------------------------------------
+
+void ts::tsp::PluginExecutor::passPacketsLockFree(size_t count, BitRate bitrate, bool input_end, bool aborted)
+{
+    assert(_lf_popped + count <= _lf_pushed.load(std::memory_order_acquire));
+
+    // Update our buffer.
+    _pkt_first = (_pkt_first + count) % _buffer->count();
+    _lf_popped += count;
+
+    // Update next processor's buffer. The bitrate is published before the
+    // packets and the end of input after the packets so that the next
+    // processor never sees an end of input before the last packets.
+    PluginExecutor* next = ringNext<PluginExecutor>();
+    next->_lf_bitrate.store(bitrate, std::memory_order_relaxed);
+    next->_lf_pushed.store(next->_lf_pushed.load(std::memory_order_relaxed) + count, std::memory_order_release);
+    if (input_end) {
+        next->_lf_end.store(true, std::memory_order_release);
+    }
+
+    // Wake the next processor when there is some data.
+    if (count > 0 || input_end) {
+        next->wakeUpLockFree();
+    }
+
+    // Wake the previous processor when we abort.
+    if (aborted) {
+        _tsp_aborting = true; // atomic bool in TSP superclass
+        ringPrevious<PluginExecutor>()->wakeUpLockFree();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Lock-free mode: check if there is something to do for this thread.
+//----------------------------------------------------------------------------
+
+bool ts::tsp::PluginExecutor::hasWorkLockFree()
+{
+    return _lf_end.load(std::memory_order_acquire) ||
+        _lf_pushed.load(std::memory_order_acquire) != _lf_popped ||
+        ringNext<PluginExecutor>()->_tsp_aborting;
+}
+
+
+//----------------------------------------------------------------------------
+// Lock-free mode: wake up the thread of this processor.
+// Invoked from the previous or next processor thread.
+//----------------------------------------------------------------------------
+
+void ts::tsp::PluginExecutor::wakeUpLockFree()
+{
+    // The atomic increment is a full memory barrier. Either the sleeping thread
+    // sees our updates when it rechecks its condition after declaring itself
+    // as sleeping or we see it sleeping here.
+    _lf_wake.fetch_add(1);
+
+    if (_lf_sleeping.load()) {
+#if defined(TS_LINUX)
+        ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&_lf_wake), FUTEX_WAKE_PRIVATE, 1, 0, 0, 0);
+#else
+        Guard lock(_lf_mutex);
+        _to_do.signal();
+#endif
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Lock-free version of waitWork().
+//----------------------------------------------------------------------------
+
+void ts::tsp::PluginExecutor::waitWorkLockFree(size_t& pkt_first, size_t& pkt_cnt, BitRate& bitrate, bool& input_end, bool& aborted)
+{
+    // First, spin for a while. The spin limit adapts to the load: it grows
+    // when work arrives while spinning and shrinks when we need to sleep.
+    size_t spin = 0;
+    while (spin < _lf_spin && !hasWorkLockFree()) {
+        CpuRelax();
+        spin++;
+    }
+    if (spin < _lf_spin) {
+        _lf_spin = std::min<size_t>(2 * _lf_spin, LF_SPIN_MAX);
+    }
+    else {
+        _lf_spin = std::max<size_t>(_lf_spin / 2, LF_SPIN_MIN);
+    }
+
+    // Then sleep until something to do.
+    for (;;) {
+        const uint32_t seq = _lf_wake.load();
+        if (hasWorkLockFree()) {
+            break;
+        }
+        _lf_sleeping.store(true);
+        // Recheck after declaring ourselves as sleeping, see wakeUpLockFree().
+        if (!hasWorkLockFree()) {
+#if defined(TS_LINUX)
+            // The futex returns immediately if the wake-up sequence has changed.
+            ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&_lf_wake), FUTEX_WAIT_PRIVATE, seq, 0, 0, 0);
+#else
+            GuardCondition lock(_lf_mutex, _to_do);
+            if (_lf_wake.load() == seq) {
+                lock.waitCondition(LF_SLEEP_TIMEOUT);
+            }
+#endif
+        }
+        _lf_sleeping.store(false);
+    }
+
+    // Read the end of input before the number of packets, see passPacketsLockFree().
+    const bool end = _lf_end.load(std::memory_order_acquire);
+    const size_t count = size_t(_lf_pushed.load(std::memory_order_acquire) - _lf_popped);
+
+    pkt_first = _pkt_first;
+    pkt_cnt = std::min(count, _buffer->count() - _pkt_first);
+    bitrate = _lf_bitrate.load(std::memory_order_relaxed);
+    input_end = end && pkt_cnt == count;
+    aborted = ringNext<PluginExecutor>()->_tsp_aborting;
 }
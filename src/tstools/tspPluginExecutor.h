@@ -37,6 +37,8 @@
 #include "tspJointTermination.h"
 #include "tsPlugin.h"
 #include "tsResidentBuffer.h"
+#include "tsLatencyHistogram.h"
+#include "tsMonotonic.h"
 #include "tsUserInterrupt.h"
 #include "tsRingNode.h"
 #include "tsCondition.h"
@@ -95,6 +97,18 @@ namespace ts {
         //!  window of the next processor), it must notify the _to_do condition variable
         //!  of the next thread.
         //!
+        //!  Alternatively, when the tsp option -\-lock-free-buffer is specified,
+        //!  the global mutex is not used to pass packets from one processor to the
+        //!  next one. Each sliding window is then described by a monotonic counter
+        //!  of packets which were pushed into it by the previous processor (updated
+        //!  by the previous processor only) and a local counter of packets which were
+        //!  passed to the next processor (updated by the owning processor only). The
+        //!  number of packets in the window is the difference between the two. Since
+        //!  each counter has exactly one writer, atomic loads and stores are sufficient.
+        //!  An idle processor first spins for a short, adaptive, time on its window
+        //!  before sleeping on a futex (or on its "_to_do" condition variable on
+        //!  operating systems without futex).
+        //!
         //!  When a packet processor decides to drop a packet, the synchronization
         //!  byte (first byte of the packet, normally 0x47) is reset to zero. When
         //!  a packet processor or the output processor encounters a packet starting
@@ -164,6 +178,46 @@ namespace ts {
                             bool          aborted,
                             BitRate       bitrate);
 
+            //!
+            //! Telemetry counters of a plugin executor.
+            //!
+            class Telemetry
+            {
+            public:
+                PacketCounter    packets;        //!< Total number of packets which were processed.
+                NanoSecond       busy_time;      //!< Time spent outside waitWork() (receive, process or send packets).
+                NanoSecond       wait_time;      //!< Time spent waiting for packets in waitWork().
+                uint64_t         window_samples; //!< Number of samples of the sliding window size.
+                uint64_t         window_total;   //!< Sum of all samples of the sliding window size, in packets.
+                size_t           window_max;     //!< Maximum sliding window size, in packets.
+                LatencyHistogram latency;        //!< Latency in microseconds from input to output (output plugin only).
+
+                //!
+                //! Constructor.
+                //!
+                Telemetry();
+            };
+
+            //!
+            //! Enable the collection of telemetry counters.
+            //! Must be executed in synchronous environment, before starting all executor threads.
+            //! @param [in] origin Common time origin of all plugin executors.
+            //! @param [in,out] timestamps Array of input timestamps, relative to @a origin,
+            //! with one element per packet in the buffer. Common to all plugin executors.
+            //!
+            void enableTelemetry(const Monotonic* origin, NanoSecond* timestamps);
+
+            //!
+            //! Get a snapshot of the telemetry counters.
+            //! Can be called from any thread when telemetry is enabled.
+            //! The packet counter, the busy and wait times and the window samples are
+            //! cumulative since the start of the plugin. The maximum window size and the
+            //! latency histogram are reset after each call: they describe the period
+            //! since the previous call.
+            //! @param [out] tlm Returned telemetry counters.
+            //!
+            void getTelemetry(Telemetry& tlm);
+
             //!
             //! Change the report method.
             //! @param [in] rep Address of new report instance.
@@ -194,6 +248,15 @@ namespace ts {
             //!
             static const size_t STACK_SIZE_OVERHEAD = 32 * 1024; // 32 kB
 
+            //!
+            //! Get the plugin name.
+            //! @return The plugin name.
+            //!
+            const UString& pluginName() const
+            {
+                return _name;
+            }
+
             //!
             //! Access the shared library API.
             //! @return Address of the plugin interface.
@@ -217,6 +280,33 @@ namespace ts {
             Plugin*       _shlib;  //!< Shared library API.
             PacketBuffer* _buffer; //!< Description of shared packet buffer.
 
+            //!
+            //! Input timestamps of the packets in the buffer, relative to the telemetry origin.
+            //! Null when telemetry is disabled.
+            //!
+            NanoSecond* _pkt_time;
+
+            //!
+            //! Get the current time for telemetry purposes.
+            //! @return The current time, in nanoseconds, relative to the telemetry origin.
+            //!
+            NanoSecond telemetryTime();
+
+            //!
+            //! Record the latency of output packets in the telemetry counters.
+            //! Must be invoked from the plugin thread.
+            //! @param [in] pkt_first Index of first output packet in the buffer.
+            //! @param [in] pkt_cnt Number of output packets.
+            //!
+            void addTelemetryLatency(size_t pkt_first, size_t pkt_cnt);
+
+            //!
+            //! Report an error if the CPU affinity, NUMA node or scheduling policy
+            //! of the plugin thread could not be applied.
+            //! Must be invoked from the plugin thread.
+            //!
+            void reportSchedulingError();
+
             //!
             //! Pass processed packets to the next packet processor.
             //! This method is invoked by a subclass to indicate that some packets
@@ -261,12 +351,48 @@ namespace ts {
             Condition _to_do;    // Notify processor to do something
 
             // The following private data must be accessed exclusively under the
-            // protection of the global mutex.
+            // protection of the global mutex (or by the owning thread only with
+            // a lock-free buffer).
             size_t  _pkt_first;  // Starting index of packets area
             size_t  _pkt_cnt;    // Size of packets area
             bool    _input_end;  // No more packet after current ones
             BitRate _bitrate;    // Input bitrate (set by previous plugin)
 
+            // Lock-free synchronization of the packet buffer (--lock-free-buffer).
+            // The "pushed" fields are written by the previous plugin only, the "popped"
+            // counter and the spin limit are used by the owning thread only.
+            bool                     _lock_free;   // Use lock-free synchronization.
+            std::atomic<uint64_t>    _lf_pushed;   // Total packets pushed into our area by previous plugin.
+            uint64_t                 _lf_popped;   // Total packets passed to next plugin.
+            std::atomic<bool>        _lf_end;      // No more packet after pushed ones.
+            std::atomic<BitRate>     _lf_bitrate;  // Input bitrate (set by previous plugin).
+            std::atomic<uint32_t>    _lf_wake;     // Wake-up sequence (futex word).
+            std::atomic<bool>        _lf_sleeping; // Owning thread is about to sleep or sleeping.
+            Mutex                    _lf_mutex;    // Sleep mutex on systems without futex.
+            size_t                   _lf_spin;     // Current adaptive spin limit.
+
+            // Telemetry (--telemetry-*). The counters are updated by the owning thread
+            // and read by the telemetry thread, under the protection of _tlm_mutex.
+            const Monotonic* _tlm_origin;  // Common time origin, null if telemetry is disabled.
+            Monotonic        _tlm_clock;   // Clock to read the current time.
+            NanoSecond       _tlm_last;    // Last exit time from waitWork().
+            Mutex            _tlm_mutex;   // Protect _tlm.
+            Telemetry        _tlm;         // Telemetry counters.
+
+            // Update the telemetry counters after a waitWork() operation.
+            void telemetryWait(NanoSecond start, size_t pkt_cnt);
+
+            // Version of waitWork() using the global mutex.
+            void waitWorkLocked(size_t& pkt_first, size_t& pkt_cnt, BitRate& bitrate, bool& input_end, bool& aborted);
+
+            // Lock-free versions of passPackets() and waitWork().
+            void passPacketsLockFree(size_t count, BitRate bitrate, bool input_end, bool aborted);
+            void waitWorkLockFree(size_t& pkt_first, size_t& pkt_cnt, BitRate& bitrate, bool& input_end, bool& aborted);
+
+            // Lock-free mode: check if there is something to do, wake up the thread.
+            bool hasWorkLockFree();
+            void wakeUpLockFree();
+
             // Inaccessible operations.
             PluginExecutor() = delete;
             PluginExecutor(const PluginExecutor&) = delete;
@@ -32,8 +32,95 @@
 //----------------------------------------------------------------------------
 
 #include "tspProcessorExecutor.h"
+#include "tsGuardCondition.h"
+#include "tsGuard.h"
 TSDUCK_SOURCE;
 
+// Packets which are not processed by any thread in a PARALLEL_PID job.
+#define NO_PART 0xFF
+
+// Minimum number of packets per thread to use parallel processing.
+// With fewer packets, thread synchronization costs more than processing.
+#define MIN_PARALLEL_PACKETS 32
+
+
+//----------------------------------------------------------------------------
+// Additional processing thread for data-parallel plugins.
+//----------------------------------------------------------------------------
+
+class ts::tsp::ProcessorExecutor::Worker : public Thread
+{
+public:
+    Worker(ProcessorExecutor* parent, size_t part, const ThreadAttributes& attributes) :
+        Thread(attributes),
+        _parent(parent),
+        _part(part),
+        _todo(),
+        _pending(false),
+        _terminate(false)
+    {
+    }
+
+    // Start a new job, must be called with the parent's _par_mutex held.
+    void startJob()
+    {
+        _pending = true;
+        _todo.signal();
+    }
+
+    // Request termination of the thread and wait for it.
+    void terminate()
+    {
+        {
+            GuardCondition lock(_parent->_par_mutex, _todo);
+            _terminate = true;
+            lock.signal();
+        }
+        waitForTermination();
+    }
+
+private:
+    ProcessorExecutor* _parent;
+    size_t             _part;       // Part of each job which is assigned to this thread.
+    Condition          _todo;       // Signaled when a new job is available.
+    bool               _pending;    // A new job is available.
+    bool               _terminate;  // Termination requested.
+
+    virtual void main() override
+    {
+        for (;;) {
+            // Wait for a new job.
+            {
+                GuardCondition lock(_parent->_par_mutex, _todo);
+                while (!_pending && !_terminate) {
+                    lock.waitCondition();
+                }
+                if (_terminate) {
+                    break;
+                }
+                _pending = false;
+            }
+
+            // Process our part of the job, outside the mutex.
+            bool bitrate_changed = false;
+            _parent->processPart(_part, bitrate_changed);
+
+            // Report completion of our part.
+            GuardCondition lock(_parent->_par_mutex, _parent->_par_done);
+            _parent->_par_bitrate = _parent->_par_bitrate || bitrate_changed;
+            assert(_parent->_par_pending > 0);
+            if (--_parent->_par_pending == 0) {
+                lock.signal();
+            }
+        }
+    }
+
+    // Inaccessible operations
+    Worker() = delete;
+    Worker(const Worker&) = delete;
+    Worker& operator=(const Worker&) = delete;
+};
+
 
 //----------------------------------------------------------------------------
 // Constructor
@@ -45,8 +132,140 @@ ts::tsp::ProcessorExecutor::ProcessorExecutor(Options* options,
                                               Mutex& global_mutex) :
 
     PluginExecutor(options, pl_options, attributes, global_mutex),
-    _processor(dynamic_cast<ProcessorPlugin*>(_shlib))
+    _processor(dynamic_cast<ProcessorPlugin*>(_shlib)),
+    _parallelism(ProcessorPlugin::PARALLEL_NONE),
+    _workers(),
+    _par_mutex(),
+    _par_done(),
+    _par_pending(0),
+    _par_bitrate(false),
+    _par_pkt(0),
+    _par_status(0),
+    _par_count(0),
+    _par_part()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Start and stop the worker threads for data-parallel plugins.
+//----------------------------------------------------------------------------
+
+void ts::tsp::ProcessorExecutor::startWorkers()
+{
+    // The plugin is already started, its parallelism may depend on its options.
+    _parallelism = _options->par_threads > 1 ? _processor->getParallelism() : ProcessorPlugin::PARALLEL_NONE;
+
+    if (_parallelism != ProcessorPlugin::PARALLEL_NONE) {
+        // The current thread processes the first part of each job, the workers the other parts.
+        ThreadAttributes attr;
+        getAttributes(attr);
+        for (size_t part = 1; part < _options->par_threads; ++part) {
+            Worker* worker = new Worker(this, part, attr);
+            if (!worker->start()) {
+                delete worker;
+                break;
+            }
+            _workers.push_back(worker);
+        }
+        debug(u"using %d threads for %s data-parallel processing", {_workers.size() + 1, _parallelism == ProcessorPlugin::PARALLEL_PID ? u"per-PID" : u"per-packet"});
+    }
+    else if (_options->par_threads > 1) {
+        debug(u"plugin is not data-parallel, using one processing thread");
+    }
+}
+
+void ts::tsp::ProcessorExecutor::stopWorkers()
+{
+    for (WorkerVector::iterator it = _workers.begin(); it != _workers.end(); ++it) {
+        (*it)->terminate();
+        delete *it;
+    }
+    _workers.clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Process a range of packets in parallel, using all workers.
+//----------------------------------------------------------------------------
+
+bool ts::tsp::ProcessorExecutor::processParallel(TSPacket* pkt, ProcessorPlugin::Status* status, size_t count)
 {
+    const size_t parts = _workers.size() + 1;
+
+    // With PARALLEL_PID, assign packets to threads before starting the job.
+    // The workers may modify the PID of their packets while others are still
+    // looking for their own packets.
+    if (_parallelism == ProcessorPlugin::PARALLEL_PID) {
+        _par_part.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            _par_part[i] = pkt[i].b[0] == 0 ? NO_PART : uint8_t(pkt[i].getPID() % parts);
+        }
+    }
+
+    // Publish the job to all workers.
+    {
+        Guard lock(_par_mutex);
+        _par_pkt = pkt;
+        _par_status = status;
+        _par_count = count;
+        _par_pending = _workers.size();
+        _par_bitrate = false;
+        for (WorkerVector::iterator it = _workers.begin(); it != _workers.end(); ++it) {
+            (*it)->startJob();
+        }
+    }
+
+    // Process the first part in the current thread.
+    bool bitrate_changed = false;
+    processPart(0, bitrate_changed);
+
+    // Wait for completion of all other parts.
+    GuardCondition lock(_par_mutex, _par_done);
+    while (_par_pending > 0) {
+        lock.waitCondition();
+    }
+    return bitrate_changed || _par_bitrate;
+}
+
+
+//----------------------------------------------------------------------------
+// Process the part of a parallel job which is assigned to one thread.
+//----------------------------------------------------------------------------
+
+void ts::tsp::ProcessorExecutor::processPart(size_t part, bool& bitrate_changed)
+{
+    const bool per_pid = _parallelism == ProcessorPlugin::PARALLEL_PID;
+    const size_t parts = _workers.size() + 1;
+    TSPacket* const pkt = _par_pkt;
+    ProcessorPlugin::Status* const status = _par_status;
+
+    // With PARALLEL_PACKET, each thread processes a contiguous sub-range.
+    size_t index = per_pid ? 0 : (_par_count * part) / parts;
+    const size_t end = per_pid ? _par_count : (_par_count * (part + 1)) / parts;
+
+    while (index < end) {
+        // Skip packets which were dropped by a previous packet processor or belong to another thread.
+        if (per_pid ? _par_part[index] != part : pkt[index].b[0] == 0) {
+            index++;
+            continue;
+        }
+
+        // Apply the processing routine to a contiguous range of packets.
+        size_t count = 1;
+        while (index + count < end && (per_pid ? _par_part[index + count] == part : pkt[index + count].b[0] != 0)) {
+            count++;
+        }
+        bool flush = false;
+        const size_t done = _processor->processPacketBatch(pkt + index, status + index, count, flush, bitrate_changed);
+        assert(done > 0 && done <= count);
+        index += done;
+
+        // All subsequent packets are ignored after end of processing.
+        if (status[index - 1] == ProcessorPlugin::TSP_END) {
+            break;
+        }
+    }
 }
 
 
@@ -57,6 +276,7 @@ ts::tsp::ProcessorExecutor::ProcessorExecutor(Options* options,
 void ts::tsp::ProcessorExecutor::main()
 {
     debug(u"packet processing thread started");
+    reportSchedulingError();
 
     PacketCounter passed_packets = 0;
     PacketCounter dropped_packets = 0;
@@ -66,6 +286,12 @@ void ts::tsp::ProcessorExecutor::main()
     bool input_end = false;
     bool aborted = false;
 
+    // Processing status of the packets in a batch.
+    std::vector<ProcessorPlugin::Status> status;
+
+    // Start additional processing threads if the plugin is data-parallel.
+    startWorkers();
+
     do {
         // Wait for packets to process
 
@@ -106,65 +332,101 @@ void ts::tsp::ProcessorExecutor::main()
             bool flush_request = false;
             TSPacket* pkt = _buffer->base() + pkt_first + pkt_done;
 
-            pkt_done++;
-            pkt_flush++;
+            // Do not process more packets than the next periodic flush.
+            size_t pkt_max = pkt_cnt - pkt_done;
+            if (_options->max_flush_pkt > 0) {
+                pkt_max = std::min(pkt_max, _options->max_flush_pkt - pkt_flush);
+            }
+
+            size_t drop_cnt = 0;
+            size_t proc_cnt = 0;
+            bool bitrate_changed = false;
+
+            if (!_workers.empty() && pkt_max >= MIN_PARALLEL_PACKETS * (_workers.size() + 1)) {
+                // Data-parallel plugin: process all packets up to the next flush using all threads.
+                // Packets which were already dropped by a previous packet processor are skipped.
+                proc_cnt = pkt_max;
+                if (status.size() < proc_cnt) {
+                    status.resize(proc_cnt);
+                }
+                bitrate_changed = processParallel(pkt, &status[0], proc_cnt);
+            }
+            else {
+                // Skip packets which were already dropped by a previous packet processor.
+                while (drop_cnt < pkt_max && pkt[drop_cnt].b[0] == 0) {
+                    drop_cnt++;
+                }
 
-            // If the packet has not already been dropped by a previous
-            // packet processor, apply the processing routine to the packet
+                // Apply the processing routine to a contiguous range of non-dropped packets.
+                if (drop_cnt == 0) {
 
-            if (pkt->b[0] != 0) {
+                    size_t batch_cnt = 1;
+                    while (batch_cnt < pkt_max && pkt[batch_cnt].b[0] != 0) {
+                        batch_cnt++;
+                    }
+                    if (status.size() < batch_cnt) {
+                        status.resize(batch_cnt);
+                    }
 
-                bool bitrate_changed = false;
-                ProcessorPlugin::Status status = _processor->processPacket (*pkt, flush_request, bitrate_changed);
+                    proc_cnt = _processor->processPacketBatch(pkt, &status[0], batch_cnt, flush_request, bitrate_changed);
+                    assert(proc_cnt > 0 && proc_cnt <= batch_cnt);
+                }
+            }
 
-                // Use the returned status
-                switch (status) {
+            // Use the returned status, in packet order.
+            for (size_t i = 0; i < proc_cnt; ++i) {
+                if (pkt[i].b[0] == 0) {
+                    // Dropped by a previous packet processor, not processed (parallel processing only).
+                    continue;
+                }
+                switch (status[i]) {
                     case ProcessorPlugin::TSP_OK:
                         // Normal case, pass packet
                         passed_packets++;
                         break;
                     case ProcessorPlugin::TSP_NULL:
                         // Replace the packet with a complete null packet
-                        *pkt = NullPacket;
+                        pkt[i] = NullPacket;
                         nullified_packets++;
                         break;
                     case ProcessorPlugin::TSP_DROP:
                         // Drop this packet.
-                        pkt->b[0] = 0;
+                        pkt[i].b[0] = 0;
                         dropped_packets++;
                         break;
                     case ProcessorPlugin::TSP_END:
-                        // Signal end of input to successors and abort
-                        // to predecessors
+                        // Signal end of input to successors and abort to predecessors.
+                        // This is always the last packet of the batch, it is not passed.
                         input_end = aborted = true;
-                        pkt_done--;
-                        pkt_flush--;
-                        pkt_cnt = pkt_done;
+                        proc_cnt = i;
+                        pkt_cnt = pkt_done + proc_cnt;
                         break;
                     default:
                         // Invalid status, report error and accept packet.
-                        error(u"invalid packet processing status %d", {status});
+                        error(u"invalid packet processing status %d", {status[i]});
                         break;
                 }
+            }
 
-                // If the packet processor has signaled a new bitrate, get it.
-                if (bitrate_changed) {
-                    BitRate new_bitrate = _processor->getBitrate();
-                    if (new_bitrate != 0) {
-                        bitrate_never_modified = false;
-                        output_bitrate = new_bitrate;
-                    }
+            // If the packet processor has signaled a new bitrate, get it.
+            if (bitrate_changed) {
+                BitRate new_bitrate = _processor->getBitrate();
+                if (new_bitrate != 0) {
+                    bitrate_never_modified = false;
+                    output_bitrate = new_bitrate;
                 }
             }
 
-            addTotalPackets (1);
+            pkt_done += drop_cnt + proc_cnt;
+            pkt_flush += drop_cnt + proc_cnt;
+            addTotalPackets(drop_cnt + proc_cnt);
 
             // Do not wait to process pkt_cnt packets before notifying
             // the next processor. Perform periodic flush to avoid waiting
             // too long before two output operations.
 
-            if (flush_request || pkt_done == pkt_cnt || (_options->max_flush_pkt > 0 && pkt_flush % _options->max_flush_pkt == 0)) {
-                passPackets (pkt_flush, output_bitrate, pkt_done == pkt_cnt && input_end, aborted);
+            if (flush_request || pkt_done == pkt_cnt || (_options->max_flush_pkt > 0 && pkt_flush >= _options->max_flush_pkt)) {
+                passPackets(pkt_flush, output_bitrate, pkt_done == pkt_cnt && input_end, aborted);
                 pkt_flush = 0;
             }
         }
@@ -172,6 +434,7 @@ void ts::tsp::ProcessorExecutor::main()
     } while (!input_end);
 
     // Close the packet processor
+    stopWorkers();
     _processor->stop();
 
     debug(u"packet processing thread %s after %'d packets, %'d passed, %'d dropped, %'d nullified",
@@ -34,6 +34,7 @@
 
 #pragma once
 #include "tspPluginExecutor.h"
+#include "tsByteBlock.h"
 
 namespace ts {
     namespace tsp {
@@ -64,11 +65,35 @@ namespace ts {
             ProcessorPlugin* plugin() {return _processor;}
 
         private:
-            ProcessorPlugin* _processor;
+            class Worker;
+            typedef std::vector<Worker*> WorkerVector;
+
+            ProcessorPlugin*             _processor;
+            ProcessorPlugin::Parallelism _parallelism;   // Data parallelism of the plugin.
+            WorkerVector                 _workers;       // Additional processing threads for data-parallel plugins.
+            Mutex                        _par_mutex;     // Protect the current parallel job.
+            Condition                    _par_done;      // Signaled by workers when their part of the job is completed.
+            size_t                       _par_pending;   // Number of workers which have not yet completed the job.
+            bool                         _par_bitrate;   // Some worker has signaled a bitrate change.
+            TSPacket*                    _par_pkt;       // First packet of the current job.
+            ProcessorPlugin::Status*     _par_status;    // Status of the packets of the current job.
+            size_t                       _par_count;     // Number of packets in the current job.
+            ByteBlock                    _par_part;      // With PARALLEL_PID, index of the thread for each packet of the job.
 
             // Inherited from Thread
             virtual void main() override;
 
+            // Start and stop the worker threads for data-parallel plugins.
+            void startWorkers();
+            void stopWorkers();
+
+            // Process a range of packets in parallel, using all workers. Return true if the bitrate has changed.
+            bool processParallel(TSPacket* pkt, ProcessorPlugin::Status* status, size_t count);
+
+            // Process the part of a parallel job which is assigned to one thread.
+            // With PARALLEL_PACKET, this is a contiguous sub-range, with PARALLEL_PID, a subset of the PID's.
+            void processPart(size_t part, bool& bitrate_changed);
+
             // Inaccessible operations
             ProcessorExecutor() = delete;
             ProcessorExecutor(const ProcessorExecutor&) = delete;
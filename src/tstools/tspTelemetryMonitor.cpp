@@ -0,0 +1,285 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Transport stream processor: Telemetry thread
+//
+//----------------------------------------------------------------------------
+
+#include "tspTelemetryMonitor.h"
+#include "tsGuardCondition.h"
+#include "tsTime.h"
+TSDUCK_SOURCE;
+
+namespace {
+    // Build a JSON integer value.
+    ts::json::ValuePtr Int(int64_t value)
+    {
+        return ts::json::ValuePtr(new ts::json::Number(value));
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Constructors and destructors.
+//----------------------------------------------------------------------------
+
+ts::tsp::TelemetryMonitor::PluginState::PluginState() :
+    packets(0),
+    busy_time(0),
+    wait_time(0),
+    window_samples(0),
+    window_total(0)
+{
+}
+
+ts::tsp::TelemetryMonitor::TelemetryMonitor(const Options& options, PluginExecutor* input, Report& report) :
+    Thread(ThreadAttributes().setStackSize(128 * 1024)),
+    _options(options),
+    _input(input),
+    _report(report),
+    _origin(),
+    _pkt_time(),
+    _states(),
+    _last_time(0),
+    _file(),
+    _udp(),
+    _tcp_addr(),
+    _tcp(),
+    _mutex(),
+    _wake_up(),
+    _terminate(false)
+{
+}
+
+ts::tsp::TelemetryMonitor::~TelemetryMonitor()
+{
+    stop();
+}
+
+
+//----------------------------------------------------------------------------
+// Check if telemetry is requested in the tsp options.
+//----------------------------------------------------------------------------
+
+bool ts::tsp::TelemetryMonitor::IsRequested(const Options& options)
+{
+    return !options.telemetry_file.empty() || !options.telemetry_udp.empty() || !options.telemetry_tcp.empty();
+}
+
+
+//----------------------------------------------------------------------------
+// Open the telemetry destinations and enable telemetry in all executors.
+//----------------------------------------------------------------------------
+
+bool ts::tsp::TelemetryMonitor::open(size_t buffer_count)
+{
+    if (!_options.telemetry_file.empty()) {
+        _file.open(_options.telemetry_file.toUTF8().c_str(), std::ios::out | std::ios::app);
+        if (!_file) {
+            _report.error(u"tsp: cannot create telemetry file %s", {_options.telemetry_file});
+            return false;
+        }
+    }
+
+    if (!_options.telemetry_udp.empty() && (!_udp.open(_report) || !_udp.setDefaultDestination(_options.telemetry_udp, _report))) {
+        return false;
+    }
+
+    if (!_options.telemetry_tcp.empty()) {
+        if (!_tcp_addr.resolve(_options.telemetry_tcp, _report)) {
+            return false;
+        }
+        if (!_tcp_addr.hasAddress() || !_tcp_addr.hasPort()) {
+            _report.error(u"tsp: missing address or port in --telemetry-tcp %s", {_options.telemetry_tcp});
+            return false;
+        }
+        // Initial connection failures are not fatal, the connection is retried on each report.
+        if (!_tcp.open(_report) || !_tcp.connect(_tcp_addr, _report)) {
+            _tcp.close(NULLREP);
+        }
+    }
+
+    // Enable telemetry in all plugin executors, with a common time origin and timestamp array.
+    _origin.getSystemTime();
+    _pkt_time.resize(buffer_count, 0);
+    _states.clear();
+    PluginExecutor* proc = _input;
+    do {
+        proc->enableTelemetry(&_origin, &_pkt_time[0]);
+        _states.push_back(PluginState());
+    } while ((proc = proc->ringNext<PluginExecutor>()) != _input);
+
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Stop the telemetry thread after a final report.
+//----------------------------------------------------------------------------
+
+void ts::tsp::TelemetryMonitor::stop()
+{
+    {
+        GuardCondition lock(_mutex, _wake_up);
+        _terminate = true;
+        lock.signal();
+    }
+    waitForTermination();
+}
+
+
+//----------------------------------------------------------------------------
+// Thread main code.
+//----------------------------------------------------------------------------
+
+void ts::tsp::TelemetryMonitor::main()
+{
+    bool terminate = false;
+    while (!terminate) {
+        // Wait until due time or termination request.
+        {
+            GuardCondition lock(_mutex, _wake_up);
+            if (!_terminate) {
+                lock.waitCondition(_options.telemetry_interval);
+            }
+            terminate = _terminate;
+        }
+        // Always send a final report on termination.
+        send(collect()->oneLiner());
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Collect the counters of all plugins and build a telemetry object.
+//----------------------------------------------------------------------------
+
+ts::json::ValuePtr ts::tsp::TelemetryMonitor::collect()
+{
+    Monotonic now;
+    now.getSystemTime();
+    const NanoSecond current = now - _origin;
+    const NanoSecond interval = std::max<NanoSecond>(1, current - _last_time);
+    _last_time = current;
+
+    json::ValuePtr root(new json::Object);
+    root->add(u"time", json::ValuePtr(new json::String(Time::CurrentLocalTime().format(Time::ALL))));
+    root->add(u"elapsed_ms", Int(current / NanoSecPerMilliSec));
+    root->add(u"interval_ms", Int(interval / NanoSecPerMilliSec));
+
+    json::ValuePtr plugins(new json::Array);
+    root->add(u"plugins", plugins);
+
+    size_t index = 0;
+    PluginExecutor* proc = _input;
+    do {
+        assert(index < _states.size());
+        PluginState& prev(_states[index]);
+        PluginExecutor::Telemetry tlm;
+        proc->getTelemetry(tlm);
+
+        const bool is_input = proc == _input;
+        const bool is_output = proc->ringNext<PluginExecutor>() == _input;
+        const PacketCounter packets = tlm.packets - prev.packets;
+        const NanoSecond busy = tlm.busy_time - prev.busy_time;
+        const NanoSecond wait = tlm.wait_time - prev.wait_time;
+        const uint64_t samples = tlm.window_samples - prev.window_samples;
+        const uint64_t window = tlm.window_total - prev.window_total;
+
+        json::ValuePtr plugin(new json::Object);
+        plugin->add(u"index", Int(int64_t(index)));
+        plugin->add(u"name", json::ValuePtr(new json::String(proc->pluginName())));
+        plugin->add(u"type", json::ValuePtr(new json::String(is_input ? u"input" : (is_output ? u"output" : u"processor"))));
+        plugin->add(u"packets", Int(int64_t(tlm.packets)));
+        plugin->add(u"packets_per_second", Int(int64_t((packets * NanoSecPerSec) / interval)));
+        plugin->add(u"busy_us", Int(busy / NanoSecPerMicroSec));
+        plugin->add(u"wait_us", Int(wait / NanoSecPerMicroSec));
+        plugin->add(u"busy_percent", Int(busy + wait <= 0 ? 0 : (100 * busy) / (busy + wait)));
+        plugin->add(u"window_avg", Int(samples == 0 ? 0 : int64_t(window / samples)));
+        plugin->add(u"window_max", Int(int64_t(tlm.window_max)));
+
+        if (is_output) {
+            json::ValuePtr latency(new json::Object);
+            latency->add(u"count", Int(int64_t(tlm.latency.count())));
+            latency->add(u"min", Int(int64_t(tlm.latency.minimum())));
+            latency->add(u"mean", Int(int64_t(tlm.latency.mean())));
+            latency->add(u"p50", Int(int64_t(tlm.latency.percentile(50.0))));
+            latency->add(u"p90", Int(int64_t(tlm.latency.percentile(90.0))));
+            latency->add(u"p99", Int(int64_t(tlm.latency.percentile(99.0))));
+            latency->add(u"p999", Int(int64_t(tlm.latency.percentile(99.9))));
+            latency->add(u"max", Int(int64_t(tlm.latency.maximum())));
+            plugin->add(u"latency_us", latency);
+        }
+        plugins->set(plugin);
+
+        prev.packets = tlm.packets;
+        prev.busy_time = tlm.busy_time;
+        prev.wait_time = tlm.wait_time;
+        prev.window_samples = tlm.window_samples;
+        prev.window_total = tlm.window_total;
+        index++;
+    } while ((proc = proc->ringNext<PluginExecutor>()) != _input);
+
+    return root;
+}
+
+
+//----------------------------------------------------------------------------
+// Send one telemetry line to all destinations.
+//----------------------------------------------------------------------------
+
+void ts::tsp::TelemetryMonitor::send(const UString& line)
+{
+    const std::string data(line.toUTF8());
+
+    if (_file.is_open()) {
+        _file << data << std::endl;
+    }
+
+    if (_udp.isOpen()) {
+        _udp.send(data.data(), data.size(), _report);
+    }
+
+    if (!_options.telemetry_tcp.empty()) {
+        // Reconnect silently when the connection was lost.
+        if (!_tcp.isConnected()) {
+            _tcp.close(NULLREP);
+            if (!_tcp.open(NULLREP) || !_tcp.connect(_tcp_addr, NULLREP)) {
+                _tcp.close(NULLREP);
+                return;
+            }
+        }
+        const std::string tcp_data(data + "\n");
+        if (!_tcp.send(tcp_data.data(), tcp_data.size(), NULLREP)) {
+            _report.verbose(u"tsp: telemetry connection to %s lost", {_options.telemetry_tcp});
+            _tcp.disconnect(NULLREP);
+            _tcp.close(NULLREP);
+        }
+    }
+}
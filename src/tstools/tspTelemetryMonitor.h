@@ -0,0 +1,140 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Transport stream processor: Telemetry thread
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tspOptions.h"
+#include "tspPluginExecutor.h"
+#include "tsUDPSocket.h"
+#include "tsTCPConnection.h"
+#include "tsjson.h"
+
+namespace ts {
+    namespace tsp {
+        //!
+        //! Telemetry thread of the Transport stream processor.
+        //! @ingroup plugin
+        //!
+        //! This class starts an internal thread which periodically wakes up,
+        //! collects the telemetry counters of all plugin executors and exports
+        //! them as JSON objects, one per line, in a file, a UDP destination or
+        //! a TCP server.
+        //!
+        //! For each plugin, the reported values are the number of processed
+        //! packets, the throughput, the time spent processing packets and the
+        //! time spent waiting for packets (in waitWork()), the occupancy of the
+        //! plugin's sliding window in the packet buffer. For the output plugin,
+        //! the distribution of the latency of packets from input to output is
+        //! also reported.
+        //!
+        class TelemetryMonitor: public Thread
+        {
+        public:
+            //!
+            //! Constructor.
+            //! @param [in] options Command line options for tsp.
+            //! @param [in] input The input plugin executor, first in the ring of executors.
+            //! @param [in,out] report Where to report errors.
+            //!
+            TelemetryMonitor(const Options& options, PluginExecutor* input, Report& report);
+
+            //!
+            //! Destructor.
+            //!
+            virtual ~TelemetryMonitor();
+
+            //!
+            //! Check if telemetry is requested in the tsp options.
+            //! @param [in] options Command line options for tsp.
+            //! @return True if telemetry is requested.
+            //!
+            static bool IsRequested(const Options& options);
+
+            //!
+            //! Open the telemetry destinations and enable telemetry in all plugin executors.
+            //! Must be executed in synchronous environment, before starting all executor threads.
+            //! @param [in] buffer_count Number of packets in the packet buffer.
+            //! @return True on success, false on error.
+            //!
+            bool open(size_t buffer_count);
+
+            //!
+            //! Stop the telemetry thread after a final report.
+            //! Must be called before deallocating the plugin executors.
+            //!
+            void stop();
+
+        private:
+            // Previous counters of a plugin, to compute rates.
+            class PluginState
+            {
+            public:
+                PacketCounter packets;
+                NanoSecond    busy_time;
+                NanoSecond    wait_time;
+                uint64_t      window_samples;
+                uint64_t      window_total;
+                PluginState();
+            };
+
+            const Options&           _options;
+            PluginExecutor*          _input;
+            Report&                  _report;
+            Monotonic                _origin;     // Common time origin of all plugin executors.
+            std::vector<NanoSecond>  _pkt_time;   // Input timestamps of packets in the buffer.
+            std::vector<PluginState> _states;     // Previous counters, one per plugin executor.
+            NanoSecond               _last_time;  // Time of last report.
+            std::ofstream            _file;       // Output file.
+            UDPSocket                _udp;        // UDP output socket.
+            SocketAddress            _tcp_addr;   // TCP server address.
+            TCPConnection            _tcp;        // TCP connection to server.
+            Mutex                    _mutex;
+            Condition                _wake_up;    // accessed under mutex
+            bool                     _terminate;  // accessed under mutex
+
+            // Collect the counters of all plugins and build a telemetry object.
+            json::ValuePtr collect();
+
+            // Send one telemetry line to all destinations.
+            void send(const UString& line);
+
+            // Inherited from Thread
+            virtual void main() override;
+
+            // Inaccessible operations.
+            TelemetryMonitor() = delete;
+            TelemetryMonitor(const TelemetryMonitor&) = delete;
+            TelemetryMonitor& operator=(const TelemetryMonitor&) = delete;
+        };
+    }
+}
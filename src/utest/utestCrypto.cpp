@@ -48,6 +48,7 @@
 #include "tsDVBCSA2.h"
 #include "tsIDSA.h"
 #include "tsSystemRandomGenerator.h"
+#include "tsTime.h"
 #include "utestCppUnitTest.h"
 TSDUCK_SOURCE;
 
@@ -83,15 +84,18 @@ public:
     void testAES_CTS3();
     void testAES_CTS4();
     void testAES_DVS042();
+    void testAESImplementations();
     void testDES();
     void testTDES();
     void testTDES_CBC();
     void testDVBCSA2();
+    void testDVBCSA2Batch();
     void testIDSA();
     void testSCTE52_2003();
     void testSCTE52_2008();
     void testSHA1();
     void testSHA256();
+    void testSHAImplementations();
     void testSHA512();
     void testMD5();
 
@@ -104,15 +108,18 @@ public:
     CPPUNIT_TEST(testAES_CTS3);
     CPPUNIT_TEST(testAES_CTS4);
     CPPUNIT_TEST(testAES_DVS042);
+    CPPUNIT_TEST(testAESImplementations);
     CPPUNIT_TEST(testDES);
     CPPUNIT_TEST(testTDES);
     CPPUNIT_TEST(testTDES_CBC);
     CPPUNIT_TEST(testDVBCSA2);
+    CPPUNIT_TEST(testDVBCSA2Batch);
     CPPUNIT_TEST(testIDSA);
     CPPUNIT_TEST(testSCTE52_2003);
     CPPUNIT_TEST(testSCTE52_2008);
     CPPUNIT_TEST(testSHA1);
     CPPUNIT_TEST(testSHA256);
+    CPPUNIT_TEST(testSHAImplementations);
     CPPUNIT_TEST(testSHA512);
     CPPUNIT_TEST(testMD5);
     CPPUNIT_TEST_SUITE_END();
@@ -399,6 +406,80 @@ void CryptoTest::testAES_DVS042()
     testChainingSizes(dvs042_aes, 16, 17, 23, 31, 32, 33, 45, 64, 67, 184, 12345, 0);
 }
 
+void CryptoTest::testAESImplementations()
+{
+    static const ts::AES::Implementation impls[] = {ts::AES::TABLES, ts::AES::AESNI};
+    static const char* const names[] = {"tables", "aes-ni"};
+    const ts::AES::Implementation initial = ts::AES::GetImplementation();
+
+    // Pseudo-random key, IV and data. The data size is not a multiple of the
+    // parallelism of AES-NI and is large enough for all chaining modes.
+    ts::ByteBlock key(32);
+    ts::ByteBlock iv(ts::AES::BLOCK_SIZE);
+    ts::ByteBlock plain(8 * 1024 + 7 * ts::AES::BLOCK_SIZE);
+    for (size_t i = 0; i < key.size(); ++i) {
+        key[i] = uint8_t(i * 29 + 3);
+    }
+    for (size_t i = 0; i < iv.size(); ++i) {
+        iv[i] = uint8_t(i * 17 + 11);
+    }
+    for (size_t i = 0; i < plain.size(); ++i) {
+        plain[i] = uint8_t(i * 131 + (i >> 8) * 7);
+    }
+
+    ts::ECB<ts::AES> ecb;
+    ts::CBC<ts::AES> cbc;
+    ts::CTS1<ts::AES> cts1;
+    ts::CTS2<ts::AES> cts2;
+    ts::CTS3<ts::AES> cts3;
+    ts::CTS4<ts::AES> cts4;
+    ts::DVS042<ts::AES> dvs042;
+    ts::CipherChaining* const modes[] = {&ecb, &cbc, &cts1, &cts2, &cts3, &cts4, &dvs042};
+    const size_t mode_count = sizeof(modes) / sizeof(modes[0]);
+
+    // Reference values, using the lookup tables implementation.
+    CPPUNIT_ASSERT(ts::AES::SetImplementation(ts::AES::TABLES));
+    std::vector<ts::ByteBlock> ref(mode_count);
+    for (size_t m = 0; m < mode_count; ++m) {
+        CPPUNIT_ASSERT(modes[m]->setKey(key.data(), key.size()));
+        CPPUNIT_ASSERT(modes[m]->setIV(iv.data(), modes[m]->minIVSize()));
+        ref[m].resize(plain.size());
+        CPPUNIT_ASSERT(modes[m]->encrypt(plain.data(), plain.size(), ref[m].data(), ref[m].size()));
+    }
+
+    for (size_t n = 0; n < sizeof(impls) / sizeof(impls[0]); ++n) {
+        if (!ts::AES::IsSupported(impls[n])) {
+            utest::Out() << "CryptoTest: AES " << names[n] << " not supported" << std::endl;
+            continue;
+        }
+        CPPUNIT_ASSERT(ts::AES::SetImplementation(impls[n]));
+
+        for (size_t m = 0; m < mode_count; ++m) {
+            ts::ByteBlock cipher(plain.size());
+            ts::ByteBlock decipher(plain.size());
+            CPPUNIT_ASSERT(modes[m]->encrypt(plain.data(), plain.size(), cipher.data(), cipher.size()));
+            CPPUNIT_ASSERT(modes[m]->decrypt(cipher.data(), cipher.size(), decipher.data(), decipher.size()));
+            if (cipher != ref[m] || decipher != plain) {
+                CPPUNIT_FAIL("CryptoTest: " + modes[m]->name().toUTF8() + " " + names[n] + " differs from reference");
+            }
+        }
+
+        // Performance evaluation, displayed in debug mode only.
+        const size_t loops = 1000;
+        ts::ByteBlock cipher(plain.size());
+        const ts::Time start(ts::Time::CurrentUTC());
+        for (size_t i = 0; i < loops; ++i) {
+            cbc.decrypt(ref[1].data(), ref[1].size(), cipher.data(), cipher.size());
+        }
+        const ts::MilliSecond duration = ts::Time::CurrentUTC() - start;
+        utest::Out() << "CryptoTest: AES-CBC decryption " << names[n] << " on " << (loops * plain.size() / 1024) << " kB: "
+                     << duration << " ms" << std::endl;
+    }
+
+    // Restore the default implementation for other tests.
+    CPPUNIT_ASSERT(ts::AES::SetImplementation(initial));
+}
+
 void CryptoTest::testDES()
 {
     ts::DES des;
@@ -475,6 +556,85 @@ void CryptoTest::testDVBCSA2()
     }
 }
 
+void CryptoTest::testDVBCSA2Batch()
+{
+    // Batch sizes exercising the byte-oriented and all bitsliced implementations.
+    static const size_t counts[] = {1, 5, 64, 100, 256, 300, 600};
+    const size_t tv_count = sizeof(tv_dvb_csa2) / sizeof(tv_dvb_csa2[0]);
+    ts::DVBCSA2 csa;
+    ts::SystemRandomGenerator prng;
+
+    utest::Out() << "CryptoTest: DVB-CSA2 batch implementation: " << ts::DVBCSA2::BatchEngineName() << std::endl;
+
+    for (size_t ci = 0; ci < sizeof(counts) / sizeof(counts[0]); ++ci) {
+        const size_t count = counts[ci];
+        std::vector<uint8_t*> data(count);
+        std::vector<size_t> sizes(count);
+
+        // Each test vector is replicated in all data blocks.
+        for (size_t tvi = 0; tvi < tv_count; ++tvi) {
+            const TV_DVB_CSA2* tv = tv_dvb_csa2 + tvi;
+            ts::ByteBlock buffer(count * tv->size);
+            for (size_t i = 0; i < count; ++i) {
+                data[i] = &buffer[i * tv->size];
+                sizes[i] = tv->size;
+                ::memcpy(data[i], tv->plain, tv->size);
+            }
+            CPPUNIT_ASSERT(csa.setKey(tv->key, sizeof(tv->key)));
+            CPPUNIT_ASSERT(csa.encryptBatch(&data[0], &sizes[0], count));
+            for (size_t i = 0; i < count; ++i) {
+                CPPUNIT_ASSERT(::memcmp(data[i], tv->cipher, tv->size) == 0);
+            }
+            CPPUNIT_ASSERT(csa.decryptBatch(&data[0], &sizes[0], count));
+            for (size_t i = 0; i < count; ++i) {
+                CPPUNIT_ASSERT(::memcmp(data[i], tv->plain, tv->size) == 0);
+            }
+        }
+
+        // Random data blocks of all sizes, compared with the byte-oriented implementation.
+        uint8_t key[ts::DVBCSA2::KEY_SIZE];
+        ts::ByteBlock plain(count * 184);
+        CPPUNIT_ASSERT(prng.read(key, sizeof(key)));
+        CPPUNIT_ASSERT(prng.read(plain.data(), plain.size()));
+        CPPUNIT_ASSERT(csa.setKey(key, sizeof(key)));
+        ts::ByteBlock buffer(plain);
+        ts::ByteBlock reference(plain);
+        for (size_t i = 0; i < count; ++i) {
+            data[i] = &buffer[i * 184];
+            sizes[i] = (i * 7) % 185;
+            CPPUNIT_ASSERT(csa.encryptInPlace(&reference[i * 184], sizes[i]));
+        }
+        CPPUNIT_ASSERT(csa.encryptBatch(&data[0], &sizes[0], count));
+        CPPUNIT_ASSERT(buffer == reference);
+        CPPUNIT_ASSERT(csa.decryptBatch(&data[0], &sizes[0], count));
+        CPPUNIT_ASSERT(buffer == plain);
+    }
+
+    // Performance comparison, displayed in debug mode only.
+    const size_t bench_count = 256;
+    const size_t bench_loops = 40;
+    ts::ByteBlock buffer(bench_count * 184);
+    std::vector<uint8_t*> data(bench_count);
+    std::vector<size_t> sizes(bench_count, 184);
+    for (size_t i = 0; i < bench_count; ++i) {
+        data[i] = &buffer[i * 184];
+    }
+    ts::Time start(ts::Time::CurrentUTC());
+    for (size_t loop = 0; loop < bench_loops; ++loop) {
+        for (size_t i = 0; i < bench_count; ++i) {
+            csa.encryptInPlace(data[i], sizes[i]);
+        }
+    }
+    const ts::MilliSecond single = ts::Time::CurrentUTC() - start;
+    start = ts::Time::CurrentUTC();
+    for (size_t loop = 0; loop < bench_loops; ++loop) {
+        csa.encryptBatch(&data[0], &sizes[0], bench_count);
+    }
+    const ts::MilliSecond batch = ts::Time::CurrentUTC() - start;
+    utest::Out() << "CryptoTest: DVB-CSA2 on " << (bench_count * bench_loops) << " packets, one by one: "
+                 << single << " ms, batch: " << batch << " ms" << std::endl;
+}
+
 void CryptoTest::testIDSA()
 {
     ts::IDSA idsa;
@@ -531,6 +691,115 @@ void CryptoTest::testSHA256()
     }
 }
 
+namespace {
+    // Check all implementations of a SHA hash against the scalar one, in one message and batch modes.
+    template <class HASH, class TV>
+    void CheckSHAImplementations(const TV* tv, size_t tv_count)
+    {
+        static const typename HASH::Implementation impls[] = {HASH::SCALAR, HASH::SHANI, HASH::AVX2};
+        static const char* const names[] = {"scalar", "sha-ni", "avx2"};
+        const typename HASH::Implementation initial = HASH::GetImplementation();
+        HASH hash;
+        const size_t hsize = hash.hashSize();
+
+        // Pseudo-random data. Messages of various sizes around the padding limits, and
+        // batches of messages of similar sizes, as TS packets or carousel payloads.
+        ts::ByteBlock data(256 * 1024);
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = uint8_t(i * 131 + (i >> 8) * 7);
+        }
+        std::vector<const void*> msg;
+        std::vector<size_t> sizes;
+        for (size_t size = 0; size < 300; ++size) {
+            msg.push_back(&data[size % 13]);
+            sizes.push_back(size);
+        }
+        msg.push_back(&data[3]);
+        sizes.push_back(data.size() - 3);
+
+        // Reference values, using the scalar implementation.
+        CPPUNIT_ASSERT(HASH::SetImplementation(HASH::SCALAR));
+        ts::ByteBlock ref(msg.size() * hsize);
+        for (size_t i = 0; i < msg.size(); ++i) {
+            CPPUNIT_ASSERT(hash.hash(msg[i], sizes[i], &ref[i * hsize], hsize));
+        }
+
+        for (size_t n = 0; n < sizeof(impls) / sizeof(impls[0]); ++n) {
+            const ts::UString name(ts::UString::Format(u"%s %s", {hash.name(), names[n]}));
+            if (!HASH::IsSupported(impls[n])) {
+                utest::Out() << "CryptoTest: " << name << " not supported" << std::endl;
+                continue;
+            }
+            CPPUNIT_ASSERT(HASH::SetImplementation(impls[n]));
+
+            // Test vectors, one message and batch.
+            for (size_t i = 0; i < tv_count; ++i) {
+                uint8_t res[64];
+                const void* const addr = tv[i].message;
+                const size_t size = ::strlen(tv[i].message);
+                CPPUNIT_ASSERT(hash.hash(tv[i].message, size, res, sizeof(res)));
+                CPPUNIT_ASSERT(::memcmp(tv[i].hash, res, hsize) == 0);
+                CPPUNIT_ASSERT(hash.hashBatch(&addr, &size, 1, res, sizeof(res)));
+                CPPUNIT_ASSERT(::memcmp(tv[i].hash, res, hsize) == 0);
+            }
+
+            // One message at a time, in one add() and in chunks.
+            ts::ByteBlock res(msg.size() * hsize);
+            for (size_t i = 0; i < msg.size(); ++i) {
+                const uint8_t* const p = reinterpret_cast<const uint8_t*>(msg[i]);
+                CPPUNIT_ASSERT(hash.hash(p, sizes[i], &res[i * hsize], hsize));
+                CPPUNIT_ASSERT(::memcmp(&ref[i * hsize], &res[i * hsize], hsize) == 0);
+                CPPUNIT_ASSERT(hash.init());
+                const size_t first = std::min<size_t>(sizes[i], 37);
+                CPPUNIT_ASSERT(hash.add(p, first));
+                CPPUNIT_ASSERT(hash.add(p + first, sizes[i] - first));
+                CPPUNIT_ASSERT(hash.getHash(&res[i * hsize], hsize));
+                CPPUNIT_ASSERT(::memcmp(&ref[i * hsize], &res[i * hsize], hsize) == 0);
+            }
+
+            // All messages in one batch.
+            res.clear();
+            res.resize(msg.size() * hsize);
+            CPPUNIT_ASSERT(hash.hashBatch(&msg[0], &sizes[0], msg.size(), res.data(), res.size()));
+            if (res != ref) {
+                CPPUNIT_FAIL("CryptoTest: " + name.toUTF8() + " batch differs from reference");
+            }
+
+            // Performance evaluation, displayed in debug mode only.
+            const size_t loops = 64;
+            const size_t batch_count = 1024;
+            const size_t batch_size = 1500;
+            std::vector<const void*> bmsg(batch_count);
+            std::vector<size_t> bsizes(batch_count, batch_size);
+            for (size_t i = 0; i < batch_count; ++i) {
+                bmsg[i] = &data[(i * batch_size) % (data.size() - batch_size)];
+            }
+            ts::ByteBlock bres(batch_count * hsize);
+            ts::Time start(ts::Time::CurrentUTC());
+            for (size_t i = 0; i < loops; ++i) {
+                hash.hash(data.data(), data.size(), res.data(), hsize);
+            }
+            const ts::MilliSecond one = ts::Time::CurrentUTC() - start;
+            start = ts::Time::CurrentUTC();
+            for (size_t i = 0; i < loops; ++i) {
+                hash.hashBatch(&bmsg[0], &bsizes[0], batch_count, bres.data(), bres.size());
+            }
+            const ts::MilliSecond batch = ts::Time::CurrentUTC() - start;
+            utest::Out() << "CryptoTest: " << name << ": one message of " << (loops * data.size() / 1024) << " kB: " << one << " ms, "
+                         << (loops * batch_count) << " messages of " << batch_size << " bytes: " << batch << " ms" << std::endl;
+        }
+
+        // Restore the default implementation for other tests.
+        CPPUNIT_ASSERT(HASH::SetImplementation(initial));
+    }
+}
+
+void CryptoTest::testSHAImplementations()
+{
+    CheckSHAImplementations<ts::SHA1>(tv_sha1, sizeof(tv_sha1) / sizeof(tv_sha1[0]));
+    CheckSHAImplementations<ts::SHA256>(tv_sha256, sizeof(tv_sha256) / sizeof(tv_sha256[0]));
+}
+
 void CryptoTest::testSHA512()
 {
     ts::SHA512 sha512;
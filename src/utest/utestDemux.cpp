@@ -43,6 +43,9 @@
 #include "tsTOT.h"
 #include "tsTDT.h"
 #include "tsNames.h"
+#include "tsPIDMap.h"
+#include "tsTSAnalyzerReport.h"
+#include "tsTime.h"
 #include "utestCppUnitTest.h"
 TSDUCK_SOURCE;
 
@@ -91,6 +94,10 @@ public:
     void testTDT();
     void testTOT();
     void testHEVC();
+    void testPIDMap();
+    void testMultiplex();
+    void testParallelAnalysis();
+    void testAnalyzerSnapshot();
 
     CPPUNIT_TEST_SUITE(DemuxTest);
     CPPUNIT_TEST(testPAT);
@@ -104,6 +111,10 @@ public:
     CPPUNIT_TEST(testTDT);
     CPPUNIT_TEST(testTOT);
     CPPUNIT_TEST(testHEVC);
+    CPPUNIT_TEST(testPIDMap);
+    CPPUNIT_TEST(testMultiplex);
+    CPPUNIT_TEST(testParallelAnalysis);
+    CPPUNIT_TEST(testAnalyzerSnapshot);
     CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -486,3 +497,414 @@ void DemuxTest::testHEVC()
 {
     TEST_TABLE("PMT with HEVC descriptor", pmt_hevc);
 }
+
+void DemuxTest::testPIDMap()
+{
+    ts::PIDMap<int> map;
+    CPPUNIT_ASSERT(map.empty());
+    CPPUNIT_ASSERT(map.begin() == map.end());
+    CPPUNIT_ASSERT(map.find(0x100) == map.end());
+    CPPUNIT_ASSERT(map.get(0x100) == 0);
+
+    map[0x1FFF] = 4;
+    map[0x0000] = 1;
+    map[0x0100] = 2;
+    map[0x0140] = 3;
+    CPPUNIT_ASSERT_EQUAL(size_t(4), map.size());
+    CPPUNIT_ASSERT_EQUAL(size_t(1), map.count(0x0140));
+    CPPUNIT_ASSERT_EQUAL(size_t(0), map.count(0x0141));
+    CPPUNIT_ASSERT_EQUAL(size_t(0), map.count(0x2000));
+    CPPUNIT_ASSERT_EQUAL(2, *map.get(0x0100));
+    CPPUNIT_ASSERT_EQUAL(3, map.find(0x0140)->second);
+
+    // Iteration in increasing PID order.
+    static const ts::PID pids[] = {0x0000, 0x0100, 0x0140, 0x1FFF};
+    size_t index = 0;
+    for (ts::PIDMap<int>::const_iterator it = map.begin(); it != map.end(); ++it) {
+        CPPUNIT_ASSERT(index < 4);
+        CPPUNIT_ASSERT_EQUAL(pids[index], it->first);
+        CPPUNIT_ASSERT_EQUAL(int(index + 1), it->second);
+        index++;
+    }
+    CPPUNIT_ASSERT_EQUAL(size_t(4), index);
+
+    // Copy and erase.
+    ts::PIDMap<int> map2(map);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), map.erase(0x0100));
+    CPPUNIT_ASSERT_EQUAL(size_t(0), map.erase(0x0100));
+    map.erase(map.find(0x1FFF));
+    CPPUNIT_ASSERT_EQUAL(size_t(2), map.size());
+    CPPUNIT_ASSERT_EQUAL(size_t(4), map2.size());
+    CPPUNIT_ASSERT_EQUAL(4, map2[0x1FFF]);
+    map2 = map;
+    CPPUNIT_ASSERT_EQUAL(size_t(2), map2.size());
+    CPPUNIT_ASSERT(map2.find(0x1FFF) == map2.end());
+    map.clear();
+    CPPUNIT_ASSERT(map.empty());
+    CPPUNIT_ASSERT(map.begin() == map.end());
+    CPPUNIT_ASSERT_EQUAL(size_t(2), map2.size());
+
+    // Performance comparison with std::map, displayed in debug mode only.
+    ts::PIDMap<int> dense;
+    std::map<ts::PID, int> tree;
+    for (ts::PID pid = 0; pid < ts::PID_MAX; pid += 40) {
+        dense[pid] = tree[pid] = 1;
+    }
+    const size_t loops = 5000000;
+    int sum1 = 0;
+    int sum2 = 0;
+    ts::Time start(ts::Time::CurrentUTC());
+    for (size_t i = 0; i < loops; ++i) {
+        sum1 += dense[ts::PID((i * 40) % ts::PID_MAX)];
+    }
+    const ts::MilliSecond duration1 = ts::Time::CurrentUTC() - start;
+    start = ts::Time::CurrentUTC();
+    for (size_t i = 0; i < loops; ++i) {
+        sum2 += tree[ts::PID((i * 40) % ts::PID_MAX)];
+    }
+    const ts::MilliSecond duration2 = ts::Time::CurrentUTC() - start;
+    CPPUNIT_ASSERT_EQUAL(sum1, sum2);
+    utest::Out() << "DemuxTest: " << loops << " lookups in " << dense.size() << " PID's, PIDMap: "
+                 << duration1 << " ms, std::map: " << duration2 << " ms" << std::endl;
+}
+
+namespace {
+    // Count the tables and sections which are demuxed from a multiplex.
+    class TableCounter: public ts::TableHandlerInterface, public ts::SectionHandlerInterface
+    {
+    public:
+        size_t count;
+        size_t sections;
+        size_t valid;
+        TableCounter() : count(0), sections(0), valid(0) {}
+        virtual void handleTable(ts::SectionDemux&, const ts::BinaryTable&) override { count++; }
+        virtual void handleSection(ts::SectionDemux&, const ts::Section& section) override
+        {
+            sections++;
+            if (section.isValid() && section.sourcePID() != ts::PID_NULL && ts::CRC32(section.content(), section.size() - 4) == ts::GetUInt32(section.content() + section.size() - 4)) {
+                valid++;
+            }
+        }
+    };
+}
+
+void DemuxTest::testMultiplex()
+{
+    // Build a multiplex with 50 services, two elementary streams each.
+    const size_t service_count = 50;
+    const size_t es_packets = 10;  // Per elementary stream, in each cycle
+    const size_t cycles = 1000;
+
+    ts::PAT pat(0, true, 1);
+    ts::SDT sdt(true, 0, true, 1, 1);
+    ts::TSPacketVector psi;
+    for (size_t i = 0; i < service_count; ++i) {
+        const uint16_t srv_id = uint16_t(i + 1);
+        const ts::PID pmt_pid = ts::PID(0x1000 + i);
+        const ts::PID es_pid = ts::PID(0x0200 + 2 * i);
+        pat.pmts[srv_id] = pmt_pid;
+        sdt.services[srv_id].setName(ts::UString::Format(u"Service %d", {srv_id}));
+        ts::PMT pmt(0, true, srv_id, es_pid);
+        pmt.streams[es_pid].stream_type = 0x1B;
+        pmt.streams[es_pid + 1].stream_type = 0x04;
+        ts::OneShotPacketizer pzer(pmt_pid);
+        pzer.addTable(pmt);
+        ts::TSPacketVector pkts;
+        pzer.getPackets(pkts);
+        psi.insert(psi.end(), pkts.begin(), pkts.end());
+    }
+    for (int t = 0; t < 2; ++t) {
+        ts::OneShotPacketizer pzer(t == 0 ? ts::PID_PAT : ts::PID_SDT);
+        if (t == 0) {
+            pzer.addTable(pat);
+        }
+        else {
+            pzer.addTable(sdt);
+        }
+        ts::TSPacketVector pkts;
+        pzer.getPackets(pkts);
+        psi.insert(psi.end(), pkts.begin(), pkts.end());
+    }
+
+    // Build the complete multiplex, with PSI/SI at the beginning of each cycle.
+    ts::TSPacketVector mux;
+    uint8_t cc[ts::PID_MAX];
+    ::memset(cc, 0, sizeof(cc));
+    for (size_t c = 0; c < cycles; ++c) {
+        for (size_t i = 0; i < psi.size(); ++i) {
+            mux.push_back(psi[i]);
+        }
+        for (size_t n = 0; n < es_packets; ++n) {
+            for (size_t i = 0; i < 2 * service_count; ++i) {
+                ts::TSPacket pkt(ts::NullPacket);
+                pkt.setPID(ts::PID(0x0200 + i));
+                mux.push_back(pkt);
+            }
+        }
+    }
+    for (size_t i = 0; i < mux.size(); ++i) {
+        const ts::PID pid = mux[i].getPID();
+        mux[i].setCC(cc[pid]);
+        cc[pid] = (cc[pid] + 1) & 0x0F;
+    }
+
+    // Demux all PID's, only new tables are notified.
+    TableCounter counter;
+    ts::SectionDemux demux(&counter, 0, ts::AllPIDs);
+    const ts::Time start(ts::Time::CurrentUTC());
+    for (size_t i = 0; i < mux.size(); ++i) {
+        demux.feedPacket(mux[i]);
+    }
+    const ts::MilliSecond duration = ts::Time::CurrentUTC() - start;
+    CPPUNIT_ASSERT_EQUAL(service_count + 2, counter.count);
+    utest::Out() << "DemuxTest: " << service_count << "-service multiplex, " << mux.size()
+                 << " packets demuxed in " << duration << " ms" << std::endl;
+
+    // Same with a section handler, all sections are notified.
+    TableCounter counter2;
+    ts::SectionDemux demux2(&counter2, &counter2, ts::AllPIDs);
+    const ts::Time start2(ts::Time::CurrentUTC());
+    for (size_t i = 0; i < mux.size(); ++i) {
+        demux2.feedPacket(mux[i]);
+    }
+    const ts::MilliSecond duration2 = ts::Time::CurrentUTC() - start2;
+    CPPUNIT_ASSERT_EQUAL(service_count + 2, counter2.count);
+    CPPUNIT_ASSERT_EQUAL(cycles * (service_count + 2), counter2.sections);
+    CPPUNIT_ASSERT_EQUAL(counter2.sections, counter2.valid);
+    utest::Out() << "DemuxTest: " << counter2.sections << " sections demuxed in " << duration2 << " ms" << std::endl;
+}
+
+
+//----------------------------------------------------------------------------
+// Parallel analysis, must produce the same report as a sequential analysis.
+//----------------------------------------------------------------------------
+
+namespace {
+    // Analyzer which also reports the raw per-PID statistics.
+    class AnalyzerDump: public ts::TSAnalyzerReport
+    {
+    public:
+        void reportRaw(std::ostream& strm)
+        {
+            recomputeStatistics();
+            for (PIDContextMap::const_iterator it = _pids.begin(); it != _pids.end(); ++it) {
+                const PIDContext& pc(*it->second);
+                strm << "raw:pid=" << pc.pid << ":cryptop=" << pc.cryptop_cnt << "/" << pc.cryptop_ts_cnt
+                     << ":pcr=" << pc.ts_bitrate_sum << "/" << pc.ts_bitrate_cnt << "/" << pc.last_pcr << "/" << pc.last_pcr_pkt
+                     << ":cc=" << int(pc.cur_continuity) << ":sc=" << int(pc.cur_ts_sc) << "/" << pc.cur_ts_sc_pkt
+                     << ":pes=" << int(pc.pes_stream_id) << "/" << pc.same_stream_id << std::endl;
+            }
+        }
+    };
+
+    // Normalized and raw analysis report, without the system times which depend on the execution.
+    std::string AnalysisReport(const ts::TSPacketVector& packets, size_t threads, size_t chunk_packets)
+    {
+        AnalyzerDump analyzer;
+        analyzer.setAnalysisThreads(threads, chunk_packets);
+        for (size_t i = 0; i < packets.size(); ++i) {
+            analyzer.feedPacket(packets[i]);
+        }
+        std::stringstream strm;
+        analyzer.reportNormalized(strm);
+        analyzer.reportRaw(strm);
+        std::string line;
+        std::string result;
+        while (std::getline(strm, line)) {
+            if (line.find(":system:") == std::string::npos) {
+                result.append(line);
+                result.append("\n");
+            }
+        }
+        return result;
+    }
+}
+
+void DemuxTest::testParallelAnalysis()
+{
+    // A service with a video PID carrying PCR's and a scrambled audio PID.
+    const ts::PID pmt_pid = 0x0100;
+    const ts::PID video_pid = 0x0200;
+    const ts::PID audio_pid = 0x0201;
+
+    ts::PAT pat(0, true, 1);
+    pat.pmts[1] = pmt_pid;
+    ts::PMT pmt(0, true, 1, video_pid);
+    pmt.streams[video_pid].stream_type = 0x02;
+    pmt.streams[audio_pid].stream_type = 0x04;
+    ts::TSPacketVector psi;
+    for (int t = 0; t < 2; ++t) {
+        ts::OneShotPacketizer pzer(t == 0 ? ts::PID_PAT : pmt_pid);
+        if (t == 0) {
+            pzer.addTable(pat);
+        }
+        else {
+            pzer.addTable(pmt);
+        }
+        ts::TSPacketVector pkts;
+        pzer.getPackets(pkts);
+        psi.insert(psi.end(), pkts.begin(), pkts.end());
+    }
+
+    // Build a stream with continuity errors, PCR's, crypto-periods, transport errors and suspect packets.
+    ts::TSPacketVector mux;
+    uint8_t cc[ts::PID_MAX];
+    ::memset(cc, 0, sizeof(cc));
+    uint32_t random = 1;
+    uint64_t pcr = 0;
+    uint8_t scrambling = ts::SC_CLEAR;
+    for (size_t n = 0; n < 50000; ++n) {
+        random = random * 1103515245 + 12345;
+        const uint32_t r = (random >> 8) % 1000;
+        ts::TSPacket pkt(ts::NullPacket);
+        if (n % 500 < psi.size()) {
+            pkt = psi[n % 500];
+        }
+        else if (n % 3 == 0) {
+            // Audio packets, with crypto-periods.
+            pkt.setPID(audio_pid);
+            if (r < 10) {
+                scrambling = r < 3 ? ts::SC_CLEAR : (r < 6 ? ts::SC_EVEN_KEY : ts::SC_ODD_KEY);
+            }
+            pkt.setScrambling(scrambling);
+        }
+        else if (n % 3 == 1) {
+            // Video packets, some with a PCR or a discontinuity indicator.
+            pkt.setPID(video_pid);
+            if (r < 300) {
+                pkt.b[3] |= 0x20;
+                pkt.b[4] = 7;
+                pkt.b[5] = r < 5 ? 0x90 : 0x10;
+                pcr += r < 20 ? 0 : 27000 + r;
+                pkt.setPCR(pcr);
+            }
+            if (r % 10 == 0) {
+                pkt.setPUSI();
+                pkt.b[pkt.getHeaderSize()] = 0x00;
+                pkt.b[pkt.getHeaderSize() + 1] = 0x00;
+                pkt.b[pkt.getHeaderSize() + 2] = 0x01;
+                pkt.b[pkt.getHeaderSize() + 3] = r < 500 ? 0xE0 : 0xE1;
+            }
+        }
+        else if (r < 5) {
+            // Transport error, followed by a suspect packet.
+            pkt.setPID(video_pid);
+            pkt.setTEI();
+            mux.push_back(pkt);
+            pkt = ts::NullPacket;
+            pkt.setPID(ts::PID(0x1000 + r));
+        }
+        const ts::PID pid = pkt.getPID();
+        if (r > 990) {
+            // Lost packets.
+            cc[pid] = (cc[pid] + 2) & 0x0F;
+        }
+        else if (r > 985 && cc[pid] > 0) {
+            // Duplicated packet.
+            cc[pid]--;
+        }
+        pkt.setCC(cc[pid]);
+        cc[pid] = (cc[pid] + 1) & 0x0F;
+        mux.push_back(pkt);
+    }
+
+    // Analyze with various numbers of threads and chunk sizes.
+    const ts::Time start(ts::Time::CurrentUTC());
+    const std::string reference(AnalysisReport(mux, 0, 0));
+    const ts::MilliSecond duration = ts::Time::CurrentUTC() - start;
+    utest::Out() << "DemuxTest: " << mux.size() << " packets analyzed in " << duration << " ms" << std::endl;
+    CPPUNIT_ASSERT(reference.find("scrambledpids=1") != std::string::npos);
+    CPPUNIT_ASSERT(reference.find("suspectignored=0:") == std::string::npos);
+
+    const size_t threads[] = {1, 2, 4};
+    const size_t chunks[] = {1, 7, 100, 8192};
+    for (size_t t = 0; t < sizeof(threads) / sizeof(threads[0]); ++t) {
+        for (size_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]); ++c) {
+            const ts::Time start2(ts::Time::CurrentUTC());
+            const std::string report(AnalysisReport(mux, threads[t], chunks[c]));
+            const ts::MilliSecond duration2 = ts::Time::CurrentUTC() - start2;
+            utest::Out() << "DemuxTest: " << threads[t] << " threads, " << chunks[c] << " packets per chunk, analyzed in " << duration2 << " ms" << std::endl;
+            CPPUNIT_ASSERT_EQUAL(reference, report);
+        }
+    }
+}
+
+void DemuxTest::testAnalyzerSnapshot()
+{
+    // Two PID's with continuous packets, one continuity error on the second one.
+    ts::TSPacketVector packets;
+    uint8_t cc[2] = {0, 0};
+    for (size_t n = 0; n < 3000; ++n) {
+        const size_t index = n % 3 == 0 ? 1 : 0;
+        ts::TSPacket pkt(ts::NullPacket);
+        pkt.setPID(ts::PID(0x0100 + index));
+        if (index == 1 && n == 2400) {
+            cc[index] = (cc[index] + 1) & 0x0F;
+        }
+        pkt.setCC(cc[index]);
+        cc[index] = (cc[index] + 1) & 0x0F;
+        packets.push_back(pkt);
+    }
+
+    ts::TSAnalyzer analyzer;
+    ts::TSAnalyzer::Snapshot first;
+    ts::TSAnalyzer::Snapshot second;
+    ts::TSAnalyzer::Snapshot delta;
+
+    for (size_t n = 0; n < 1800; ++n) {
+        analyzer.feedPacket(packets[n]);
+    }
+    analyzer.getSnapshot(first);
+    for (size_t n = 1800; n < packets.size(); ++n) {
+        analyzer.feedPacket(packets[n]);
+    }
+    analyzer.getSnapshot(second);
+
+    CPPUNIT_ASSERT_EQUAL(uint64_t(1800), first.packets);
+    CPPUNIT_ASSERT_EQUAL(uint64_t(3000), second.packets);
+    CPPUNIT_ASSERT_EQUAL(size_t(2), second.pids.size());
+    CPPUNIT_ASSERT_EQUAL(ts::PID(0x0100), second.pids[0].pid);
+    CPPUNIT_ASSERT_EQUAL(ts::PID(0x0101), second.pids[1].pid);
+    CPPUNIT_ASSERT_EQUAL(uint64_t(2000), second.pids[0].packets);
+    CPPUNIT_ASSERT_EQUAL(uint64_t(1000), second.pids[1].packets);
+
+    second.getDelta(first, delta);
+    CPPUNIT_ASSERT_EQUAL(uint64_t(1200), delta.packets);
+    CPPUNIT_ASSERT_EQUAL(size_t(2), delta.pids.size());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(800), delta.pids[0].packets);
+    CPPUNIT_ASSERT_EQUAL(uint64_t(400), delta.pids[1].packets);
+    CPPUNIT_ASSERT_EQUAL(uint64_t(0), delta.pids[0].discontinuities);
+    CPPUNIT_ASSERT_EQUAL(uint64_t(1), delta.pids[1].discontinuities);
+
+    // With a bitrate, the PID bitrates are proportional to their packets.
+    delta.user_bitrate = 3000000;
+    CPPUNIT_ASSERT_EQUAL(ts::BitRate(2000000), delta.bitrate(delta.pids[0]));
+    CPPUNIT_ASSERT_EQUAL(ts::BitRate(1000000), delta.bitrate(delta.pids[1]));
+    const ts::json::ValuePtr json(delta.toJSON());
+    CPPUNIT_ASSERT_EQUAL(int64_t(1200), json->value(u"packets").toInteger());
+    CPPUNIT_ASSERT_EQUAL(int64_t(0x0101), json->value(u"pids").at(1).value(u"pid").toInteger());
+    CPPUNIT_ASSERT_EQUAL(int64_t(1000000), json->value(u"pids").at(1).value(u"bitrate").toInteger());
+
+    // After a reset, the delta starts at the reset.
+    analyzer.reset();
+    for (size_t n = 0; n < 300; ++n) {
+        analyzer.feedPacket(packets[n]);
+    }
+    analyzer.getSnapshot(first);
+    first.getDelta(second, delta);
+    CPPUNIT_ASSERT_EQUAL(uint64_t(300), delta.packets);
+    CPPUNIT_ASSERT_EQUAL(uint64_t(200), delta.pids[0].packets);
+
+    // Another analyzer with more packets: the counters do not decrease but the generation differs.
+    ts::TSAnalyzer other;
+    other.setGeneration(analyzer.getGeneration() + 1);
+    for (size_t n = 0; n < 600; ++n) {
+        other.feedPacket(packets[n]);
+    }
+    other.getSnapshot(second);
+    CPPUNIT_ASSERT(second.generation != first.generation);
+    second.getDelta(first, delta);
+    CPPUNIT_ASSERT_EQUAL(uint64_t(600), delta.packets);
+    CPPUNIT_ASSERT_EQUAL(uint64_t(400), delta.pids[0].packets);
+    CPPUNIT_ASSERT_EQUAL(uint64_t(200), delta.pids[1].packets);
+}
@@ -115,6 +115,11 @@ void JsonTest::testSimple()
         u"  }\n"
         u"]",
         jv->printed());
+
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(u"[true,{\"ab\": 67,\"foo\": \"bar\"}]", jv->oneLiner());
+
+    CPPUNIT_ASSERT(ts::json::Parse(jv, u"{\"a\": \"x\\ny\"}", CERR));
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(u"{\"a\": \"x\\ny\"}", jv->oneLiner());
 }
 
 void JsonTest::testGitHub()
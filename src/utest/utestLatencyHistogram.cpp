@@ -0,0 +1,161 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  CppUnit test suite for class ts::LatencyHistogram
+//
+//----------------------------------------------------------------------------
+
+#include "tsLatencyHistogram.h"
+#include "utestCppUnitTest.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class LatencyHistogramTest: public CppUnit::TestFixture
+{
+public:
+    virtual void setUp() override;
+    virtual void tearDown() override;
+
+    void testBuckets();
+    void testStatistics();
+    void testMerge();
+
+    CPPUNIT_TEST_SUITE(LatencyHistogramTest);
+    CPPUNIT_TEST(testBuckets);
+    CPPUNIT_TEST(testStatistics);
+    CPPUNIT_TEST(testMerge);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(LatencyHistogramTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void LatencyHistogramTest::setUp()
+{
+}
+
+// Test suite cleanup method.
+void LatencyHistogramTest::tearDown()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Test cases
+//----------------------------------------------------------------------------
+
+void LatencyHistogramTest::testBuckets()
+{
+    // Small values are exact.
+    for (uint64_t v = 0; v < ts::LatencyHistogram::SUB_COUNT; ++v) {
+        CPPUNIT_ASSERT_EQUAL(size_t(v), ts::LatencyHistogram::BucketIndex(v));
+        CPPUNIT_ASSERT_EQUAL(v, ts::LatencyHistogram::BucketHighValue(size_t(v)));
+    }
+
+    // Buckets are contiguous, each value falls in its bucket, the relative error is bounded.
+    uint64_t previous = 0;
+    for (size_t i = 1; i < ts::LatencyHistogram::BUCKET_COUNT; ++i) {
+        const uint64_t high = ts::LatencyHistogram::BucketHighValue(i);
+        const uint64_t low = previous + 1;
+        CPPUNIT_ASSERT(high >= low);
+        CPPUNIT_ASSERT_EQUAL(i, ts::LatencyHistogram::BucketIndex(low));
+        CPPUNIT_ASSERT_EQUAL(i, ts::LatencyHistogram::BucketIndex(high));
+        CPPUNIT_ASSERT((high - low) <= low / ts::LatencyHistogram::SUB_COUNT);
+        previous = high;
+    }
+    CPPUNIT_ASSERT_EQUAL(TS_UCONST64(0xFFFFFFFFFFFFFFFF), previous);
+}
+
+void LatencyHistogramTest::testStatistics()
+{
+    ts::LatencyHistogram h;
+    CPPUNIT_ASSERT_EQUAL(uint64_t(0), h.count());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(0), h.minimum());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(0), h.maximum());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(0), h.mean());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(0), h.percentile(50.0));
+
+    // Values 1 to 1000.
+    for (uint64_t v = 1; v <= 1000; ++v) {
+        h.add(v);
+    }
+    CPPUNIT_ASSERT_EQUAL(uint64_t(1000), h.count());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(1), h.minimum());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(1000), h.maximum());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(500), h.mean());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(1), h.percentile(0.0));
+    CPPUNIT_ASSERT_EQUAL(uint64_t(1000), h.percentile(100.0));
+
+    // Percentiles within the precision of the histogram.
+    const uint64_t p50 = h.percentile(50.0);
+    const uint64_t p99 = h.percentile(99.0);
+    CPPUNIT_ASSERT(p50 >= 500 && p50 <= 500 + 500 / ts::LatencyHistogram::SUB_COUNT);
+    CPPUNIT_ASSERT(p99 >= 990 && p99 <= 1000);
+
+    // Multiple occurences.
+    h.add(1000000, 1000);
+    CPPUNIT_ASSERT_EQUAL(uint64_t(2000), h.count());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(1000000), h.maximum());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(1000000), h.percentile(99.9));
+    CPPUNIT_ASSERT(h.percentile(25.0) <= 500 + 500 / ts::LatencyHistogram::SUB_COUNT);
+
+    h.reset();
+    CPPUNIT_ASSERT_EQUAL(uint64_t(0), h.count());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(0), h.maximum());
+}
+
+void LatencyHistogramTest::testMerge()
+{
+    ts::LatencyHistogram h1, h2;
+    h1.add(10, 3);
+    h2.add(5);
+    h2.add(2000);
+
+    h1.add(h2);
+    CPPUNIT_ASSERT_EQUAL(uint64_t(5), h1.count());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(5), h1.minimum());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(2000), h1.maximum());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(407), h1.mean());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(10), h1.percentile(50.0));
+
+    // Merging an empty histogram does not change anything.
+    h2.reset();
+    h1.add(h2);
+    CPPUNIT_ASSERT_EQUAL(uint64_t(5), h1.count());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(5), h1.minimum());
+}
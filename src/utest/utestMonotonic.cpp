@@ -32,6 +32,7 @@
 //----------------------------------------------------------------------------
 
 #include "tsMonotonic.h"
+#include "tsPacingTimer.h"
 #include "tsSysUtils.h"
 #include "tsTime.h"
 #include "utestCppUnitTest.h"
@@ -53,11 +54,13 @@ public:
     void testArithmetic();
     void testSysWait();
     void testWait();
+    void testPacingTimer();
 
     CPPUNIT_TEST_SUITE(MonotonicTest);
     CPPUNIT_TEST(testArithmetic);
     CPPUNIT_TEST(testSysWait);
     CPPUNIT_TEST(testWait);
+    CPPUNIT_TEST(testPacingTimer);
     CPPUNIT_TEST_SUITE_END();
 private:
     ts::NanoSecond  _nsPrecision;
@@ -153,3 +156,41 @@ void MonotonicTest::testWait()
     CPPUNIT_ASSERT(end >= start + 100 - _msPrecision);
     CPPUNIT_ASSERT(end < start + 150);
 }
+
+void MonotonicTest::testPacingTimer()
+{
+    ts::PacingTimer timer;
+    CPPUNIT_ASSERT_EQUAL(ts::PacingTimer::DEFAULT_MAX_SPIN, timer.maxSpin());
+
+    // Pace 100 short intervals of 100 microseconds, much shorter than the system timer precision.
+    ts::Monotonic start;
+    start.getSystemTime();
+    ts::Monotonic due(start);
+    ts::NanoSecond late_max = 0;
+
+    for (int i = 0; i < 100; ++i) {
+        due += 100 * ts::NanoSecPerMicroSec;
+        ts::Monotonic now;
+        const ts::NanoSecond late = timer.waitUntil(due, now);
+        CPPUNIT_ASSERT(late >= 0);
+        CPPUNIT_ASSERT(now >= due);
+        CPPUNIT_ASSERT_EQUAL(now - due, late);
+        late_max = std::max(late_max, late);
+    }
+
+    ts::Monotonic end;
+    end.getSystemTime();
+    utest::Out() << "MonotonicTest: pacing timer, max lateness: " << ts::UString::Decimal(late_max)
+                 << " ns, sleep latency: " << ts::UString::Decimal(timer.sleepLatency()) << " ns" << std::endl;
+
+    // The lateness is not deterministic on a loaded system, only check the total duration.
+    CPPUNIT_ASSERT(end - start >= 10 * ts::NanoSecPerMilliSec);
+    CPPUNIT_ASSERT(end - start < 10 * ts::NanoSecPerMilliSec + 50 * ts::NanoSecPerMilliSec);
+
+    // Without spin, rely on the system timer only.
+    timer.setMaxSpin(0);
+    CPPUNIT_ASSERT_EQUAL(ts::NanoSecond(0), timer.maxSpin());
+    due.getSystemTime();
+    due += ts::NanoSecPerMilliSec;
+    CPPUNIT_ASSERT(timer.waitUntil(due) >= 0);
+}
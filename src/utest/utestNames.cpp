@@ -83,6 +83,7 @@ public:
     void testAudioType();
     void testT2MIPacketType();
     void testPlatformId();
+    void testCompiled();
 
     CPPUNIT_TEST_SUITE(NamesTest);
     CPPUNIT_TEST(testConfigFile);
@@ -120,6 +121,7 @@ public:
     CPPUNIT_TEST(testAudioType);
     CPPUNIT_TEST(testT2MIPacketType);
     CPPUNIT_TEST(testPlatformId);
+    CPPUNIT_TEST(testCompiled);
     CPPUNIT_TEST_SUITE_END();
 };
 
@@ -375,3 +377,60 @@ void NamesTest::testPlatformId()
     CPPUNIT_ASSERT_USTRINGS_EQUAL(u"0x000004 (TV digitale mobile, Telecom Italia)", ts::names::PlatformId(4, ts::names::FIRST));
     CPPUNIT_ASSERT_USTRINGS_EQUAL(u"VTC Mobile TV (0x704001)", ts::names::PlatformId(0x704001, ts::names::VALUE));
 }
+
+void NamesTest::testCompiled()
+{
+    utest::Out() << "NamesTest: DVB names compiled: " << ts::UString::TrueFalse(ts::NamesDVB::Instance().isCompiled())
+                 << ", OUI names compiled: " << ts::UString::TrueFalse(ts::NamesOUI::Instance().isCompiled()) << std::endl;
+
+    const ts::UString textFile(ts::TempFile(u".names"));
+    const ts::UString binFile(textFile + ts::Names::COMPILED_SUFFIX);
+
+    std::ofstream strm(textFile.toUTF8().c_str());
+    strm << "[Foo]" << std::endl
+         << "Bits = 16" << std::endl
+         << "0x0001 = One" << std::endl
+         << "0x0010-0x001F = Range" << std::endl
+         << "0x1000 = Last" << std::endl
+         << "[Bar]" << std::endl
+         << "0x01 = Bar one" << std::endl;
+    strm.close();
+
+    CPPUNIT_ASSERT(ts::Names::Compile(textFile, binFile, CERR));
+    CPPUNIT_ASSERT(ts::FileExists(binFile));
+
+    {
+        ts::Names names(textFile);
+        CPPUNIT_ASSERT(names.isCompiled());
+        CPPUNIT_ASSERT_EQUAL(size_t(0), names.errorCount());
+        CPPUNIT_ASSERT(names.nameExists(u"foo", 0x0001));
+        CPPUNIT_ASSERT(names.nameExists(u" FOO ", 0x0018));
+        CPPUNIT_ASSERT(!names.nameExists(u"foo", 0x0000));
+        CPPUNIT_ASSERT(!names.nameExists(u"foo", 0x0020));
+        CPPUNIT_ASSERT(!names.nameExists(u"fo", 0x0001));
+        CPPUNIT_ASSERT(!names.nameExists(u"foobar", 0x0001));
+        CPPUNIT_ASSERT_USTRINGS_EQUAL(u"One", names.nameFromSection(u"Foo", 0x0001));
+        CPPUNIT_ASSERT_USTRINGS_EQUAL(u"Range (0x0015)", names.nameFromSection(u"Foo", 0x0015, ts::names::VALUE));
+        CPPUNIT_ASSERT_USTRINGS_EQUAL(u"Last", names.nameFromSection(u"Foo", 0x1000));
+        CPPUNIT_ASSERT_USTRINGS_EQUAL(u"unknown (0x1001)", names.nameFromSection(u"Foo", 0x1001));
+        CPPUNIT_ASSERT_USTRINGS_EQUAL(u"Bar one", names.nameFromSection(u"bar", 0x01));
+        CPPUNIT_ASSERT_USTRINGS_EQUAL(u"One", names.nameFromSectionWithFallback(u"foo", 0x0002, 0x0001));
+        CPPUNIT_ASSERT_USTRINGS_EQUAL(u"unknown (0x01)", names.nameFromSection(u"none", 0x01, ts::names::NAME, 8));
+    }
+
+    // A modified text file takes precedence over the compiled file.
+    strm.open(textFile.toUTF8().c_str(), std::ios::app);
+    strm << "0x02 = Bar two" << std::endl;
+    strm.close();
+
+    {
+        ts::Names names(textFile);
+        CPPUNIT_ASSERT(!names.isCompiled());
+        CPPUNIT_ASSERT_EQUAL(size_t(0), names.errorCount());
+        CPPUNIT_ASSERT_USTRINGS_EQUAL(u"One", names.nameFromSection(u"Foo", 0x0001));
+        CPPUNIT_ASSERT_USTRINGS_EQUAL(u"Bar two", names.nameFromSection(u"bar", 0x02));
+    }
+
+    CPPUNIT_ASSERT_EQUAL(ts::SYS_SUCCESS, ts::DeleteFile(textFile));
+    CPPUNIT_ASSERT_EQUAL(ts::SYS_SUCCESS, ts::DeleteFile(binFile));
+}
@@ -68,6 +68,7 @@ public:
     void testSocketAddress();
     void testTCPSocket();
     void testUDPSocket();
+    void testUDPBatch();
     void testIPHeader();
 
     CPPUNIT_TEST_SUITE(NetworkingTest);
@@ -80,6 +81,7 @@ public:
     CPPUNIT_TEST(testSocketAddress);
     CPPUNIT_TEST(testTCPSocket);
     CPPUNIT_TEST(testUDPSocket);
+    CPPUNIT_TEST(testUDPBatch);
     CPPUNIT_TEST(testIPHeader);
     CPPUNIT_TEST_SUITE_END();
 
@@ -677,6 +679,64 @@ void NetworkingTest::testUDPSocket()
     CERR.debug(u"UDPSocketTest: main thread: reply sent");
 }
 
+// Test batch send and receive on the loopback interface.
+void NetworkingTest::testUDPBatch()
+{
+    CPPUNIT_ASSERT(ts::IPInitialize());
+
+    const uint16_t portNumber = 12346;
+    const size_t msgCount = 10;
+
+    // Create server socket
+    ts::UDPSocket server;
+    CPPUNIT_ASSERT(server.open(CERR));
+    CPPUNIT_ASSERT(server.reusePort(true, CERR));
+    CPPUNIT_ASSERT(server.bind(ts::SocketAddress(ts::IPAddress::LocalHost, portNumber), CERR));
+#if defined(TS_LINUX)
+    CPPUNIT_ASSERT(server.setReceiveTimestamps(true, CERR));
+#endif
+
+    // Send a batch of messages with distinct sizes and contents to the default destination.
+    ts::UDPSocket client;
+    CPPUNIT_ASSERT(client.open(CERR));
+    CPPUNIT_ASSERT(client.setDefaultDestination(ts::SocketAddress(ts::IPAddress::LocalHost, portNumber), CERR));
+    uint8_t out[msgCount][100];
+    ts::UDPSocket::Message outMsgs[msgCount];
+    for (size_t i = 0; i < msgCount; ++i) {
+        ::memset(out[i], int(i), sizeof(out[i]));
+        outMsgs[i].data = out[i];
+        outMsgs[i].size = 10 + i;
+    }
+    CPPUNIT_ASSERT(client.sendBatch(outMsgs, msgCount, CERR));
+
+    // Receive all messages, possibly in several batches.
+    uint8_t in[msgCount][100];
+    ts::UDPSocket::Message inMsgs[msgCount];
+    size_t received = 0;
+    while (received < msgCount) {
+        for (size_t i = received; i < msgCount; ++i) {
+            inMsgs[i].data = in[i];
+            inMsgs[i].max_size = sizeof(in[i]);
+        }
+        size_t count = 0;
+        CPPUNIT_ASSERT(server.receiveBatch(inMsgs + received, msgCount - received, count, 0, CERR));
+        CPPUNIT_ASSERT(count > 0);
+        received += count;
+    }
+    CPPUNIT_ASSERT_EQUAL(msgCount, received);
+
+    for (size_t i = 0; i < msgCount; ++i) {
+        const uint8_t* data = reinterpret_cast<const uint8_t*>(inMsgs[i].data);
+        CPPUNIT_ASSERT_EQUAL(10 + i, inMsgs[i].size);
+        CPPUNIT_ASSERT_EQUAL(uint8_t(i), data[0]);
+        CPPUNIT_ASSERT_EQUAL(uint8_t(i), data[inMsgs[i].size - 1]);
+        CPPUNIT_ASSERT(ts::IPAddress(inMsgs[i].sender) == ts::IPAddress::LocalHost);
+#if defined(TS_LINUX)
+        CPPUNIT_ASSERT(inMsgs[i].timestamp > 0);
+#endif
+    }
+}
+
 // Test IP header
 void NetworkingTest::testIPHeader()
 {
@@ -0,0 +1,186 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  CppUnit test suite for class ts::PESDemux
+//
+//----------------------------------------------------------------------------
+
+#include "tsPESDemux.h"
+#include "utestCppUnitTest.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class PESDemuxTest: public CppUnit::TestFixture
+{
+public:
+    virtual void setUp() override;
+    virtual void tearDown() override;
+
+    void testReassembly();
+    void testHeaderOnly();
+
+    CPPUNIT_TEST_SUITE(PESDemuxTest);
+    CPPUNIT_TEST(testReassembly);
+    CPPUNIT_TEST(testHeaderOnly);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(PESDemuxTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void PESDemuxTest::setUp()
+{
+}
+
+// Test suite cleanup method.
+void PESDemuxTest::tearDown()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Test stream and handler.
+//----------------------------------------------------------------------------
+
+namespace {
+
+    const ts::PID TEST_PID = 0x0123;
+    const size_t  TEST_PES_COUNT = 10;
+    const size_t  TEST_TS_PER_PES = 3;
+
+    // Build a stream of PES packets, each one spanning several TS packets.
+    // The payload bytes of PES packet #n have value n. The last TS packet
+    // starts an additional PES packet to terminate the previous one.
+    void BuildStream(ts::TSPacketVector& packets)
+    {
+        packets.clear();
+        uint8_t cc = 0;
+        for (size_t pes = 0; pes <= TEST_PES_COUNT; ++pes) {
+            for (size_t i = 0; i < TEST_TS_PER_PES && (pes < TEST_PES_COUNT || i == 0); ++i) {
+                ts::TSPacket pkt(ts::NullPacket);
+                pkt.setPID(TEST_PID);
+                pkt.setCC(cc);
+                cc = (cc + 1) % ts::CC_MAX;
+                uint8_t* const pl = pkt.getPayload();
+                ::memset(pl, int(pes), pkt.getPayloadSize());
+                if (i == 0) {
+                    // PES header: private stream 1, unbounded size, no optional field.
+                    pkt.setPUSI();
+                    static const uint8_t header[] = {0x00, 0x00, 0x01, 0xBD, 0x00, 0x00, 0x80, 0x00, 0x00};
+                    ::memcpy(pl, header, sizeof(header));
+                }
+                packets.push_back(pkt);
+            }
+        }
+    }
+
+    class PESHandler: public ts::PESHandlerInterface
+    {
+    public:
+        PESHandler() : packets(), headers(0) {}
+        std::vector<ts::PESPacket*> packets;
+        size_t headers;
+        ~PESHandler()
+        {
+            for (size_t i = 0; i < packets.size(); ++i) {
+                delete packets[i];
+            }
+        }
+        virtual void handlePESPacket(ts::PESDemux&, const ts::PESPacket& packet) override
+        {
+            // Keep a shared reference on the packet, the demux shall not reuse its buffer.
+            packets.push_back(new ts::PESPacket(packet, ts::SHARE));
+        }
+        virtual void handlePESHeader(ts::PESDemux&, const ts::PESPacket& packet) override
+        {
+            CPPUNIT_ASSERT(packet.isValid());
+            CPPUNIT_ASSERT_EQUAL(size_t(9), packet.headerSize());
+            CPPUNIT_ASSERT_EQUAL(ts::PacketCounter(headers * TEST_TS_PER_PES), packet.getFirstTSPacketIndex());
+            headers++;
+        }
+    };
+}
+
+
+//----------------------------------------------------------------------------
+// Test cases
+//----------------------------------------------------------------------------
+
+void PESDemuxTest::testReassembly()
+{
+    ts::TSPacketVector packets;
+    BuildStream(packets);
+
+    PESHandler handler;
+    ts::PESDemux demux(&handler);
+    for (size_t i = 0; i < packets.size(); ++i) {
+        demux.feedPacket(packets[i]);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(size_t(0), handler.headers);
+    CPPUNIT_ASSERT_EQUAL(TEST_PES_COUNT, handler.packets.size());
+    for (size_t pes = 0; pes < handler.packets.size(); ++pes) {
+        const ts::PESPacket& pp(*handler.packets[pes]);
+        CPPUNIT_ASSERT(pp.isValid());
+        CPPUNIT_ASSERT_EQUAL(TEST_TS_PER_PES * 184 - 9, pp.payloadSize());
+        CPPUNIT_ASSERT_EQUAL(ts::PacketCounter(pes * TEST_TS_PER_PES), pp.getFirstTSPacketIndex());
+        CPPUNIT_ASSERT_EQUAL(ts::PacketCounter(pes * TEST_TS_PER_PES + TEST_TS_PER_PES - 1), pp.getLastTSPacketIndex());
+        // The retained packets are not overwritten by the next ones.
+        for (size_t i = 0; i < pp.payloadSize(); ++i) {
+            CPPUNIT_ASSERT_EQUAL(int(pes), int(pp.payload()[i]));
+        }
+    }
+}
+
+void PESDemuxTest::testHeaderOnly()
+{
+    ts::TSPacketVector packets;
+    BuildStream(packets);
+
+    PESHandler handler;
+    ts::PESDemux demux(&handler);
+    demux.setHeaderOnly(true);
+    CPPUNIT_ASSERT(demux.headerOnly());
+    for (size_t i = 0; i < packets.size(); ++i) {
+        demux.feedPacket(packets[i]);
+    }
+
+    // All headers are notified, including the last one, no complete packet.
+    CPPUNIT_ASSERT_EQUAL(TEST_PES_COUNT + 1, handler.headers);
+    CPPUNIT_ASSERT_EQUAL(size_t(0), handler.packets.size());
+}
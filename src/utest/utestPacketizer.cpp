@@ -57,9 +57,11 @@ public:
     virtual void tearDown() override;
 
     void testPacketizer();
+    void testRemoveSection();
 
     CPPUNIT_TEST_SUITE(PacketizerTest);
     CPPUNIT_TEST(testPacketizer);
+    CPPUNIT_TEST(testRemoveSection);
     CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -174,3 +176,40 @@ void PacketizerTest::testPacketizer()
     CPPUNIT_ASSERT(pmt_count == 4);
     CPPUNIT_ASSERT(sdt_count >= 15 && sdt_count <= 17);
 }
+
+void PacketizerTest::testRemoveSection()
+{
+    ts::BinaryTablePtr binpat;
+    ts::BinaryTablePtr binpmt;
+    ts::BinaryTablePtr binsdt;
+
+    DemuxTable(binpat, "PAT", psi_pat_r4_packets, sizeof(psi_pat_r4_packets));
+    DemuxTable(binpmt, "PMT", psi_pmt_planete_packets, sizeof(psi_pmt_planete_packets));
+    DemuxTable(binsdt, "SDT", psi_sdt_r3_packets, sizeof(psi_sdt_r3_packets));
+
+    ts::CyclingPacketizer pzer(ts::PID_PAT, ts::CyclingPacketizer::ALWAYS);
+    pzer.addTable(*binpat);
+    pzer.addTable(*binpmt);
+    pzer.addTable(*binsdt);
+    CPPUNIT_ASSERT_EQUAL(ts::SectionCounter(3), pzer.storedSectionCount());
+
+    // Remove the PMT section, identified by its pointer, not by its content.
+    const ts::SectionPtr pmtCopy(new ts::Section(*binpmt->sectionAt(0), ts::COPY));
+    CPPUNIT_ASSERT(!pzer.removeSection(pmtCopy));
+    CPPUNIT_ASSERT(pzer.removeSection(binpmt->sectionAt(0)));
+    CPPUNIT_ASSERT(!pzer.removeSection(binpmt->sectionAt(0)));
+    CPPUNIT_ASSERT_EQUAL(ts::SectionCounter(2), pzer.storedSectionCount());
+
+    // The PMT is never packetized, the other sections remain in the same order.
+    ts::TID previous = ts::TID_NULL;
+    for (int pi = 1; pi <= 20; ++pi) {
+        ts::TSPacket pkt;
+        pzer.getNextPacket(pkt);
+        if (pkt.getPUSI()) {
+            const ts::TID tid = pkt.b[5];
+            CPPUNIT_ASSERT(tid == ts::TID_PAT || tid == ts::TID_SDT_ACT);
+            CPPUNIT_ASSERT(tid != previous);
+            previous = tid;
+        }
+    }
+}
@@ -32,6 +32,11 @@
 //----------------------------------------------------------------------------
 
 #include "tsPluginSharedLibrary.h"
+#include "tsSectionDemux.h"
+#include "tsBinaryTable.h"
+#include "tsPAT.h"
+#include "tsSysUtils.h"
+#include "tsTime.h"
 #include "utestCppUnitTest.h"
 TSDUCK_SOURCE;
 
@@ -49,15 +54,20 @@ public:
     void testInput();
     void testOutput();
     void testProcessor();
+    void testInjectPollFiles();
 
     CPPUNIT_TEST_SUITE(PluginTest);
     CPPUNIT_TEST(testInput);
     CPPUNIT_TEST(testOutput);
     CPPUNIT_TEST(testProcessor);
+    CPPUNIT_TEST(testInjectPollFiles);
     CPPUNIT_TEST_SUITE_END();
 
 private:
+    ts::UString _tempFile;
+
     static void display(const ts::PluginSharedLibrary& lib);
+    static void savePAT(const ts::UString& fileName, uint8_t version);
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(PluginTest);
@@ -70,11 +80,74 @@ CPPUNIT_TEST_SUITE_REGISTRATION(PluginTest);
 // Test suite initialization method.
 void PluginTest::setUp()
 {
+    _tempFile = ts::TempFile(u".bin");
 }
 
 // Test suite cleanup method.
 void PluginTest::tearDown()
 {
+    ts::DeleteFile(_tempFile);
+}
+
+
+//----------------------------------------------------------------------------
+// Test support classes.
+//----------------------------------------------------------------------------
+
+namespace {
+
+    // A TSP callback structure to run a plugin outside tsp.
+    class TestTSP: public ts::TSP
+    {
+    public:
+        TestTSP() : ts::TSP(ts::Severity::Info) {}
+        virtual void useJointTermination(bool on) override {}
+        virtual void jointTerminate() override {}
+        virtual bool useJointTermination() const override {return false;}
+        virtual bool thisJointTerminated() const override {return false;}
+    protected:
+        virtual void writeLog(int severity, const ts::UString& message) override
+        {
+            utest::Out() << "PluginTest: " << message << std::endl;
+        }
+    };
+
+    // Collect the last PAT in a PID.
+    class PATCollector: public ts::TableHandlerInterface
+    {
+    public:
+        bool    found;
+        uint8_t version;
+        PATCollector() : found(false), version(0) {}
+        virtual void handleTable(ts::SectionDemux& demux, const ts::BinaryTable& table) override
+        {
+            const ts::PAT pat(table);
+            if (pat.isValid()) {
+                found = true;
+                version = pat.version;
+            }
+        }
+    };
+}
+
+// Save a binary section file containing a PAT, different for each version.
+void PluginTest::savePAT(const ts::UString& fileName, uint8_t version)
+{
+    ts::PAT pat(version, true, 0x1000);
+    for (uint16_t srv = 0; srv <= version; ++srv) {
+        pat.pmts[0x0100 + srv] = 0x0200 + srv;
+    }
+    ts::BinaryTable bin;
+    pat.serialize(bin);
+    ts::ByteBlock data;
+    for (size_t i = 0; i < bin.sectionCount(); ++i) {
+        data.append(bin.sectionAt(i)->content(), bin.sectionAt(i)->size());
+    }
+
+    // Write a new file and rename it, never let the plugin read a partially written file.
+    const ts::UString tmpName(fileName + u".tmp");
+    CPPUNIT_ASSERT(data.saveToFile(tmpName));
+    CPPUNIT_ASSERT(ts::RenameFile(tmpName, fileName) == ts::SYS_SUCCESS);
 }
 
 
@@ -123,3 +196,64 @@ void PluginTest::testProcessor()
     CPPUNIT_ASSERT(plugin.new_output == 0);
     CPPUNIT_ASSERT(plugin.new_processor != 0);
 }
+
+// Repeatedly rewrite a file which is injected with --poll-files. The compiler
+// thread recompiles or reuses cached versions while packets are processed.
+void PluginTest::testInjectPollFiles()
+{
+    ts::PluginSharedLibrary lib(u"inject");
+    CPPUNIT_ASSERT(lib.isLoaded());
+    CPPUNIT_ASSERT(lib.new_processor != 0);
+
+    TestTSP tsp;
+    ts::ProcessorPlugin* plugin = lib.new_processor(&tsp);
+    CPPUNIT_ASSERT(plugin != 0);
+
+    savePAT(_tempFile, 0);
+    ts::UStringVector args;
+    args.push_back(u"--poll-files");
+    args.push_back(u"--inter-packet");
+    args.push_back(u"1");
+    args.push_back(u"--pid");
+    args.push_back(u"0x0100");
+    args.push_back(_tempFile);
+    CPPUNIT_ASSERT(plugin->analyze(u"inject", args, false));
+    CPPUNIT_ASSERT(plugin->start());
+
+    // Successive versions of the file. Reverting to a previous version reuses the
+    // compiled cache (4 versions per file). The first version is evicted at the end.
+    static const uint8_t versions[] = {0, 1, 2, 1, 3, 4, 5, 0};
+
+    PATCollector collector;
+    ts::SectionDemux demux(&collector);
+    demux.addPID(0x0100);
+    ts::Time lastWrite(ts::Time::CurrentUTC());
+    ts::TSPacket pkt;
+    bool flush = false;
+    bool bitrate_changed = false;
+
+    for (size_t i = 0; i < sizeof(versions) / sizeof(versions[0]); ++i) {
+        if (i > 0) {
+            // File modification dates may have a one-second resolution.
+            const ts::MilliSecond elapsed = ts::Time::CurrentUTC() - lastWrite;
+            if (elapsed < 1100) {
+                ts::SleepThread(1100 - elapsed);
+            }
+            savePAT(_tempFile, versions[i]);
+            lastWrite = ts::Time::CurrentUTC();
+        }
+
+        // Process null packets until the expected version is injected.
+        const ts::Time timeout(ts::Time::CurrentUTC() + 5000);
+        while (!collector.found || collector.version != versions[i]) {
+            CPPUNIT_ASSERT(ts::Time::CurrentUTC() < timeout);
+            pkt = ts::NullPacket;
+            CPPUNIT_ASSERT(plugin->processPacket(pkt, flush, bitrate_changed) == ts::ProcessorPlugin::TSP_OK);
+            demux.feedPacket(pkt);
+        }
+        utest::Out() << "PluginTest: injected PAT version " << int(versions[i]) << std::endl;
+    }
+
+    CPPUNIT_ASSERT(plugin->stop());
+    delete plugin;
+}
@@ -34,6 +34,7 @@
 #include "tsReportBuffer.h"
 #include "tsReportFile.h"
 #include "tsSysUtils.h"
+#include "tsTime.h"
 #include "utestCppUnitTest.h"
 TSDUCK_SOURCE;
 
@@ -55,6 +56,8 @@ public:
     void testPrintf();
     void testByName();
     void testByStream();
+    void testMacros();
+    void testDisabledCost();
 
     CPPUNIT_TEST_SUITE(ReportTest);
     CPPUNIT_TEST(testSeverity);
@@ -62,6 +65,8 @@ public:
     CPPUNIT_TEST(testPrintf);
     CPPUNIT_TEST(testByName);
     CPPUNIT_TEST(testByStream);
+    CPPUNIT_TEST(testMacros);
+    CPPUNIT_TEST(testDisabledCost);
     CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -325,3 +330,67 @@ void ReportTest::testByStream()
     ts::UString::Load(value, _fileName);
     CPPUNIT_ASSERT(value == ref);
 }
+
+// Argument of logged messages, count evaluations.
+namespace {
+    int _evaluations = 0;
+    int _evaluate(int value)
+    {
+        _evaluations++;
+        return value;
+    }
+}
+
+// Test case: severity-gated macros
+void ReportTest::testMacros()
+{
+    ts::ReportBuffer<> log;
+    _evaluations = 0;
+
+    TS_DEBUG(log, u"debug %d", {_evaluate(1)});
+    TS_LOG(log, 10, u"level 10 %d", {_evaluate(2)});
+    TS_LOG(log, ts::Severity::Info, u"info %d", {_evaluate(3)});
+    CPPUNIT_ASSERT_EQUAL(1, _evaluations);
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(u"info 3", log.getMessages());
+
+    log.setMaxSeverity(10);
+    log.resetMessages();
+    _evaluations = 0;
+
+    TS_DEBUG(log, u"debug %d", {_evaluate(1)});
+    TS_LOG(log, 10, u"level 10 %d", {_evaluate(2)});
+    TS_LOG(log, 11, u"level 11 %d", {_evaluate(3)});
+    CPPUNIT_ASSERT_EQUAL(2, _evaluations);
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(u"Debug: debug 1\nDebug[10]: level 10 2", log.getMessages());
+}
+
+// Test case: cost of disabled debug messages, as in the tsp packet handoff.
+void ReportTest::testDisabledCost()
+{
+    ts::ReportBuffer<> log;
+    const size_t count = 5000000;
+    size_t pkt_first = 0;
+    size_t pkt_cnt = 0;
+    uint32_t bitrate = 0;
+
+    ts::Time start(ts::Time::CurrentUTC());
+    for (size_t i = 0; i < count; ++i) {
+        pkt_first = i & 0xFFFF;
+        pkt_cnt = i & 0x3FF;
+        bitrate = uint32_t(i);
+        log.log(10, u"waitWork (pkt_first = %'d, pkt_cnt = %'d, bitrate = %'d, input_end = %'d, aborted = %'d)", {pkt_first, pkt_cnt, bitrate, false, false});
+    }
+    const ts::MilliSecond direct = ts::Time::CurrentUTC() - start;
+
+    start = ts::Time::CurrentUTC();
+    for (size_t i = 0; i < count; ++i) {
+        pkt_first = i & 0xFFFF;
+        pkt_cnt = i & 0x3FF;
+        bitrate = uint32_t(i);
+        TS_LOG(log, 10, u"waitWork (pkt_first = %'d, pkt_cnt = %'d, bitrate = %'d, input_end = %'d, aborted = %'d)", {pkt_first, pkt_cnt, bitrate, false, false});
+    }
+    const ts::MilliSecond gated = ts::Time::CurrentUTC() - start;
+
+    CPPUNIT_ASSERT(log.emptyMessages());
+    utest::Out() << "ReportTest: " << count << " disabled debug messages, log(): " << direct << " ms, TS_LOG(): " << gated << " ms" << std::endl;
+}
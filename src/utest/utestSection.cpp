@@ -34,6 +34,8 @@
 #include "tsSection.h"
 #include "tsBinaryTable.h"
 #include "tsNames.h"
+#include "tsCRC32.h"
+#include "tsTime.h"
 #include "utestCppUnitTest.h"
 TSDUCK_SOURCE;
 
@@ -58,6 +60,7 @@ public:
     void testReload();
     void testAssign();
     void testPackSections();
+    void testCRC32();
 
     CPPUNIT_TEST_SUITE(SectionTest);
     CPPUNIT_TEST(testTOT);
@@ -66,6 +69,7 @@ public:
     CPPUNIT_TEST(testReload);
     CPPUNIT_TEST(testAssign);
     CPPUNIT_TEST(testPackSections);
+    CPPUNIT_TEST(testCRC32);
     CPPUNIT_TEST_SUITE_END();
 };
 
@@ -242,3 +246,59 @@ void SectionTest::testPackSections()
     CPPUNIT_ASSERT(sec->payload() != 0);
     CPPUNIT_ASSERT_EQUAL(uint8_t(4), *sec->payload());
 }
+
+void SectionTest::testCRC32()
+{
+    static const ts::CRC32::Implementation impls[] = {ts::CRC32::BYTEWISE, ts::CRC32::SLICING_BY_8, ts::CRC32::PCLMULQDQ};
+    static const char* const names[] = {"bytewise", "slicing-by-8", "pclmulqdq"};
+    const ts::CRC32::Implementation initial = ts::CRC32::GetImplementation();
+
+    // Pseudo-random data, large enough to test all sizes and alignments.
+    ts::ByteBlock data(8192);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = uint8_t(i * 131 + (i >> 8) * 7);
+    }
+
+    // Reference values, using the bytewise implementation.
+    CPPUNIT_ASSERT(ts::CRC32::SetImplementation(ts::CRC32::BYTEWISE));
+    CPPUNIT_ASSERT_EQUAL(uint32_t(0x0376E6E7), ts::CRC32("123456789", 9).value());
+    std::vector<uint32_t> ref;
+    for (size_t size = 0; size < 600; ++size) {
+        ref.push_back(ts::CRC32(&data[size % 13], size).value());
+    }
+    const uint32_t ref_large = ts::CRC32(&data[3], data.size() - 3).value();
+
+    for (size_t n = 0; n < sizeof(impls) / sizeof(impls[0]); ++n) {
+        if (!ts::CRC32::IsSupported(impls[n])) {
+            utest::Out() << "SectionTest: CRC32 " << names[n] << " not supported" << std::endl;
+            continue;
+        }
+        CPPUNIT_ASSERT(ts::CRC32::SetImplementation(impls[n]));
+        CPPUNIT_ASSERT_EQUAL(uint32_t(0x0376E6E7), ts::CRC32("123456789", 9).value());
+        for (size_t size = 0; size < ref.size(); ++size) {
+            CPPUNIT_ASSERT_EQUAL(ref[size], ts::CRC32(&data[size % 13], size).value());
+        }
+        CPPUNIT_ASSERT_EQUAL(ref_large, ts::CRC32(&data[3], data.size() - 3).value());
+
+        // Incremental computation.
+        ts::CRC32 crc;
+        crc.add(&data[3], 200);
+        crc.add(&data[203], 5);
+        crc.add(&data[208], data.size() - 208);
+        CPPUNIT_ASSERT_EQUAL(ref_large, crc.value());
+
+        // Performance evaluation, displayed in debug mode only.
+        const size_t loops = 10000;
+        uint32_t sum = 0;
+        const ts::Time start(ts::Time::CurrentUTC());
+        for (size_t i = 0; i < loops; ++i) {
+            sum ^= ts::CRC32(&data[i % 64], 4096).value();
+        }
+        const ts::MilliSecond duration = ts::Time::CurrentUTC() - start;
+        utest::Out() << "SectionTest: CRC32 " << names[n] << " on " << (loops * 4096 / 1024) << " kB: "
+                     << duration << " ms (" << ts::UString::Format(u"%X", {sum}) << ")" << std::endl;
+    }
+
+    // Restore the default implementation for other tests.
+    CPPUNIT_ASSERT(ts::CRC32::SetImplementation(initial));
+}
@@ -32,6 +32,11 @@
 //----------------------------------------------------------------------------
 
 #include "tsTSPacket.h"
+#include "tsTSFileInput.h"
+#include "tsTSFileOutput.h"
+#include "tsTSPacketQueue.h"
+#include "tsThread.h"
+#include "tsSysUtils.h"
 #include "tsMemoryUtils.h"
 #include "utestCppUnitTest.h"
 TSDUCK_SOURCE;
@@ -44,14 +49,31 @@ TSDUCK_SOURCE;
 class TSPacketTest: public CppUnit::TestFixture
 {
 public:
+    TSPacketTest();
+
     virtual void setUp() override;
     virtual void tearDown() override;
 
     void testPacket();
+    void testFileInput();
+    void testFileOutput();
+    void testPacketQueue();
 
     CPPUNIT_TEST_SUITE(TSPacketTest);
     CPPUNIT_TEST(testPacket);
+    CPPUNIT_TEST(testFileInput);
+    CPPUNIT_TEST(testFileOutput);
+    CPPUNIT_TEST(testPacketQueue);
     CPPUNIT_TEST_SUITE_END();
+
+private:
+    ts::UString _tempFileName;
+
+    // Read a test file in one access mode.
+    void checkFileInput(ts::TSFileInput::AccessMode mode, bool zero_copy, size_t chunk);
+
+    // Write a test file in one write mode, then append to it.
+    void checkFileOutput(ts::TSFileOutput::WriteMode mode, bool direct, uint64_t sync_interval, size_t chunk);
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TSPacketTest);
@@ -61,14 +83,22 @@ CPPUNIT_TEST_SUITE_REGISTRATION(TSPacketTest);
 // Initialization.
 //----------------------------------------------------------------------------
 
+// Constructor.
+TSPacketTest::TSPacketTest() :
+    _tempFileName(ts::TempFile(u".tmp.ts"))
+{
+}
+
 // Test suite initialization method.
 void TSPacketTest::setUp()
 {
+    ts::DeleteFile(_tempFileName);
 }
 
 // Test suite cleanup method.
 void TSPacketTest::tearDown()
 {
+    ts::DeleteFile(_tempFileName);
 }
 
 
@@ -88,3 +118,215 @@ void TSPacketTest::testPacket()
 
     CPPUNIT_ASSERT_EQUAL(size_t(7 * ts::PKT_SIZE), sizeof(packets));
 }
+
+namespace {
+    // Test file: header, sequence of numbered packets, truncated packet.
+    const size_t FILE_HEADER_SIZE = 50;
+    const size_t FILE_PACKETS = 30000;
+}
+
+void TSPacketTest::checkFileInput(ts::TSFileInput::AccessMode mode, bool zero_copy, size_t chunk)
+{
+    utest::Out() << "TSPacketTest::testFileInput: mode " << int(mode) << ", zero copy: " << zero_copy << ", chunk: " << chunk << std::endl;
+
+    // Use minimum window size, read file twice.
+    ts::TSFileInput file;
+    file.setAccessMode(mode, 1);
+    CPPUNIT_ASSERT(file.open(_tempFileName, 2, FILE_HEADER_SIZE, CERR));
+
+    ts::TSPacketVector buffer(chunk);
+    const ts::TSPacket* pkt = 0;
+    size_t count = 0;
+    size_t index = 0;
+    while ((count = zero_copy ? file.readZeroCopy(pkt, chunk, CERR) : file.read(&buffer[0], chunk, CERR)) > 0) {
+        if (!zero_copy) {
+            pkt = &buffer[0];
+        }
+        CPPUNIT_ASSERT(count <= chunk);
+        for (size_t i = 0; i < count; ++i) {
+            CPPUNIT_ASSERT_EQUAL(ts::SYNC_BYTE, pkt[i].b[0]);
+            CPPUNIT_ASSERT_EQUAL(uint32_t(index % FILE_PACKETS), ts::GetUInt32(pkt[i].b + 4));
+            ++index;
+        }
+    }
+    CPPUNIT_ASSERT_EQUAL(2 * FILE_PACKETS, index);
+    CPPUNIT_ASSERT_EQUAL(ts::PacketCounter(2 * FILE_PACKETS), file.getPacketCount());
+    CPPUNIT_ASSERT(file.close(CERR));
+
+    // Rewindable mode.
+    CPPUNIT_ASSERT(file.open(_tempFileName, FILE_HEADER_SIZE, CERR));
+    CPPUNIT_ASSERT(file.seek(FILE_PACKETS - 10, CERR));
+    buffer.resize(20);
+    CPPUNIT_ASSERT_EQUAL(size_t(10), file.read(&buffer[0], 20, CERR));
+    CPPUNIT_ASSERT_EQUAL(uint32_t(FILE_PACKETS - 10), ts::GetUInt32(buffer[0].b + 4));
+    CPPUNIT_ASSERT(file.rewind(CERR));
+    CPPUNIT_ASSERT_EQUAL(size_t(20), file.read(&buffer[0], 20, CERR));
+    CPPUNIT_ASSERT_EQUAL(uint32_t(19), ts::GetUInt32(buffer[19].b + 4));
+    CPPUNIT_ASSERT(file.close(CERR));
+}
+
+void TSPacketTest::testFileInput()
+{
+    // Build the test file.
+    {
+        std::ofstream strm(_tempFileName.toUTF8().c_str(), std::ios::binary);
+        const std::string header(FILE_HEADER_SIZE, 'x');
+        strm.write(header.data(), header.size());
+        ts::TSPacket pkt;
+        pkt = ts::NullPacket;
+        for (size_t i = 0; i < FILE_PACKETS; ++i) {
+            ts::PutUInt32(pkt.b + 4, uint32_t(i));
+            strm.write(reinterpret_cast<const char*>(pkt.b), ts::PKT_SIZE);
+        }
+        strm.write(reinterpret_cast<const char*>(pkt.b), 100);
+        CPPUNIT_ASSERT(strm.good());
+    }
+
+    checkFileInput(ts::TSFileInput::READ_ACCESS, false, 1000);
+    checkFileInput(ts::TSFileInput::READ_ACCESS, true, 1000);
+    checkFileInput(ts::TSFileInput::MMAP_ACCESS, false, 1000);
+    checkFileInput(ts::TSFileInput::MMAP_ACCESS, true, 777);
+    checkFileInput(ts::TSFileInput::DIRECT_ACCESS, false, 1000);
+    checkFileInput(ts::TSFileInput::DIRECT_ACCESS, true, 777);
+}
+
+void TSPacketTest::checkFileOutput(ts::TSFileOutput::WriteMode mode, bool direct, uint64_t sync_interval, size_t chunk)
+{
+    utest::Out() << "TSPacketTest::testFileOutput: mode " << int(mode) << ", direct: " << direct << ", sync: " << sync_interval << ", chunk: " << chunk << std::endl;
+
+    // Use two minimum buffers to force waiting for free buffers.
+    ts::TSFileOutput file;
+    file.setWriteMode(mode, 1, 2);
+    file.setDirectIO(direct);
+    file.setSyncInterval(sync_interval);
+
+    ts::TSPacketVector buffer(chunk);
+    for (size_t pass = 0; pass < 2; ++pass) {
+        CPPUNIT_ASSERT(file.open(_tempFileName, pass > 0, false, CERR));
+        CPPUNIT_ASSERT(mode == ts::TSFileOutput::SYNC_WRITE ? file.getWriteMode() == mode : file.getWriteMode() != ts::TSFileOutput::SYNC_WRITE);
+        for (size_t index = 0; index < FILE_PACKETS; ) {
+            const size_t count = std::min(chunk, FILE_PACKETS - index);
+            for (size_t i = 0; i < count; ++i) {
+                buffer[i] = ts::NullPacket;
+                ts::PutUInt32(buffer[i].b + 4, uint32_t(index++));
+            }
+            CPPUNIT_ASSERT(file.write(&buffer[0], count, CERR));
+        }
+        CPPUNIT_ASSERT_EQUAL(ts::PacketCounter(FILE_PACKETS), file.getPacketCount());
+        CPPUNIT_ASSERT(file.close(CERR));
+
+        const ts::TSFileOutput::WriteStatistics stats(file.getWriteStatistics());
+        CPPUNIT_ASSERT_EQUAL(file.getWriteMode(), stats.mode);
+        if (mode != ts::TSFileOutput::SYNC_WRITE) {
+            // Full buffers of 1024 packets are written asynchronously.
+            CPPUNIT_ASSERT_EQUAL(uint64_t(FILE_PACKETS / 1024), stats.writes);
+            CPPUNIT_ASSERT_EQUAL(uint64_t((FILE_PACKETS / 1024) * 1024 * ts::PKT_SIZE), stats.bytes);
+        }
+        if (sync_interval == 0) {
+            CPPUNIT_ASSERT_EQUAL(uint64_t(0), stats.syncs);
+        }
+    }
+
+    // Read back the file.
+    ts::TSFileInput input;
+    CPPUNIT_ASSERT(input.open(_tempFileName, 1, 0, CERR));
+    size_t index = 0;
+    size_t count = 0;
+    while ((count = input.read(&buffer[0], chunk, CERR)) > 0) {
+        for (size_t i = 0; i < count; ++i) {
+            CPPUNIT_ASSERT_EQUAL(ts::SYNC_BYTE, buffer[i].b[0]);
+            CPPUNIT_ASSERT_EQUAL(uint32_t(index % FILE_PACKETS), ts::GetUInt32(buffer[i].b + 4));
+            ++index;
+        }
+    }
+    CPPUNIT_ASSERT_EQUAL(2 * FILE_PACKETS, index);
+    CPPUNIT_ASSERT(input.close(CERR));
+}
+
+void TSPacketTest::testFileOutput()
+{
+    checkFileOutput(ts::TSFileOutput::SYNC_WRITE, false, 0, 1000);
+    checkFileOutput(ts::TSFileOutput::SYNC_WRITE, false, 1024 * 1024, 777);
+    checkFileOutput(ts::TSFileOutput::THREAD_WRITE, false, 0, 1000);
+    checkFileOutput(ts::TSFileOutput::THREAD_WRITE, true, 1024 * 1024, 777);
+    checkFileOutput(ts::TSFileOutput::URING_WRITE, false, 0, 3000);
+    checkFileOutput(ts::TSFileOutput::URING_WRITE, true, 1024 * 1024, 777);
+}
+
+namespace {
+    // Writer thread for the packet queue test.
+    class QueueWriter : public ts::Thread
+    {
+    public:
+        QueueWriter(ts::TSPacketQueue& queue, uint32_t count) : _queue(queue), _count(count) {}
+    private:
+        ts::TSPacketQueue& _queue;
+        uint32_t _count;
+
+        virtual void main() override
+        {
+            uint32_t next = 0;
+            ts::TSPacket* buffer = 0;
+            size_t size = 0;
+            while (next < _count && _queue.lockWriteBuffer(buffer, size, 3)) {
+                // Write less than possible to exercise various positions in the buffer.
+                size = std::min<size_t>(std::min<size_t>(size, 5), _count - next);
+                for (size_t i = 0; i < size; ++i) {
+                    buffer[i] = ts::NullPacket;
+                    ts::PutUInt32(buffer[i].b + 4, next++);
+                }
+                _queue.releaseWriteBuffer(size);
+            }
+            _queue.setEOF();
+        }
+    };
+}
+
+void TSPacketTest::testPacketQueue()
+{
+    const uint32_t total = 100000;
+    ts::TSPacketQueue queue(17);
+    QueueWriter writer(queue, total);
+    CPPUNIT_ASSERT(writer.start());
+
+    // Read packets using all reading methods in turn.
+    uint32_t next = 0;
+    ts::TSPacket pkt[8];
+    ts::BitRate bitrate = 0;
+    bool ok = true;
+    for (size_t loop = 0; ok && next < total; ++loop) {
+        if (queue.eof() && queue.currentSize() == 0) {
+            ok = false;
+        }
+        else if (loop % 3 == 0) {
+            if (queue.getPacket(pkt[0], bitrate)) {
+                ok = ts::GetUInt32(pkt[0].b + 4) == next++;
+            }
+        }
+        else if (loop % 3 == 1) {
+            const size_t count = queue.getPackets(pkt, 8, bitrate);
+            for (size_t i = 0; ok && i < count; ++i) {
+                ok = ts::GetUInt32(pkt[i].b + 4) == next++;
+            }
+        }
+        else {
+            const ts::TSPacket* span = 0;
+            size_t count = 0;
+            if (queue.lockReadBuffer(span, count, bitrate)) {
+                CPPUNIT_ASSERT(count > 0);
+                CPPUNIT_ASSERT(count <= queue.bufferSize());
+                for (size_t i = 0; ok && i < count; ++i) {
+                    ok = ts::GetUInt32(span[i].b + 4) == next++;
+                }
+                queue.releaseReadBuffer(count);
+            }
+        }
+    }
+    queue.stop();
+    CPPUNIT_ASSERT(writer.waitForTermination());
+    CPPUNIT_ASSERT(ok);
+    CPPUNIT_ASSERT_EQUAL(total, next);
+    CPPUNIT_ASSERT(queue.eof());
+    CPPUNIT_ASSERT_EQUAL(size_t(0), queue.currentSize());
+    CPPUNIT_ASSERT(!queue.getPacket(pkt[0], bitrate));
+}
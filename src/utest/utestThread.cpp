@@ -59,6 +59,8 @@ public:
     virtual void tearDown() override;
 
     void testAttributes();
+    void testCPUSet();
+    void testAffinity();
     void testTermination();
     void testDeleteWhenTerminated();
     void testMutexRecursion();
@@ -67,6 +69,8 @@ public:
 
     CPPUNIT_TEST_SUITE(ThreadTest);
     CPPUNIT_TEST(testAttributes);
+    CPPUNIT_TEST(testCPUSet);
+    CPPUNIT_TEST(testAffinity);
     CPPUNIT_TEST(testTermination);
     CPPUNIT_TEST(testDeleteWhenTerminated);
     CPPUNIT_TEST(testMutexRecursion);
@@ -141,6 +145,77 @@ void ThreadTest::testAttributes()
 
     ts::ThreadAttributes attr2;
     CPPUNIT_ASSERT(thread.setAttributes(attr2));
+
+    CPPUNIT_ASSERT(attr2.getAffinity().empty());
+    CPPUNIT_ASSERT(attr2.getNUMANode() < 0);
+    CPPUNIT_ASSERT_EQUAL(ts::ThreadAttributes::DEFAULT_POLICY, attr2.getSchedulingPolicy());
+
+    ts::ThreadAttributes::CPUSet cpus;
+    cpus.insert(1);
+    cpus.insert(3);
+    attr2.setAffinity(cpus).setNUMANode(2).setSchedulingPolicy(ts::ThreadAttributes::FIFO_POLICY, 10);
+    CPPUNIT_ASSERT(attr2.getAffinity() == cpus);
+    CPPUNIT_ASSERT_EQUAL(2, attr2.getNUMANode());
+    CPPUNIT_ASSERT_EQUAL(ts::ThreadAttributes::FIFO_POLICY, attr2.getSchedulingPolicy());
+}
+
+//
+// Test case: CPU lists.
+//
+void ThreadTest::testCPUSet()
+{
+    ts::ThreadAttributes::CPUSet cpus;
+
+    CPPUNIT_ASSERT(ts::ThreadAttributes::DecodeCPUSet(u"0-3,8, 10-11", cpus));
+    CPPUNIT_ASSERT_EQUAL(size_t(7), cpus.size());
+    CPPUNIT_ASSERT(cpus.count(0) == 1 && cpus.count(3) == 1 && cpus.count(4) == 0 && cpus.count(8) == 1 && cpus.count(11) == 1);
+
+    CPPUNIT_ASSERT(ts::ThreadAttributes::DecodeCPUSet(u"5", cpus));
+    CPPUNIT_ASSERT_EQUAL(size_t(1), cpus.size());
+    CPPUNIT_ASSERT(cpus.count(5) == 1);
+
+    CPPUNIT_ASSERT(!ts::ThreadAttributes::DecodeCPUSet(u"", cpus));
+    CPPUNIT_ASSERT(!ts::ThreadAttributes::DecodeCPUSet(u"3-1", cpus));
+    CPPUNIT_ASSERT(!ts::ThreadAttributes::DecodeCPUSet(u"1,x", cpus));
+    CPPUNIT_ASSERT(!ts::ThreadAttributes::DecodeCPUSet(u"0-999999999", cpus));
+}
+
+//
+// Test case: CPU affinity, applied in the context of the thread.
+//
+namespace {
+    class ThreadAffinity: public utest::CppUnitThread
+    {
+    public:
+        explicit ThreadAffinity(const ts::ThreadAttributes& attributes) :
+            utest::CppUnitThread(attributes)
+        {
+        }
+        virtual ~ThreadAffinity()
+        {
+            waitForTermination();
+        }
+        virtual void test() override
+        {
+            CPPUNIT_ASSERT_EQUAL(ts::SYS_SUCCESS, schedulingErrorCode());
+#if defined(TS_LINUX)
+            ::cpu_set_t set;
+            CPU_ZERO(&set);
+            CPPUNIT_ASSERT_EQUAL(0, ::pthread_getaffinity_np(::pthread_self(), sizeof(set), &set));
+            CPPUNIT_ASSERT_EQUAL(1, CPU_COUNT(&set));
+            CPPUNIT_ASSERT(CPU_ISSET(0, &set));
+#endif
+        }
+    };
+}
+
+void ThreadTest::testAffinity()
+{
+    // CPU 0 always exists.
+    ts::ThreadAttributes::CPUSet cpus;
+    cpus.insert(0);
+    ThreadAffinity thread(ts::ThreadAttributes().setAffinity(cpus));
+    CPPUNIT_ASSERT(thread.start());
 }
 
 //
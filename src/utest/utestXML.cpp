@@ -33,6 +33,8 @@
 
 #include "tsxmlDocument.h"
 #include "tsxmlElement.h"
+#include "tsxmlReader.h"
+#include "tsxmlWriter.h"
 #include "tsTextFormatter.h"
 #include "tsCerrReport.h"
 #include "tsReportBuffer.h"
@@ -59,6 +61,8 @@ public:
     void testValidation();
     void testCreation();
     void testKeepOpen();
+    void testReader();
+    void testWriter();
 
     CPPUNIT_TEST_SUITE(XMLTest);
     CPPUNIT_TEST(testDocument);
@@ -67,6 +71,8 @@ public:
     CPPUNIT_TEST(testValidation);
     CPPUNIT_TEST(testCreation);
     CPPUNIT_TEST(testKeepOpen);
+    CPPUNIT_TEST(testReader);
+    CPPUNIT_TEST(testWriter);
     CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -371,3 +377,137 @@ void XMLTest::testKeepOpen()
         u"</node2>\n",
         out.toString());
 }
+
+namespace {
+    // An XML reader handler which logs all events.
+    class LogHandler : public ts::xml::Reader::Handler
+    {
+    public:
+        ts::UString log;
+        LogHandler() : log() {}
+
+        virtual bool handleElementStart(ts::xml::Reader& reader, const ts::UString& name, const ts::xml::Reader::AttributeList& attributes, size_t line) override
+        {
+            log += ts::UString::Format(u"%d:%d:start:%s", {line, reader.depth(), name});
+            for (ts::xml::Reader::AttributeList::const_iterator it = attributes.begin(); it != attributes.end(); ++it) {
+                log += ts::UString::Format(u":%s=%s@%d", {it->name(), it->value(), it->lineNumber()});
+            }
+            log += u"\n";
+            return true;
+        }
+        virtual bool handleElementEnd(ts::xml::Reader& reader, const ts::UString& name, size_t line) override
+        {
+            log += ts::UString::Format(u"%d:%d:end:%s\n", {line, reader.depth(), name});
+            return true;
+        }
+        virtual bool handleText(ts::xml::Reader& reader, const ts::UString& text, bool cdata, size_t line) override
+        {
+            log += ts::UString::Format(u"%d:%d:%s:[%s]\n", {line, reader.depth(), cdata ? u"cdata" : u"text", text});
+            return true;
+        }
+        virtual bool handleComment(ts::xml::Reader& reader, const ts::UString& value, size_t line) override
+        {
+            log += ts::UString::Format(u"%d:%d:comment:[%s]\n", {line, reader.depth(), value});
+            return true;
+        }
+    };
+}
+
+void XMLTest::testReader()
+{
+    const std::string document(
+        "\xEF\xBB\xBF<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<root attr1=\"val1\">\n"
+        "  <!-- a comment -->\n"
+        "  <node1 a1='v1' a2=\"&lt;v2&gt;\">Text &amp; node1</node1>\n"
+        "  <node2\n"
+        "     b1=\"x1\"><![CDATA[<raw>]]></node2>\n"
+        "  <node3/>\n"
+        "</root>\n");
+
+    const ts::UString expected(
+        u"2:1:start:root:attr1=val1@2\n"
+        u"3:1:comment:[ a comment ]\n"
+        u"4:2:start:node1:a1=v1@4:a2=<v2>@4\n"
+        u"4:2:text:[Text & node1]\n"
+        u"4:2:end:node1\n"
+        u"5:2:start:node2:b1=x1@6\n"
+        u"6:2:cdata:[<raw>]\n"
+        u"6:2:end:node2\n"
+        u"7:2:start:node3\n"
+        u"7:2:end:node3\n"
+        u"8:1:end:root\n");
+
+    // Parse the complete document in one chunk.
+    ts::xml::Reader reader(report());
+    LogHandler handler1;
+    CPPUNIT_ASSERT(reader.feed(document.data(), document.size(), handler1));
+    CPPUNIT_ASSERT(reader.finish(handler1));
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(expected, handler1.log);
+
+    // Parse the same document, one byte at a time.
+    reader.reset();
+    LogHandler handler2;
+    for (size_t i = 0; i < document.size(); ++i) {
+        CPPUNIT_ASSERT(reader.feed(&document[i], 1, handler2));
+    }
+    CPPUNIT_ASSERT(reader.finish(handler2));
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(expected, handler2.log);
+
+    // Parse from a stream.
+    std::istringstream strm(document);
+    LogHandler handler3;
+    CPPUNIT_ASSERT(reader.parse(strm, handler3));
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(expected, handler3.log);
+
+    // Incorrect XML documents.
+    ts::ReportBuffer<> rep;
+    ts::xml::Reader bad(rep);
+    LogHandler handler4;
+    std::istringstream strm4("<?xml version='1.0' encoding='UTF-8'?>\n<foo>\n</bar>");
+    CPPUNIT_ASSERT(!bad.parse(strm4, handler4));
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(u"Error: line 3: parsing error, expected </foo>", rep.getMessages());
+
+    rep.resetMessages();
+    std::istringstream strm5("<foo>\n  <bar>\n");
+    CPPUNIT_ASSERT(!bad.parse(strm5, handler4));
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(u"Error: line 3: unexpected end of document, expected </bar>", rep.getMessages());
+
+    rep.resetMessages();
+    std::istringstream strm6("<foo/>\n<bar/>\n");
+    CPPUNIT_ASSERT(!bad.parse(strm6, handler4));
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(u"Error: line 2: trailing element <bar> after root element, invalid XML document", rep.getMessages());
+}
+
+void XMLTest::testWriter()
+{
+    std::ostringstream strm;
+    ts::xml::Writer writer(report());
+    CPPUNIT_ASSERT(writer.rootElement() == 0);
+    CPPUNIT_ASSERT(writer.open(strm, u"root"));
+    CPPUNIT_ASSERT(writer.isOpen());
+
+    ts::xml::Element* root = writer.rootElement();
+    CPPUNIT_ASSERT(root != 0);
+    ts::xml::Element* e1 = root->addElement(u"node1");
+    e1->setAttribute(u"a1", u"v1");
+    e1->addElement(u"node11");
+    writer.flush();
+    CPPUNIT_ASSERT(!root->hasChildren());
+
+    root->addElement(u"node2")->addText(u"text2");
+    root->addElement(u"node3");
+    writer.close();
+    CPPUNIT_ASSERT(!writer.isOpen());
+
+    CPPUNIT_ASSERT_EQUAL(std::string(
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<root>\n"
+        "  <node1 a1=\"v1\">\n"
+        "    <node11/>\n"
+        "  </node1>\n"
+        "  <node2>text2</node2>\n"
+        "  <node3/>\n"
+        "</root>\n"),
+        strm.str());
+}